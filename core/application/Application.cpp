@@ -25,6 +25,7 @@
 #include "collection_pipeline/plugin/PluginRegistry.h"
 #include "collection_pipeline/queue/ExactlyOnceQueueManager.h"
 #include "collection_pipeline/queue/SenderQueueManager.h"
+#include "collection_pipeline/queue/SenderQueueSpiller.h"
 #include "common/CrashBackTraceUtil.h"
 #include "common/EnvUtil.h"
 #include "common/Flags.h"
@@ -34,6 +35,7 @@
 #include "common/TimeKeeper.h"
 #include "common/TimeUtil.h"
 #include "common/UUIDUtil.h"
+#include "common/memory/ChunkPool.h"
 #include "common/version.h"
 #include "config/ConfigDiff.h"
 #include "config/InstanceConfigManager.h"
@@ -77,6 +79,7 @@ DEFINE_FLAG_INT32(config_scan_interval, "seconds", 10);
 DEFINE_FLAG_INT32(tcmalloc_release_memory_interval, "force release memory held by tcmalloc, seconds", 300);
 DEFINE_FLAG_INT32(exit_flushout_duration, "exit process flushout duration", 20 * 1000);
 DEFINE_FLAG_INT32(queue_check_gc_interval_sec, "30s", 30);
+DEFINE_FLAG_INT32(source_buffer_chunk_pool_trim_interval_sec, "free source buffer chunks idle longer than this", 60);
 #if defined(__ENTERPRISE__) && defined(__linux__) && !defined(__ANDROID__)
 DEFINE_FLAG_BOOL(enable_cgroup, "", false);
 #endif
@@ -261,6 +264,7 @@ void Application::Start() { // GCOVR_EXCL_START
 #endif
 
     // runner
+    SenderQueueSpiller::RemoveStaleFiles();
     BoundedSenderQueueInterface::SetFeedback(ProcessQueueManager::GetInstance());
     HttpSink::GetInstance()->Init();
     FlusherRunner::GetInstance()->Init();
@@ -304,7 +308,8 @@ void Application::Start() { // GCOVR_EXCL_START
     OnetimeConfigInfoManager::GetInstance()->LoadCheckpointFile();
 
     time_t curTime = 0, lastOnetimeConfigTimeoutCheckTime = 0, lastConfigCheckTime = 0, lastUpdateMetricTime = 0,
-           lastCheckTagsTime = 0, lastQueueGCTime = 0, lastCheckUnusedCheckpointsTime = 0, lastContainerCheckTime = 0;
+           lastCheckTagsTime = 0, lastQueueGCTime = 0, lastCheckUnusedCheckpointsTime = 0, lastContainerCheckTime = 0,
+           lastChunkPoolTrimTime = 0;
     while (true) {
         curTime = time(NULL);
         if (curTime - lastCheckTagsTime >= INT32_FLAG(file_tags_update_interval)) {
@@ -337,6 +342,10 @@ void Application::Start() { // GCOVR_EXCL_START
             }
             lastConfigCheckTime = curTime;
         }
+        if (curTime - lastChunkPoolTrimTime >= INT32_FLAG(source_buffer_chunk_pool_trim_interval_sec)) {
+            ChunkPool::GetInstance()->Trim();
+            lastChunkPoolTrimTime = curTime;
+        }
 #ifndef LOGTAIL_NO_TC_MALLOC
         if (curTime - gLastTcmallocReleaseMemTime >= INT32_FLAG(tcmalloc_release_memory_interval)) {
             MallocExtension::instance()->ReleaseFreeMemory();
@@ -431,6 +440,7 @@ void Application::Exit() {
     ContainerManager::GetInstance()->Stop();
     FlusherRunner::GetInstance()->Stop();
     HttpSink::GetInstance()->Stop();
+    SenderQueueManager::GetInstance()->StopSpillThread();
 
     // TODO: make it common
     FlusherSLS::RecycleResourceIfNotUsed();
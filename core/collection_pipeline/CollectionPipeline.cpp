@@ -32,6 +32,8 @@
 #include "collection_pipeline/queue/SenderQueueManager.h"
 #include "common/Flags.h"
 #include "common/ParamExtractor.h"
+#include "common/TimeUtil.h"
+#include "common/memory/MemoryBudget.h"
 #include "config/OnetimeConfigInfoManager.h"
 #include "go_pipeline/LogtailPlugin.h"
 #include "logger/Logger.h"
@@ -41,6 +43,7 @@
 #include "plugin/processor/inner/ProcessorTagNative.h"
 
 DECLARE_FLAG_INT32(default_plugin_log_queue_size);
+DECLARE_FLAG_INT32(event_group_trace_sample_interval);
 
 using namespace std;
 
@@ -65,6 +68,46 @@ private:
 
 namespace logtail {
 
+static const vector<uint32_t> sTraceLatencyBucketsMs = {10, 100, 1000, 10000};
+
+// indexed by the stages of EventGroupTrace with the end-to-end latency at last, the names of the buckets follow
+// sTraceLatencyBucketsMs. built on first use, since the metric names are defined in another translation unit.
+static const vector<pair<string, vector<string>>>& GetStageLatencyMetricNames() {
+    static const vector<pair<string, vector<string>>> sNames = {
+        {METRIC_PIPELINE_READ_LATENCY_MS,
+         {METRIC_PIPELINE_READ_LATENCY_LE_10MS_TOTAL,
+          METRIC_PIPELINE_READ_LATENCY_LE_100MS_TOTAL,
+          METRIC_PIPELINE_READ_LATENCY_LE_1000MS_TOTAL,
+          METRIC_PIPELINE_READ_LATENCY_LE_10000MS_TOTAL}},
+        {METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_MS,
+         {METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_LE_10MS_TOTAL,
+          METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_LE_100MS_TOTAL,
+          METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_LE_1000MS_TOTAL,
+          METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_LE_10000MS_TOTAL}},
+        {METRIC_PIPELINE_PROCESS_LATENCY_MS,
+         {METRIC_PIPELINE_PROCESS_LATENCY_LE_10MS_TOTAL,
+          METRIC_PIPELINE_PROCESS_LATENCY_LE_100MS_TOTAL,
+          METRIC_PIPELINE_PROCESS_LATENCY_LE_1000MS_TOTAL,
+          METRIC_PIPELINE_PROCESS_LATENCY_LE_10000MS_TOTAL}},
+        {METRIC_PIPELINE_BATCH_LATENCY_MS,
+         {METRIC_PIPELINE_BATCH_LATENCY_LE_10MS_TOTAL,
+          METRIC_PIPELINE_BATCH_LATENCY_LE_100MS_TOTAL,
+          METRIC_PIPELINE_BATCH_LATENCY_LE_1000MS_TOTAL,
+          METRIC_PIPELINE_BATCH_LATENCY_LE_10000MS_TOTAL}},
+        {METRIC_PIPELINE_SENDER_QUEUE_LATENCY_MS,
+         {METRIC_PIPELINE_SENDER_QUEUE_LATENCY_LE_10MS_TOTAL,
+          METRIC_PIPELINE_SENDER_QUEUE_LATENCY_LE_100MS_TOTAL,
+          METRIC_PIPELINE_SENDER_QUEUE_LATENCY_LE_1000MS_TOTAL,
+          METRIC_PIPELINE_SENDER_QUEUE_LATENCY_LE_10000MS_TOTAL}},
+        {METRIC_PIPELINE_END_TO_END_LATENCY_MS,
+         {METRIC_PIPELINE_END_TO_END_LATENCY_LE_10MS_TOTAL,
+          METRIC_PIPELINE_END_TO_END_LATENCY_LE_100MS_TOTAL,
+          METRIC_PIPELINE_END_TO_END_LATENCY_LE_1000MS_TOTAL,
+          METRIC_PIPELINE_END_TO_END_LATENCY_LE_10000MS_TOTAL}},
+    };
+    return sNames;
+}
+
 void AddExtendedGlobalParamToGoPipeline(const Json::Value& extendedParams, Json::Value& pipeline) {
     if (!pipeline.isNull()) {
         Json::Value& global = pipeline["global"];
@@ -371,6 +414,22 @@ bool CollectionPipeline::Init(CollectionConfig&& config) {
     mFlushersInEventsTotal = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_FLUSHERS_IN_EVENTS_TOTAL);
     mFlushersInSizeBytes = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_FLUSHERS_IN_SIZE_BYTES);
     mFlushersTotalPackageTimeMs = mMetricsRecordRef.CreateTimeCounter(METRIC_PIPELINE_FLUSHERS_TOTAL_PACKAGE_TIME_MS);
+    // not exported where it cannot be measured, instead of being always 0
+    if (IsThreadCpuTimeSupported()) {
+        mCpuTimeMs = mMetricsRecordRef.CreateTimeCounter(METRIC_PIPELINE_CPU_TIME_MS);
+    }
+    mAllocatedSizeBytes = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_ALLOCATED_SIZE_BYTES);
+    if (INT32_FLAG(event_group_trace_sample_interval) > 0) {
+        mTracedGroupsTotal = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_TRACED_EVENT_GROUPS_TOTAL);
+        const auto& names = GetStageLatencyMetricNames();
+        mStageLatencies.resize(EventGroupTrace::kStageCnt + 1);
+        for (size_t i = 0; i < mStageLatencies.size(); ++i) {
+            mStageLatencies[i].mTotalMs = mMetricsRecordRef.CreateTimeCounter(names[i].first);
+            for (const auto& bucket : names[i].second) {
+                mStageLatencies[i].mBuckets.emplace_back(mMetricsRecordRef.CreateCounter(bucket));
+            }
+        }
+    }
     WriteMetrics::GetInstance()->CommitMetricsRecordRef(mMetricsRecordRef);
 
     return true;
@@ -403,6 +462,7 @@ void CollectionPipeline::Start() {
 }
 
 void CollectionPipeline::Process(vector<PipelineEventGroup>& logGroupList, size_t inputIndex) {
+    PipelineResourceUsageGuard guard(*this);
     for (const auto& logGroup : logGroupList) {
         ADD_COUNTER(mProcessorsInEventsTotal, logGroup.GetEvents().size());
         ADD_COUNTER(mProcessorsInSizeBytes, logGroup.DataSize());
@@ -437,6 +497,8 @@ void CollectionPipeline::Process(vector<PipelineEventGroup>& logGroupList, size_
 }
 
 bool CollectionPipeline::Send(vector<PipelineEventGroup>&& groupList) {
+    // serialization and compression are done in flushers, except for those flushed on timeout
+    PipelineResourceUsageGuard guard(*this);
     for (const auto& group : groupList) {
         ADD_COUNTER(mFlushersInEventsTotal, group.GetEvents().size());
         ADD_COUNTER(mFlushersInSizeBytes, group.DataSize());
@@ -465,7 +527,38 @@ bool CollectionPipeline::Send(vector<PipelineEventGroup>&& groupList) {
     return allSucceeded;
 }
 
+void CollectionPipeline::AddResourceUsage(chrono::nanoseconds cpuTime, uint64_t allocatedBytes) const {
+    ADD_COUNTER(mCpuTimeMs, cpuTime);
+    ADD_COUNTER(mAllocatedSizeBytes, allocatedBytes);
+    mTotalCpuTimeNs.fetch_add(cpuTime.count(), memory_order_relaxed);
+    mTotalAllocatedBytes.fetch_add(allocatedBytes, memory_order_relaxed);
+}
+
+void CollectionPipeline::RecordLatencyTrace(const EventGroupTrace& trace) {
+    if (mStageLatencies.empty()) {
+        return;
+    }
+    ADD_COUNTER(mTracedGroupsTotal, 1);
+    for (size_t i = 0; i < mStageLatencies.size(); ++i) {
+        chrono::nanoseconds latency;
+        bool valid = i < EventGroupTrace::kStageCnt ? trace.GetStageLatency(i, latency)
+                                                    : trace.GetTotalLatency(latency);
+        if (!valid) {
+            continue;
+        }
+        auto& metrics = mStageLatencies[i];
+        ADD_COUNTER(metrics.mTotalMs, latency);
+        auto latencyMs = chrono::duration_cast<chrono::milliseconds>(latency).count();
+        for (size_t j = 0; j < sTraceLatencyBucketsMs.size(); ++j) {
+            if (latencyMs <= sTraceLatencyBucketsMs[j]) {
+                ADD_COUNTER(metrics.mBuckets[j], 1);
+            }
+        }
+    }
+}
+
 bool CollectionPipeline::FlushBatch() {
+    PipelineResourceUsageGuard guard(*this);
     bool allSucceeded = true;
     for (auto& flusher : mFlushers) {
         allSucceeded = flusher->FlushAll() && allSucceeded;
@@ -662,4 +755,15 @@ void CollectionPipeline::WaitAllItemsInProcessFinished() {
     }
 }
 
+PipelineResourceUsageGuard::PipelineResourceUsageGuard(const CollectionPipeline& pipeline)
+    : mPipeline(pipeline),
+      mCpuTimeNs(GetCurrentThreadCpuTimeInNanoSeconds()),
+      mAllocatedBytes(MemoryBudget::GetThreadAllocatedBytes()) {
+}
+
+PipelineResourceUsageGuard::~PipelineResourceUsageGuard() {
+    mPipeline.AddResourceUsage(chrono::nanoseconds(GetCurrentThreadCpuTimeInNanoSeconds() - mCpuTimeNs),
+                               MemoryBudget::GetThreadAllocatedBytes() - mAllocatedBytes);
+}
+
 } // namespace logtail
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <optional>
 #include <string>
@@ -50,6 +51,13 @@ public:
     bool Send(std::vector<PipelineEventGroup>&& groupList);
     bool FlushBatch();
     void RemoveProcessQueue() const;
+    // called by flushers when sampled data is acknowledged by the destination
+    void RecordLatencyTrace(const EventGroupTrace& trace);
+    // see PipelineResourceUsageGuard
+    void AddResourceUsage(std::chrono::nanoseconds cpuTime, uint64_t allocatedBytes) const;
+    // accumulated since the pipeline is created, e.g., for per-pipeline quotas
+    std::chrono::nanoseconds GetTotalCpuTime() const { return std::chrono::nanoseconds(mTotalCpuTimeNs.load()); }
+    uint64_t GetTotalAllocatedBytes() const { return mTotalAllocatedBytes.load(); }
     // Should add before or when item pop from ProcessorQueue, must be called in the lock of ProcessorQueue
     void AddInProcessCnt() { mInProcessCnt.fetch_add(1); }
     // Should sub when or after item push to SenderQueue
@@ -122,6 +130,17 @@ private:
     CounterPtr mFlushersInEventsTotal;
     CounterPtr mFlushersInSizeBytes;
     TimeCounterPtr mFlushersTotalPackageTimeMs;
+    TimeCounterPtr mCpuTimeMs;
+    CounterPtr mAllocatedSizeBytes;
+    mutable std::atomic_uint64_t mTotalCpuTimeNs = 0;
+    mutable std::atomic_uint64_t mTotalAllocatedBytes = 0;
+    // only created when event group tracing is enabled, the last element is for end-to-end latency
+    struct StageLatencyMetrics {
+        TimeCounterPtr mTotalMs;
+        std::vector<CounterPtr> mBuckets; // cumulative, see sTraceLatencyBucketsMs
+    };
+    CounterPtr mTracedGroupsTotal;
+    std::vector<StageLatencyMetrics> mStageLatencies;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class PipelineMock;
@@ -144,4 +163,20 @@ private:
 #endif
 };
 
+// Accounts the CPU time consumed and the data allocated by the calling thread during its lifetime to the pipeline.
+// Allocations are counted by MemoryBudget, i.e., source buffers and serialized data.
+class PipelineResourceUsageGuard {
+public:
+    explicit PipelineResourceUsageGuard(const CollectionPipeline& pipeline);
+    ~PipelineResourceUsageGuard();
+
+    PipelineResourceUsageGuard(const PipelineResourceUsageGuard&) = delete;
+    PipelineResourceUsageGuard& operator=(const PipelineResourceUsageGuard&) = delete;
+
+private:
+    const CollectionPipeline& mPipeline;
+    uint64_t mCpuTimeNs = 0;
+    uint64_t mAllocatedBytes = 0;
+};
+
 } // namespace logtail
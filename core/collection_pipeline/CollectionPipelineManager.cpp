@@ -21,6 +21,7 @@
 #include <shared_mutex>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "common/http/AsynCurlRunner.h"
 #include "common/timer/Timer.h"
@@ -53,7 +54,15 @@ void logtail::CollectionPipelineManager::UpdatePipelines(CollectionConfigDiff& d
 #endif
 #endif
     if (isFileServerStarted && isFileServerInputChanged) {
-        FileServer::GetInstance()->Pause();
+        // handlers and readers of unchanged configs are kept
+        unordered_set<string> changedConfigNames(diff.mRemoved.begin(), diff.mRemoved.end());
+        for (const auto& config : diff.mModified) {
+            changedConfigNames.insert(config.mName);
+        }
+        for (const auto& config : diff.mAdded) {
+            changedConfigNames.insert(config.mName);
+        }
+        FileServer::GetInstance()->PauseForConfigUpdate(changedConfigNames);
     }
     // other threads only read mPipelineNameEntityMap, so we don't need to lock read here
     for (const auto& name : diff.mRemoved) {
@@ -149,7 +158,7 @@ void logtail::CollectionPipelineManager::UpdatePipelines(CollectionConfigDiff& d
 
     if (isFileServerInputChanged) {
         if (isFileServerStarted) {
-            FileServer::GetInstance()->Resume(true, false);
+            FileServer::GetInstance()->ResumeForConfigUpdate();
         } else {
             FileServer::GetInstance()->Start();
             isFileServerStarted = true;
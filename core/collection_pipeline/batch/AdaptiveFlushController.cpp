@@ -0,0 +1,107 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "collection_pipeline/batch/AdaptiveFlushController.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "logger/Logger.h"
+
+using namespace std;
+
+namespace logtail {
+
+// weight of the latest period in the smoothed inflow rate and send latency
+static constexpr double kSmoothingFactor = 0.5;
+// requests are sized for twice the inflow, so that bursts do not saturate the sender at once
+static constexpr double kHeadroom = 2.0;
+static constexpr double kIncreaseRatio = 2.0;
+static constexpr double kDecreaseRatio = 0.75;
+
+AdaptiveFlushController::AdaptiveFlushController(const AdaptiveFlushOptions& options)
+    : mOptions(options),
+      mMinSizeBytes(options.mMinSizeBytesUpperBound),
+      mTimeoutSecs(options.mTimeoutSecsUpperBound) {
+}
+
+void AdaptiveFlushController::OnSendDone(chrono::milliseconds latency, uint32_t concurrency, bool saturated) {
+    lock_guard<mutex> lock(mFeedbackMux);
+    ++mSendCnt;
+    mTotalSendLatencyMs += latency.count();
+    mLastConcurrency = concurrency;
+    mSaturated = mSaturated || saturated;
+}
+
+bool AdaptiveFlushController::Adjust(chrono::steady_clock::time_point now) {
+    if (mLastAdjustTime == chrono::steady_clock::time_point()) {
+        mLastAdjustTime = now;
+        return false;
+    }
+    double elapsedSec = chrono::duration<double>(now - mLastAdjustTime).count();
+    if (elapsedSec < sAdjustIntervalSecs) {
+        return false;
+    }
+    mInflowRate += kSmoothingFactor * (mInBytes / elapsedSec - mInflowRate);
+    mInBytes = 0;
+    mLastAdjustTime = now;
+
+    bool saturated = false;
+    {
+        lock_guard<mutex> lock(mFeedbackMux);
+        if (mSendCnt > 0) {
+            double latencyMs = mTotalSendLatencyMs / mSendCnt;
+            if (mSendLatencyMs == 0.0) {
+                mSendLatencyMs = latencyMs;
+            } else {
+                mSendLatencyMs += kSmoothingFactor * (latencyMs - mSendLatencyMs);
+            }
+            mConcurrency = max(mLastConcurrency, 1U);
+            mIsFeedbackReceived = true;
+        }
+        saturated = mSaturated;
+        mSendCnt = 0;
+        mTotalSendLatencyMs = 0.0;
+        mSaturated = false;
+    }
+    if (!mIsFeedbackReceived) {
+        // the sender is unknown, e.g., the flusher does not report sends at all, so the configured thresholds are kept
+        return false;
+    }
+
+    double requiredSize = mInflowRate * mSendLatencyMs / 1000 / mConcurrency * kHeadroom;
+    double size = max(requiredSize, mMinSizeBytes * (saturated ? kIncreaseRatio : kDecreaseRatio));
+    size = min(max(size, static_cast<double>(mOptions.mMinSizeBytesLowerBound)),
+               static_cast<double>(mOptions.mMinSizeBytesUpperBound));
+    double fillSecs = mInflowRate > 0.0 ? (saturated ? size : requiredSize) / mInflowRate : 0.0;
+    fillSecs = min(max(ceil(fillSecs), static_cast<double>(mOptions.mTimeoutSecsLowerBound)),
+                   static_cast<double>(mOptions.mTimeoutSecsUpperBound));
+
+    auto minSizeBytes = static_cast<uint32_t>(size);
+    auto timeoutSecs = static_cast<uint32_t>(fillSecs);
+    if (minSizeBytes == mMinSizeBytes && timeoutSecs == mTimeoutSecs) {
+        return false;
+    }
+    LOG_DEBUG(sLogger,
+              ("batch thresholds adjusted, inflow rate", mInflowRate)("send latency ms", mSendLatencyMs)(
+                  "concurrency", mConcurrency)("saturated", saturated)("min size bytes", minSizeBytes)("timeout secs",
+                                                                                                       timeoutSecs));
+    mMinSizeBytes = minSizeBytes;
+    mTimeoutSecs = timeoutSecs;
+    return true;
+}
+
+} // namespace logtail
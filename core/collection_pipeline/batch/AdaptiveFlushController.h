@@ -0,0 +1,86 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+#include <mutex>
+
+namespace logtail {
+
+struct AdaptiveFlushOptions {
+    uint32_t mMinSizeBytesLowerBound = 0;
+    uint32_t mMinSizeBytesUpperBound = 0;
+    uint32_t mTimeoutSecsLowerBound = 0;
+    uint32_t mTimeoutSecsUpperBound = 0;
+};
+
+// Tunes the size and timeout thresholds of a batcher from its inflow rate and the feedback of the sender, within the
+// configured bounds.
+//
+// To keep up with the inflow, each request should carry at least inflow rate * send latency / concurrency bytes. While
+// the sender has free concurrency, batches are not made larger than that, so that quiet pipelines are flushed quickly.
+// Once the sender is saturated, the size is doubled in each period to cut the overhead of requests, and it decays
+// slowly after the pressure is gone. The timeout is the time needed to fill a batch of the required size at the
+// current inflow rate. The thresholds stay at the upper bounds until the first feedback of the sender, since a flusher
+// which never reports sends would otherwise be left with the lower bounds.
+class AdaptiveFlushController {
+public:
+    static constexpr double sAdjustIntervalSecs = 1.0;
+
+    explicit AdaptiveFlushController(const AdaptiveFlushOptions& options);
+
+    // should be called under the lock of the batcher
+    void OnAdd(size_t dataSize) { mInBytes += dataSize; }
+    // can be called by any thread, @saturated means that the in-sending requests have reached the concurrency limit
+    void OnSendDone(std::chrono::milliseconds latency, uint32_t concurrency, bool saturated);
+    // recomputes the thresholds once a period, returns true if they are changed
+    bool Adjust(std::chrono::steady_clock::time_point now);
+
+    uint32_t GetMinSizeBytes() const { return mMinSizeBytes; }
+    uint32_t GetTimeoutSecs() const { return mTimeoutSecs; }
+    double GetInflowRate() const { return mInflowRate; }
+    double GetSendLatencyMs() const { return mSendLatencyMs; }
+
+private:
+    const AdaptiveFlushOptions mOptions;
+
+    uint32_t mMinSizeBytes = 0;
+    uint32_t mTimeoutSecs = 0;
+
+    std::chrono::steady_clock::time_point mLastAdjustTime;
+    size_t mInBytes = 0;
+    // bytes per second
+    double mInflowRate = 0.0;
+    double mSendLatencyMs = 0.0;
+    uint32_t mConcurrency = 1;
+    bool mIsFeedbackReceived = false;
+
+    std::mutex mFeedbackMux;
+    uint32_t mSendCnt = 0;
+    double mTotalSendLatencyMs = 0.0;
+    uint32_t mLastConcurrency = 0;
+    bool mSaturated = false;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class AdaptiveFlushControllerUnittest;
+#endif
+};
+
+} // namespace logtail
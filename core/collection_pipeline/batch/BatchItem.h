@@ -63,7 +63,7 @@ public:
     size_t DataSize() const { return mStatus.GetSize(); }
     int64_t TotalEnqueTimeMs() const { return mTotalEnqueTimeMs; }
 
-    bool IsEmpty() { return mGroups.empty(); }
+    bool IsEmpty() const { return mGroups.empty(); }
 
 private:
     void Clear() {
@@ -149,6 +149,13 @@ public:
         AddSourceBuffer(sourceBuffer);
     }
 
+    // the trace is moved so that a group split into several batches is only traced once
+    void AddTrace(EventGroupTracePtr& trace) {
+        if (trace && !mBatch.mTrace) {
+            mBatch.mTrace = std::move(trace);
+        }
+    }
+
     void AddSourceBuffer(const std::shared_ptr<SourceBuffer>& sourceBuffer) {
         if (mSourceBuffers.find(sourceBuffer.get()) == mSourceBuffers.end()) {
             mSourceBuffers.insert(sourceBuffer.get());
@@ -158,7 +165,7 @@ public:
 
     T& GetStatus() { return mStatus; }
 
-    bool IsEmpty() { return mBatch.mEvents.empty(); }
+    bool IsEmpty() const { return mBatch.mEvents.empty(); }
 
     size_t DataSize() const { return sizeof(decltype(mBatch.mEvents)) + mStatus.GetSize() + mBatch.mTags.DataSize(); }
     size_t EventSize() const { return mBatch.mEvents.size(); }
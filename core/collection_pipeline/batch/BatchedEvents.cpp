@@ -78,11 +78,13 @@ BatchedEvents::BatchedEvents(EventsContainer&& events,
                              SizedMap&& tags,
                              std::shared_ptr<SourceBuffer>&& sourceBuffer,
                              StringView packIdPrefix,
-                             RangeCheckpointPtr&& eoo)
+                             RangeCheckpointPtr&& eoo,
+                             EventGroupTracePtr&& trace)
     : mEvents(std::move(events)),
       mTags(std::move(tags)),
       mExactlyOnceCheckpoint(std::move(eoo)),
-      mPackIdPrefix(packIdPrefix) {
+      mPackIdPrefix(packIdPrefix),
+      mTrace(std::move(trace)) {
     mSourceBuffers.emplace_back(std::move(sourceBuffer));
     mSizeBytes = sizeof(decltype(mEvents)) + mTags.DataSize();
     for (const auto& item : mEvents) {
@@ -97,6 +99,7 @@ void BatchedEvents::Clear() {
     mSizeBytes = 0;
     mExactlyOnceCheckpoint.reset();
     mPackIdPrefix = StringView();
+    mTrace.reset();
 }
 
 } // namespace logtail
@@ -32,6 +32,8 @@ struct BatchedEvents {
     // for flusher_sls only
     RangeCheckpointPtr mExactlyOnceCheckpoint;
     StringView mPackIdPrefix;
+    // only the first sampled group added to the batch is kept
+    EventGroupTracePtr mTrace;
 
     BatchedEvents() = default;
     ~BatchedEvents();
@@ -41,7 +43,8 @@ struct BatchedEvents {
           mSourceBuffers(std::move(other.mSourceBuffers)),
           mSizeBytes(other.mSizeBytes),
           mExactlyOnceCheckpoint(std::move(other.mExactlyOnceCheckpoint)),
-          mPackIdPrefix(other.mPackIdPrefix) {}
+          mPackIdPrefix(other.mPackIdPrefix),
+          mTrace(std::move(other.mTrace)) {}
     BatchedEvents& operator=(BatchedEvents&&) noexcept = default;
 
     // for flusher_sls only
@@ -49,7 +52,8 @@ struct BatchedEvents {
                   SizedMap&& tags,
                   std::shared_ptr<SourceBuffer>&& sourceBuffer,
                   StringView packIdPrefix,
-                  RangeCheckpointPtr&& eoo);
+                  RangeCheckpointPtr&& eoo,
+                  EventGroupTracePtr&& trace = nullptr);
 
     void Clear();
 };
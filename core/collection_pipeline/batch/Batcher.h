@@ -18,7 +18,9 @@
 
 #include <cstdint>
 
+#include <chrono>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <vector>
@@ -26,12 +28,14 @@
 #include "json/json.h"
 
 #include "collection_pipeline/CollectionPipelineContext.h"
+#include "collection_pipeline/batch/AdaptiveFlushController.h"
 #include "collection_pipeline/batch/BatchItem.h"
 #include "collection_pipeline/batch/BatchStatus.h"
 #include "collection_pipeline/batch/FlushStrategy.h"
 #include "collection_pipeline/batch/TimeoutFlushManager.h"
 #include "common/Flags.h"
 #include "common/ParamExtractor.h"
+#include "common/memory/MemoryBudget.h"
 #include "models/PipelineEventGroup.h"
 #include "monitor/MetricManager.h"
 #include "monitor/metric_constants/MetricConstants.h"
@@ -87,6 +91,70 @@ public:
                                   ctx.GetRegion());
         }
 
+        bool enableAdaptive = false;
+        if (!GetOptionalBoolParam(config, "EnableAdaptive", enableAdaptive, errorMsg)) {
+            PARAM_WARNING_DEFAULT(ctx.GetLogger(),
+                                  ctx.GetAlarm(),
+                                  errorMsg,
+                                  enableAdaptive,
+                                  flusher->Name(),
+                                  ctx.GetConfigName(),
+                                  ctx.GetProjectName(),
+                                  ctx.GetLogstoreName(),
+                                  ctx.GetRegion());
+        }
+        if (enableAdaptive) {
+            // the configured thresholds are used as the upper bounds by default, and are kept until the flusher reports
+            // the first send via OnSendDone, so that enabling it for a flusher not reporting sends changes nothing
+            AdaptiveFlushOptions options;
+            options.mMinSizeBytesUpperBound = std::min(minSizeBytes, strategy.mMaxSizeBytes);
+            if (!GetOptionalUIntParam(config, "MinSizeBytesUpperBound", options.mMinSizeBytesUpperBound, errorMsg)
+                || options.mMinSizeBytesUpperBound > strategy.mMaxSizeBytes) {
+                options.mMinSizeBytesUpperBound = std::min(minSizeBytes, strategy.mMaxSizeBytes);
+                PARAM_WARNING_DEFAULT(ctx.GetLogger(),
+                                      ctx.GetAlarm(),
+                                      "param MinSizeBytesUpperBound is not valid",
+                                      options.mMinSizeBytesUpperBound,
+                                      flusher->Name(),
+                                      ctx.GetConfigName(),
+                                      ctx.GetProjectName(),
+                                      ctx.GetLogstoreName(),
+                                      ctx.GetRegion());
+            }
+            options.mMinSizeBytesLowerBound = options.mMinSizeBytesUpperBound / 16;
+            if (!GetOptionalUIntParam(config, "MinSizeBytesLowerBound", options.mMinSizeBytesLowerBound, errorMsg)
+                || options.mMinSizeBytesLowerBound > options.mMinSizeBytesUpperBound) {
+                options.mMinSizeBytesLowerBound = options.mMinSizeBytesUpperBound / 16;
+                PARAM_WARNING_DEFAULT(ctx.GetLogger(),
+                                      ctx.GetAlarm(),
+                                      "param MinSizeBytesLowerBound is not valid",
+                                      options.mMinSizeBytesLowerBound,
+                                      flusher->Name(),
+                                      ctx.GetConfigName(),
+                                      ctx.GetProjectName(),
+                                      ctx.GetLogstoreName(),
+                                      ctx.GetRegion());
+            }
+            options.mTimeoutSecsUpperBound = timeoutSecs;
+            options.mTimeoutSecsLowerBound = std::min(1U, timeoutSecs);
+            if (!GetOptionalUIntParam(config, "TimeoutSecsLowerBound", options.mTimeoutSecsLowerBound, errorMsg)
+                || options.mTimeoutSecsLowerBound > options.mTimeoutSecsUpperBound) {
+                options.mTimeoutSecsLowerBound = std::min(1U, timeoutSecs);
+                PARAM_WARNING_DEFAULT(ctx.GetLogger(),
+                                      ctx.GetAlarm(),
+                                      "param TimeoutSecsLowerBound is not valid",
+                                      options.mTimeoutSecsLowerBound,
+                                      flusher->Name(),
+                                      ctx.GetConfigName(),
+                                      ctx.GetProjectName(),
+                                      ctx.GetLogstoreName(),
+                                      ctx.GetRegion());
+            }
+            // starts from the upper bounds, which are lowered once the inflow and the sender are observed
+            mAdaptiveFlushController = std::make_unique<AdaptiveFlushController>(options);
+            minSizeBytes = mAdaptiveFlushController->GetMinSizeBytes();
+        }
+
         if (enableGroupBatch) {
             uint32_t groupTimeout = timeoutSecs / 2;
             mGroupFlushStrategy = GroupFlushStrategy(minSizeBytes, groupTimeout);
@@ -122,7 +190,15 @@ public:
         mBufferedEventsTotal = mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_BATCHER_BUFFERED_EVENTS_TOTAL);
         mBufferedDataSizeByte = mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_BATCHER_BUFFERED_SIZE_BYTES);
         mTotalAddTimeMs = mMetricsRecordRef.CreateTimeCounter(METRIC_COMPONENT_BATCHER_TOTAL_ADD_TIME_MS);
+        mOutBatchesTotal = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_BATCHER_OUT_BATCHES_TOTAL);
+        mOutBatchSizeBytes = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_BATCHER_OUT_BATCH_SIZE_BYTES);
+        mSendLatencyMs = mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_BATCHER_SEND_LATENCY_MS);
+        mTargetBatchSizeBytes = mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_BATCHER_TARGET_BATCH_SIZE_BYTES);
+        mTargetBatchTimeoutSecs = mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_BATCHER_TARGET_BATCH_TIMEOUT_SECS);
         WriteMetrics::GetInstance()->CommitMetricsRecordRef(mMetricsRecordRef);
+        mPipelineMemoryUsageBytes = MemoryBudget::GetInstance()->GetPipelineUsage(ctx.GetConfigName());
+        SET_GAUGE(mTargetBatchSizeBytes, minSizeBytes);
+        SET_GAUGE(mTargetBatchTimeoutSecs, timeoutSecs);
 
         return true;
     }
@@ -131,6 +207,15 @@ public:
     void Add(PipelineEventGroup&& g, std::vector<BatchedEventsList>& res) {
         auto before = std::chrono::system_clock::now();
         std::lock_guard<std::mutex> lock(mMux);
+        if (g.GetTrace()) {
+            g.GetTrace()->Stamp(TraceStamp::BATCH_ADD);
+        }
+        if (mAdaptiveFlushController) {
+            mAdaptiveFlushController->OnAdd(g.DataSize());
+            if (mAdaptiveFlushController->Adjust(std::chrono::steady_clock::now())) {
+                ApplyAdaptiveThresholds();
+            }
+        }
         size_t key = g.GetTagsHash();
         EventBatchItem<T>& item = mEventQueueMap[key];
         ADD_COUNTER(mInEventsTotal, g.GetEvents().size());
@@ -147,6 +232,7 @@ public:
                 // should consider time condition here because sls require this
                 if (!item.IsEmpty() && mEventFlushStrategy.NeedFlushByTime(item.GetStatus(), e)) {
                     ADD_COUNTER(mOutEventsTotal, item.EventSize());
+                    UpdateMetricsOnFlushingBatch(item.DataSize());
                     item.Flush(res);
                 }
                 if (item.IsEmpty()) {
@@ -159,13 +245,18 @@ public:
                     }
                 }
                 item.Add(std::move(e));
+                item.AddTrace(g.GetTrace());
                 if (mEventFlushStrategy.SizeReachingUpperLimit(item.GetStatus())) {
                     ADD_COUNTER(mOutEventsTotal, item.EventSize());
+                    UpdateMetricsOnFlushingBatch(item.DataSize());
                     item.Flush(res);
                 }
             }
-            ADD_COUNTER(mOutEventsTotal, item.EventSize());
-            item.Flush(res);
+            if (!item.IsEmpty()) {
+                ADD_COUNTER(mOutEventsTotal, item.EventSize());
+                UpdateMetricsOnFlushingBatch(item.DataSize());
+                item.Flush(res);
+            }
         } else {
             size_t eventsSize = g.GetEvents().size();
             for (size_t i = 0; i < eventsSize; ++i) {
@@ -208,6 +299,7 @@ public:
                                                                      mFlusher);
                     ADD_GAUGE(mBufferedGroupsTotal, 1);
                     ADD_GAUGE(mBufferedDataSizeByte, item.DataSize());
+                    ADD_GAUGE(mPipelineMemoryUsageBytes, item.DataSize());
                 } else if (i == 0) {
                     item.AddSourceBuffer(g.GetSourceBuffer());
                     for (const auto& extraSourceBuffer : g.GetExtraSourceBuffers()) {
@@ -216,7 +308,9 @@ public:
                 }
                 ADD_GAUGE(mBufferedEventsTotal, 1);
                 ADD_GAUGE(mBufferedDataSizeByte, e->DataSize());
+                ADD_GAUGE(mPipelineMemoryUsageBytes, e->DataSize());
                 item.Add(std::move(e));
+                item.AddTrace(g.GetTrace());
                 if (mEventFlushStrategy.NeedFlushBySize(item.GetStatus())
                     || mEventFlushStrategy.NeedFlushByCnt(item.GetStatus())) {
                     UpdateMetricsOnFlushingEventQueue(item);
@@ -298,13 +392,45 @@ public:
         mEventQueueMap.clear();
     }
 
+    // should be called when a batch is sent, so that the thresholds can be adapted to the sender
+    void OnSendDone(std::chrono::milliseconds latency, uint32_t concurrency, bool saturated) {
+        SET_GAUGE(mSendLatencyMs, latency.count());
+        if (mAdaptiveFlushController) {
+            mAdaptiveFlushController->OnSendDone(latency, concurrency, saturated);
+        }
+    }
+
 #ifdef APSARA_UNIT_TEST_MAIN
     EventFlushStrategy<T>& GetEventFlushStrategy() { return mEventFlushStrategy; }
     std::optional<GroupFlushStrategy>& GetGroupFlushStrategy() { return mGroupFlushStrategy; }
 #endif
 
 private:
+    void ApplyAdaptiveThresholds() {
+        uint32_t minSizeBytes = mAdaptiveFlushController->GetMinSizeBytes();
+        uint32_t timeoutSecs = mAdaptiveFlushController->GetTimeoutSecs();
+        if (mGroupQueue) {
+            uint32_t groupTimeout = timeoutSecs / 2;
+            mGroupFlushStrategy->SetMinSizeBytes(minSizeBytes);
+            mGroupFlushStrategy->SetTimeoutSecs(groupTimeout);
+            mEventFlushStrategy.SetTimeoutSecs(timeoutSecs - groupTimeout);
+        } else {
+            mEventFlushStrategy.SetTimeoutSecs(timeoutSecs);
+        }
+        mEventFlushStrategy.SetMinSizeBytes(minSizeBytes);
+        SET_GAUGE(mTargetBatchSizeBytes, minSizeBytes);
+        SET_GAUGE(mTargetBatchTimeoutSecs, timeoutSecs);
+    }
+
+    void UpdateMetricsOnFlushingBatch(size_t dataSize) {
+        ADD_COUNTER(mOutBatchesTotal, 1);
+        ADD_COUNTER(mOutBatchSizeBytes, dataSize);
+    }
+
     void UpdateMetricsOnFlushingEventQueue(const EventBatchItem<T>& item) {
+        if (!item.IsEmpty()) {
+            UpdateMetricsOnFlushingBatch(item.DataSize());
+        }
         ADD_COUNTER(mOutEventsTotal, item.EventSize());
         // ADD_COUNTER(mTotalDelayMs,
         //             item.EventSize()
@@ -315,9 +441,13 @@ private:
         SUB_GAUGE(mBufferedGroupsTotal, 1);
         SUB_GAUGE(mBufferedEventsTotal, item.EventSize());
         SUB_GAUGE(mBufferedDataSizeByte, item.DataSize());
+        SUB_GAUGE(mPipelineMemoryUsageBytes, item.DataSize());
     }
 
     void UpdateMetricsOnFlushingGroupQueue() {
+        if (!mGroupQueue->IsEmpty()) {
+            UpdateMetricsOnFlushingBatch(mGroupQueue->DataSize());
+        }
         ADD_COUNTER(mOutEventsTotal, mGroupQueue->EventSize());
         // ADD_COUNTER(mTotalDelayMs,
         //             mGroupQueue->EventSize()
@@ -328,6 +458,7 @@ private:
         SUB_GAUGE(mBufferedGroupsTotal, mGroupQueue->GroupSize());
         SUB_GAUGE(mBufferedEventsTotal, mGroupQueue->EventSize());
         SUB_GAUGE(mBufferedDataSizeByte, mGroupQueue->DataSize());
+        SUB_GAUGE(mPipelineMemoryUsageBytes, mGroupQueue->DataSize());
     }
 
     std::mutex mMux;
@@ -336,6 +467,7 @@ private:
 
     std::optional<GroupBatchItem> mGroupQueue;
     std::optional<GroupFlushStrategy> mGroupFlushStrategy;
+    std::unique_ptr<AdaptiveFlushController> mAdaptiveFlushController;
 
     Flusher* mFlusher = nullptr;
 
@@ -349,6 +481,12 @@ private:
     IntGaugePtr mBufferedEventsTotal;
     IntGaugePtr mBufferedDataSizeByte;
     TimeCounterPtr mTotalAddTimeMs;
+    IntGaugePtr mPipelineMemoryUsageBytes;
+    CounterPtr mOutBatchesTotal;
+    CounterPtr mOutBatchSizeBytes;
+    IntGaugePtr mSendLatencyMs;
+    IntGaugePtr mTargetBatchSizeBytes;
+    IntGaugePtr mTargetBatchTimeoutSecs;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class BatcherUnittest;
@@ -14,6 +14,10 @@
 
 #include "collection_pipeline/batch/TimeoutFlushManager.h"
 
+#include <optional>
+
+#include "collection_pipeline/CollectionPipeline.h"
+
 using namespace std;
 
 namespace logtail {
@@ -51,6 +55,11 @@ void TimeoutFlushManager::FlushTimeoutBatch() {
         lock_guard<mutex> lock(mDeletedFlushersMux);
         for (auto& item : records) {
             if (mDeletedFlushers.find(make_pair(item.first, item.second.first)) == mDeletedFlushers.end()) {
+                auto& ctx = item.second.first->GetContext();
+                optional<PipelineResourceUsageGuard> guard;
+                if (ctx.HasValidPipeline()) {
+                    guard.emplace(ctx.GetPipeline());
+                }
                 item.second.first->Flush(item.second.second);
             }
         }
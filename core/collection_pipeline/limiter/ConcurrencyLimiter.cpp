@@ -21,11 +21,6 @@ using namespace std;
 
 namespace logtail {
 #ifdef APSARA_UNIT_TEST_MAIN
-uint32_t ConcurrencyLimiter::GetCurrentLimit() const {
-    lock_guard<mutex> lock(mLimiterMux);
-    return mCurrenctConcurrency;
-}
-
 void ConcurrencyLimiter::SetCurrentLimit(uint32_t limit) {
     lock_guard<mutex> lock(mLimiterMux);
     mCurrenctConcurrency = limit;
@@ -34,9 +29,6 @@ void ConcurrencyLimiter::SetCurrentLimit(uint32_t limit) {
 void ConcurrencyLimiter::SetInSendingCount(uint32_t count) {
     mInSendingCnt.store(count);
 }
-uint32_t ConcurrencyLimiter::GetInSendingCount() const {
-    return mInSendingCnt.load();
-}
 
 uint32_t ConcurrencyLimiter::GetStatisticThreshold() const {
     return CONCURRENCY_STATISTIC_THRESHOLD;
@@ -68,6 +60,15 @@ void ConcurrencyLimiter::OnFail(std::chrono::system_clock::time_point currentTim
     AdjustConcurrency(false, currentTime);
 }
 
+uint32_t ConcurrencyLimiter::GetCurrentLimit() const {
+    lock_guard<mutex> lock(mLimiterMux);
+    return mCurrenctConcurrency;
+}
+
+uint32_t ConcurrencyLimiter::GetInSendingCount() const {
+    return mInSendingCnt.load();
+}
+
 void ConcurrencyLimiter::Increase() {
     lock_guard<mutex> lock(mLimiterMux);
     if (mCurrenctConcurrency != mMaxConcurrency) {
@@ -48,6 +48,9 @@ public:
     void OnSuccess(std::chrono::system_clock::time_point currentTime);
     void OnFail(std::chrono::system_clock::time_point currentTime);
 
+    uint32_t GetCurrentLimit() const;
+    uint32_t GetInSendingCount() const;
+
 
     static std::string GetLimiterMetricName(const std::string& limiter) {
         if (limiter == "region") {
@@ -62,10 +65,8 @@ public:
 
 #ifdef APSARA_UNIT_TEST_MAIN
 
-    uint32_t GetCurrentLimit() const;
     void SetCurrentLimit(uint32_t limit);
     void SetInSendingCount(uint32_t count);
-    uint32_t GetInSendingCount() const;
     uint32_t GetStatisticThreshold() const;
 
 #endif
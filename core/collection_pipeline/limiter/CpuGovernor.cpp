@@ -0,0 +1,149 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "collection_pipeline/limiter/CpuGovernor.h"
+
+#include <algorithm>
+
+#include "common/TimeUtil.h"
+#include "logger/Logger.h"
+
+using namespace std;
+
+namespace logtail {
+
+// fraction of the error corrected in each period
+static constexpr double kGain = 0.5;
+// governed threads always get a small share, so that data keeps flowing when ungoverned threads are busy
+static constexpr double kMinRateRatio = 0.05;
+// CPU time a bucket can accumulate while idle, in seconds
+static constexpr double kBurstSec = 0.1;
+
+static thread_local int64_t sLastThreadCpuTimeUs = -1;
+
+static uint32_t GetPriorityWeight(uint32_t priority) {
+    return 1U << (CpuGovernor::sMaxPriority - priority);
+}
+
+void CpuGovernor::Update(double cpuUsage, double cpuLimit) {
+    lock_guard<mutex> lock(mMux);
+    auto now = chrono::steady_clock::now();
+    if (cpuLimit <= 0.0) {
+        mIsEnabled = false;
+        mRate = 0.0;
+        mConsumedUs = 0;
+        mLastUpdateTime = now;
+        mCond.notify_all();
+        return;
+    }
+
+    double target = cpuLimit;
+    if (mIsEnabled) {
+        double elapsedSec = chrono::duration<double>(now - mLastUpdateTime).count();
+        if (elapsedSec > 0.0) {
+            double governedUsage = mConsumedUs / 1000000.0 / elapsedSec;
+            target = cpuLimit - max(cpuUsage - governedUsage, 0.0);
+        }
+        mRate += kGain * (target - mRate);
+    } else {
+        mRate = target;
+    }
+    mRate = min(max(mRate, cpuLimit * kMinRateRatio), cpuLimit);
+    mConsumedUs = 0;
+    mLastUpdateTime = now;
+
+    uint32_t activeWeight = 0;
+    for (uint32_t i = 0; i <= sMaxPriority; ++i) {
+        if (mBuckets[i].mIsActive) {
+            activeWeight += GetPriorityWeight(i);
+        }
+    }
+    for (uint32_t i = 0; i <= sMaxPriority; ++i) {
+        auto& bucket = mBuckets[i];
+        if (mIsEnabled) {
+            Refill(bucket, now);
+        } else {
+            bucket.mTokensUs = 0.0;
+            bucket.mLastRefillTime = now;
+        }
+        // an idle priority gets the share it would have if it became active
+        auto weight = GetPriorityWeight(i);
+        bucket.mRate = mRate * weight / (bucket.mIsActive ? activeWeight : activeWeight + weight);
+        bucket.mIsActive = false;
+    }
+    mIsEnabled = true;
+    mCond.notify_all();
+    LOG_DEBUG(sLogger,
+              ("cpu governor updated, cpu usage", cpuUsage)("cpu limit", cpuLimit)("target rate", target)("rate",
+                                                                                                         mRate));
+}
+
+void CpuGovernor::Charge(uint32_t priority) {
+    if (!IsEnabled()) {
+        sLastThreadCpuTimeUs = -1;
+        return;
+    }
+    auto cpuTimeUs = static_cast<int64_t>(GetCurrentThreadCpuTimeInNanoSeconds() / 1000);
+    int64_t consumedUs = sLastThreadCpuTimeUs < 0 ? 0 : cpuTimeUs - sLastThreadCpuTimeUs;
+    sLastThreadCpuTimeUs = cpuTimeUs;
+    Consume(min(priority, sMaxPriority), consumedUs);
+}
+
+bool CpuGovernor::Acquire(uint32_t priority, uint32_t maxWaitMs) {
+    Charge(priority);
+    if (!IsEnabled()) {
+        return true;
+    }
+    auto& bucket = mBuckets[min(priority, sMaxPriority)];
+    auto deadline = chrono::steady_clock::now() + chrono::milliseconds(maxWaitMs);
+    unique_lock<mutex> lock(mMux);
+    while (mIsEnabled) {
+        auto now = chrono::steady_clock::now();
+        Refill(bucket, now);
+        if (bucket.mTokensUs >= 0.0) {
+            return true;
+        }
+        if (now >= deadline) {
+            return false;
+        }
+        // the rate may be changed by the monitor meanwhile
+        auto waitTime = chrono::microseconds(static_cast<int64_t>(-bucket.mTokensUs / bucket.mRate) + 1);
+        mCond.wait_until(lock, min(deadline, now + waitTime));
+    }
+    return true;
+}
+
+double CpuGovernor::GetRate() const {
+    lock_guard<mutex> lock(mMux);
+    return mRate;
+}
+
+void CpuGovernor::Consume(uint32_t priority, int64_t cpuTimeUs) {
+    lock_guard<mutex> lock(mMux);
+    auto& bucket = mBuckets[priority];
+    Refill(bucket, chrono::steady_clock::now());
+    bucket.mTokensUs -= cpuTimeUs;
+    bucket.mIsActive = true;
+    mConsumedUs += cpuTimeUs;
+}
+
+void CpuGovernor::Refill(Bucket& bucket, chrono::steady_clock::time_point now) {
+    if (now > bucket.mLastRefillTime) {
+        double elapsedUs = chrono::duration<double, micro>(now - bucket.mLastRefillTime).count();
+        bucket.mTokensUs = min(bucket.mTokensUs + elapsedUs * bucket.mRate, bucket.mRate * kBurstSec * 1000000);
+        bucket.mLastRefillTime = now;
+    }
+}
+
+} // namespace logtail
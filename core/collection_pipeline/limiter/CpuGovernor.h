@@ -0,0 +1,91 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace logtail {
+
+// Keeps the CPU usage of the agent under the CPU limit by handing out CPU time to runner threads.
+//
+// Each governed thread reports the CPU time it has consumed, measured by its thread CPU clock, to the token bucket of
+// the pipeline priority it works for, and waits while the bucket is overdrawn. Buckets are refilled at a total rate,
+// in cores, which is split among the priorities active in the last period, with a higher priority getting a larger
+// share. Every second, the monitor feeds back the CPU usage of the whole process, and the rate is moved towards the
+// limit minus the usage of ungoverned threads in proportion to the error, so that the usage settles at the limit
+// instead of oscillating around it.
+class CpuGovernor {
+public:
+    // same as process queues, the highest priority is 0
+    static constexpr uint32_t sMaxPriority = 2;
+    // for threads shared by pipelines of all priorities, same as the default priority of pipelines
+    static constexpr uint32_t sDefaultPriority = 1;
+
+    CpuGovernor(const CpuGovernor&) = delete;
+    CpuGovernor& operator=(const CpuGovernor&) = delete;
+
+    static CpuGovernor* GetInstance() {
+        static CpuGovernor sInstance;
+        return &sInstance;
+    }
+
+    // @cpuUsage is the usage of the process in the last period, and a non-positive @cpuLimit disables the governor
+    void Update(double cpuUsage, double cpuLimit);
+
+    // charges the CPU time consumed by the calling thread since its last call, without waiting
+    void Charge(uint32_t priority);
+    // charges as Charge does, and then waits at most @maxWaitMs while the bucket is overdrawn, returns false on timeout
+    bool Acquire(uint32_t priority, uint32_t maxWaitMs = 1000);
+
+    bool IsEnabled() const { return mIsEnabled.load(std::memory_order_relaxed); }
+    double GetRate() const;
+
+private:
+    struct Bucket {
+        double mRate = 0.0;
+        double mTokensUs = 0.0;
+        std::chrono::steady_clock::time_point mLastRefillTime;
+        bool mIsActive = false;
+    };
+
+    CpuGovernor() = default;
+    ~CpuGovernor() = default;
+
+    void Consume(uint32_t priority, int64_t cpuTimeUs);
+    void Refill(Bucket& bucket, std::chrono::steady_clock::time_point now);
+
+    std::atomic_bool mIsEnabled = false;
+
+    mutable std::mutex mMux;
+    std::condition_variable mCond;
+    double mRate = 0.0;
+    int64_t mConsumedUs = 0;
+    std::chrono::steady_clock::time_point mLastUpdateTime;
+    std::array<Bucket, sMaxPriority + 1> mBuckets;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class CpuGovernorUnittest;
+#endif
+};
+
+} // namespace logtail
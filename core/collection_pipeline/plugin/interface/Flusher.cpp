@@ -94,12 +94,19 @@ bool Flusher::PushToQueue(unique_ptr<SenderQueueItem>&& item, uint32_t retryTime
 
 void Flusher::DealSenderQueueItemAfterSend(SenderQueueItem* item, bool keep) {
     if (keep) {
-        item->mStatus = SendingStatus::IDLE;
         ++item->mTryCnt;
+        SenderQueueManager::GetInstance()->SetItemIdle(item);
     } else {
         // TODO: because current profile has a dummy flusher, we have to use item->mQueueKey here
         SenderQueueManager::GetInstance()->RemoveItem(item->mQueueKey, item);
     }
 }
 
+void Flusher::RecordTraceOnSendDone(const EventGroupTracePtr& trace) {
+    if (trace && HasContext() && mContext->HasValidPipeline()) {
+        trace->Stamp(TraceStamp::SEND_DONE);
+        mContext->GetPipeline().RecordLatencyTrace(*trace);
+    }
+}
+
 } // namespace logtail
@@ -53,6 +53,8 @@ protected:
     void GenerateQueueKey(const std::string& target);
     bool PushToQueue(std::unique_ptr<SenderQueueItem>&& item, uint32_t retryTimes = 500);
     void DealSenderQueueItemAfterSend(SenderQueueItem* item, bool keep);
+    // stamps the end of a sampled trace once its data is delivered, and records the latencies to the pipeline
+    void RecordTraceOnSendDone(const EventGroupTracePtr& trace);
     void SetPipelineForItemsWhenStop();
 
     QueueKey mQueueKey;
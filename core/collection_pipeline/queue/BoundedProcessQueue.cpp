@@ -44,6 +44,7 @@ bool BoundedProcessQueue::Push(unique_ptr<ProcessQueueItem>&& item) {
     ADD_COUNTER(mInItemDataSizeBytes, size);
     SET_GAUGE(mQueueSizeTotal, Size());
     ADD_COUNTER(mQueueDataSizeByte, size);
+    ADD_GAUGE(mPipelineMemoryUsageBytes, size);
     SET_GAUGE(mValidToPushFlag, IsValidToPush());
     return true;
 }
@@ -68,6 +69,7 @@ bool BoundedProcessQueue::Pop(unique_ptr<ProcessQueueItem>& item) {
     ADD_COUNTER(mTotalDelayMs, chrono::system_clock::now() - item->mEnqueTime);
     SET_GAUGE(mQueueSizeTotal, Size());
     SUB_GAUGE(mQueueDataSizeByte, item->mEventGroup.DataSize());
+    SUB_GAUGE(mPipelineMemoryUsageBytes, item->mEventGroup.DataSize());
     SET_GAUGE(mValidToPushFlag, IsValidToPush());
     return true;
 }
@@ -54,6 +54,9 @@ protected:
         return false;
     }
 
+    // for queues accepting items beyond the high watermark, which stop doing so only when the overflow is exhausted
+    void MarkInvalidToPush() { mValidToPush = false; }
+
     void Reset(size_t low, size_t high) {
         mLowWatermark = low;
         mHighWatermark = high;
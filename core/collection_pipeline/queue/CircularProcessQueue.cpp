@@ -41,6 +41,7 @@ bool CircularProcessQueue::Push(unique_ptr<ProcessQueueItem>&& item) {
         mQueue.pop_front();
         SET_GAUGE(mQueueSizeTotal, Size());
         SUB_GAUGE(mQueueDataSizeByte, size);
+        SUB_GAUGE(mPipelineMemoryUsageBytes, size);
         ADD_COUNTER(mDiscardedEventsTotal, cnt);
     }
     if (mEventCnt + newCnt > mCapacity) {
@@ -55,6 +56,7 @@ bool CircularProcessQueue::Push(unique_ptr<ProcessQueueItem>&& item) {
     ADD_COUNTER(mInItemDataSizeBytes, size);
     SET_GAUGE(mQueueSizeTotal, Size());
     ADD_GAUGE(mQueueDataSizeByte, size);
+    ADD_GAUGE(mPipelineMemoryUsageBytes, size);
     return true;
 }
 
@@ -76,6 +78,7 @@ bool CircularProcessQueue::Pop(unique_ptr<ProcessQueueItem>& item) {
     ADD_COUNTER(mTotalDelayMs, std::chrono::system_clock::now() - item->mEnqueTime);
     SET_GAUGE(mQueueSizeTotal, Size());
     SUB_GAUGE(mQueueDataSizeByte, item->mEventGroup.DataSize());
+    SUB_GAUGE(mPipelineMemoryUsageBytes, item->mEventGroup.DataSize());
     return true;
 }
 
@@ -84,8 +87,11 @@ void CircularProcessQueue::Reset(size_t cap) {
     // framework design so we simply discard extra items, considering that it is a rare case to change capacity
     uint32_t cnt = 0;
     while (!mQueue.empty() && mEventCnt > cap) {
+        auto size = mQueue.front()->mEventGroup.DataSize();
         mEventCnt -= mQueue.front()->mEventGroup.GetEvents().size();
         mQueue.pop_front();
+        SUB_GAUGE(mQueueDataSizeByte, size);
+        SUB_GAUGE(mPipelineMemoryUsageBytes, size);
         ++cnt;
     }
     if (cnt > 0) {
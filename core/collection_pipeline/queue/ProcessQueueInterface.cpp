@@ -15,6 +15,7 @@
 #include "collection_pipeline/queue/ProcessQueueInterface.h"
 
 #include "collection_pipeline/queue/BoundedSenderQueueInterface.h"
+#include "common/memory/MemoryBudget.h"
 
 using namespace std;
 
@@ -41,6 +42,21 @@ void ProcessQueueInterface::SetDownStreamQueues(vector<BoundedSenderQueueInterfa
     }
 }
 
+bool ProcessQueueInterface::IsMemoryBudgetExceeded() const {
+    auto* budget = MemoryBudget::GetInstance();
+    if (!budget->IsExceeded()) {
+        // checked again as soon as the budget is exceeded
+        mMemoryBudgetCheckTime = chrono::steady_clock::time_point();
+        return false;
+    }
+    auto now = chrono::steady_clock::now();
+    if (now - mMemoryBudgetCheckTime >= kMemoryBudgetCheckInterval) {
+        mIsMemoryBudgetExceeded = budget->IsExceeded(mConfigName);
+        mMemoryBudgetCheckTime = now;
+    }
+    return mIsMemoryBudgetExceeded;
+}
+
 bool ProcessQueueInterface::IsValidToPop() const {
     return mValidToPop && IsDownStreamQueuesValidToPush();
 }
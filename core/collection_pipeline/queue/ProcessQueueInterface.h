@@ -18,6 +18,7 @@
 
 #include <cstdint>
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -46,6 +47,10 @@ public:
     void DisablePop() { mValidToPop = false; }
     void EnablePop() { mValidToPop = true; }
 
+    // whether inputs of the pipeline should back off on the memory budget. The result is kept for a while, since
+    // telling the pipelines apart takes the lock of the budget, while it is checked on each read of the inputs.
+    bool IsMemoryBudgetExceeded() const;
+
     void Reset() { mDownStreamQueues.clear(); }
 
 protected:
@@ -63,6 +68,10 @@ private:
     std::vector<BoundedSenderQueueInterface*> mDownStreamQueues;
     bool mValidToPop = false;
 
+    static constexpr std::chrono::milliseconds kMemoryBudgetCheckInterval{100};
+    mutable bool mIsMemoryBudgetExceeded = false;
+    mutable std::chrono::steady_clock::time_point mMemoryBudgetCheckTime;
+
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class BoundedProcessQueueUnittest;
     friend class CircularProcessQueueUnittest;
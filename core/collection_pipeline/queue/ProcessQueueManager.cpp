@@ -19,6 +19,7 @@
 #include "collection_pipeline/queue/ExactlyOnceQueueManager.h"
 #include "collection_pipeline/queue/QueueKeyManager.h"
 #include "common/Flags.h"
+#include "common/memory/MemoryBudget.h"
 
 DEFINE_FLAG_INT32(bounded_process_queue_capacity, "", 5);
 
@@ -102,16 +103,27 @@ bool ProcessQueueManager::IsValidToPush(QueueKey key) const {
     lock_guard<mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter != mQueues.end()) {
+        // inputs of pipelines buffering too much back off when data in flight reaches the memory budget, no matter how
+        // much room is left in the queue
+        if ((*iter->second.first)->IsMemoryBudgetExceeded()) {
+            return false;
+        }
         if (iter->second.second == QueueType::BOUNDED) {
             return static_cast<BoundedProcessQueue*>(iter->second.first->get())->IsValidToPush();
         } else {
             return true;
         }
     }
+    if (MemoryBudget::GetInstance()->IsExceeded()) {
+        return false;
+    }
     return ExactlyOnceQueueManager::GetInstance()->IsValidToPushProcessQueue(key);
 }
 
 QueueStatus ProcessQueueManager::PushQueue(QueueKey key, unique_ptr<ProcessQueueItem>&& item) {
+    if (item->mEventGroup.GetTrace()) {
+        item->mEventGroup.GetTrace()->Stamp(TraceStamp::PROCESS_QUEUE_PUSH);
+    }
     {
         lock_guard<mutex> lock(mQueueMux);
         auto iter = mQueues.find(key);
@@ -18,6 +18,7 @@
 
 #include "collection_pipeline/CollectionPipelineContext.h"
 #include "collection_pipeline/queue/QueueKey.h"
+#include "common/memory/MemoryBudget.h"
 #include "monitor/MetricManager.h"
 #include "monitor/metric_constants/MetricConstants.h"
 
@@ -40,6 +41,7 @@ public:
         mTotalDelayMs = mMetricsRecordRef.CreateTimeCounter(METRIC_COMPONENT_TOTAL_DELAY_MS);
         mQueueSizeTotal = mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_QUEUE_SIZE);
         mQueueDataSizeByte = mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_QUEUE_SIZE_BYTES);
+        mPipelineMemoryUsageBytes = MemoryBudget::GetInstance()->GetPipelineUsage(ctx.GetConfigName());
     }
     virtual ~QueueInterface() = default;
 
@@ -66,6 +68,8 @@ protected:
     TimeCounterPtr mTotalDelayMs;
     IntGaugePtr mQueueSizeTotal;
     IntGaugePtr mQueueDataSizeByte;
+    // data held by the queue, including the extra buffer if any, which is charged to the pipeline
+    IntGaugePtr mPipelineMemoryUsageBytes;
 
 private:
     virtual size_t Size() const = 0;
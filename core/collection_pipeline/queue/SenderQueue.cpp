@@ -14,12 +14,24 @@
 
 #include "collection_pipeline/queue/SenderQueue.h"
 
+#include "common/Flags.h"
+#include "common/memory/MemoryBudget.h"
 #include "logger/Logger.h"
 
+DEFINE_FLAG_INT32(sender_queue_spill_extra_buffer_bytes,
+                  "size of the extra buffer of a sender queue above which new items are spilled to disk",
+                  16 * 1024 * 1024);
+
 using namespace std;
 
 namespace logtail {
 
+// under memory pressure, items are spilled as soon as the queue is full
+static bool IsExtraBufferOverflowed(size_t dataSize) {
+    return dataSize >= static_cast<size_t>(INT32_FLAG(sender_queue_spill_extra_buffer_bytes))
+        || MemoryBudget::GetInstance()->IsExceeded();
+}
+
 SenderQueue::SenderQueue(
     size_t cap, size_t low, size_t high, QueueKey key, const string& flusherId, const CollectionPipelineContext& ctx)
     : QueueInterface(key, cap, ctx), BoundedSenderQueueInterface(cap, low, high, key, flusherId, ctx) {
@@ -27,6 +39,10 @@ SenderQueue::SenderQueue(
     mFetchTimesCnt = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_QUEUE_FETCH_TIMES_TOTAL);
     mValidFetchTimesCnt = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_QUEUE_VALID_FETCH_TIMES_TOTAL);
     mFetchedItemsCnt = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_QUEUE_FETCHED_ITEMS_TOTAL);
+    mSpillSize = mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_QUEUE_SPILL_SIZE);
+    mSpillSizeBytes = mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_QUEUE_SPILL_SIZE_BYTES);
+    mSpillDiscardedItemsCnt = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_DISCARDED_ITEMS_TOTAL);
+    mSpillDiscardedSizeBytes = mMetricsRecordRef.CreateCounter(METRIC_COMPONENT_DISCARDED_SIZE_BYTES);
     WriteMetrics::GetInstance()->CommitMetricsRecordRef(mMetricsRecordRef);
 }
 
@@ -37,11 +53,23 @@ bool SenderQueue::Push(unique_ptr<SenderQueueItem>&& item) {
     ADD_COUNTER(mInItemsTotal, 1);
     ADD_COUNTER(mInItemDataSizeBytes, size);
 
-    if (Full()) {
+    bool spillable = SenderQueueSpiller::IsEnabled();
+    // spilled items may be not read back yet when the queue drains, new items should still be put after them
+    if (Full() || (spillable && HasSpilledItems())) {
+        if (spillable && SpillIfNeeded(item)) {
+            return true;
+        }
+        if (spillable && IsExtraBufferOverflowed(mExtraBufferDataSize)) {
+            // disk quota is exhausted, fall back to backpressure
+            MarkInvalidToPush();
+            SET_GAUGE(mValidToPushFlag, IsValidToPush());
+        }
         mExtraBuffer.push_back(std::move(item));
+        mExtraBufferDataSize += size;
 
         SET_GAUGE(mExtraBufferSize, mExtraBuffer.size());
         ADD_GAUGE(mExtraBufferDataSizeBytes, size);
+        ADD_GAUGE(mPipelineMemoryUsageBytes, size);
         return true;
     }
 
@@ -56,10 +84,14 @@ bool SenderQueue::Push(unique_ptr<SenderQueueItem>&& item) {
         ++mWrite;
     }
     ++mSize;
-    ChangeStateIfNeededAfterPush();
+    // spillable queues keep accepting items beyond the high watermark until the spill tier is exhausted
+    if (!spillable) {
+        ChangeStateIfNeededAfterPush();
+    }
 
     SET_GAUGE(mQueueSizeTotal, Size());
     ADD_GAUGE(mQueueDataSizeByte, size);
+    ADD_GAUGE(mPipelineMemoryUsageBytes, size);
     SET_GAUGE(mValidToPushFlag, IsValidToPush());
     return true;
 }
@@ -91,14 +123,21 @@ bool SenderQueue::Remove(SenderQueueItem* item) {
     ADD_COUNTER(mOutItemsTotal, 1);
     ADD_COUNTER(mTotalDelayMs, chrono::system_clock::now() - enQueuTime);
     SUB_GAUGE(mQueueDataSizeByte, size);
+    SUB_GAUGE(mPipelineMemoryUsageBytes, size);
 
+    if (mExtraBuffer.empty()) {
+        LoadFromSpiller();
+    }
     if (!mExtraBuffer.empty()) {
         auto newSize = mExtraBuffer.front()->mData.size();
         PushFromExtraBuffer(std::move(mExtraBuffer.front()));
         mExtraBuffer.pop_front();
+        mExtraBufferDataSize -= newSize;
 
         SET_GAUGE(mExtraBufferSize, mExtraBuffer.size());
         SUB_GAUGE(mExtraBufferDataSizeBytes, newSize);
+        // keep the extra buffer fed, so that spilled items move forward as the queue drains
+        LoadFromSpiller();
         return true;
     }
     if (ChangeStateIfNeededAfterPop()) {
@@ -177,6 +216,16 @@ void SenderQueue::GetAvailableItems(vector<SenderQueueItem*>& items, int32_t lim
     }
 }
 
+bool SenderQueue::HasIdleItem() const {
+    for (auto index = mRead; index < mWrite; ++index) {
+        SenderQueueItem* item = mQueue[index % mCapacity].get();
+        if (item != nullptr && item->mStatus.load() == SendingStatus::IDLE) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void SenderQueue::SetPipelineForItems(const std::shared_ptr<CollectionPipeline>& p) const {
     if (Empty()) {
         return;
@@ -195,6 +244,9 @@ void SenderQueue::SetPipelineForItems(const std::shared_ptr<CollectionPipeline>&
             item->mPipeline = p;
         }
     }
+    if (mSpiller) {
+        mSpiller->SetPipelineForItems(p);
+    }
 }
 
 void SenderQueue::PushFromExtraBuffer(std::unique_ptr<SenderQueueItem>&& item) {
@@ -216,4 +268,81 @@ void SenderQueue::PushFromExtraBuffer(std::unique_ptr<SenderQueueItem>&& item) {
     ADD_GAUGE(mQueueDataSizeByte, size);
 }
 
+shared_ptr<SenderQueueSpiller> SenderQueue::GetSpillerWithPendingIO() const {
+    if (mSpiller && mSpiller->HasPendingIO()) {
+        return mSpiller;
+    }
+    return nullptr;
+}
+
+bool SenderQueue::FeedFromSpiller() {
+    if (!mSpiller) {
+        return false;
+    }
+    bool fed = false;
+    while (!Full()) {
+        if (mExtraBuffer.empty()) {
+            LoadFromSpiller();
+        }
+        if (mExtraBuffer.empty()) {
+            break;
+        }
+        auto size = mExtraBuffer.front()->mData.size();
+        PushFromExtraBuffer(std::move(mExtraBuffer.front()));
+        mExtraBuffer.pop_front();
+        mExtraBufferDataSize -= size;
+
+        SET_GAUGE(mExtraBufferSize, mExtraBuffer.size());
+        SUB_GAUGE(mExtraBufferDataSizeBytes, size);
+        fed = true;
+    }
+    if (mExtraBuffer.empty()) {
+        LoadFromSpiller();
+    }
+    return fed;
+}
+
+bool SenderQueue::SpillIfNeeded(unique_ptr<SenderQueueItem>& item) {
+    // items are kept in FIFO order across the tiers, i.e., queue, extra buffer and then the spilled ones
+    if (!HasSpilledItems() && !IsExtraBufferOverflowed(mExtraBufferDataSize)) {
+        return false;
+    }
+    if (!mSpiller) {
+        mSpiller = make_shared<SenderQueueSpiller>(mKey);
+    }
+    if (!mSpiller->Spill(item)) {
+        return false;
+    }
+
+    SET_GAUGE(mSpillSize, mSpiller->Size());
+    SET_GAUGE(mSpillSizeBytes, mSpiller->DataSize());
+    return true;
+}
+
+void SenderQueue::LoadFromSpiller() {
+    if (!mSpiller || mSpiller->Empty()) {
+        return;
+    }
+    size_t discardedCnt = 0, discardedBytes = 0;
+    auto item = mSpiller->Pop(discardedCnt, discardedBytes);
+    if (discardedCnt > 0) {
+        LOG_WARNING(sLogger,
+                    ("discard spilled sender queue items", "too old or unreadable")("queue key", mKey)(
+                        "count", discardedCnt)("size", discardedBytes));
+        ADD_COUNTER(mSpillDiscardedItemsCnt, discardedCnt);
+        ADD_COUNTER(mSpillDiscardedSizeBytes, discardedBytes);
+    }
+    if (item) {
+        auto size = item->mData.size();
+        mExtraBuffer.push_back(std::move(item));
+        mExtraBufferDataSize += size;
+
+        SET_GAUGE(mExtraBufferSize, mExtraBuffer.size());
+        ADD_GAUGE(mExtraBufferDataSizeBytes, size);
+        ADD_GAUGE(mPipelineMemoryUsageBytes, size);
+    }
+    SET_GAUGE(mSpillSize, mSpiller->Size());
+    SET_GAUGE(mSpillSizeBytes, mSpiller->DataSize());
+}
+
 } // namespace logtail
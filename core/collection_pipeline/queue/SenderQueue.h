@@ -22,6 +22,7 @@
 #include "collection_pipeline/queue/BoundedSenderQueueInterface.h"
 #include "collection_pipeline/queue/QueueKey.h"
 #include "collection_pipeline/queue/SenderQueueItem.h"
+#include "collection_pipeline/queue/SenderQueueSpiller.h"
 
 namespace logtail {
 
@@ -41,19 +42,37 @@ public:
     bool Remove(SenderQueueItem* item) override;
     void GetAvailableItems(std::vector<SenderQueueItem*>& items, int32_t limit) override;
     void SetPipelineForItems(const std::shared_ptr<CollectionPipeline>& p) const override;
+    bool HasIdleItem() const;
+    bool HasSpilledItems() const { return mSpiller && !mSpiller->Empty(); }
+
+    // spill files are accessed without the lock of the queue, see SenderQueueSpiller
+    std::shared_ptr<SenderQueueSpiller> GetSpillerWithPendingIO() const;
+    // move items read back by the spiller forward, in case the queue drains before they are ready
+    // @return true if any item is moved to the queue
+    bool FeedFromSpiller();
 
 private:
     size_t Size() const override { return mSize; }
     void PushFromExtraBuffer(std::unique_ptr<SenderQueueItem>&& item) override;
+    bool SpillIfNeeded(std::unique_ptr<SenderQueueItem>& item);
+    void LoadFromSpiller();
 
     std::vector<std::unique_ptr<SenderQueueItem>> mQueue;
     size_t mWrite = 0;
     size_t mRead = 0;
     size_t mSize = 0;
 
+    // items overflowing the extra buffer, created on first spill
+    std::shared_ptr<SenderQueueSpiller> mSpiller;
+    size_t mExtraBufferDataSize = 0;
+
     CounterPtr mFetchTimesCnt;
     CounterPtr mValidFetchTimesCnt;
     CounterPtr mFetchedItemsCnt;
+    IntGaugePtr mSpillSize;
+    IntGaugePtr mSpillSizeBytes;
+    CounterPtr mSpillDiscardedItemsCnt;
+    CounterPtr mSpillDiscardedSizeBytes;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class SenderQueueUnittest;
@@ -24,6 +24,8 @@
 #include <string>
 
 #include "collection_pipeline/queue/QueueKey.h"
+#include "common/memory/MemoryBudget.h"
+#include "models/EventGroupTrace.h"
 
 namespace logtail {
 
@@ -46,6 +48,7 @@ struct SenderQueueItem {
     std::chrono::system_clock::time_point mFirstEnqueTime;
     std::chrono::system_clock::time_point mLastSendTime;
     uint32_t mTryCnt = 1;
+    EventGroupTracePtr mTrace; // not null only when the data is sampled for latency tracing
 
     SenderQueueItem(std::string&& data,
                     size_t rawSize,
@@ -59,8 +62,12 @@ struct SenderQueueItem {
           mBufferOrNot(bufferOrNot),
           mFlusher(flusher),
           mQueueKey(key),
-          mStatus(SendingStatus::IDLE) {}
-    virtual ~SenderQueueItem() = default;
+          mStatus(SendingStatus::IDLE) {
+        MemoryBudget::GetInstance()->Add(MemoryBudget::Category::SENDER_QUEUE_ITEM, mData.size());
+    }
+    virtual ~SenderQueueItem() {
+        MemoryBudget::GetInstance()->Sub(MemoryBudget::Category::SENDER_QUEUE_ITEM, mData.size());
+    }
 
     // for Clone only
     SenderQueueItem(const SenderQueueItem& item)
@@ -74,7 +81,11 @@ struct SenderQueueItem {
           mStatus(item.mStatus.load()),
           mFirstEnqueTime(item.mFirstEnqueTime),
           mLastSendTime(item.mLastSendTime),
-          mTryCnt(item.mTryCnt) {}
+          mTryCnt(item.mTryCnt),
+          // the copy is sent on its own, so it must not stamp the trace of the original
+          mTrace(item.mTrace ? std::make_shared<EventGroupTrace>(*item.mTrace) : nullptr) {
+        MemoryBudget::GetInstance()->Add(MemoryBudget::Category::SENDER_QUEUE_ITEM, mData.size());
+    }
 
     virtual SenderQueueItem* Clone() { return new SenderQueueItem(*this); }
 };
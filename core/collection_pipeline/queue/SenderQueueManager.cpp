@@ -17,6 +17,7 @@
 #include "collection_pipeline/queue/ExactlyOnceQueueManager.h"
 #include "collection_pipeline/queue/QueueKeyManager.h"
 #include "common/Flags.h"
+#include "logger/Logger.h"
 
 DEFINE_FLAG_INT32(sender_queue_gc_threshold_sec, "30s", 30);
 DEFINE_FLAG_INT32(sender_queue_capacity, "", 15);
@@ -28,6 +29,10 @@ namespace logtail {
 SenderQueueManager::SenderQueueManager() : mDefaultQueueParam(INT32_FLAG(sender_queue_capacity), 1.0) {
 }
 
+SenderQueueManager::~SenderQueueManager() {
+    StopSpillThread();
+}
+
 bool SenderQueueManager::CreateQueue(
     QueueKey key,
     const string& flusherId,
@@ -89,6 +94,9 @@ bool SenderQueueManager::ReuseQueue(QueueKey key) {
 }
 
 int SenderQueueManager::PushQueue(QueueKey key, unique_ptr<SenderQueueItem>&& item) {
+    if (item->mTrace) {
+        item->mTrace->Stamp(TraceStamp::SENDER_QUEUE_PUSH);
+    }
     {
         lock_guard<mutex> lock(mQueueMux);
         auto iter = mQueues.find(key);
@@ -96,6 +104,10 @@ int SenderQueueManager::PushQueue(QueueKey key, unique_ptr<SenderQueueItem>&& it
             if (!iter->second.Push(std::move(item))) {
                 return 1;
             }
+            MarkQueueReady(key);
+            if (iter->second.GetSpillerWithPendingIO()) {
+                NotifySpillIO(key);
+            }
         } else {
             int res = ExactlyOnceQueueManager::GetInstance()->PushSenderQueue(key, std::move(item));
             if (res != 0) {
@@ -110,28 +122,35 @@ int SenderQueueManager::PushQueue(QueueKey key, unique_ptr<SenderQueueItem>&& it
 void SenderQueueManager::GetAvailableItems(vector<SenderQueueItem*>& items, int32_t itemsCntLimit) {
     {
         lock_guard<mutex> lock(mQueueMux);
-        if (mQueues.empty()) {
-            return;
-        }
-        if (itemsCntLimit == -1) {
-            for (auto iter = mQueues.begin(); iter != mQueues.end(); ++iter) {
-                iter->second.GetAvailableItems(items, -1);
+        if (!mReadyQueueKeys.empty()) {
+            int cntLimitPerQueue = -1;
+            if (itemsCntLimit != -1) {
+                cntLimitPerQueue = std::max((int)(mDefaultQueueParam.GetCapacity() * 0.3),
+                                            (int)(itemsCntLimit / mReadyQueueKeys.size()));
             }
-        } else {
-            int cntLimitPerQueue
-                = std::max((int)(mDefaultQueueParam.GetCapacity() * 0.3), (int)(itemsCntLimit / mQueues.size()));
-            // must check index before moving iterator
-            mSenderQueueBeginIndex = mSenderQueueBeginIndex % mQueues.size();
             // here we set sender queue begin index, let the sender order be different each time
-            auto beginIter = mQueues.begin();
-            std::advance(beginIter, mSenderQueueBeginIndex++);
-
-            for (auto iter = beginIter; iter != mQueues.end(); ++iter) {
-                iter->second.GetAvailableItems(items, cntLimitPerQueue);
-            }
-            for (auto iter = mQueues.begin(); iter != beginIter; ++iter) {
+            size_t readyCnt = mReadyQueueKeys.size();
+            mSenderQueueBeginIndex = mSenderQueueBeginIndex % readyCnt;
+            vector<QueueKey> readyKeys;
+            readyKeys.reserve(readyCnt);
+            for (size_t i = 0; i < readyCnt; ++i) {
+                auto key = mReadyQueueKeys[(mSenderQueueBeginIndex + i) % readyCnt];
+                auto iter = mQueues.find(key);
+                if (iter == mQueues.end()) {
+                    mReadyQueueKeySet.erase(key);
+                    continue;
+                }
                 iter->second.GetAvailableItems(items, cntLimitPerQueue);
+                if (iter->second.HasIdleItem()) {
+                    // limited by concurrency or rate limiters, or the per queue limit
+                    readyKeys.push_back(key);
+                } else {
+                    mReadyQueueKeySet.erase(key);
+                }
             }
+            // ready keys are now ordered from the begin index, so the next round begins at the following queue
+            mReadyQueueKeys.swap(readyKeys);
+            mSenderQueueBeginIndex = 1;
         }
     }
     ExactlyOnceQueueManager::GetInstance()->GetAvailableSenderQueueItems(items, itemsCntLimit);
@@ -142,12 +161,106 @@ bool SenderQueueManager::RemoveItem(QueueKey key, SenderQueueItem* item) {
         lock_guard<mutex> lock(mQueueMux);
         auto iter = mQueues.find(key);
         if (iter != mQueues.end()) {
-            return iter->second.Remove(item);
+            if (!iter->second.Remove(item)) {
+                return false;
+            }
+            // items may be moved from the extra buffer to the queue
+            if (iter->second.HasIdleItem()) {
+                MarkQueueReady(key);
+            }
+            if (iter->second.GetSpillerWithPendingIO()) {
+                NotifySpillIO(key);
+            }
+            return true;
         }
     }
     return ExactlyOnceQueueManager::GetInstance()->RemoveSenderQueueItem(key, item);
 }
 
+void SenderQueueManager::StopSpillThread() {
+    {
+        lock_guard<mutex> lock(mSpillMux);
+        if (mIsSpillThreadStopped) {
+            return;
+        }
+        mIsSpillThreadStopped = true;
+    }
+    mSpillCond.notify_all();
+    if (mSpillThreadRes.valid()) {
+        mSpillThreadRes.get();
+    }
+}
+
+void SenderQueueManager::NotifySpillIO(QueueKey key) {
+    {
+        lock_guard<mutex> lock(mSpillMux);
+        if (mIsSpillThreadStopped) {
+            // items are kept in memory on exit
+            return;
+        }
+        if (!mSpillThreadRes.valid()) {
+            mSpillThreadRes = async(launch::async, &SenderQueueManager::RunSpillThread, this);
+        }
+        if (!mSpillKeySet.insert(key).second) {
+            return;
+        }
+        mSpillKeys.push_back(key);
+    }
+    mSpillCond.notify_one();
+}
+
+void SenderQueueManager::RunSpillThread() {
+    LOG_INFO(sLogger, ("sender queue spill thread", "started"));
+    unique_lock<mutex> spillLock(mSpillMux);
+    while (!mIsSpillThreadStopped) {
+        if (mSpillKeys.empty()) {
+            mSpillCond.wait_for(spillLock, chrono::seconds(1));
+            continue;
+        }
+        vector<QueueKey> keys;
+        keys.swap(mSpillKeys);
+        mSpillKeySet.clear();
+        spillLock.unlock();
+        for (auto key : keys) {
+            shared_ptr<SenderQueueSpiller> spiller;
+            {
+                lock_guard<mutex> lock(mQueueMux);
+                auto iter = mQueues.find(key);
+                if (iter != mQueues.end()) {
+                    spiller = iter->second.GetSpillerWithPendingIO();
+                }
+            }
+            if (spiller) {
+                DoSpillIO(key, spiller);
+            }
+        }
+        spillLock.lock();
+    }
+}
+
+void SenderQueueManager::DoSpillIO(QueueKey key, const shared_ptr<SenderQueueSpiller>& spiller) {
+    if (!spiller->DoIO()) {
+        return;
+    }
+    {
+        lock_guard<mutex> lock(mQueueMux);
+        auto iter = mQueues.find(key);
+        if (iter == mQueues.end() || !iter->second.FeedFromSpiller()) {
+            return;
+        }
+        MarkQueueReady(key);
+    }
+    Trigger();
+}
+
+void SenderQueueManager::SetItemIdle(SenderQueueItem* item) {
+    item->mStatus = SendingStatus::IDLE;
+    lock_guard<mutex> lock(mQueueMux);
+    if (mQueues.find(item->mQueueKey) != mQueues.end()) {
+        MarkQueueReady(item->mQueueKey);
+    }
+}
+
 void SenderQueueManager::DecreaseConcurrencyLimiterInSendingCnt(QueueKey key) {
     lock_guard<mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
@@ -160,7 +273,7 @@ bool SenderQueueManager::IsAllQueueEmpty() const {
     {
         lock_guard<mutex> lock(mQueueMux);
         for (const auto& q : mQueues) {
-            if (!q.second.Empty()) {
+            if (!q.second.Empty() || q.second.HasSpilledItems()) {
                 return false;
             }
         }
@@ -184,7 +297,7 @@ void SenderQueueManager::ClearUnusedQueues() {
                 // should not happen
                 continue;
             }
-            if (!itr->second.Empty()) {
+            if (!itr->second.Empty() || itr->second.HasSpilledItems()) {
                 ++iter;
                 continue;
             }
@@ -225,6 +338,12 @@ void SenderQueueManager::Trigger() {
     mCond.notify_one();
 }
 
+void SenderQueueManager::MarkQueueReady(QueueKey key) {
+    if (mReadyQueueKeySet.insert(key).second) {
+        mReadyQueueKeys.push_back(key);
+    }
+}
+
 void SenderQueueManager::SetPipelineForItems(QueueKey key, const std::shared_ptr<CollectionPipeline>& p) {
     lock_guard<mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
@@ -239,7 +358,12 @@ void SenderQueueManager::SetPipelineForItems(QueueKey key, const std::shared_ptr
 void SenderQueueManager::Clear() {
     lock_guard<mutex> lock(mQueueMux);
     mQueues.clear();
+    mReadyQueueKeys.clear();
+    mReadyQueueKeySet.clear();
     mQueueDeletionTimeMap.clear();
+    lock_guard<mutex> spillLock(mSpillMux);
+    mSpillKeys.clear();
+    mSpillKeySet.clear();
 }
 
 bool SenderQueueManager::IsQueueMarkedDeleted(QueueKey key) {
@@ -17,10 +17,12 @@
 #pragma once
 
 #include <condition_variable>
+#include <future>
 #include <list>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "collection_pipeline/limiter/ConcurrencyLimiter.h"
@@ -59,6 +61,8 @@ public:
     int PushQueue(QueueKey key, std::unique_ptr<SenderQueueItem>&& item);
     void GetAvailableItems(std::vector<SenderQueueItem*>& items, int32_t itemsCntLimit);
     bool RemoveItem(QueueKey key, SenderQueueItem* item);
+    // the only way to return a fetched item to the queue for sending again
+    void SetItemIdle(SenderQueueItem* item);
     void DecreaseConcurrencyLimiterInSendingCnt(QueueKey key);
     bool IsAllQueueEmpty() const;
     void ClearUnusedQueues();
@@ -68,6 +72,9 @@ public:
     bool Wait(uint64_t ms);
     void Trigger();
 
+    // spilled items are kept in memory afterwards, should be called after the flusher runner is stopped
+    void StopSpillThread();
+
     // only used for go pipeline before flushing data to C++ flusher
     bool IsValidToPush(QueueKey key) const;
 
@@ -78,12 +85,33 @@ public:
 
 private:
     SenderQueueManager();
-    ~SenderQueueManager() = default;
+    ~SenderQueueManager();
+
+    // should be called with mQueueMux held
+    void MarkQueueReady(QueueKey key);
+    // should be called with mQueueMux held, hands the disk io of the queue over to the spill thread
+    void NotifySpillIO(QueueKey key);
+    void RunSpillThread();
+    // should be called without mQueueMux held
+    void DoSpillIO(QueueKey key, const std::shared_ptr<SenderQueueSpiller>& spiller);
 
     BoundedQueueParam mDefaultQueueParam;
 
     mutable std::mutex mQueueMux;
     std::unordered_map<QueueKey, SenderQueue> mQueues;
+    // queues which may have idle items, maintained on push, removal and reset of items, so that only these queues are
+    // visited when fetching items
+    std::vector<QueueKey> mReadyQueueKeys;
+    std::unordered_set<QueueKey> mReadyQueueKeySet;
+
+    // spill files are only accessed by the spill thread, which is started on first spill, so that disk stalls never
+    // block pushing items or the http sink removing sent ones
+    std::mutex mSpillMux;
+    std::condition_variable mSpillCond;
+    std::vector<QueueKey> mSpillKeys;
+    std::unordered_set<QueueKey> mSpillKeySet;
+    std::future<void> mSpillThreadRes;
+    bool mIsSpillThreadStopped = false;
 
     mutable std::mutex mGCMux;
     std::unordered_map<QueueKey, time_t> mQueueDeletionTimeMap;
@@ -0,0 +1,338 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "collection_pipeline/queue/SenderQueueSpiller.h"
+
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+#include "app_config/AppConfig.h"
+#include "common/ErrorUtil.h"
+#include "common/FileSystemUtil.h"
+#include "common/Flags.h"
+#include "common/StringTools.h"
+#include "common/memory/MemoryBudget.h"
+#include "logger/Logger.h"
+#include "monitor/AlarmManager.h"
+
+DEFINE_FLAG_BOOL(enable_sender_queue_spill,
+                 "spill items of sender queues to disk when the queues are full, instead of blocking the input",
+                 false);
+DEFINE_FLAG_INT64(sender_queue_spill_max_bytes, "max disk usage of all spilled sender queue items", 1024 * 1024 * 1024);
+DEFINE_FLAG_INT32(sender_queue_spill_max_age_sec, "spilled sender queue items older than this are discarded", 86400);
+DEFINE_FLAG_INT32(sender_queue_spill_segment_size, "max size of each sender queue spill file", 64 * 1024 * 1024);
+
+using namespace std;
+
+namespace logtail {
+
+atomic_int64_t SenderQueueSpiller::sTotalSpilledBytes(0);
+
+SenderQueueSpiller::SenderQueueSpiller(QueueKey key) : mKey(key) {
+}
+
+SenderQueueSpiller::~SenderQueueSpiller() {
+    RemoveFiles();
+    sTotalSpilledBytes -= mDataSize;
+}
+
+bool SenderQueueSpiller::IsEnabled() {
+    return BOOL_FLAG(enable_sender_queue_spill);
+}
+
+const string& SenderQueueSpiller::GetSpillDir() {
+    static string sDir
+        = (filesystem::path(AppConfig::GetInstance()->GetBufferFilePath()) / "sender_queue_spill").string();
+    return sDir;
+}
+
+void SenderQueueSpiller::RemoveStaleFiles() {
+    error_code ec;
+    filesystem::remove_all(GetSpillDir(), ec);
+    if (ec) {
+        LOG_WARNING(sLogger, ("failed to remove stale sender queue spill files", GetSpillDir())("error", ec.message()));
+    }
+}
+
+string SenderQueueSpiller::GetSegmentFileName(uint32_t segmentId) const {
+    return GetSpillDir() + PATH_SEPARATOR + ToString(mKey) + "_" + ToString(segmentId) + ".dat";
+}
+
+bool SenderQueueSpiller::HasRoom() const {
+    return sTotalSpilledBytes.load() < INT64_FLAG(sender_queue_spill_max_bytes);
+}
+
+bool SenderQueueSpiller::Spill(unique_ptr<SenderQueueItem>& item) {
+    if (!HasRoom()) {
+        return false;
+    }
+    size_t size = item->mData.size();
+    lock_guard<mutex> lock(mMux);
+    Entry entry;
+    entry.mItem = std::move(item);
+    entry.mDataSize = size;
+    mEntries.emplace_back(std::move(entry));
+    ++mPendingWriteCnt;
+    mDataSize += size;
+    sTotalSpilledBytes += size;
+    return true;
+}
+
+unique_ptr<SenderQueueItem> SenderQueueSpiller::Pop(size_t& discardedCnt, size_t& discardedBytes) {
+    auto now = chrono::system_clock::now();
+    lock_guard<mutex> lock(mMux);
+    while (!mEntries.empty()) {
+        auto& entry = mEntries.front();
+        if (entry.mState == EntryState::WRITING || entry.mState == EntryState::READING) {
+            return nullptr;
+        }
+        if (entry.mState == EntryState::BROKEN
+            || now - entry.mItem->mFirstEnqueTime > chrono::seconds(INT32_FLAG(sender_queue_spill_max_age_sec))) {
+            ++discardedCnt;
+            discardedBytes += entry.mDataSize;
+            PopFront();
+            continue;
+        }
+        if (entry.mState == EntryState::ON_DISK) {
+            return nullptr;
+        }
+        auto item = std::move(entry.mItem);
+        PopFront();
+        return item;
+    }
+    return nullptr;
+}
+
+bool SenderQueueSpiller::HasPendingIO() const {
+    lock_guard<mutex> lock(mMux);
+    return mPendingWriteCnt > 0 || (mOnDiskCnt > 0 && mReadAheadSize < kReadAheadBytes)
+        || (mEntries.empty() && mHasFiles);
+}
+
+bool SenderQueueSpiller::DoIO() {
+    lock_guard<mutex> ioLock(mIOMux);
+
+    // pending entries are always at the back, since they are moved to disk in order
+    vector<pair<Entry*, string>> writes;
+    {
+        lock_guard<mutex> lock(mMux);
+        for (auto iter = mEntries.rbegin(); iter != mEntries.rend() && iter->mState == EntryState::PENDING_WRITE;
+             ++iter) {
+            iter->mState = EntryState::WRITING;
+            writes.emplace_back(&*iter, std::move(iter->mItem->mData));
+            iter->mItem->mData.clear();
+        }
+        mPendingWriteCnt = 0;
+        if (!writes.empty()) {
+            mHasFiles = true;
+        }
+    }
+    vector<bool> written(writes.size());
+    for (size_t i = writes.size(); i > 0; --i) {
+        auto& write = writes[i - 1];
+        written[i - 1] = Write(write.second, write.first->mSegmentId, write.first->mOffset);
+    }
+    if (mWriteFile != nullptr) {
+        fflush(mWriteFile);
+    }
+    {
+        lock_guard<mutex> lock(mMux);
+        for (size_t i = 0; i < writes.size(); ++i) {
+            auto* entry = writes[i].first;
+            if (written[i]) {
+                // the item is accounted in the memory budget by the size of its data, which is now moved out
+                MemoryBudget::GetInstance()->Sub(MemoryBudget::Category::SENDER_QUEUE_ITEM, entry->mDataSize);
+                entry->mState = EntryState::ON_DISK;
+                ++mOnDiskCnt;
+            } else {
+                // kept in memory
+                entry->mItem->mData = std::move(writes[i].second);
+                entry->mState = EntryState::LOADED;
+                mReadAheadSize += entry->mDataSize;
+            }
+        }
+    }
+    writes.clear();
+
+    // read back the first items, so that they are ready before the queue drains
+    vector<Entry*> reads;
+    {
+        lock_guard<mutex> lock(mMux);
+        size_t readAheadSize = mReadAheadSize;
+        for (auto iter = mEntries.begin(); iter != mEntries.end() && readAheadSize < kReadAheadBytes; ++iter) {
+            if (iter->mState == EntryState::ON_DISK) {
+                iter->mState = EntryState::READING;
+                --mOnDiskCnt;
+                readAheadSize += iter->mDataSize;
+                reads.push_back(&*iter);
+            }
+        }
+        mReadAheadSize = readAheadSize;
+    }
+    vector<string> data(reads.size());
+    vector<bool> read(reads.size());
+    for (size_t i = 0; i < reads.size(); ++i) {
+        data[i].resize(reads[i]->mDataSize);
+        read[i] = Read(reads[i]->mSegmentId, reads[i]->mOffset, data[i]);
+        if (!read[i]) {
+            LOG_ERROR(sLogger,
+                      ("failed to load spilled sender queue item, discard it",
+                       GetSegmentFileName(reads[i]->mSegmentId))("offset", reads[i]->mOffset)("size",
+                                                                                              reads[i]->mDataSize));
+        }
+    }
+
+    lock_guard<mutex> lock(mMux);
+    for (size_t i = 0; i < reads.size(); ++i) {
+        auto* entry = reads[i];
+        if (read[i]) {
+            entry->mItem->mData = std::move(data[i]);
+            MemoryBudget::GetInstance()->Add(MemoryBudget::Category::SENDER_QUEUE_ITEM, entry->mDataSize);
+            entry->mState = EntryState::LOADED;
+        } else {
+            entry->mState = EntryState::BROKEN;
+            mReadAheadSize -= entry->mDataSize;
+        }
+    }
+    if (mEntries.empty() && mHasFiles) {
+        RemoveFiles();
+        mHasFiles = false;
+    }
+    return !reads.empty();
+}
+
+bool SenderQueueSpiller::Empty() const {
+    lock_guard<mutex> lock(mMux);
+    return mEntries.empty();
+}
+
+size_t SenderQueueSpiller::Size() const {
+    lock_guard<mutex> lock(mMux);
+    return mEntries.size();
+}
+
+size_t SenderQueueSpiller::DataSize() const {
+    lock_guard<mutex> lock(mMux);
+    return mDataSize;
+}
+
+void SenderQueueSpiller::SetPipelineForItems(const shared_ptr<CollectionPipeline>& p) {
+    lock_guard<mutex> lock(mMux);
+    for (auto& entry : mEntries) {
+        if (!entry.mItem->mPipeline) {
+            entry.mItem->mPipeline = p;
+        }
+    }
+}
+
+bool SenderQueueSpiller::Write(const string& data, uint32_t& segmentId, int64_t& offset) {
+    if (mWriteFile != nullptr && mWriteOffset >= INT32_FLAG(sender_queue_spill_segment_size)) {
+        fclose(mWriteFile);
+        mWriteFile = nullptr;
+        ++mWriteSegmentId;
+        mWriteOffset = 0;
+    }
+    if (mWriteFile == nullptr && !OpenWriteSegment()) {
+        return false;
+    }
+    if (fwrite(data.data(), 1, data.size(), mWriteFile) != data.size()) {
+        string errorStr = ErrnoToString(GetErrno());
+        LOG_ERROR(sLogger,
+                  ("failed to spill sender queue item", GetSegmentFileName(mWriteSegmentId))("error", errorStr));
+        AlarmManager::GetInstance()->SendAlarmWarning(SECONDARY_READ_WRITE_ALARM,
+                                                      "failed to spill sender queue item: " + errorStr);
+        // the rest of the segment is not trustworthy any more
+        fclose(mWriteFile);
+        mWriteFile = nullptr;
+        ++mWriteSegmentId;
+        mWriteOffset = 0;
+        return false;
+    }
+    segmentId = mWriteSegmentId;
+    offset = mWriteOffset;
+    mWriteOffset += data.size();
+    return true;
+}
+
+bool SenderQueueSpiller::Read(uint32_t segmentId, int64_t offset, string& data) {
+    return SwitchReadSegment(segmentId) && FSeek(mReadFile, offset, SEEK_SET) == 0
+        && fread(&data[0], 1, data.size(), mReadFile) == data.size();
+}
+
+bool SenderQueueSpiller::OpenWriteSegment() {
+    error_code ec;
+    filesystem::create_directories(GetSpillDir(), ec);
+    auto fileName = GetSegmentFileName(mWriteSegmentId);
+    mWriteFile = FileWriteOnlyOpen(fileName.c_str(), "wb");
+    if (mWriteFile == nullptr) {
+        string errorStr = ErrnoToString(GetErrno());
+        LOG_ERROR(sLogger, ("failed to open sender queue spill file", fileName)("error", errorStr));
+        AlarmManager::GetInstance()->SendAlarmWarning(SECONDARY_READ_WRITE_ALARM,
+                                                      "failed to open sender queue spill file: " + errorStr);
+        return false;
+    }
+    return true;
+}
+
+bool SenderQueueSpiller::SwitchReadSegment(uint32_t segmentId) {
+    if (mReadFile != nullptr && mReadSegmentId == segmentId) {
+        return true;
+    }
+    if (mReadFile != nullptr) {
+        fclose(mReadFile);
+        mReadFile = nullptr;
+    }
+    // items are read back in order, so the segments before are fully consumed
+    for (; mReadSegmentId < segmentId; ++mReadSegmentId) {
+        remove(GetSegmentFileName(mReadSegmentId).c_str());
+    }
+    mReadFile = FileReadOnlyOpen(GetSegmentFileName(segmentId).c_str(), "rb");
+    return mReadFile != nullptr;
+}
+
+void SenderQueueSpiller::RemoveFiles() {
+    if (mReadFile != nullptr) {
+        fclose(mReadFile);
+        mReadFile = nullptr;
+    }
+    if (mWriteFile != nullptr) {
+        fclose(mWriteFile);
+        mWriteFile = nullptr;
+    }
+    if (mReadSegmentId != mWriteSegmentId || mWriteOffset != 0) {
+        for (; mReadSegmentId <= mWriteSegmentId; ++mReadSegmentId) {
+            remove(GetSegmentFileName(mReadSegmentId).c_str());
+        }
+        // segment ids are not reused, so that a stale read handle never refers to a new segment
+        mWriteSegmentId = mReadSegmentId;
+        mWriteOffset = 0;
+    }
+}
+
+void SenderQueueSpiller::PopFront() {
+    auto& entry = mEntries.front();
+    if (entry.mState == EntryState::PENDING_WRITE) {
+        --mPendingWriteCnt;
+    } else if (entry.mState == EntryState::ON_DISK) {
+        --mOnDiskCnt;
+    } else if (entry.mState == EntryState::LOADED) {
+        mReadAheadSize -= entry.mDataSize;
+    }
+    mDataSize -= entry.mDataSize;
+    sTotalSpilledBytes -= entry.mDataSize;
+    mEntries.pop_front();
+}
+
+} // namespace logtail
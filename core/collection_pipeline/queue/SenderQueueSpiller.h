@@ -0,0 +1,123 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "collection_pipeline/queue/QueueKey.h"
+#include "collection_pipeline/queue/SenderQueueItem.h"
+
+namespace logtail {
+
+// SenderQueueSpiller is the on-disk overflow tier of a sender queue.
+//
+// Once the in-memory extra buffer of a queue grows too large, the data of further items is appended to segment files
+// and read back in FIFO order as the queue drains. Only the data is written to disk, while the item itself, including
+// the fields of derived items, is kept in memory. So items of any flusher can be spilled, but spilled items do not
+// survive a restart. Flushers requiring durability (e.g. flusher_sls) have their own buffer.
+//
+// Spill files are never accessed in Spill() and Pop(), which only move items in memory and are called with the queue
+// lock held. Writing spilled data, reading data back ahead of Pop() and removing consumed files are done in DoIO(),
+// which is called by the spill thread of SenderQueueManager without the queue lock.
+class SenderQueueSpiller {
+public:
+    explicit SenderQueueSpiller(QueueKey key);
+    ~SenderQueueSpiller();
+    SenderQueueSpiller(const SenderQueueSpiller&) = delete;
+    SenderQueueSpiller& operator=(const SenderQueueSpiller&) = delete;
+
+    static bool IsEnabled();
+    static int64_t GetTotalSpilledBytes() { return sTotalSpilledBytes.load(); }
+    // spilled items are not recovered after restart, so files left by last run should be removed on startup
+    static void RemoveStaleFiles();
+
+    // @return false if the disk quota is exhausted, in which case the item is kept by the caller
+    bool Spill(std::unique_ptr<SenderQueueItem>& item);
+    // @return nullptr if no item is left, or the data of the first item is not read back yet. Items older than the
+    // max age are discarded and counted in @discardedCnt.
+    std::unique_ptr<SenderQueueItem> Pop(size_t& discardedCnt, size_t& discardedBytes);
+    bool HasPendingIO() const;
+    // @return true if any item is read back, i.e., ready to pop
+    bool DoIO();
+    bool HasRoom() const;
+
+    bool Empty() const;
+    size_t Size() const;
+    size_t DataSize() const;
+    void SetPipelineForItems(const std::shared_ptr<CollectionPipeline>& p);
+
+private:
+    enum class EntryState { PENDING_WRITE, WRITING, ON_DISK, READING, LOADED, BROKEN };
+
+    struct Entry {
+        // data of the item is moved to disk and back
+        std::unique_ptr<SenderQueueItem> mItem;
+        size_t mDataSize = 0;
+        EntryState mState = EntryState::PENDING_WRITE;
+        uint32_t mSegmentId = 0;
+        int64_t mOffset = 0;
+    };
+
+    // max size of data read back ahead of Pop()
+    static constexpr size_t kReadAheadBytes = 4 * 1024 * 1024;
+
+    static const std::string& GetSpillDir();
+
+    std::string GetSegmentFileName(uint32_t segmentId) const;
+    bool Write(const std::string& data, uint32_t& segmentId, int64_t& offset);
+    bool Read(uint32_t segmentId, int64_t offset, std::string& data);
+    bool OpenWriteSegment();
+    bool SwitchReadSegment(uint32_t segmentId);
+    void RemoveFiles();
+    void PopFront();
+
+    static std::atomic_int64_t sTotalSpilledBytes;
+
+    QueueKey mKey;
+
+    // protects the entries, which are referenced by DoIO() while in WRITING or READING state. References to deque
+    // elements are kept valid on push_back and pop_front, and such entries are never popped.
+    mutable std::mutex mMux;
+    std::deque<Entry> mEntries;
+    size_t mDataSize = 0;
+    size_t mPendingWriteCnt = 0;
+    size_t mOnDiskCnt = 0;
+    // size of data read back or being read back
+    size_t mReadAheadSize = 0;
+    bool mHasFiles = false;
+
+    // protects the files
+    std::mutex mIOMux;
+    FILE* mWriteFile = nullptr;
+    uint32_t mWriteSegmentId = 0;
+    int64_t mWriteOffset = 0;
+    FILE* mReadFile = nullptr;
+    uint32_t mReadSegmentId = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class SenderQueueUnittest;
+#endif
+};
+
+} // namespace logtail
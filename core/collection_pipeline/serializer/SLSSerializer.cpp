@@ -60,6 +60,54 @@ std::string SerializeSpanEventsToString(const SpanEvent& event) {
 }
 
 bool SLSEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, string& errorMsg) {
+    // loggroup.category is deprecated, no need to set
+    size_t tagsSZ = 0;
+    for (const auto& tag : group.mTags.mInner) {
+        if (tag.first == LOG_RESERVED_KEY_TOPIC || tag.first == LOG_RESERVED_KEY_SOURCE
+            || tag.first == LOG_RESERVED_KEY_MACHINE_UUID) {
+            tagsSZ += GetStringSize(tag.second.size());
+        } else {
+            tagsSZ += GetLogTagSize(tag.first.size(), tag.second.size());
+        }
+    }
+
+    thread_local LogGroupSerializer serializer;
+    if (!SerializeEvents(group, mFlusher->GetContext(), tagsSZ, serializer, errorMsg)) {
+        return false;
+    }
+    for (const auto& tag : group.mTags.mInner) {
+        if (tag.first == LOG_RESERVED_KEY_TOPIC) {
+            serializer.AddTopic(tag.second);
+        } else if (tag.first == LOG_RESERVED_KEY_SOURCE) {
+            serializer.AddSource(tag.second);
+        } else if (tag.first == LOG_RESERVED_KEY_MACHINE_UUID) {
+            serializer.AddMachineUUID(tag.second);
+        } else {
+            serializer.AddLogTag(tag.first, tag.second);
+        }
+    }
+    res = std::move(serializer.GetResult());
+
+    // when function stablize, remove the following logic
+    if (BOOL_FLAG(debug_sls_serializer)) {
+        sls_logs::LogGroup logGroup;
+        if (!logGroup.ParseFromString(res)) {
+            JsonEventGroupSerializer ser(const_cast<Flusher*>(mFlusher));
+            string jsonStr;
+            ser.DoSerialize(std::move(group), jsonStr, errorMsg);
+            LOG_ERROR(sLogger,
+                      ("failed to parse log group", jsonStr)("config", mFlusher->GetContext().GetConfigName()));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SLSEventGroupSerializer::SerializeEvents(BatchedEvents& group,
+                                              const CollectionPipelineContext& ctx,
+                                              size_t tagsSZ,
+                                              LogGroupSerializer& serializer,
+                                              string& errorMsg) {
     if (group.mEvents.empty()) {
         errorMsg = "empty event group";
         return false;
@@ -72,12 +120,12 @@ bool SLSEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, stri
         return false;
     }
 
-    bool enableNs = mFlusher->GetContext().GetGlobalConfig().mEnableTimestampNanosecond;
+    bool enableNs = ctx.GetGlobalConfig().mEnableTimestampNanosecond;
 
     // caculate serialized logGroup size first, where some critical results can be cached
     vector<size_t> logSZ(group.mEvents.size());
-    vector<MetricEventContentCacheItem> metricEventContentCache(group.mEvents.size());
-    vector<array<string, 6>> spanEventContentCache(group.mEvents.size());
+    vector<MetricEventContentCacheItem> metricEventContentCache;
+    vector<array<string, 6>> spanEventContentCache;
     size_t logGroupSZ = 0;
     switch (eventType) {
         case PipelineEvent::Type::LOG: {
@@ -85,10 +133,12 @@ bool SLSEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, stri
             break;
         }
         case PipelineEvent::Type::METRIC: {
-            CalculateMetricEventSize(group, logGroupSZ, metricEventContentCache, logSZ);
+            metricEventContentCache.resize(group.mEvents.size());
+            CalculateMetricEventSize(group, ctx, logGroupSZ, metricEventContentCache, logSZ);
             break;
         }
         case PipelineEvent::Type::SPAN:
+            spanEventContentCache.resize(group.mEvents.size());
             CalculateSpanEventSize(group, logGroupSZ, spanEventContentCache, logSZ);
             break;
         case PipelineEvent::Type::RAW:
@@ -102,30 +152,20 @@ bool SLSEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, stri
         return false;
     }
 
-    // loggroup.category is deprecated, no need to set
-    for (const auto& tag : group.mTags.mInner) {
-        if (tag.first == LOG_RESERVED_KEY_TOPIC || tag.first == LOG_RESERVED_KEY_SOURCE
-            || tag.first == LOG_RESERVED_KEY_MACHINE_UUID) {
-            logGroupSZ += GetStringSize(tag.second.size());
-        } else {
-            logGroupSZ += GetLogTagSize(tag.first.size(), tag.second.size());
-        }
-    }
-
+    logGroupSZ += tagsSZ;
     if (static_cast<int32_t>(logGroupSZ) > INT32_FLAG(max_send_log_group_size)) {
         errorMsg = "log group exceeds size limit\tgroup size: " + ToString(logGroupSZ)
             + "\tsize limit: " + ToString(INT32_FLAG(max_send_log_group_size));
         return false;
     }
 
-    thread_local LogGroupSerializer serializer;
     serializer.Prepare(logGroupSZ);
     switch (eventType) {
         case PipelineEvent::Type::LOG:
             SerializeLogEvent(serializer, group, logSZ, enableNs);
             break;
         case PipelineEvent::Type::METRIC:
-            SerializeMetricEvent(serializer, group, metricEventContentCache, logSZ);
+            SerializeMetricEvent(serializer, group, ctx, metricEventContentCache, logSZ);
             break;
         case PipelineEvent::Type::SPAN:
             SerializeSpanEvent(serializer, group, spanEventContentCache, logSZ);
@@ -136,38 +176,13 @@ bool SLSEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, stri
         default:
             break;
     }
-    for (const auto& tag : group.mTags.mInner) {
-        if (tag.first == LOG_RESERVED_KEY_TOPIC) {
-            serializer.AddTopic(tag.second);
-        } else if (tag.first == LOG_RESERVED_KEY_SOURCE) {
-            serializer.AddSource(tag.second);
-        } else if (tag.first == LOG_RESERVED_KEY_MACHINE_UUID) {
-            serializer.AddMachineUUID(tag.second);
-        } else {
-            serializer.AddLogTag(tag.first, tag.second);
-        }
-    }
-    res = std::move(serializer.GetResult());
-
-    // when function stablize, remove the following logic
-    if (BOOL_FLAG(debug_sls_serializer)) {
-        sls_logs::LogGroup logGroup;
-        if (!logGroup.ParseFromString(res)) {
-            JsonEventGroupSerializer ser(const_cast<Flusher*>(mFlusher));
-            string jsonStr;
-            ser.DoSerialize(std::move(group), jsonStr, errorMsg);
-            LOG_ERROR(sLogger,
-                      ("failed to parse log group", jsonStr)("config", mFlusher->GetContext().GetConfigName()));
-            return false;
-        }
-    }
     return true;
 }
 
 void SLSEventGroupSerializer::CalculateLogEventSize(const BatchedEvents& group,
                                                     size_t& logGroupSZ,
                                                     std::vector<size_t>& logSZ,
-                                                    bool enableNs) const {
+                                                    bool enableNs) {
     for (size_t i = 0; i < group.mEvents.size(); ++i) {
         const auto& e = group.mEvents[i].Cast<LogEvent>();
         if (e.Empty()) {
@@ -183,15 +198,16 @@ void SLSEventGroupSerializer::CalculateLogEventSize(const BatchedEvents& group,
 
 void SLSEventGroupSerializer::CalculateMetricEventSize(
     const BatchedEvents& group,
+    const CollectionPipelineContext& ctx,
     size_t& logGroupSZ,
     std::vector<MetricEventContentCacheItem>& metricEventContentCache,
-    std::vector<size_t>& logSZ) const {
+    std::vector<size_t>& logSZ) {
     for (size_t i = 0; i < group.mEvents.size(); ++i) {
         const auto& e = group.mEvents[i].Cast<MetricEvent>();
         if (e.GetTimestamp() < 1e9) {
             LOG_WARNING(sLogger,
                         ("metric event timestamp is less than 1e9", "discard event")("timestamp", e.GetTimestamp())(
-                            "config", mFlusher->GetContext().GetConfigName()));
+                            "config", ctx.GetConfigName()));
             continue;
         }
         if (e.Is<UntypedSingleValue>()) {
@@ -209,8 +225,7 @@ void SLSEventGroupSerializer::CalculateMetricEventSize(
         } else if (e.Is<UntypedMultiDoubleValues>()) {
             if (e.GetValue<UntypedMultiDoubleValues>()->ValuesSize() == 0) {
                 LOG_WARNING(sLogger,
-                            ("metric event multi value is empty",
-                             "discard event")("config", mFlusher->GetContext().GetConfigName()));
+                            ("metric event multi value is empty", "discard event")("config", ctx.GetConfigName()));
                 continue;
             }
             size_t contentSZ = 0;
@@ -228,9 +243,7 @@ void SLSEventGroupSerializer::CalculateMetricEventSize(
             }
             logGroupSZ += GetLogSize(contentSZ, false, logSZ[i]);
         } else {
-            LOG_WARNING(
-                sLogger,
-                ("invalid metric event type", "discard event")("config", mFlusher->GetContext().GetConfigName()));
+            LOG_WARNING(sLogger, ("invalid metric event type", "discard event")("config", ctx.GetConfigName()));
             continue;
         }
     }
@@ -239,7 +252,7 @@ void SLSEventGroupSerializer::CalculateMetricEventSize(
 void SLSEventGroupSerializer::CalculateSpanEventSize(const BatchedEvents& group,
                                                      size_t& logGroupSZ,
                                                      std::vector<std::array<std::string, 6>>& spanEventContentCache,
-                                                     std::vector<size_t>& logSZ) const {
+                                                     std::vector<size_t>& logSZ) {
     for (size_t i = 0; i < group.mEvents.size(); ++i) {
         const auto& e = group.mEvents[i].Cast<SpanEvent>();
         size_t contentSZ = 0;
@@ -287,7 +300,7 @@ void SLSEventGroupSerializer::CalculateSpanEventSize(const BatchedEvents& group,
 void SLSEventGroupSerializer::CalculateRawEventSize(const BatchedEvents& group,
                                                     size_t& logGroupSZ,
                                                     std::vector<size_t>& logSZ,
-                                                    bool enableNs) const {
+                                                    bool enableNs) {
     for (size_t i = 0; i < group.mEvents.size(); ++i) {
         const auto& e = group.mEvents[i].Cast<RawEvent>();
         size_t contentSZ = GetLogContentSize(DEFAULT_CONTENT_KEY.size(), e.GetContent().size());
@@ -298,7 +311,7 @@ void SLSEventGroupSerializer::CalculateRawEventSize(const BatchedEvents& group,
 void SLSEventGroupSerializer::SerializeLogEvent(LogGroupSerializer& serializer,
                                                 const BatchedEvents& group,
                                                 std::vector<size_t>& logSZ,
-                                                bool enableNs) const {
+                                                bool enableNs) {
     for (size_t i = 0; i < group.mEvents.size(); ++i) {
         const auto& e = group.mEvents[i].Cast<LogEvent>();
         if (e.Empty()) {
@@ -336,8 +349,9 @@ void SLSEventGroupSerializer::SerializeLogEvent(LogGroupSerializer& serializer,
 //      value2: 456
 void SLSEventGroupSerializer::SerializeMetricEvent(LogGroupSerializer& serializer,
                                                    BatchedEvents& group,
+                                                   const CollectionPipelineContext& ctx,
                                                    std::vector<MetricEventContentCacheItem>& metricEventContentCache,
-                                                   std::vector<size_t>& logSZ) const {
+                                                   std::vector<size_t>& logSZ) {
     for (size_t i = 0; i < group.mEvents.size(); ++i) {
         auto& e = group.mEvents[i].Cast<MetricEvent>();
         if (e.GetTimestamp() < 1e9) {
@@ -347,7 +361,7 @@ void SLSEventGroupSerializer::SerializeMetricEvent(LogGroupSerializer& serialize
             if (metricEventContentCache[i].mMetricEventContentCache.empty()) {
                 LOG_ERROR(sLogger,
                           ("metric event single value size mismatch", "should never happen")(
-                              "config", mFlusher->GetContext().GetConfigName())("expected", 1)("actual", 0));
+                              "config", ctx.GetConfigName())("expected", 1)("actual", 0));
                 continue;
             }
             serializer.StartToAddLog(logSZ[i]);
@@ -362,7 +376,7 @@ void SLSEventGroupSerializer::SerializeMetricEvent(LogGroupSerializer& serialize
             if (metricEventContentCache[i].mMetricEventContentCache.size() != multiValue->ValuesSize()) {
                 LOG_ERROR(sLogger,
                           ("metric event multi value size mismatch", "should never happen")(
-                              "config", mFlusher->GetContext().GetConfigName())("expected", multiValue->ValuesSize())(
+                              "config", ctx.GetConfigName())("expected", multiValue->ValuesSize())(
                               "actual", metricEventContentCache[i].mMetricEventContentCache.size()));
                 continue;
             }
@@ -387,7 +401,7 @@ void SLSEventGroupSerializer::SerializeMetricEvent(LogGroupSerializer& serialize
 void SLSEventGroupSerializer::SerializeSpanEvent(LogGroupSerializer& serializer,
                                                  const BatchedEvents& group,
                                                  std::vector<std::array<std::string, 6>>& spanEventContentCache,
-                                                 std::vector<size_t>& logSZ) const {
+                                                 std::vector<size_t>& logSZ) {
     for (size_t i = 0; i < group.mEvents.size(); ++i) {
         const auto& spanEvent = group.mEvents[i].Cast<SpanEvent>();
 
@@ -423,7 +437,7 @@ void SLSEventGroupSerializer::SerializeSpanEvent(LogGroupSerializer& serializer,
 void SLSEventGroupSerializer::SerializeRawEvent(LogGroupSerializer& serializer,
                                                 const BatchedEvents& group,
                                                 std::vector<size_t>& logSZ,
-                                                bool enableNs) const {
+                                                bool enableNs) {
     for (size_t i = 0; i < group.mEvents.size(); ++i) {
         const auto& e = group.mEvents[i].Cast<RawEvent>();
         serializer.StartToAddLog(logSZ[i]);
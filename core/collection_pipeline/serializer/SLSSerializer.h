@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -33,42 +34,52 @@ class SLSEventGroupSerializer : public Serializer<BatchedEvents> {
 public:
     SLSEventGroupSerializer(Flusher* f) : Serializer<BatchedEvents>(f) {}
 
+    // Serializes the events of @group into @serializer in sls LogGroup format, with room reserved for @tagsSZ bytes of
+    // group level fields, which are then added by the caller. Also used to hand off event groups to Go pipelines.
+    static bool SerializeEvents(BatchedEvents& group,
+                                const CollectionPipelineContext& ctx,
+                                size_t tagsSZ,
+                                LogGroupSerializer& serializer,
+                                std::string& errorMsg);
+
 private:
     bool Serialize(BatchedEvents&& p, std::string& res, std::string& errorMsg) override;
 
-    void CalculateLogEventSize(const BatchedEvents& group,
-                               size_t& logGroupSZ,
-                               std::vector<size_t>& logSZ,
-                               bool enableNs) const;
-    void CalculateMetricEventSize(const BatchedEvents& group,
-                                  size_t& logGroupSZ,
-                                  std::vector<MetricEventContentCacheItem>& metricEventContentCache,
-                                  std::vector<size_t>& logSZ) const;
-    void CalculateSpanEventSize(const BatchedEvents& group,
-                                size_t& logGroupSZ,
-                                std::vector<std::array<std::string, 6>>& spanEventContentCache,
-                                std::vector<size_t>& logSZ) const;
-    void CalculateRawEventSize(const BatchedEvents& group,
-                               size_t& logGroupSZ,
-                               std::vector<size_t>& logSZ,
-                               bool enableNs) const;
-
-    void SerializeLogEvent(LogGroupSerializer& serializer,
-                           const BatchedEvents& group,
-                           std::vector<size_t>& logSZ,
-                           bool enableNs) const;
-    void SerializeMetricEvent(LogGroupSerializer& serializer,
-                              BatchedEvents& group,
-                              std::vector<MetricEventContentCacheItem>& metricEventContentCache,
-                              std::vector<size_t>& logSZ) const;
-    void SerializeSpanEvent(LogGroupSerializer& serializer,
-                            const BatchedEvents& group,
-                            std::vector<std::array<std::string, 6>>& spanEventContentCache,
-                            std::vector<size_t>& logSZ) const;
-    void SerializeRawEvent(LogGroupSerializer& serializer,
-                           const BatchedEvents& group,
-                           std::vector<size_t>& logSZ,
-                           bool enableNs) const;
+    static void CalculateLogEventSize(const BatchedEvents& group,
+                                      size_t& logGroupSZ,
+                                      std::vector<size_t>& logSZ,
+                                      bool enableNs);
+    static void CalculateMetricEventSize(const BatchedEvents& group,
+                                         const CollectionPipelineContext& ctx,
+                                         size_t& logGroupSZ,
+                                         std::vector<MetricEventContentCacheItem>& metricEventContentCache,
+                                         std::vector<size_t>& logSZ);
+    static void CalculateSpanEventSize(const BatchedEvents& group,
+                                       size_t& logGroupSZ,
+                                       std::vector<std::array<std::string, 6>>& spanEventContentCache,
+                                       std::vector<size_t>& logSZ);
+    static void CalculateRawEventSize(const BatchedEvents& group,
+                                      size_t& logGroupSZ,
+                                      std::vector<size_t>& logSZ,
+                                      bool enableNs);
+
+    static void SerializeLogEvent(LogGroupSerializer& serializer,
+                                  const BatchedEvents& group,
+                                  std::vector<size_t>& logSZ,
+                                  bool enableNs);
+    static void SerializeMetricEvent(LogGroupSerializer& serializer,
+                                     BatchedEvents& group,
+                                     const CollectionPipelineContext& ctx,
+                                     std::vector<MetricEventContentCacheItem>& metricEventContentCache,
+                                     std::vector<size_t>& logSZ);
+    static void SerializeSpanEvent(LogGroupSerializer& serializer,
+                                   const BatchedEvents& group,
+                                   std::vector<std::array<std::string, 6>>& spanEventContentCache,
+                                   std::vector<size_t>& logSZ);
+    static void SerializeRawEvent(LogGroupSerializer& serializer,
+                                  const BatchedEvents& group,
+                                  std::vector<size_t>& logSZ,
+                                  bool enableNs);
 };
 
 struct CompressedLogGroup {
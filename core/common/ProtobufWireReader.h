@@ -0,0 +1,126 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "common/StringView.h"
+
+namespace logtail {
+
+// Reads fields of a serialized protobuf message in place, for hot paths where building the protobuf objects costs
+// too much. All views returned point into the data being read.
+// see for detail: https://protobuf.dev/programming-guides/encoding/
+class ProtobufWireReader {
+public:
+    enum WireType : uint32_t { kVarint = 0, kFixed64 = 1, kLengthDelimited = 2, kFixed32 = 5 };
+
+    explicit ProtobufWireReader(StringView data) : mCur(data.data()), mEnd(data.data() + data.size()) {}
+
+    bool Done() const { return mCur == mEnd; }
+    size_t Remaining() const { return mEnd - mCur; }
+
+    bool ReadTag(uint32_t& field, uint32_t& wireType) {
+        uint64_t tag = 0;
+        if (!ReadVarint(tag) || (tag >> 3) == 0 || (tag >> 3) > UINT32_MAX) {
+            return false;
+        }
+        field = static_cast<uint32_t>(tag >> 3);
+        wireType = static_cast<uint32_t>(tag & 0x7);
+        return true;
+    }
+
+    bool ReadVarint(uint64_t& value) {
+        value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7) {
+            if (mCur == mEnd) {
+                return false;
+            }
+            uint8_t byte = static_cast<uint8_t>(*mCur++);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ReadFixed64(uint64_t& value) {
+        if (mEnd - mCur < 8) {
+            return false;
+        }
+        value = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            value |= static_cast<uint64_t>(static_cast<uint8_t>(mCur[i])) << (i * 8);
+        }
+        mCur += 8;
+        return true;
+    }
+
+    bool ReadDouble(double& value) {
+        uint64_t bits = 0;
+        if (!ReadFixed64(bits)) {
+            return false;
+        }
+        memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    bool ReadLengthDelimited(StringView& value) {
+        uint64_t len = 0;
+        if (!ReadVarint(len) || len > static_cast<uint64_t>(mEnd - mCur)) {
+            return false;
+        }
+        value = StringView(mCur, len);
+        mCur += len;
+        return true;
+    }
+
+    bool Skip(uint32_t wireType) {
+        uint64_t unused = 0;
+        StringView unusedView;
+        switch (wireType) {
+            case kVarint:
+                return ReadVarint(unused);
+            case kFixed64:
+                return ReadFixed64(unused);
+            case kLengthDelimited:
+                return ReadLengthDelimited(unusedView);
+            case kFixed32:
+                if (mEnd - mCur < 4) {
+                    return false;
+                }
+                mCur += 4;
+                return true;
+            default:
+                // groups are deprecated
+                return false;
+        }
+    }
+
+    // sint32 and sint64 are zigzag encoded
+    static int64_t DecodeZigZag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+private:
+    const char* mCur = nullptr;
+    const char* mEnd = nullptr;
+};
+
+} // namespace logtail
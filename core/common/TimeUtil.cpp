@@ -24,6 +24,8 @@
 #include <ctime>
 #include <sys/sysinfo.h>
 #include <utmp.h>
+#elif defined(_MSC_VER)
+#include <Windows.h>
 #endif
 #include "common/LogtailCommonFlags.h"
 #include "common/ParamExtractor.h"
@@ -369,6 +371,29 @@ uint64_t GetCurrentTimeInNanoSeconds() {
         .count();
 }
 
+uint64_t GetCurrentThreadCpuTimeInNanoSeconds() {
+#if defined(__linux__)
+    struct timespec ts {};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#elif defined(_MSC_VER)
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    ULARGE_INTEGER kernel, user;
+    kernel.LowPart = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+    user.LowPart = userTime.dwLowDateTime;
+    user.HighPart = userTime.dwHighDateTime;
+    // in 100ns, updated on each clock tick
+    return (kernel.QuadPart + user.QuadPart) * 100;
+#else
+    // TODO: support other platforms
+    return 0;
+#endif
+}
+
 bool ParseTimeZoneOffsetSecond(const std::string& logTZ, int& logTZSecond) {
     if (logTZ.size() != strlen("GMT+08:00") || logTZ[6] != ':' || (logTZ[3] != '+' && logTZ[3] != '-')) {
         return false;
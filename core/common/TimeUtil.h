@@ -50,6 +50,19 @@ uint64_t GetCurrentTimeInMicroSeconds();
 uint64_t GetCurrentTimeInMilliSeconds();
 uint64_t GetCurrentTimeInNanoSeconds();
 
+// Whether the cpu time consumed by a thread can be measured on this platform.
+constexpr bool IsThreadCpuTimeSupported() {
+#if defined(__linux__) || defined(_MSC_VER)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Get cpu time consumed by the calling thread in ns, always 0 if IsThreadCpuTimeSupported() is false. On Windows, it
+// is only updated on each clock tick.
+uint64_t GetCurrentThreadCpuTimeInNanoSeconds();
+
 // Get offset between current time zone and UTC in seconds.
 // For example, for UTC+8, returns 8*60*60.
 int GetLocalTimeZoneOffsetSecond();
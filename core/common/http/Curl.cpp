@@ -30,10 +30,16 @@
 #include "common/DNSCache.h"
 #include "common/Flags.h"
 #include "common/StringTools.h"
+#include "common/http/CurlHandlePool.h"
 #include "common/http/HttpRequest.h"
 #include "common/http/HttpResponse.h"
 #include "logger/Logger.h"
 
+DEFINE_FLAG_BOOL(enable_curl_http2,
+                 "negotiate http/2 via alpn for https requests, so that concurrent requests to the same endpoint are "
+                 "multiplexed over one connection",
+                 false);
+
 using namespace std;
 
 namespace logtail {
@@ -135,7 +141,7 @@ CURL* CreateCurlHandler(const string& method,
 ) {
     static DnsCache* dnsCache = DnsCache::GetInstance();
 
-    CURL* curl = curl_easy_init();
+    CURL* curl = CurlHandlePool::GetInstance()->Acquire(CurlHandlePool::GetEndpoint(httpsFlag, host, port));
     if (curl == nullptr) {
         return nullptr;
     }
@@ -172,6 +178,11 @@ CURL* CreateCurlHandler(const string& method,
     if (httpsFlag) {
         curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
         curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
+        if (BOOL_FLAG(enable_curl_http2)) {
+            // falls back to http/1.1 if libcurl is built without http/2 or the server does not support it
+            curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+            curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+        }
     }
 
     if (tls.has_value()) {
@@ -266,7 +277,8 @@ bool SendHttpRequest(unique_ptr<HttpRequest>&& request, HttpResponse& response)
     if (headers != NULL) {
         curl_slist_free_all(headers);
     }
-    curl_easy_cleanup(curl);
+    CurlHandlePool::GetInstance()->Release(
+        CurlHandlePool::GetEndpoint(request->mHTTPSFlag, request->mHost, request->mPort), curl);
     return success;
 }
 
@@ -305,8 +317,9 @@ bool AddRequestToMultiCurlHandler(CURLM* multiCurl, unique_ptr<AsynHttpRequest>&
         LOG_ERROR(sLogger,
                   ("failed to send request", "failed to add the easy curl handle to multi_handle")(
                       "errMsg", curl_multi_strerror(res))("request address", request.get()));
+        CurlHandlePool::GetInstance()->Release(
+            CurlHandlePool::GetEndpoint(request->mHTTPSFlag, request->mHost, request->mPort), curl);
         request->OnSendDone(request->mResponse);
-        curl_easy_cleanup(curl);
         return false;
     }
     // let callback destruct the request
@@ -323,6 +336,8 @@ void HandleCompletedAsynRequests(CURLM* multiCurl, int& runningHandlers) {
             CURL* handler = msg->easy_handle;
             AsynHttpRequest* request = nullptr;
             curl_easy_getinfo(handler, CURLINFO_PRIVATE, &request);
+            // the request may be destructed during retry
+            auto endpoint = CurlHandlePool::GetEndpoint(request->mHTTPSFlag, request->mHost, request->mPort);
             switch (msg->data.result) {
                 case CURLE_OK: {
                     long statusCode = 0;
@@ -369,7 +384,7 @@ void HandleCompletedAsynRequests(CURLM* multiCurl, int& runningHandlers) {
             }
 
             curl_multi_remove_handle(multiCurl, handler);
-            curl_easy_cleanup(handler);
+            CurlHandlePool::GetInstance()->Release(endpoint, handler);
             if (!requestReused) {
                 if (request->mPrivateData) {
                     curl_slist_free_all((curl_slist*)request->mPrivateData);
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/http/CurlHandlePool.h"
+
+#include <algorithm>
+
+#include "common/Flags.h"
+#include "logger/Logger.h"
+
+DEFINE_FLAG_INT32(curl_max_idle_handles_per_endpoint,
+                  "max number of idle curl handles kept for each endpoint, 0 means handles are not reused",
+                  16);
+DEFINE_FLAG_INT32(curl_max_idle_handles, "max number of idle curl handles kept for all endpoints", 1024);
+
+using namespace std;
+
+namespace logtail {
+
+CurlHandlePool::CurlHandlePool()
+    : mMaxIdleCntPerEndpoint(max(INT32_FLAG(curl_max_idle_handles_per_endpoint), 0)),
+      mMaxIdleCnt(max(INT32_FLAG(curl_max_idle_handles), 0)) {
+    mShare = curl_share_init();
+    if (mShare == nullptr) {
+        LOG_WARNING(sLogger, ("failed to init curl share handle", "dns cache and tls sessions will not be shared"));
+        return;
+    }
+    curl_share_setopt(mShare, CURLSHOPT_LOCKFUNC, LockShare);
+    curl_share_setopt(mShare, CURLSHOPT_UNLOCKFUNC, UnlockShare);
+    curl_share_setopt(mShare, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(mShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(mShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    // the connection cache is not shared, since a shared cache serializes all transfers of all multi handles on one
+    // lock. connections are reused via the idle handles of each endpoint and the own cache of each multi handle.
+}
+
+CurlHandlePool::~CurlHandlePool() {
+    Clear();
+    if (mShare != nullptr) {
+        // handles still in use keep the share handle alive, which is fine on exit
+        curl_share_cleanup(mShare);
+    }
+}
+
+string CurlHandlePool::GetEndpoint(bool httpsFlag, const string& host, int32_t port) {
+    string endpoint = httpsFlag ? "https://" : "http://";
+    return endpoint.append(host).append(":").append(to_string(port));
+}
+
+CURL* CurlHandlePool::Acquire(const string& endpoint) {
+    {
+        lock_guard<mutex> lock(mMux);
+        auto it = mIdleHandles.find(endpoint);
+        if (it != mIdleHandles.end() && !it->second.empty()) {
+            CURL* handle = it->second.back();
+            it->second.pop_back();
+            --mIdleCnt;
+            return handle;
+        }
+    }
+    CURL* handle = curl_easy_init();
+    if (handle != nullptr && mShare != nullptr) {
+        curl_easy_setopt(handle, CURLOPT_SHARE, mShare);
+    }
+    return handle;
+}
+
+void CurlHandlePool::Release(const string& endpoint, CURL* handle) {
+    if (handle == nullptr) {
+        return;
+    }
+    // options are reset to default, while live connections, tls sessions and the share handle are kept
+    curl_easy_reset(handle);
+    {
+        lock_guard<mutex> lock(mMux);
+        if (mMaxIdleCntPerEndpoint > 0 && mIdleCnt < mMaxIdleCnt) {
+            auto& handles = mIdleHandles[endpoint];
+            if (handles.size() < mMaxIdleCntPerEndpoint) {
+                handles.push_back(handle);
+                ++mIdleCnt;
+                return;
+            }
+        }
+    }
+    curl_easy_cleanup(handle);
+}
+
+void CurlHandlePool::Clear() {
+    unordered_map<string, vector<CURL*>> handles;
+    {
+        lock_guard<mutex> lock(mMux);
+        handles.swap(mIdleHandles);
+        mIdleCnt = 0;
+    }
+    for (auto& item : handles) {
+        for (auto* handle : item.second) {
+            curl_easy_cleanup(handle);
+        }
+    }
+}
+
+size_t CurlHandlePool::IdleCount() const {
+    lock_guard<mutex> lock(mMux);
+    return mIdleCnt;
+}
+
+void CurlHandlePool::LockShare(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<CurlHandlePool*>(userptr)->mShareMuxes[data].lock();
+}
+
+void CurlHandlePool::UnlockShare(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<CurlHandlePool*>(userptr)->mShareMuxes[data].unlock();
+}
+
+} // namespace logtail
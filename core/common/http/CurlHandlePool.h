@@ -0,0 +1,77 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "curl/curl.h"
+
+namespace logtail {
+
+// Keeps idle easy handles of each endpoint for reuse, so that the live connection and TLS session kept in the handle
+// survive between requests, and attaches all handles to one share handle, which shares DNS cache and TLS sessions
+// across handles and threads. Connections are not shared, so that multi handles keep their own connection caches.
+class CurlHandlePool {
+public:
+    CurlHandlePool(const CurlHandlePool&) = delete;
+    CurlHandlePool& operator=(const CurlHandlePool&) = delete;
+
+    static CurlHandlePool* GetInstance() {
+        static CurlHandlePool sInstance;
+        return &sInstance;
+    }
+
+    static std::string GetEndpoint(bool httpsFlag, const std::string& host, int32_t port);
+
+    // the returned handle has default options except for the share handle
+    CURL* Acquire(const std::string& endpoint);
+    // the handle must have been removed from any multi handle
+    void Release(const std::string& endpoint, CURL* handle);
+    void Clear();
+
+    size_t IdleCount() const;
+
+private:
+    CurlHandlePool();
+    ~CurlHandlePool();
+
+    static void LockShare(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void UnlockShare(CURL* handle, curl_lock_data data, void* userptr);
+
+    size_t mMaxIdleCntPerEndpoint = 0;
+    size_t mMaxIdleCnt = 0;
+
+    CURLSH* mShare = nullptr;
+    std::array<std::mutex, CURL_LOCK_DATA_LAST> mShareMuxes;
+
+    mutable std::mutex mMux;
+    std::unordered_map<std::string, std::vector<CURL*>> mIdleHandles;
+    size_t mIdleCnt = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class CurlUnittest;
+    friend class CurlBenchmark;
+#endif
+};
+
+} // namespace logtail
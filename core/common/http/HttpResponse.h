@@ -42,6 +42,8 @@ enum NetworkCode {
     SendDataFailed,
     RecvDataFailed,
     Timeout,
+    // aborted by the low speed limit before the timeout
+    LowSpeed,
     Other
 };
 
@@ -102,7 +104,7 @@ public:
     void SetResponseTime(const std::chrono::milliseconds& time) { mResponseTime = time; }
     std::chrono::milliseconds GetResponseTime() const { return mResponseTime; }
 
-    const NetworkStatus& GetNetworkStatus() { return mNetworkStatus; }
+    const NetworkStatus& GetNetworkStatus() const { return mNetworkStatus; }
     void SetNetworkStatus(NetworkCode code, const std::string& msg) {
         mNetworkStatus.mCode = code;
         mNetworkStatus.mMessage = msg;
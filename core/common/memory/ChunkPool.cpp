@@ -0,0 +1,264 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/memory/ChunkPool.h"
+
+#include <algorithm>
+
+#include "common/Flags.h"
+#include "logger/Logger.h"
+
+DEFINE_FLAG_INT32(source_buffer_chunk_pool_max_mb, "max size of idle source buffer chunks shared by threads", 64);
+
+using namespace std;
+
+namespace logtail {
+
+// bytes of idle chunks each thread caches for a class
+static constexpr size_t kThreadCacheBytesPerClass = 128 * 1024;
+// bytes of idle chunks each thread caches for all classes
+static constexpr size_t kThreadCacheMaxBytes = 1024 * 1024;
+
+enum class ThreadCacheState : uint8_t { NONE, ALIVE, DESTRUCTED };
+// trivially destructible, so that it can still be read after the thread cache is destructed on thread exit
+static thread_local ThreadCacheState sThreadCacheState = ThreadCacheState::NONE;
+
+ChunkPool::ThreadCache::ThreadCache() {
+    auto* pool = ChunkPool::GetInstance();
+    lock_guard<mutex> lock(pool->mThreadCacheMux);
+    pool->mThreadCaches.push_back(this);
+}
+
+ChunkPool::ThreadCache::~ThreadCache() {
+    sThreadCacheState = ThreadCacheState::DESTRUCTED;
+    auto* pool = ChunkPool::GetInstance();
+    {
+        lock_guard<mutex> lock(pool->mThreadCacheMux);
+        pool->mThreadCaches.erase(find(pool->mThreadCaches.begin(), pool->mThreadCaches.end(), this));
+    }
+    mBytes = 0;
+    for (size_t i = 0; i < sClassCount; ++i) {
+        pool->Release(i, mChunks[i], mChunks[i].size());
+    }
+}
+
+uint8_t* ChunkPool::Allocate(size_t& size) {
+    if (size > sMaxChunkSize) {
+        return new uint8_t[size];
+    }
+    size_t index = GetClassIndex(size);
+    size = GetClassSize(index);
+
+    auto* cache = GetThreadCache();
+    if (cache == nullptr) {
+        vector<uint8_t*> chunks;
+        return Fetch(index, chunks, 1) > 0 ? chunks[0] : new uint8_t[size];
+    }
+    lock_guard<mutex> lock(cache->mMux);
+    cache->mIsUsedSinceTrim = true;
+    auto& chunks = cache->mChunks[index];
+    if (chunks.empty()) {
+        // the chunks fetched in batch, except for the one returned, must fit in the thread cache
+        size_t bytes = cache->mBytes.load(memory_order_relaxed);
+        size_t count = min((GetThreadCacheCapacity(index) + 1) / 2, (kThreadCacheMaxBytes - bytes) / size + 1);
+        count = Fetch(index, chunks, count);
+        if (count == 0) {
+            return new uint8_t[size];
+        }
+        cache->mBytes.store(bytes + count * size, memory_order_relaxed);
+    }
+    auto* chunk = chunks.back();
+    chunks.pop_back();
+    cache->mBytes.store(cache->mBytes.load(memory_order_relaxed) - size, memory_order_relaxed);
+    return chunk;
+}
+
+void ChunkPool::Free(uint8_t* chunk, size_t size) {
+    if (size > sMaxChunkSize) {
+        delete[] chunk;
+        return;
+    }
+    size_t index = GetClassIndex(size);
+
+    auto* cache = GetThreadCache();
+    if (cache == nullptr) {
+        vector<uint8_t*> chunks{chunk};
+        Release(index, chunks, 1);
+        return;
+    }
+    lock_guard<mutex> lock(cache->mMux);
+    cache->mIsUsedSinceTrim = true;
+    auto& chunks = cache->mChunks[index];
+    chunks.push_back(chunk);
+    size_t classSize = GetClassSize(index);
+    size_t bytes = cache->mBytes.load(memory_order_relaxed) + classSize;
+    size_t capacity = GetThreadCacheCapacity(index);
+    if (chunks.size() > capacity || bytes > kThreadCacheMaxBytes) {
+        // the thread cache was within the limit before the chunk is added, so releasing one chunk is enough
+        size_t count = max(chunks.size() - min(chunks.size(), capacity / 2), static_cast<size_t>(1));
+        bytes -= count * classSize;
+        // released chunks are no longer counted as cached by the thread when the cap is checked
+        cache->mBytes.store(bytes, memory_order_relaxed);
+        Release(index, chunks, count);
+        return;
+    }
+    cache->mBytes.store(bytes, memory_order_relaxed);
+}
+
+void ChunkPool::Trim() {
+    TrimThreadCaches();
+    vector<uint8_t*> chunks;
+    size_t freedBytes = 0;
+    {
+        lock_guard<mutex> lock(mMux);
+        for (size_t i = 0; i < sClassCount; ++i) {
+            // chunks are taken from and returned to the back, so those at the front have been idle for the longest
+            auto& list = mChunks[i];
+            size_t count = min(mLowWatermarks[i], list.size());
+            chunks.insert(chunks.end(), list.begin(), list.begin() + count);
+            list.erase(list.begin(), list.begin() + count);
+            list.shrink_to_fit();
+            mLowWatermarks[i] = list.size();
+            freedBytes += count * GetClassSize(i);
+        }
+        mIdleBytes.store(mIdleBytes.load(memory_order_relaxed) - freedBytes, memory_order_relaxed);
+    }
+    for (auto* chunk : chunks) {
+        delete[] chunk;
+    }
+    if (!chunks.empty()) {
+        LOG_INFO(sLogger,
+                 ("idle source buffer chunks freed, cnt", chunks.size())("bytes", freedBytes)("remaining idle bytes",
+                                                                                              GetIdleBytes()));
+    }
+}
+
+size_t ChunkPool::GetIdleBytes() const {
+    return mIdleBytes.load(memory_order_relaxed) + GetThreadCachedBytes();
+}
+
+size_t ChunkPool::GetClassIndex(size_t size) {
+    if (size <= sMinChunkSize) {
+        return 0;
+    }
+    // 2^shift < size <= 2^(shift+1), which is split into 4 classes
+    size_t shift = 10;
+    while ((static_cast<size_t>(2) << shift) < size) {
+        ++shift;
+    }
+    return (shift - 10) * 4 + ((size - 1 - (static_cast<size_t>(1) << shift)) >> (shift - 2)) + 1;
+}
+
+size_t ChunkPool::GetClassSize(size_t index) {
+    if (index == 0) {
+        return sMinChunkSize;
+    }
+    size_t shift = 10 + (index - 1) / 4;
+    return (static_cast<size_t>(1) << shift) + (((index - 1) % 4 + 1) << (shift - 2));
+}
+
+size_t ChunkPool::GetThreadCacheCapacity(size_t index) {
+    return max(kThreadCacheBytesPerClass / GetClassSize(index), static_cast<size_t>(2));
+}
+
+ChunkPool::ThreadCache* ChunkPool::GetThreadCache() {
+    if (sThreadCacheState == ThreadCacheState::DESTRUCTED) {
+        return nullptr;
+    }
+    static thread_local ThreadCache sCache;
+    sThreadCacheState = ThreadCacheState::ALIVE;
+    return &sCache;
+}
+
+size_t ChunkPool::Fetch(size_t index, vector<uint8_t*>& chunks, size_t count) {
+    lock_guard<mutex> lock(mMux);
+    auto& list = mChunks[index];
+    count = min(count, list.size());
+    chunks.insert(chunks.end(), list.end() - count, list.end());
+    list.resize(list.size() - count);
+    mLowWatermarks[index] = min(mLowWatermarks[index], list.size());
+    mIdleBytes.store(mIdleBytes.load(memory_order_relaxed) - count * GetClassSize(index), memory_order_relaxed);
+    return count;
+}
+
+void ChunkPool::Release(size_t index, vector<uint8_t*>& chunks, size_t count) {
+    size_t size = GetClassSize(index);
+    size_t maxIdleBytes = static_cast<size_t>(max(INT32_FLAG(source_buffer_chunk_pool_max_mb), 0)) * 1024 * 1024;
+    // chunks cached by threads count against the cap as well
+    size_t threadCachedBytes = GetThreadCachedBytes();
+    auto begin = chunks.end() - count;
+    auto it = begin;
+    {
+        lock_guard<mutex> lock(mMux);
+        auto& list = mChunks[index];
+        size_t idleBytes = mIdleBytes.load(memory_order_relaxed);
+        for (; it != chunks.end() && threadCachedBytes + idleBytes + size <= maxIdleBytes; ++it) {
+            list.push_back(*it);
+            idleBytes += size;
+        }
+        mIdleBytes.store(idleBytes, memory_order_relaxed);
+    }
+    // beyond the cap
+    for (; it != chunks.end(); ++it) {
+        delete[] *it;
+    }
+    chunks.erase(begin, chunks.end());
+}
+
+size_t ChunkPool::GetThreadCachedBytes() const {
+    lock_guard<mutex> lock(mThreadCacheMux);
+    size_t bytes = 0;
+    for (const auto* cache : mThreadCaches) {
+        bytes += cache->mBytes.load(memory_order_relaxed);
+    }
+    return bytes;
+}
+
+void ChunkPool::TrimThreadCaches() {
+    vector<uint8_t*> chunks;
+    size_t freedBytes = 0;
+    {
+        lock_guard<mutex> lock(mThreadCacheMux);
+        for (auto* cache : mThreadCaches) {
+            // a locked cache is being used by its thread. besides, waiting for it here may deadlock with its thread,
+            // which checks the cap with the cache locked.
+            unique_lock<mutex> cacheLock(cache->mMux, try_to_lock);
+            if (!cacheLock.owns_lock()) {
+                continue;
+            }
+            if (cache->mIsUsedSinceTrim) {
+                cache->mIsUsedSinceTrim = false;
+                continue;
+            }
+            for (auto& list : cache->mChunks) {
+                chunks.insert(chunks.end(), list.begin(), list.end());
+                list.clear();
+                list.shrink_to_fit();
+            }
+            freedBytes += cache->mBytes.load(memory_order_relaxed);
+            cache->mBytes.store(0, memory_order_relaxed);
+        }
+    }
+    for (auto* chunk : chunks) {
+        delete[] chunk;
+    }
+    if (!chunks.empty()) {
+        LOG_INFO(sLogger,
+                 ("idle source buffer chunks cached by threads freed, cnt", chunks.size())("bytes", freedBytes));
+    }
+}
+
+} // namespace logtail
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace logtail {
+
+// Recycles the memory chunks of source buffers, so that the chunks released by a group once it is sent are reused by
+// the groups read later, instead of going back and forth between the heap and the allocators.
+//
+// Chunks are grouped into size classes, four for each power of two from 1KB to 1MB, so that at most a quarter of a
+// chunk is wasted by rounding. Larger chunks are not pooled. Each thread caches a few idle chunks of each class, up to
+// 1MB in total, and moves them to the shared lists in batches, since chunks are usually allocated by inputs and
+// released by flushers. The idle chunks, including those cached by threads, are capped, and those staying idle during
+// a whole trim period are freed, as well as all chunks cached by threads not using the pool during the period, so
+// that the pool shrinks after a burst of data.
+class ChunkPool {
+public:
+    static constexpr size_t sMinChunkSize = 1024;
+    static constexpr size_t sMaxChunkSize = 1024 * 1024;
+
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+
+    // never destructed, since source buffers may be released after static objects are destructed
+    static ChunkPool* GetInstance() {
+        static ChunkPool* sInstance = new ChunkPool();
+        return sInstance;
+    }
+
+    // @size is rounded up to the size of the class, which is the capacity of the chunk returned
+    uint8_t* Allocate(size_t& size);
+    // @size must be the capacity returned by Allocate
+    void Free(uint8_t* chunk, size_t size);
+    // frees the chunks in the shared lists which have not been used since the last call
+    void Trim();
+
+    // bytes of idle chunks, including those cached by threads
+    size_t GetIdleBytes() const;
+
+private:
+    static constexpr size_t sClassCount = 41;
+
+    struct ThreadCache {
+        ThreadCache();
+        ~ThreadCache();
+
+        // locked by the owner thread on each allocation and free, and by Trim only when not locked
+        std::mutex mMux;
+        std::array<std::vector<uint8_t*>, sClassCount> mChunks;
+        // only written with mMux held, but read by other threads for the cap
+        std::atomic_size_t mBytes = 0;
+        bool mIsUsedSinceTrim = false;
+    };
+
+    ChunkPool() = default;
+    ~ChunkPool() = default;
+
+    static size_t GetClassIndex(size_t size);
+    static size_t GetClassSize(size_t index);
+    static size_t GetThreadCacheCapacity(size_t index);
+    static ThreadCache* GetThreadCache();
+
+    // moves at most @count chunks of the class from the shared list to @chunks, returns the number of chunks moved
+    size_t Fetch(size_t index, std::vector<uint8_t*>& chunks, size_t count);
+    // moves the last @count chunks of @chunks to the shared list of the class, and frees those beyond the cap
+    void Release(size_t index, std::vector<uint8_t*>& chunks, size_t count);
+    size_t GetThreadCachedBytes() const;
+    // frees the chunks of thread caches which have not been used since the last call
+    void TrimThreadCaches();
+
+    std::mutex mMux;
+    std::array<std::vector<uint8_t*>, sClassCount> mChunks;
+    // the least number of idle chunks of each class since the last trim
+    std::array<size_t, sClassCount> mLowWatermarks{};
+    // bytes of idle chunks in the shared lists
+    std::atomic_size_t mIdleBytes = 0;
+
+    mutable std::mutex mThreadCacheMux;
+    std::vector<ThreadCache*> mThreadCaches;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ChunkPoolUnittest;
+#endif
+};
+
+} // namespace logtail
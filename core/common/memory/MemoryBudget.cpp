@@ -0,0 +1,122 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/memory/MemoryBudget.h"
+
+#include "logger/Logger.h"
+#include "monitor/MetricManager.h"
+#include "monitor/metric_constants/MetricConstants.h"
+
+using namespace std;
+
+namespace logtail {
+
+namespace {
+
+struct PipelineUsage {
+    MetricsRecordRef mMetricsRecordRef;
+    IntGaugePtr mUsageBytes;
+};
+
+} // namespace
+
+int64_t MemoryBudget::GetUsage() const {
+    int64_t usage = 0;
+    for (const auto& item : mUsages) {
+        usage += item.load(memory_order_relaxed);
+    }
+    return usage;
+}
+
+bool MemoryBudget::IsExceeded() {
+    int64_t limit = GetLimit();
+    if (limit <= 0) {
+        mIsExceeded.store(false, memory_order_relaxed);
+        return false;
+    }
+    int64_t usage = GetUsage();
+    if (mIsExceeded.load(memory_order_relaxed)) {
+        if (usage < limit / 10 * 9 && mIsExceeded.exchange(false)) {
+            LOG_INFO(sLogger, ("memory budget recovered", "inputs resumed")("usage", usage)("limit", limit));
+        }
+    } else if (usage >= limit && !mIsExceeded.exchange(true)) {
+        LOG_WARNING(sLogger,
+                    ("memory budget exceeded", "inputs throttled and sender queues spilled")("usage", usage)(
+                        "source buffer", GetUsage(Category::SOURCE_BUFFER))(
+                        "sender queue item", GetUsage(Category::SENDER_QUEUE_ITEM))("limit", limit));
+    }
+    return mIsExceeded.load(memory_order_relaxed);
+}
+
+bool MemoryBudget::IsExceeded(const string& configName) {
+    if (!IsExceeded()) {
+        return false;
+    }
+    int64_t usage = 0;
+    int64_t totalUsage = 0;
+    int64_t pipelineCnt = 0;
+    {
+        lock_guard<mutex> lock(mPipelineUsageMux);
+        for (const auto& item : mPipelineUsages) {
+            auto gauge = item.second.lock();
+            if (!gauge) {
+                continue;
+            }
+            auto value = static_cast<int64_t>(gauge->GetValue());
+            if (item.first == configName) {
+                usage = value;
+            }
+            totalUsage += value;
+            ++pipelineCnt;
+        }
+    }
+    if (pipelineCnt == 0 || totalUsage < GetUsage() / 2) {
+        return true;
+    }
+    // the pipeline buffering the most is always throttled
+    return usage * pipelineCnt >= totalUsage;
+}
+
+IntGaugePtr MemoryBudget::GetPipelineUsage(const string& configName) {
+    lock_guard<mutex> lock(mPipelineUsageMux);
+    auto& item = mPipelineUsages[configName];
+    auto gauge = item.lock();
+    if (gauge) {
+        return gauge;
+    }
+    auto usage = make_shared<PipelineUsage>();
+    WriteMetrics::GetInstance()->CreateMetricsRecordRef(
+        usage->mMetricsRecordRef,
+        MetricCategory::METRIC_CATEGORY_COMPONENT,
+        {{METRIC_LABEL_KEY_PIPELINE_NAME, configName},
+         {METRIC_LABEL_KEY_COMPONENT_NAME, METRIC_LABEL_VALUE_COMPONENT_NAME_MEMORY_BUDGET}});
+    usage->mUsageBytes = usage->mMetricsRecordRef.CreateIntGauge(METRIC_COMPONENT_MEMORY_USAGE_BYTES);
+    WriteMetrics::GetInstance()->CommitMetricsRecordRef(usage->mMetricsRecordRef);
+    // the gauge keeps the metrics record alive, which is deleted once all components of the pipeline are gone
+    gauge = IntGaugePtr(usage, usage->mUsageBytes.get());
+    item = gauge;
+
+    for (auto it = mPipelineUsages.begin(); it != mPipelineUsages.end();) {
+        if (it->second.expired()) {
+            it = mPipelineUsages.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return gauge;
+}
+
+} // namespace logtail
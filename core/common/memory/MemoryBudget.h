@@ -0,0 +1,100 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "monitor/metric_models/MetricTypes.h"
+
+namespace logtail {
+
+// Accounts the bytes of data flowing through pipelines against a global budget derived from the memory limit of the
+// agent, so that inputs back off before the memory limit is hit, instead of the agent being restarted by the monitor.
+//
+// Only two kinds of allocations are charged, which together hold nearly all data in flight without counting any byte
+// twice: chunks of source buffers, holding the events of groups in process queues, processors and batchers, and the
+// serialized data of sender queue items. Once the usage reaches the budget, spillable sender queues move new items to
+// disk, and process queues of the pipelines holding the most data refuse new data, so that their file readers,
+// prometheus scrapes and forward inputs stop producing, while other pipelines go on. Both last until the usage drops
+// below 90% of the budget.
+//
+// To tell the pipelines apart, the data buffered in the queues and batchers of each pipeline is charged to a
+// per-pipeline gauge, and the bytes charged by each thread are counted.
+class MemoryBudget {
+public:
+    enum class Category { SOURCE_BUFFER, SENDER_QUEUE_ITEM, COUNT };
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    static MemoryBudget* GetInstance() {
+        static MemoryBudget sInstance;
+        return &sInstance;
+    }
+
+    void Add(Category category, int64_t bytes) {
+        mUsages[static_cast<size_t>(category)].fetch_add(bytes, std::memory_order_relaxed);
+        sThreadAllocatedBytes += bytes;
+    }
+    void Sub(Category category, int64_t bytes) {
+        mUsages[static_cast<size_t>(category)].fetch_sub(bytes, std::memory_order_relaxed);
+    }
+    int64_t GetUsage(Category category) const {
+        return mUsages[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+    int64_t GetUsage() const;
+
+    // 0 means unlimited
+    void SetLimit(int64_t bytes) { mLimit.store(bytes, std::memory_order_relaxed); }
+    int64_t GetLimit() const { return mLimit.load(std::memory_order_relaxed); }
+    bool IsExceeded();
+    // whether inputs of the pipeline should back off, i.e., the budget is exceeded and the pipeline buffers at least
+    // the average of all pipelines. if most of the usage is not buffered by any pipeline, all pipelines back off.
+    bool IsExceeded(const std::string& configName);
+
+    // bytes charged by the calling thread so far, which are accounted to pipelines
+    static uint64_t GetThreadAllocatedBytes() { return sThreadAllocatedBytes; }
+
+    // the gauge is shared by all queues and batchers of the pipeline, and survives config updates of the pipeline
+    IntGaugePtr GetPipelineUsage(const std::string& configName);
+
+private:
+    MemoryBudget() = default;
+    ~MemoryBudget() = default;
+
+    static inline thread_local uint64_t sThreadAllocatedBytes = 0;
+
+    std::array<std::atomic_int64_t, static_cast<size_t>(Category::COUNT)> mUsages{};
+    std::atomic_int64_t mLimit = 0;
+    std::atomic_bool mIsExceeded = false;
+
+    std::mutex mPipelineUsageMux;
+    std::unordered_map<std::string, std::weak_ptr<IntGauge>> mPipelineUsages;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class MemoryBudgetUnittest;
+#endif
+};
+
+} // namespace logtail
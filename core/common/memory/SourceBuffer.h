@@ -18,9 +18,12 @@
 
 #include <list>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "common/StringView.h"
+#include "common/memory/ChunkPool.h"
+#include "common/memory/MemoryBudget.h"
 
 namespace logtail {
 
@@ -50,33 +53,48 @@ private:
 public:
     explicit BufferAllocator(uint32_t firstChunkSize = 4096, uint32_t chunkSizeLimit = 1024 * 128)
         : mFirstChunkSize(firstChunkSize), mChunkSizeLimit(chunkSizeLimit), mChunkSize(firstChunkSize) {
-        mAllocPtr = new uint8_t[mChunkSize];
-        mAllocatedChunks.push_back(mAllocPtr);
-        mFreeBytesInChunk = mChunkSize;
-        mAllocated = mChunkSize;
+        size_t capacity = mChunkSize;
+        mAllocPtr = ChunkPool::GetInstance()->Allocate(capacity);
+        mAllocatedChunks.emplace_back(mAllocPtr, capacity);
+        mFreeBytesInChunk = capacity;
+        mAllocated = capacity;
+        MemoryBudget::GetInstance()->Add(MemoryBudget::Category::SOURCE_BUFFER, mAllocated);
     }
 
     BufferAllocator(const BufferAllocator&) = delete;
     BufferAllocator& operator=(const BufferAllocator&) = delete;
 
     BufferAllocator(BufferAllocator&&) = default;
-    BufferAllocator& operator=(BufferAllocator&&) = default;
-
-    ~BufferAllocator() {
-        for (size_t i = 0; i < mAllocatedChunks.size(); i++) {
-            delete[] mAllocatedChunks[i];
+    BufferAllocator& operator=(BufferAllocator&& rhs) noexcept {
+        if (this != &rhs) {
+            // the chunks of this allocator are released rather than leaked
+            FreeChunks();
+            mFirstChunkSize = rhs.mFirstChunkSize;
+            mChunkSizeLimit = rhs.mChunkSizeLimit;
+            mAllocatedChunks = std::move(rhs.mAllocatedChunks);
+            rhs.mAllocatedChunks.clear();
+            mAllocated = rhs.mAllocated;
+            mUsed = rhs.mUsed;
+            mAllocPtr = rhs.mAllocPtr;
+            mFreeBytesInChunk = rhs.mFreeBytesInChunk;
+            mChunkSize = rhs.mChunkSize;
         }
+        return *this;
     }
 
+    ~BufferAllocator() { FreeChunks(); }
+
     void Reset(void) {
+        size_t firstChunkCapacity = mAllocatedChunks[0].second;
+        MemoryBudget::GetInstance()->Sub(MemoryBudget::Category::SOURCE_BUFFER, mAllocated - firstChunkCapacity);
         for (size_t i = 1; i < mAllocatedChunks.size(); i++) {
-            delete[] mAllocatedChunks[i];
+            ChunkPool::GetInstance()->Free(mAllocatedChunks[i].first, mAllocatedChunks[i].second);
         }
         mAllocatedChunks.resize(1);
-        mAllocPtr = mAllocatedChunks[0];
+        mAllocPtr = mAllocatedChunks[0].first;
         mChunkSize = mFirstChunkSize;
-        mFreeBytesInChunk = mChunkSize;
-        mAllocated = mChunkSize;
+        mFreeBytesInChunk = firstChunkCapacity;
+        mAllocated = firstChunkCapacity;
         mUsed = 0;
     }
 
@@ -93,6 +111,17 @@ public:
     int64_t GetAllocatedSize() const { return mAllocated + mAllocatedChunks.size() * sizeof(void*); }
 
 private:
+    void FreeChunks() {
+        // a moved-from allocator owns no chunk
+        if (!mAllocatedChunks.empty()) {
+            MemoryBudget::GetInstance()->Sub(MemoryBudget::Category::SOURCE_BUFFER, mAllocated);
+        }
+        for (size_t i = 0; i < mAllocatedChunks.size(); i++) {
+            ChunkPool::GetInstance()->Free(mAllocatedChunks[i].first, mAllocatedChunks[i].second);
+        }
+        mAllocatedChunks.clear();
+    }
+
     // Please do not make it public, user should always use Allocate() to get a better performance.
     // If you have a strong reason to do it, please drop a email to me: shiquan.yangsq@aliyun-inc.com
     uint8_t* Alloc(uint32_t bytes) {
@@ -109,9 +138,16 @@ private:
              * will not be so large. Thus, it is wise to allocate it directly
              * from heap in order to avoid polluting chunk size.
              */
-            mem = new uint8_t[bytes];
-            mAllocatedChunks.push_back(mem);
-            mAllocated += bytes;
+            size_t capacity = bytes;
+            mem = ChunkPool::GetInstance()->Allocate(capacity);
+            mAllocatedChunks.emplace_back(mem, capacity);
+            mAllocated += capacity;
+            MemoryBudget::GetInstance()->Add(MemoryBudget::Category::SOURCE_BUFFER, capacity);
+            // the space left by rounding up to the size class is used if it is more than that in the current chunk
+            if (capacity - bytes > mFreeBytesInChunk) {
+                mAllocPtr = mem + bytes;
+                mFreeBytesInChunk = capacity - bytes;
+            }
         } else {
             /*
              * Here we intentionally waste some space in the current chunk.
@@ -119,11 +155,13 @@ private:
             if (mChunkSize < mChunkSizeLimit) {
                 mChunkSize *= 2;
             }
-            mem = new uint8_t[mChunkSize];
-            mAllocatedChunks.push_back(mem);
+            size_t capacity = mChunkSize;
+            mem = ChunkPool::GetInstance()->Allocate(capacity);
+            mAllocatedChunks.emplace_back(mem, capacity);
             mAllocPtr = mem + bytes;
-            mFreeBytesInChunk = mChunkSize - bytes;
-            mAllocated += mChunkSize;
+            mFreeBytesInChunk = capacity - bytes;
+            mAllocated += capacity;
+            MemoryBudget::GetInstance()->Add(MemoryBudget::Category::SOURCE_BUFFER, capacity);
         }
 
         mUsed += bytes;
@@ -134,8 +172,8 @@ private:
     uint32_t mFirstChunkSize = 4096;
     uint32_t mChunkSizeLimit = 1024 * 128;
 
-    // The allocated memory chunks
-    std::vector<uint8_t*> mAllocatedChunks;
+    // The allocated memory chunks and their capacities
+    std::vector<std::pair<uint8_t*, size_t>> mAllocatedChunks;
     // Statistics data
     uint64_t mAllocated = 0;
     uint64_t mUsed = 0;
@@ -14,12 +14,28 @@
 
 #include "common/timer/Timer.h"
 
+#include <algorithm>
+
+#include "common/Flags.h"
 #include "logger/Logger.h"
 
+DEFINE_FLAG_INT32(timer_shard_num, "number of timing wheels of the timer, each guarded by its own lock", 8);
+DEFINE_FLAG_INT32(timer_worker_thread_num,
+                  "number of threads executing due timer events, 0 means executing in the timer thread",
+                  0);
+
 using namespace std;
 
 namespace logtail {
 
+Timer::Timer() : mStartTime(chrono::steady_clock::now()) {
+    size_t shardNum = static_cast<size_t>(max(1, INT32_FLAG(timer_shard_num)));
+    mShards.reserve(shardNum);
+    for (size_t i = 0; i < shardNum; ++i) {
+        mShards.emplace_back(make_unique<Shard>());
+    }
+}
+
 Timer::~Timer() {
     Stop();
 }
@@ -30,6 +46,10 @@ void Timer::Init() {
             return;
         }
     }
+    mWorkerThreadRes.clear();
+    for (int32_t i = 0; i < INT32_FLAG(timer_worker_thread_num); ++i) {
+        mWorkerThreadRes.emplace_back(async(launch::async, &Timer::RunWorker, this));
+    }
     mThreadRes = async(launch::async, &Timer::Run, this);
 }
 
@@ -39,11 +59,23 @@ void Timer::Stop() {
             return;
         }
     }
-    mCV.notify_one();
+    {
+        lock_guard<mutex> lock(mWakeMux);
+        mCV.notify_one();
+    }
+    {
+        lock_guard<mutex> lock(mWorkerMux);
+        mWorkerCV.notify_all();
+    }
     if (!mThreadRes.valid()) {
         return;
     }
     future_status s = mThreadRes.wait_for(chrono::seconds(1));
+    for (auto& res : mWorkerThreadRes) {
+        if (s == future_status::ready) {
+            s = res.wait_for(chrono::seconds(1));
+        }
+    }
     if (s == future_status::ready) {
         LOG_INFO(sLogger, ("timer", "stopped successfully"));
     } else {
@@ -52,51 +84,156 @@ void Timer::Stop() {
 }
 
 void Timer::PushEvent(unique_ptr<TimerEvent>&& e) {
-    lock_guard<mutex> lock(mQueueMux);
-    if (mQueue.empty() || e->GetExecTime() < mQueue.top()->GetExecTime()) {
-        mQueue.push(std::move(e));
-        mCV.notify_one();
-    } else {
-        mQueue.push(std::move(e));
+    uint64_t tick = ToTick(e->GetExecTime());
+    auto& shard = *mShards[mNextShard.fetch_add(1, memory_order_relaxed) % mShards.size()];
+    {
+        lock_guard<mutex> lock(shard.mMux);
+        shard.mWheel.Add(std::move(e), tick);
+    }
+    // the timer thread is only notified when the event is due earlier than its next wake-up
+    if (tick < mNextTick.load()) {
+        lock_guard<mutex> lock(mWakeMux);
+        if (tick < mNextTick.load()) {
+            mNextTick.store(tick);
+            mCV.notify_one();
+        }
     }
 }
 
 void Timer::Run() {
     LOG_INFO(sLogger, ("timer", "started"));
+    vector<unique_ptr<TimerEvent>> expired;
     while (mIsThreadRunning.load()) {
-        unique_lock<mutex> queueLock(mQueueMux);
-        if (mQueue.empty()) {
-            mCV.wait(queueLock, [this]() { return !mIsThreadRunning.load() || !mQueue.empty(); });
+        // events pushed while collecting may be missed by NextTick, which then must notify
+        mNextTick.store(TimingWheel::kMaxTick);
+        uint64_t now = CurrentTick();
+        uint64_t next = TimingWheel::kMaxTick;
+        for (auto& shard : mShards) {
+            lock_guard<mutex> lock(shard->mMux);
+            shard->mWheel.Advance(now, expired);
+            next = min(next, shard->mWheel.NextTick());
+        }
+        {
+            lock_guard<mutex> lock(mWakeMux);
+            if (next < mNextTick.load()) {
+                mNextTick.store(next);
+            }
+        }
+        if (!expired.empty()) {
+            Dispatch(expired);
+            expired.clear();
+        }
+
+        unique_lock<mutex> lock(mWakeMux);
+        uint64_t planned = mNextTick.load();
+        if (planned <= CurrentTick()) {
+            continue;
+        }
+        auto pred = [this, planned]() { return !mIsThreadRunning.load() || mNextTick.load() < planned; };
+        if (planned == TimingWheel::kMaxTick) {
+            mCV.wait(lock, pred);
         } else {
-            auto now = chrono::steady_clock::now();
-            while (!mQueue.empty()) {
-                auto& e = mQueue.top();
-                if (now < e->GetExecTime()) {
-                    auto timeout = e->GetExecTime() - now + chrono::milliseconds(1);
-                    mCV.wait_for(queueLock, timeout);
-                    break;
-                } else {
-                    auto e = std::move(const_cast<unique_ptr<TimerEvent>&>(mQueue.top()));
-                    mQueue.pop();
-                    queueLock.unlock();
-                    if (!e->IsValid()) {
-                        LOG_INFO(sLogger, ("invalid timer event", "task is cancelled"));
-                    } else {
-                        e->Execute();
-                    }
-                    queueLock.lock();
-                }
+            mCV.wait_until(lock, ToTimePoint(planned), pred);
+        }
+    }
+}
+
+void Timer::RunWorker() {
+    while (true) {
+        unique_ptr<TimerEvent> e;
+        {
+            unique_lock<mutex> lock(mWorkerMux);
+            mWorkerCV.wait(lock, [this]() { return !mIsThreadRunning.load() || !mWorkerQueue.empty(); });
+            if (!mIsThreadRunning.load()) {
+                return;
             }
+            e = std::move(mWorkerQueue.front());
+            mWorkerQueue.pop_front();
         }
+        ExecuteEvent(e);
     }
 }
 
+void Timer::Dispatch(vector<unique_ptr<TimerEvent>>& events) {
+    // events from different wheels are interleaved
+    if (mShards.size() > 1) {
+        stable_sort(events.begin(),
+                    events.end(),
+                    [](const unique_ptr<TimerEvent>& lhs, const unique_ptr<TimerEvent>& rhs) {
+                        return lhs->GetExecTime() < rhs->GetExecTime();
+                    });
+    }
+    if (mWorkerThreadRes.empty()) {
+        for (auto& e : events) {
+            ExecuteEvent(e);
+        }
+        return;
+    }
+    {
+        lock_guard<mutex> lock(mWorkerMux);
+        for (auto& e : events) {
+            mWorkerQueue.emplace_back(std::move(e));
+        }
+    }
+    mWorkerCV.notify_all();
+}
+
+void Timer::ExecuteEvent(unique_ptr<TimerEvent>& e) {
+    if (!e->IsValid()) {
+        LOG_INFO(sLogger, ("invalid timer event", "task is cancelled"));
+    } else {
+        e->Execute();
+    }
+}
+
+uint64_t Timer::ToTick(chrono::steady_clock::time_point time) const {
+    if (time <= mStartTime) {
+        return 0;
+    }
+    auto elapsed = time - mStartTime;
+    auto tick = static_cast<uint64_t>(chrono::duration_cast<chrono::milliseconds>(elapsed) / kTick);
+    return ToTimePoint(tick) < time ? tick + 1 : tick;
+}
+
+uint64_t Timer::CurrentTick() const {
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - mStartTime)
+                                 / kTick);
+}
+
 #ifdef APSARA_UNIT_TEST_MAIN
 void Timer::Clear() {
-    lock_guard<mutex> lock(mQueueMux);
-    while (!mQueue.empty()) {
-        mQueue.pop();
+    for (auto& shard : mShards) {
+        lock_guard<mutex> lock(shard->mMux);
+        shard->mWheel.Clear();
+    }
+}
+
+size_t Timer::Size() const {
+    size_t size = 0;
+    for (auto& shard : mShards) {
+        lock_guard<mutex> lock(shard->mMux);
+        size += shard->mWheel.Size();
+    }
+    return size;
+}
+
+unique_ptr<TimerEvent> Timer::PopEarliest() {
+    unique_ptr<TimerEvent> res;
+    for (auto& shard : mShards) {
+        lock_guard<mutex> lock(shard->mMux);
+        auto e = shard->mWheel.PopEarliest();
+        if (e == nullptr) {
+            continue;
+        }
+        if (res == nullptr || e->GetExecTime() < res->GetExecTime()) {
+            swap(res, e);
+        }
+        if (e != nullptr) {
+            uint64_t tick = ToTick(e->GetExecTime());
+            shard->mWheel.Add(std::move(e), tick);
+        }
     }
+    return res;
 }
 #endif
 
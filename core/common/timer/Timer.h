@@ -16,22 +16,22 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <future>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <vector>
 
 #include "common/timer/TimerEvent.h"
+#include "common/timer/TimingWheel.h"
 
 namespace logtail {
 
-struct TimerEventCompare {
-    bool operator()(const std::unique_ptr<TimerEvent>& lhs, const std::unique_ptr<TimerEvent>& rhs) const {
-        return lhs->GetExecTime() > rhs->GetExecTime();
-    }
-};
-
+// Events are kept in several timing wheels, each guarded by its own lock, so that pushing events from many
+// schedulers rarely contends. The timer thread wakes up at the next due tick, collects all due events from the wheels
+// in one pass and executes them, or hands them over to the worker threads if timer_worker_thread_num is positive.
 class Timer {
 public:
     ~Timer();
@@ -49,19 +49,45 @@ public:
     void InitMetrics();
 #ifdef APSARA_UNIT_TEST_MAIN
     void Clear();
+    size_t Size() const;
+    std::unique_ptr<TimerEvent> PopEarliest();
 #endif
 
 private:
-    Timer() = default;
+    struct Shard {
+        std::mutex mMux;
+        TimingWheel mWheel;
+    };
+
+    static constexpr std::chrono::milliseconds kTick{1};
+
+    Timer();
     void Run();
+    void RunWorker();
+    void Dispatch(std::vector<std::unique_ptr<TimerEvent>>& events);
+    static void ExecuteEvent(std::unique_ptr<TimerEvent>& e);
+    // the first tick not earlier than @time, so that no event is executed before its exec time
+    uint64_t ToTick(std::chrono::steady_clock::time_point time) const;
+    uint64_t CurrentTick() const;
+    std::chrono::steady_clock::time_point ToTimePoint(uint64_t tick) const { return mStartTime + tick * kTick; }
 
-    mutable std::mutex mQueueMux;
-    std::priority_queue<std::unique_ptr<TimerEvent>, std::vector<std::unique_ptr<TimerEvent>>, TimerEventCompare>
-        mQueue;
+    std::chrono::steady_clock::time_point mStartTime;
+    std::vector<std::unique_ptr<Shard>> mShards;
+    std::atomic_size_t mNextShard = 0;
+
+    // the tick the timer thread is going to wake up at, which is set to max while collecting events so that any
+    // event pushed meanwhile notifies the timer thread
+    std::atomic<uint64_t> mNextTick = TimingWheel::kMaxTick;
+    mutable std::mutex mWakeMux;
+    mutable std::condition_variable mCV;
 
     std::future<void> mThreadRes;
     std::atomic_bool mIsThreadRunning = false;
-    mutable std::condition_variable mCV;
+
+    std::vector<std::future<void>> mWorkerThreadRes;
+    std::mutex mWorkerMux;
+    std::condition_variable mWorkerCV;
+    std::deque<std::unique_ptr<TimerEvent>> mWorkerQueue;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class TimerUnittest;
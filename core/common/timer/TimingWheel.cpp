@@ -0,0 +1,143 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/timer/TimingWheel.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace logtail {
+
+void TimingWheel::Add(unique_ptr<TimerEvent>&& e, uint64_t tick) {
+    Place(tick, std::move(e));
+    ++mSize;
+}
+
+void TimingWheel::Advance(uint64_t tick, vector<unique_ptr<TimerEvent>>& expired) {
+    auto collect = [&](Slot& slot) {
+        for (auto& item : slot) {
+            expired.emplace_back(std::move(item.second));
+        }
+        mSize -= slot.size();
+        slot.clear();
+    };
+
+    collect(mReady);
+    while (mCurrentTick < tick && mSize > 0) {
+        // empty slots are skipped without missing any cascade
+        mCurrentTick = min(NextTick(), tick);
+        if ((mCurrentTick & kSlotMask) == 0) {
+            Cascade();
+            collect(mReady);
+        }
+        collect(mSlots[0][mCurrentTick & kSlotMask]);
+    }
+    if (mCurrentTick < tick) {
+        mCurrentTick = tick;
+    }
+}
+
+uint64_t TimingWheel::NextTick() const {
+    if (!mReady.empty()) {
+        return mCurrentTick;
+    }
+    if (mSize == 0) {
+        return kMaxTick;
+    }
+    // the first populated slot after the current one, searched from the lowest level, where the start of a slot of
+    // higher levels is when it is cascaded
+    for (size_t level = 0; level < kLevelNum; ++level) {
+        size_t shift = kSlotBits * level;
+        for (uint64_t idx = ((mCurrentTick >> shift) & kSlotMask) + 1; idx < kSlotNum; ++idx) {
+            if (!mSlots[level][idx].empty()) {
+                return ((mCurrentTick >> (shift + kSlotBits)) << (shift + kSlotBits)) | (idx << shift);
+            }
+        }
+    }
+    return ((mCurrentTick >> (kSlotBits * kLevelNum)) + 1) << (kSlotBits * kLevelNum);
+}
+
+void TimingWheel::Clear() {
+    mReady.clear();
+    for (auto& level : mSlots) {
+        for (auto& slot : level) {
+            slot.clear();
+        }
+    }
+    mSize = 0;
+}
+
+void TimingWheel::Place(uint64_t tick, unique_ptr<TimerEvent>&& e) {
+    if (tick <= mCurrentTick) {
+        mReady.emplace_back(tick, std::move(e));
+        return;
+    }
+    for (size_t level = 0; level < kLevelNum; ++level) {
+        size_t shift = kSlotBits * (level + 1);
+        if ((tick >> shift) == (mCurrentTick >> shift)) {
+            mSlots[level][(tick >> (kSlotBits * level)) & kSlotMask].emplace_back(tick, std::move(e));
+            return;
+        }
+    }
+    // out of range, which is placed again when the next slot of the top level is cascaded
+    size_t topShift = kSlotBits * (kLevelNum - 1);
+    mSlots[kLevelNum - 1][((mCurrentTick >> topShift) + 1) & kSlotMask].emplace_back(tick, std::move(e));
+}
+
+void TimingWheel::Cascade() {
+    size_t level = 1;
+    while (level < kLevelNum && (mCurrentTick & ((uint64_t(1) << (kSlotBits * level)) - 1)) == 0) {
+        ++level;
+    }
+    // higher levels first, since their events may go to the slots of lower levels to be cascaded
+    for (size_t i = level - 1; i > 0; --i) {
+        mCascading.swap(mSlots[i][(mCurrentTick >> (kSlotBits * i)) & kSlotMask]);
+        for (auto& item : mCascading) {
+            Place(item.first, std::move(item.second));
+        }
+        mCascading.clear();
+    }
+}
+
+#ifdef APSARA_UNIT_TEST_MAIN
+unique_ptr<TimerEvent> TimingWheel::PopEarliest() {
+    Slot* target = nullptr;
+    size_t targetIdx = 0;
+    auto find = [&](Slot& slot) {
+        for (size_t i = 0; i < slot.size(); ++i) {
+            if (target == nullptr
+                || slot[i].second->GetExecTime() < (*target)[targetIdx].second->GetExecTime()) {
+                target = &slot;
+                targetIdx = i;
+            }
+        }
+    };
+    find(mReady);
+    for (auto& level : mSlots) {
+        for (auto& slot : level) {
+            find(slot);
+        }
+    }
+    if (target == nullptr) {
+        return nullptr;
+    }
+    auto e = std::move((*target)[targetIdx].second);
+    target->erase(target->begin() + targetIdx);
+    --mSize;
+    return e;
+}
+#endif
+
+} // namespace logtail
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <array>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/timer/TimerEvent.h"
+
+namespace logtail {
+
+// Hierarchical timing wheel with O(1) insertion. Level 0 has one slot per tick, and each slot of level n covers a
+// whole round of level n-1, whose events are moved down when the lower level wraps. Events beyond the range of the
+// top level are kept in its next slot and placed again when that slot is cascaded.
+// It is not thread-safe.
+class TimingWheel {
+public:
+    static constexpr uint64_t kMaxTick = std::numeric_limits<uint64_t>::max();
+
+    explicit TimingWheel(uint64_t currentTick = 0) : mCurrentTick(currentTick) {}
+
+    void Add(std::unique_ptr<TimerEvent>&& e, uint64_t tick);
+    // moves the wheel to @tick and appends all events due to @expired
+    void Advance(uint64_t tick, std::vector<std::unique_ptr<TimerEvent>>& expired);
+    // a lower bound of the tick of the next due event, which is kMaxTick if the wheel is empty
+    uint64_t NextTick() const;
+
+    uint64_t CurrentTick() const { return mCurrentTick; }
+    size_t Size() const { return mSize; }
+    bool Empty() const { return mSize == 0; }
+    void Clear();
+#ifdef APSARA_UNIT_TEST_MAIN
+    std::unique_ptr<TimerEvent> PopEarliest();
+#endif
+
+private:
+    static constexpr size_t kSlotBits = 8;
+    static constexpr size_t kSlotNum = 1 << kSlotBits;
+    static constexpr uint64_t kSlotMask = kSlotNum - 1;
+    static constexpr size_t kLevelNum = 4;
+
+    using Slot = std::vector<std::pair<uint64_t, std::unique_ptr<TimerEvent>>>;
+
+    void Place(uint64_t tick, std::unique_ptr<TimerEvent>&& e);
+    void Cascade();
+
+    uint64_t mCurrentTick = 0;
+    size_t mSize = 0;
+    // events already due when added
+    Slot mReady;
+    std::array<std::array<Slot, kSlotNum>, kLevelNum> mSlots;
+    // avoid reallocation when cascading
+    Slot mCascading;
+};
+
+} // namespace logtail
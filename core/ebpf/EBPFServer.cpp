@@ -21,6 +21,7 @@
 #include <utility>
 
 #include "app_config/AppConfig.h"
+#include "collection_pipeline/limiter/CpuGovernor.h"
 #include "common/Flags.h"
 #include "common/LogtailCommonFlags.h"
 #include "common/MachineInfoUtil.h"
@@ -148,7 +149,7 @@ EBPFServer::EBPFServer()
       mHostIp(GetHostIp()),
       mHostName(GetHostName()),
       mCommonEventQueue(8192),
-      mEventPool(true) {
+      mEventPool(true, EventPool::kDefaultMagazineSize) {
     mEnvMgr.InitEnvInfo();
 
     // read host path prefix
@@ -612,6 +613,8 @@ void EBPFServer::handlerEvents() {
         // handle ....
         handleEvents(items, count);
         sendEvents();
+        // events of all ebpf pipelines are handled together
+        CpuGovernor::GetInstance()->Acquire(CpuGovernor::sDefaultPriority);
     }
 }
 
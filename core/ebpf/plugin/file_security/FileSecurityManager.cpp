@@ -151,9 +151,11 @@ int FileSecurityManager::SendEvents() {
             auto sharedEvent = sharedEventGroup.CreateLogEvent(true, mEventPool);
             bool hit = processCacheMgr->AttachProcessData(group->mPid, group->mKtime, *sharedEvent, eventGroup);
 
+            size_t eventIdx = eventGroup.GetEvents().size();
+            eventGroup.AddLogEvents(group->mInnerEvents.size(), true, mEventPool);
             for (const auto& commonEvent : group->mInnerEvents) {
                 auto* innerEvent = static_cast<FileEvent*>(commonEvent.get());
-                auto* logEvent = eventGroup.AddLogEvent(true, mEventPool);
+                auto* logEvent = &eventGroup.MutableEvents()[eventIdx++].Cast<LogEvent>();
                 // attach process tags
                 for (const auto& it : *sharedEvent) {
                     logEvent->SetContentNoCopy(it.first, it.second);
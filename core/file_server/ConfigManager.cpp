@@ -237,17 +237,35 @@ void ConfigManager::RemoveHandler(const string& dir, bool delete_flag) {
 
 // this functions should only be called when register base dir
 bool ConfigManager::RegisterHandlers() {
+    vector<FileDiscoveryConfig> configs;
+    for (const auto& item : FileServer::GetInstance()->GetAllFileDiscoveryConfigs()) {
+        configs.push_back(item.second);
+    }
+    return RegisterHandlersOfConfigs(configs);
+}
+
+bool ConfigManager::RegisterHandlers(const unordered_set<string>& configNames) {
+    vector<FileDiscoveryConfig> configs;
+    for (const auto& name : configNames) {
+        auto config = FileServer::GetInstance()->GetFileDiscoveryConfig(name);
+        if (config.first) {
+            configs.push_back(config);
+        }
+    }
+    return RegisterHandlersOfConfigs(configs);
+}
+
+bool ConfigManager::RegisterHandlersOfConfigs(const vector<FileDiscoveryConfig>& configs) {
     if (mSharedHandler == NULL) {
         mSharedHandler = new NormalEventHandler();
     }
     vector<FileDiscoveryConfig> sortedConfigs;
     vector<FileDiscoveryConfig> wildcardConfigs;
-    auto nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
-    for (auto itr = nameConfigMap.begin(); itr != nameConfigMap.end(); ++itr) {
-        if (itr->second.first->GetWildcardPaths().empty())
-            sortedConfigs.push_back(itr->second);
+    for (auto itr = configs.begin(); itr != configs.end(); ++itr) {
+        if (itr->first->GetWildcardPaths().empty())
+            sortedConfigs.push_back(*itr);
         else
-            wildcardConfigs.push_back(itr->second);
+            wildcardConfigs.push_back(*itr);
     }
     sort(sortedConfigs.begin(), sortedConfigs.end(), FileDiscoveryOptions::CompareByPathLength);
     bool result = true;
@@ -618,42 +636,37 @@ FileDiscoveryConfig ConfigManager::FindBestMatch(const string& path, const strin
             }
         }
     }
-    const auto& nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
-    auto itr = nameConfigMap.begin();
+    vector<FileDiscoveryConfig> candidates;
+    FileServer::GetInstance()->GetFileDiscoveryMatchIndex().GetCandidates(path, name, candidates);
     FileDiscoveryConfig prevMatch(nullptr, nullptr);
     size_t prevLen = 0;
     size_t curLen = 0;
     uint32_t nameRepeat = 0;
     string logNameList;
     vector<FileDiscoveryConfig> multiConfigs;
-    for (; itr != nameConfigMap.end(); ++itr) {
-        const FileDiscoveryOptions* config = itr->second.first;
-        // // exclude __FUSE_CONFIG__
-        // if (itr->first == STRING_FLAG(fuse_customized_config_name)) {
-        //     continue;
-        // }
-
+    for (const auto& candidate : candidates) {
+        const FileDiscoveryOptions* config = candidate.first;
         bool match = config->IsMatch(path, name);
         if (match) {
             // if force multi config, do not send alarm
             if (!name.empty() && !config->mAllowingIncludedByMultiConfigs) {
                 nameRepeat++;
                 logNameList.append("logstore:");
-                logNameList.append(itr->second.second->GetLogstoreName());
+                logNameList.append(candidate.second->GetLogstoreName());
                 logNameList.append(",config:");
-                logNameList.append(itr->second.second->GetConfigName());
+                logNameList.append(candidate.second->GetConfigName());
                 logNameList.append(" ");
-                multiConfigs.push_back(itr->second);
+                multiConfigs.push_back(candidate);
             }
 
             // note: best config is the one which length is longest and create time is nearest
             curLen = config->GetBasePath().size();
             if (prevLen < curLen) {
-                prevMatch = itr->second;
+                prevMatch = candidate;
                 prevLen = curLen;
             } else if (prevLen == curLen && prevMatch.first) {
-                if (prevMatch.second->GetCreateTime() > itr->second.second->GetCreateTime()) {
-                    prevMatch = itr->second;
+                if (prevMatch.second->GetCreateTime() > candidate.second->GetCreateTime()) {
+                    prevMatch = candidate;
                     prevLen = curLen;
                 }
             }
@@ -708,18 +721,11 @@ int32_t ConfigManager::FindAllMatch(vector<FileDiscoveryConfig>& allConfig,
         }
     }
     bool alarmFlag = false;
-    auto nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
-    auto itr = nameConfigMap.begin();
-    for (; itr != nameConfigMap.end(); ++itr) {
-        const FileDiscoveryOptions* config = itr->second.first;
-        // // exclude __FUSE_CONFIG__
-        // if (itr->first == STRING_FLAG(fuse_customized_config_name)) {
-        //     continue;
-        // }
-
-        bool match = config->IsMatch(path, name);
-        if (match) {
-            allConfig.push_back(itr->second);
+    vector<FileDiscoveryConfig> candidates;
+    FileServer::GetInstance()->GetFileDiscoveryMatchIndex().GetCandidates(path, name, candidates);
+    for (const auto& candidate : candidates) {
+        if (candidate.first->IsMatch(path, name)) {
+            allConfig.push_back(candidate);
         }
     }
 
@@ -756,21 +762,15 @@ int32_t ConfigManager::FindMatchWithForceFlag(std::vector<FileDiscoveryConfig>&
             }
         }
     }
-    auto nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
-    auto itr = nameConfigMap.begin();
+    vector<FileDiscoveryConfig> candidates;
+    FileServer::GetInstance()->GetFileDiscoveryMatchIndex().GetCandidates(path, name, candidates);
     FileDiscoveryConfig prevMatch = make_pair(nullptr, nullptr);
     size_t prevLen = 0;
     size_t curLen = 0;
     uint32_t nameRepeat = 0;
     string logNameList;
     vector<FileDiscoveryConfig> multiConfigs;
-    for (; itr != nameConfigMap.end(); ++itr) {
-        FileDiscoveryConfig config = itr->second;
-        // // exclude __FUSE_CONFIG__
-        // if (itr->first == STRING_FLAG(fuse_customized_config_name)) {
-        //     continue;
-        // }
-
+    for (const auto& config : candidates) {
         bool match = config.first->IsMatch(path, name);
         if (match) {
             // if force multi config, do not send alarm
@@ -20,6 +20,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -254,6 +255,8 @@ public:
     void RegisterWildcardPath(const FileDiscoveryConfig& config, const std::string& path, int32_t depth);
     bool RegisterHandlers(const std::string& basePath, const FileDiscoveryConfig& config);
     bool RegisterHandlers();
+    // only register base dirs of @configNames, used when the handlers of other configs are kept on config update
+    bool RegisterHandlers(const std::unordered_set<std::string>& configNames);
     bool RegisterHandlersRecursively(const std::string& dir, const FileDiscoveryConfig& config, bool checkTimeout);
     // 废弃，蚂蚁
     // /**
@@ -502,6 +505,7 @@ private:
                                      int preservedDirDepth,
                                      int maxDepth);
     bool RegisterDescendants(const std::string& path, const FileDiscoveryConfig& config, int withinDepth);
+    bool RegisterHandlersOfConfigs(const std::vector<FileDiscoveryConfig>& configs);
     // bool CheckLogType(const std::string& logTypeStr, LogType& logType);
     // 废弃
     // std::vector<std::string> GetStringVector(const Json::Value& value);
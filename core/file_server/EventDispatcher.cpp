@@ -28,6 +28,9 @@
 #include <limits.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <vector>
 
 #include "app_config/AppConfig.h"
@@ -84,6 +87,10 @@ DEFINE_FLAG_INT32(existed_file_active_timeout,
 DEFINE_FLAG_INT32(checkpoint_find_max_cache_size, "", 100000);
 DEFINE_FLAG_INT32(max_watch_dir_count, "", 100 * 1000);
 DEFINE_FLAG_INT32(default_max_inotify_watch_num, "the max allowed inotify watch dir number", 3000);
+DEFINE_FLAG_INT32(checkpoint_restore_thread_count,
+                  "number of threads to stat files and check signatures for checkpoints on startup, and events of "
+                  "recently modified files are pushed first if larger than 1",
+                  1);
 
 namespace logtail {
 
@@ -407,7 +414,10 @@ void EventDispatcher::AddExistedFileEvents(const string& path, int wd) {
 }
 
 EventDispatcher::ValidateCheckpointResult EventDispatcher::validateCheckpoint(
-    CheckPointPtr& checkpoint, map<DevInode, SplitedFilePath>& cachePathDevInodeMap, vector<Event*>& eventVec) {
+    CheckPointPtr& checkpoint,
+    map<DevInode, SplitedFilePath>& cachePathDevInodeMap,
+    vector<Event*>& eventVec,
+    const CheckpointFileState* prefetchedState) {
     shared_ptr<CollectionPipeline> config
         = CollectionPipelineManager::GetInstance()->FindConfigByName(checkpoint->mConfigName);
     if (config == NULL) {
@@ -473,9 +483,12 @@ EventDispatcher::ValidateCheckpointResult EventDispatcher::validateCheckpoint(
     }
 
     int wd = pathIter->second;
-    DevInode devInode = GetFileDevInode(realFilePath);
+    DevInode devInode = prefetchedState ? prefetchedState->mDevInode : GetFileDevInode(realFilePath);
     if (devInode.IsValid() && checkpoint->mDevInode.inode == devInode.inode) {
-        if (!CheckFileSignature(realFilePath, checkpoint->mSignatureHash, checkpoint->mSignatureSize)) {
+        bool sigMatched = prefetchedState
+            ? prefetchedState->mSigMatched
+            : CheckFileSignature(realFilePath, checkpoint->mSignatureHash, checkpoint->mSignatureSize);
+        if (!sigMatched) {
             LOG_INFO(sLogger,
                      ("delete checkpoint", "file device & inode remains the same but signature has changed")(
                          "config", checkpoint->mConfigName)("log reader queue name", checkpoint->mFileName)(
@@ -621,11 +634,41 @@ void EventDispatcher::AddExistedCheckPointFileEvents() {
     LOG_INFO(sLogger, ("start to verify existed checkpoints, total checkpoint count", checkPointMap.size()));
     vector<CheckPointManager::CheckPointKey> deleteKeyVec;
     vector<Event*> eventVec;
-    for (auto iter = checkPointMap.begin(); iter != checkPointMap.end(); ++iter) {
-        auto const result = validateCheckpoint(iter->second, cachePathDevInodeMap, eventVec);
+    // stat and signature check are the slow part on nodes with many files, so do them in parallel beforehand.
+    // Reading the signature also brings the head of each file into page cache for the reader created later.
+    bool isParallel = INT32_FLAG(checkpoint_restore_thread_count) > 1;
+    vector<CheckpointFileState> states;
+    unordered_map<const Event*, int64_t> eventMtimes;
+    if (isParallel) {
+        auto start = GetCurrentTimeInMilliSeconds();
+        vector<const CheckPoint*> checkpoints;
+        checkpoints.reserve(checkPointMap.size());
+        for (const auto& item : checkPointMap) {
+            checkpoints.push_back(item.second.get());
+        }
+        size_t missingCnt = PrefetchCheckpointFileStates(checkpoints, states);
+        LOG_INFO(sLogger,
+                 ("prefetch checkpoint file states, thread count", INT32_FLAG(checkpoint_restore_thread_count))(
+                     "missing file count", missingCnt)("cost ms", GetCurrentTimeInMilliSeconds() - start));
+    }
+    size_t idx = 0;
+    for (auto iter = checkPointMap.begin(); iter != checkPointMap.end(); ++iter, ++idx) {
+        size_t eventCnt = eventVec.size();
+        auto const result
+            = validateCheckpoint(iter->second, cachePathDevInodeMap, eventVec, isParallel ? &states[idx] : nullptr);
         if (!(result == ValidateCheckpointResult::kNormal || result == ValidateCheckpointResult::kRotate)) {
             deleteKeyVec.push_back(iter->first);
         }
+        if (isParallel && eventVec.size() > eventCnt) {
+            int64_t mtime = states[idx].mMtime;
+            // the prefetched state is of the file at the original path, which is not the rotated one
+            fsutil::PathStat buf;
+            if (result == ValidateCheckpointResult::kRotate
+                && fsutil::PathStat::stat(iter->second->mRealFileName, buf)) {
+                mtime = buf.GetMtime();
+            }
+            eventMtimes[eventVec.back()] = mtime;
+        }
     }
     for (size_t i = 0; i < deleteKeyVec.size(); ++i) {
         checkPointMap.erase(deleteKeyVec[i]);
@@ -705,11 +748,77 @@ void EventDispatcher::AddExistedCheckPointFileEvents() {
     if (eventVec.size() > 0) {
         // Sort by Source/Object (length+alphabet) in event to adjust the order of rotating files.
         // eg. /log/a.log.10 -> /log/a.log.9 -> /log/a.log.8 -> ...
-        sort(eventVec.begin(), eventVec.end(), Event::CompareByFullPath);
+        if (isParallel) {
+            // Events of the same log reader queue share the same full path, so the order within a queue is kept,
+            // while queues with the most recently modified files are pushed first.
+            unordered_map<string, int64_t> queueMtimes;
+            for (const auto& item : eventMtimes) {
+                auto& mtime = queueMtimes[PathJoin(item.first->GetSource(), item.first->GetEventObject())];
+                mtime = max(mtime, item.second);
+            }
+            vector<pair<int64_t, Event*>> sortedEvents;
+            sortedEvents.reserve(eventVec.size());
+            for (auto* event : eventVec) {
+                auto it = queueMtimes.find(PathJoin(event->GetSource(), event->GetEventObject()));
+                sortedEvents.emplace_back(it == queueMtimes.end() ? 0 : it->second, event);
+            }
+            sort(sortedEvents.begin(), sortedEvents.end(), [](const auto& lhs, const auto& rhs) {
+                if (lhs.first != rhs.first) {
+                    return lhs.first > rhs.first;
+                }
+                return Event::CompareByFullPath(lhs.second, rhs.second);
+            });
+            for (size_t i = 0; i < sortedEvents.size(); ++i) {
+                eventVec[i] = sortedEvents[i].second;
+            }
+        } else {
+            sort(eventVec.begin(), eventVec.end(), Event::CompareByFullPath);
+        }
         LogInput::GetInstance()->PushEventQueue(eventVec);
     }
 }
 
+size_t EventDispatcher::PrefetchCheckpointFileStates(const vector<const CheckPoint*>& checkpoints,
+                                                     vector<CheckpointFileState>& states) {
+    states.clear();
+    states.resize(checkpoints.size());
+    atomic_size_t next(0);
+    atomic_size_t missingCnt(0);
+    auto fetch = [&]() {
+        for (size_t i = next++; i < checkpoints.size(); i = next++) {
+            const auto* checkpoint = checkpoints[i];
+            const string& realFilePath
+                = checkpoint->mRealFileName.empty() ? checkpoint->mFileName : checkpoint->mRealFileName;
+            auto& state = states[i];
+            fsutil::PathStat buf;
+            if (!fsutil::PathStat::stat(realFilePath, buf)) {
+                LOG_DEBUG(sLogger, ("call stat() on file fail", realFilePath)("error", strerror(errno)));
+                ++missingCnt;
+                continue;
+            }
+            state.mDevInode = buf.GetDevInode();
+            if (state.mDevInode.inode != checkpoint->mDevInode.inode) {
+                continue;
+            }
+            state.mMtime = buf.GetMtime();
+            state.mSigMatched
+                = CheckFileSignature(realFilePath, checkpoint->mSignatureHash, checkpoint->mSignatureSize);
+        }
+    };
+    // the caller thread is one of the workers
+    size_t threadCnt
+        = min(static_cast<size_t>(max(INT32_FLAG(checkpoint_restore_thread_count), 1)), checkpoints.size());
+    vector<future<void>> workerRes;
+    for (size_t i = 1; i < threadCnt; ++i) {
+        workerRes.emplace_back(async(launch::async, fetch));
+    }
+    fetch();
+    for (auto& res : workerRes) {
+        res.get();
+    }
+    return missingCnt;
+}
+
 bool EventDispatcher::AddTimeoutWatch(const string& path) {
     MapType<string, int>::Type::iterator itr = mPathWdMap.find(path);
     if (itr != mPathWdMap.end()) {
@@ -993,6 +1102,19 @@ void EventDispatcher::DumpAllHandlersMeta(bool remove) {
     LOG_INFO(sLogger, ("save log reader status", "succeeded"));
 }
 
+void EventDispatcher::DumpHandlersMetaOfConfigs(const unordered_set<string>& configNames) {
+    // the same handler may be shared by several dirs
+    unordered_set<EventHandler*> handlers;
+    for (auto it = mWdDirInfoMap.begin(); it != mWdDirInfoMap.end(); ++it) {
+        if (handlers.insert(it->second->mHandler).second) {
+            it->second->mHandler->RemoveModifyHandlers(configNames);
+        }
+    }
+    // readers of the removed handlers are not dumped again
+    DumpAllHandlersMeta(false);
+    LOG_INFO(sLogger, ("save log reader status", "succeeded")("config count", configNames.size()));
+}
+
 void EventDispatcher::ProcessHandlerTimeOut() {
     MapType<int, DirInfo*>::Type::iterator mapIter = mWdDirInfoMap.begin();
     for (; mapIter != mWdDirInfoMap.end(); ++mapIter) {
@@ -198,6 +198,9 @@ public:
     // virtual void ExtraWork() = 0;
 
     void DumpAllHandlersMeta(bool);
+    // dump and remove the readers of @configNames only, dir watches and readers of other configs are kept but dumped
+    // as well, since the checkpoint file is rewritten as a whole
+    void DumpHandlersMetaOfConfigs(const std::unordered_set<std::string>& configNames);
     std::vector<std::pair<std::string, EventHandler*> > FindAllSubDirAndHandler(const std::string& baseDir);
     void UnregisterAllDir(const std::string& basePath);
     bool IsRegistered(int wd, std::string& path);
@@ -248,9 +251,20 @@ protected:
         kCacheFull,
         kDevInodeNotFound
     };
+    // state of the file recorded in a checkpoint, fetched in parallel on startup
+    struct CheckpointFileState {
+        DevInode mDevInode;
+        // only valid when the inode is not changed
+        bool mSigMatched = false;
+        int64_t mMtime = 0;
+    };
     ValidateCheckpointResult validateCheckpoint(CheckPointPtr& checkpoint,
                                                 std::map<DevInode, SplitedFilePath>& cachePathDevInodeMap,
-                                                std::vector<Event*>& eventVec);
+                                                std::vector<Event*>& eventVec,
+                                                const CheckpointFileState* prefetchedState = nullptr);
+    // @return number of files that cannot be found
+    size_t PrefetchCheckpointFileStates(const std::vector<const CheckPoint*>& checkpoints,
+                                        std::vector<CheckpointFileState>& states);
 
     // int mListenFd;
     int mWatchNum;
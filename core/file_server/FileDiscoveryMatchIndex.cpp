@@ -0,0 +1,135 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "file_server/FileDiscoveryMatchIndex.h"
+
+#if defined(__linux__)
+#include <fnmatch.h>
+#endif
+
+#include <algorithm>
+
+#include "common/FileSystemUtil.h"
+
+using namespace std;
+
+namespace logtail {
+
+// empty directories are skipped, since a literal prefix of a path is always a prefix of its directory list then
+static void SplitDirs(const string& path, vector<string>& dirs) {
+    size_t begin = 0;
+    while (begin < path.size()) {
+        size_t end = path.find(PATH_SEPARATOR[0], begin);
+        if (end == string::npos) {
+            end = path.size();
+        }
+        if (end > begin) {
+            dirs.emplace_back(path, begin, end - begin);
+        }
+        begin = end + 1;
+    }
+}
+
+vector<string> FileDiscoveryMatchIndex::GetConstPrefixDirs(const FileDiscoveryOptions& options) {
+    vector<string> dirs;
+    if (options.IsContainerDiscoveryEnabled()) {
+        return dirs;
+    }
+    SplitDirs(options.GetBasePath(), dirs);
+    if (options.GetWildcardPaths().empty()) {
+        // base path is compared literally
+        return dirs;
+    }
+    // base path is matched by fnmatch, where brackets and backslash are special as well
+    auto it = find_if(dirs.begin(), dirs.end(), [](const string& dir) {
+        return dir.find_first_of("*?[\\") != string::npos;
+    });
+    dirs.erase(it, dirs.end());
+    return dirs;
+}
+
+void FileDiscoveryMatchIndex::Add(const string& name, const FileDiscoveryConfig& config) {
+    Remove(name);
+    Node* node = &mRoot;
+    for (auto& dir : GetConstPrefixDirs(*config.first)) {
+        auto& child = node->mChildren[dir];
+        if (!child) {
+            child = make_unique<Node>();
+        }
+        node = child.get();
+    }
+    Entry& entry = mEntries[name];
+    entry.mNode = node;
+    entry.mFilePattern = config.first->GetFilePattern();
+    entry.mSeq = mNextSeq++;
+    node->mConfigs[entry.mFilePattern].emplace(entry.mSeq, config);
+}
+
+void FileDiscoveryMatchIndex::Remove(const string& name) {
+    auto it = mEntries.find(name);
+    if (it == mEntries.end()) {
+        return;
+    }
+    auto& configs = it->second.mNode->mConfigs;
+    auto group = configs.find(it->second.mFilePattern);
+    if (group != configs.end()) {
+        group->second.erase(it->second.mSeq);
+        if (group->second.empty()) {
+            configs.erase(group);
+        }
+    }
+    // empty nodes are kept, they are few and cheap to walk through
+    mEntries.erase(it);
+}
+
+void FileDiscoveryMatchIndex::Clear() {
+    mRoot.mChildren.clear();
+    mRoot.mConfigs.clear();
+    mEntries.clear();
+}
+
+void FileDiscoveryMatchIndex::GetCandidates(const string& path,
+                                            const string& name,
+                                            vector<FileDiscoveryConfig>& res) const {
+    vector<pair<uint64_t, FileDiscoveryConfig>> candidates;
+    auto collect = [&](const Node& node) {
+        for (const auto& group : node.mConfigs) {
+            if (!name.empty() && fnmatch(group.first.c_str(), name.c_str(), 0) != 0) {
+                continue;
+            }
+            candidates.insert(candidates.end(), group.second.begin(), group.second.end());
+        }
+    };
+
+    collect(mRoot);
+    vector<string> dirs;
+    SplitDirs(NormalizeNativePath(path), dirs);
+    const Node* node = &mRoot;
+    for (const auto& dir : dirs) {
+        auto it = node->mChildren.find(dir);
+        if (it == node->mChildren.end()) {
+            break;
+        }
+        node = it->second.get();
+        collect(*node);
+    }
+
+    sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    res.reserve(res.size() + candidates.size());
+    for (auto& candidate : candidates) {
+        res.emplace_back(candidate.second);
+    }
+}
+
+} // namespace logtail
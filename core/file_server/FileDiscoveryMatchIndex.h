@@ -0,0 +1,76 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "file_server/FileDiscoveryOptions.h"
+
+namespace logtail {
+
+// FileDiscoveryMatchIndex narrows down the file discovery configs that may match a path, so that
+// FileDiscoveryOptions::IsMatch is not evaluated against every config.
+//
+// Configs are put in a trie keyed by the constant leading directories of their base path (i.e., the directories
+// before the first wildcard), and grouped by file pattern in each trie node. A lookup walks the directories of the
+// path once, and evaluates each distinct file pattern once per node. Configs with container discovery enabled match
+// paths on the host, which are unrelated to their base path, so they are always candidates.
+//
+// The candidates are a superset of the matched configs, and IsMatch must still be called on them.
+// not thread-safe, should be protected by the owner
+class FileDiscoveryMatchIndex {
+public:
+    void Add(const std::string& name, const FileDiscoveryConfig& config);
+    void Remove(const std::string& name);
+    void Clear();
+
+    // @name: empty if the object is a directory, in which case file patterns are not checked
+    // @res: in the order of addition
+    void GetCandidates(const std::string& path, const std::string& name, std::vector<FileDiscoveryConfig>& res) const;
+    size_t Size() const { return mEntries.size(); }
+
+private:
+    struct Node {
+        std::unordered_map<std::string, std::unique_ptr<Node>> mChildren;
+        // file pattern -> (sequence number -> config)
+        std::unordered_map<std::string, std::map<uint64_t, FileDiscoveryConfig>> mConfigs;
+    };
+
+    struct Entry {
+        Node* mNode = nullptr;
+        std::string mFilePattern;
+        uint64_t mSeq = 0;
+    };
+
+    static std::vector<std::string> GetConstPrefixDirs(const FileDiscoveryOptions& options);
+
+    Node mRoot;
+    std::unordered_map<std::string, Entry> mEntries;
+    uint64_t mNextSeq = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class FileDiscoveryMatchIndexUnittest;
+#endif
+};
+
+} // namespace logtail
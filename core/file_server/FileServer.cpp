@@ -29,6 +29,9 @@
 #include "plugin/input/InputFile.h"
 
 DEFINE_FLAG_BOOL(enable_polling_discovery, "", true);
+DEFINE_FLAG_BOOL(enable_incremental_file_server_update,
+                 "only reload handlers and readers of the changed configs on config update",
+                 false);
 
 using namespace std;
 
@@ -39,6 +42,7 @@ FileServer::FileServer() {
         mMetricsRecordRef,
         MetricCategory::METRIC_CATEGORY_RUNNER,
         {{METRIC_LABEL_KEY_RUNNER_NAME, METRIC_LABEL_VALUE_RUNNER_NAME_FILE_SERVER}});
+    mLastConfigUpdatePauseMs = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_FILE_LAST_CONFIG_UPDATE_PAUSE_MS);
 }
 
 // 启动文件服务，包括加载配置、处理检查点、注册事件等
@@ -80,11 +84,34 @@ void FileServer::Pause(bool isConfigUpdate) {
     }
 }
 
+void FileServer::PauseForConfigUpdate(const unordered_set<string>& configNames) {
+    // exactly once checkpoints are scanned by config on resume, which would recreate readers of the kept configs
+    mIsIncrementalUpdate = BOOL_FLAG(enable_incremental_file_server_update) && GetExactlyOnceConfigs().empty();
+    if (!mIsIncrementalUpdate) {
+        Pause();
+        return;
+    }
+    PauseInner();
+    mUpdatingConfigNames = configNames;
+    DumpCheckPointForConfigUpdate();
+    EventDispatcher::GetInstance()->ClearBrokenLinkSet();
+    PollingDirFile::GetInstance()->ClearCache();
+    ConfigManager::GetInstance()->ClearFilePipelineMatchCache();
+}
+
+void FileServer::DumpCheckPointForConfigUpdate() {
+    EventDispatcher::GetInstance()->DumpHandlersMetaOfConfigs(mUpdatingConfigNames);
+    CheckPointManager::Instance()->DumpCheckPointToLocal();
+    // readers of the other configs are kept, so their checkpoints must not be turned into events on resume
+    CheckPointManager::Instance()->RemoveCheckPointsOfOtherConfigs(mUpdatingConfigNames);
+}
+
 // 暂停文件服务的内部实现，记录日志并处理暂停逻辑
 void FileServer::PauseInner() {
     LOG_INFO(sLogger, ("file server pause", "starts"));
     // cache must be cleared at last, since logFileReader dump still requires the cache
     auto holdOnStart = GetCurrentTimeInMilliSeconds();
+    mPauseStartTimeMs = holdOnStart;
     if (BOOL_FLAG(enable_polling_discovery)) {
         PollingDirFile::GetInstance()->HoldOn();
         PollingModify::GetInstance()->HoldOn();
@@ -124,9 +151,45 @@ void FileServer::Resume(bool isConfigUpdate, bool isContainerUpdate) {
         PollingModify::GetInstance()->Resume();
         PollingDirFile::GetInstance()->Resume();
     }
+    if (isConfigUpdate) {
+        RecordConfigUpdatePause();
+    }
     LOG_INFO(sLogger, ("file server resume", "succeeded"));
 }
 
+void FileServer::ResumeForConfigUpdate() {
+    if (!mIsIncrementalUpdate) {
+        Resume();
+        return;
+    }
+    if (ContainerManager::GetInstance()->CheckContainerDiffForAllConfig()) {
+        ContainerManager::GetInstance()->ApplyContainerDiffs();
+        ContainerManager::GetInstance()->SaveContainerInfo();
+    }
+    LOG_INFO(sLogger, ("file server resume", "starts")("updated config count", mUpdatingConfigNames.size()));
+    // dirs of the other configs are still registered
+    ConfigManager::GetInstance()->RegisterHandlers(mUpdatingConfigNames);
+    LOG_INFO(sLogger, ("watch dirs", "succeeded"));
+    // only the checkpoints of the updated configs are dumped
+    EventDispatcher::GetInstance()->AddExistedCheckPointFileEvents();
+    LogInput::GetInstance()->Resume();
+    if (BOOL_FLAG(enable_polling_discovery)) {
+        PollingModify::GetInstance()->Resume();
+        PollingDirFile::GetInstance()->Resume();
+    }
+    mUpdatingConfigNames.clear();
+    mIsIncrementalUpdate = false;
+    RecordConfigUpdatePause();
+    LOG_INFO(sLogger, ("file server resume", "succeeded"));
+}
+
+// the time during which no file is collected, including the time to apply the pipeline changes
+void FileServer::RecordConfigUpdatePause() {
+    auto costMs = GetCurrentTimeInMilliSeconds() - mPauseStartTimeMs;
+    SET_GAUGE(mLastConfigUpdatePauseMs, costMs);
+    LOG_INFO(sLogger, ("file server paused for config update, cost ms", costMs));
+}
+
 // 停止文件服务，将事件处理程序的元数据以及检查点数据保存到本地
 void FileServer::Stop() {
     PauseInner();
@@ -150,12 +213,14 @@ void FileServer::AddFileDiscoveryConfig(const string& name,
                                         const CollectionPipelineContext* ctx) {
     WriteLock lock(mReadWriteLock);
     mPipelineNameFileDiscoveryConfigsMap[name] = make_pair(opts, ctx);
+    mFileDiscoveryMatchIndex.Add(name, make_pair(opts, ctx));
 }
 
 // 移除给定名称的文件发现配置
 void FileServer::RemoveFileDiscoveryConfig(const string& name) {
     WriteLock lock(mReadWriteLock);
     mPipelineNameFileDiscoveryConfigsMap.erase(name);
+    mFileDiscoveryMatchIndex.Remove(name);
 }
 
 // 获取给定名称的文件读取器配置
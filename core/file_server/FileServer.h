@@ -18,10 +18,12 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #include "collection_pipeline/CollectionPipelineContext.h"
 #include "common/Lock.h"
+#include "file_server/FileDiscoveryMatchIndex.h"
 #include "file_server/FileDiscoveryOptions.h"
 #include "file_server/FileTagOptions.h"
 #include "file_server/MultilineOptions.h"
@@ -44,6 +46,10 @@ public:
 
     void Start();
     void Pause(bool isConfigUpdate = true);
+    // config update that only affects @configNames: handlers and readers of other configs are kept, so that their
+    // collection is only held for the duration of the update. Falls back to full pause and resume if not applicable.
+    void PauseForConfigUpdate(const std::unordered_set<std::string>& configNames);
+    void ResumeForConfigUpdate();
 
     // for plugin
     FileDiscoveryConfig GetFileDiscoveryConfig(const std::string& name) const;
@@ -53,6 +59,8 @@ public:
     void
     AddFileDiscoveryConfig(const std::string& name, FileDiscoveryOptions* opts, const CollectionPipelineContext* ctx);
     void RemoveFileDiscoveryConfig(const std::string& name);
+    // same as GetAllFileDiscoveryConfigs, should only be used when file server is paused or by file server itself
+    const FileDiscoveryMatchIndex& GetFileDiscoveryMatchIndex() const { return mFileDiscoveryMatchIndex; }
 
     FileReaderConfig GetFileReaderConfig(const std::string& name) const;
     const std::unordered_map<std::string, FileReaderConfig>& GetAllFileReaderConfigs() const {
@@ -102,10 +110,13 @@ private:
     ~FileServer() = default;
 
     void PauseInner();
+    void DumpCheckPointForConfigUpdate();
+    void RecordConfigUpdatePause();
 
     mutable ReadWriteLock mReadWriteLock;
 
     std::unordered_map<std::string, FileDiscoveryConfig> mPipelineNameFileDiscoveryConfigsMap;
+    FileDiscoveryMatchIndex mFileDiscoveryMatchIndex;
     std::unordered_map<std::string, FileReaderConfig> mPipelineNameFileReaderConfigsMap;
     std::unordered_map<std::string, MultilineConfig> mPipelineNameMultilineConfigsMap;
     std::unordered_map<std::string, FileTagConfig> mPipelineNameFileTagConfigsMap;
@@ -118,7 +129,13 @@ private:
     // 过渡使用
     std::unordered_map<std::string, uint32_t> mPipelineNameEOConcurrencyMap;
 
+    // only accessed by the config update thread
+    std::unordered_set<std::string> mUpdatingConfigNames;
+    bool mIsIncrementalUpdate = false;
+    uint64_t mPauseStartTimeMs = 0;
+
     mutable MetricsRecordRef mMetricsRecordRef;
+    IntGaugePtr mLastConfigUpdatePauseMs;
 };
 
 } // namespace logtail
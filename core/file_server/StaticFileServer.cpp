@@ -14,6 +14,11 @@
 
 #include "file_server/StaticFileServer.h"
 
+#include <cstring>
+
+#include <fstream>
+
+#include "collection_pipeline/queue/ProcessQueueItem.h"
 #include "collection_pipeline/queue/ProcessQueueManager.h"
 #include "common/LogtailCommonFlags.h"
 #include "file_server/checkpoint/InputStaticFileCheckpointManager.h"
@@ -21,6 +26,10 @@
 
 
 DEFINE_FLAG_INT32(input_static_file_checkpoint_dump_interval_sec, "", 5);
+DEFINE_FLAG_INT32(static_file_range_reader_thread_num,
+                  "max number of ranges of large static files read concurrently, 0 means files are read sequentially",
+                  0);
+DEFINE_FLAG_INT32(static_file_read_range_size_mb, "size of each range when a large static file is read in ranges", 256);
 
 using namespace std;
 
@@ -42,6 +51,10 @@ void StaticFileServer::Init() {
     InputStaticFileCheckpointManager::GetInstance()->GetAllCheckpointFileNames();
     mIsThreadRunning = true;
     mThreadRes = async(launch::async, &StaticFileServer::Run, this);
+    mIsRangeReaderRunning = true;
+    for (int32_t i = 0; i < INT32_FLAG(static_file_range_reader_thread_num); ++i) {
+        mRangeReaderThreadRes.emplace_back(async(launch::async, &StaticFileServer::RunRangeReader, this));
+    }
     mStartTime = time(nullptr);
 }
 
@@ -54,6 +67,11 @@ void StaticFileServer::Stop() {
         mIsThreadRunning = false;
     }
     mStopCV.notify_all();
+    {
+        lock_guard<mutex> lock(mRangeTaskMux);
+        mIsRangeReaderRunning = false;
+    }
+    mRangeTaskCV.notify_all();
 
     future_status s = mThreadRes.wait_for(chrono::seconds(1));
     if (s == future_status::ready) {
@@ -61,6 +79,12 @@ void StaticFileServer::Stop() {
     } else {
         LOG_WARNING(sLogger, ("static file server", "forced to stopped"));
     }
+    for (auto& res : mRangeReaderThreadRes) {
+        if (res.wait_for(chrono::seconds(1)) != future_status::ready) {
+            LOG_WARNING(sLogger, ("static file range reader", "forced to stopped"));
+        }
+    }
+    mRangeReaderThreadRes.clear();
 }
 
 bool StaticFileServer::HasRegisteredPlugins() const {
@@ -161,10 +185,17 @@ void StaticFileServer::ReadFiles() {
             auto cur = chrono::system_clock::now();
             while (chrono::system_clock::now() - cur < chrono::milliseconds(50)) {
                 if (!reader) {
+                    if (HasRangesInFlight(configName, inputIdx)) {
+                        break;
+                    }
                     reader = GetNextAvailableReader(configName, inputIdx);
                     if (!reader) {
                         break;
                     }
+                    if (ReadInRanges(configName, inputIdx, reader)) {
+                        reader = nullptr;
+                        break;
+                    }
                 }
 
                 bool skip = false;
@@ -208,25 +239,9 @@ void StaticFileServer::ReadFiles() {
 LogFileReaderPtr StaticFileServer::GetNextAvailableReader(const string& configName, size_t idx) {
     FileFingerprint fingerprint;
     while (InputStaticFileCheckpointManager::GetInstance()->GetCurrentFileFingerprint(configName, idx, &fingerprint)) {
-        LogFileReaderPtr reader(LogFileReader::CreateLogFileReader(fingerprint.mFilePath.parent_path().string(),
-                                                                   fingerprint.mFilePath.filename().string(),
-                                                                   fingerprint.mDevInode,
-                                                                   GetFileReaderConfig(configName, idx),
-                                                                   GetMultilineConfig(configName, idx),
-                                                                   GetFileDiscoveryConfig(configName, idx),
-                                                                   GetFileTagConfig(configName, idx),
-                                                                   0,
-                                                                   true));
         string errMsg;
+        auto reader = CreateReader(configName, idx, fingerprint, errMsg);
         if (!reader) {
-            errMsg = "failed to create reader";
-        } else if (!reader->UpdateFilePtr()) {
-            errMsg = "failed to open file";
-        } else if (!reader->CheckFileSignatureAndOffset(false)
-                   || reader->GetSignature() != make_pair(fingerprint.mSignatureHash, fingerprint.mSignatureSize)) {
-            errMsg = "file signature check failed";
-        }
-        if (!errMsg.empty()) {
             LOG_WARNING(sLogger,
                         ("failed to get reader",
                          errMsg)("config", configName)("input idx", idx)("filepath", fingerprint.mFilePath.string()));
@@ -240,11 +255,211 @@ LogFileReaderPtr StaticFileServer::GetNextAvailableReader(const string& configNa
     return LogFileReaderPtr();
 }
 
+LogFileReaderPtr StaticFileServer::CreateReader(const string& configName,
+                                                size_t idx,
+                                                const FileFingerprint& fingerprint,
+                                                string& errMsg) {
+    LogFileReaderPtr reader(LogFileReader::CreateLogFileReader(fingerprint.mFilePath.parent_path().string(),
+                                                               fingerprint.mFilePath.filename().string(),
+                                                               fingerprint.mDevInode,
+                                                               GetFileReaderConfig(configName, idx),
+                                                               GetMultilineConfig(configName, idx),
+                                                               GetFileDiscoveryConfig(configName, idx),
+                                                               GetFileTagConfig(configName, idx),
+                                                               0,
+                                                               true));
+    if (!reader) {
+        errMsg = "failed to create reader";
+    } else if (!reader->UpdateFilePtr()) {
+        errMsg = "failed to open file";
+    } else if (!reader->CheckFileSignatureAndOffset(false)
+               || reader->GetSignature() != make_pair(fingerprint.mSignatureHash, fingerprint.mSignatureSize)) {
+        errMsg = "file signature check failed";
+    }
+    return errMsg.empty() ? reader : LogFileReaderPtr();
+}
+
+// returns the offset right after the first line feed at or after pos, or size if there is none
+static uint64_t FindNextLineBegin(ifstream& is, uint64_t pos, uint64_t size) {
+    char buf[4096];
+    is.clear();
+    is.seekg(pos);
+    while (pos < size) {
+        is.read(buf, sizeof(buf));
+        auto n = static_cast<size_t>(is.gcount());
+        if (n == 0) {
+            break;
+        }
+        auto* lf = static_cast<const char*>(memchr(buf, '\n', n));
+        if (lf != nullptr) {
+            return min(pos + (lf - buf) + 1, size);
+        }
+        pos += n;
+    }
+    return size;
+}
+
+static vector<FileRangeCheckpoint>
+SplitFileIntoRanges(const filesystem::path& filepath, uint64_t size, uint64_t rangeSize) {
+    vector<FileRangeCheckpoint> ranges;
+    ifstream is(filepath, ios::binary);
+    if (!is) {
+        return ranges;
+    }
+    for (uint64_t begin = 0; begin < size;) {
+        uint64_t end = size - begin > rangeSize ? FindNextLineBegin(is, begin + rangeSize - 1, size) : size;
+        ranges.emplace_back(begin, end);
+        begin = end;
+    }
+    return ranges;
+}
+
+bool StaticFileServer::ReadInRanges(const string& configName, size_t idx, const LogFileReaderPtr& reader) {
+    if (mRangeReaderThreadRes.empty()) {
+        return false;
+    }
+    auto* manager = InputStaticFileCheckpointManager::GetInstance();
+    FileFingerprint fingerprint;
+    vector<FileRangeCheckpoint> ranges;
+    if (!manager->GetCurrentFileFingerprint(configName, idx, &fingerprint)
+        || !manager->GetCurrentFileRanges(configName, idx, &ranges)) {
+        return false;
+    }
+    if (ranges.empty()) {
+        // a multiline log may span two ranges
+        auto multilineConfig = GetMultilineConfig(configName, idx);
+        if (multilineConfig.first != nullptr && multilineConfig.first->IsMultiline()) {
+            return false;
+        }
+        uint64_t size = reader->GetFileSize();
+        uint64_t rangeSize = static_cast<uint64_t>(max(INT32_FLAG(static_file_read_range_size_mb), 0)) * 1024 * 1024;
+        if (rangeSize == 0 || size <= rangeSize) {
+            return false;
+        }
+        ranges = SplitFileIntoRanges(fingerprint.mFilePath, size, rangeSize);
+        if (ranges.size() <= 1
+            || !manager->SetCurrentFileRanges(configName, idx, vector<FileRangeCheckpoint>(ranges), size)) {
+            return false;
+        }
+    }
+
+    size_t cnt = 0;
+    {
+        lock_guard<mutex> lock(mRangeTaskMux);
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            if (!ranges[i].IsFinished()) {
+                mRangeTasks.push_back({configName, idx, fingerprint, i, ranges[i]});
+                ++cnt;
+            }
+        }
+        if (cnt > 0) {
+            mInFlightRangeCnts[make_pair(configName, idx)] = cnt;
+        }
+    }
+    mRangeTaskCV.notify_all();
+    return cnt > 0;
+}
+
+bool StaticFileServer::HasRangesInFlight(const string& configName, size_t idx) const {
+    lock_guard<mutex> lock(mRangeTaskMux);
+    return mInFlightRangeCnts.find(make_pair(configName, idx)) != mInFlightRangeCnts.end();
+}
+
+void StaticFileServer::RunRangeReader() {
+    while (true) {
+        RangeReadTask task;
+        {
+            unique_lock<mutex> lock(mRangeTaskMux);
+            mRangeTaskCV.wait(lock, [this]() { return !mRangeTasks.empty() || !mIsRangeReaderRunning; });
+            if (!mIsRangeReaderRunning) {
+                return;
+            }
+            task = std::move(mRangeTasks.front());
+            mRangeTasks.pop_front();
+        }
+        ReadRange(task);
+        {
+            lock_guard<mutex> lock(mRangeTaskMux);
+            auto it = mInFlightRangeCnts.find(make_pair(task.mConfigName, task.mInputIdx));
+            if (it != mInFlightRangeCnts.end() && --it->second == 0) {
+                mInFlightRangeCnts.erase(it);
+            }
+        }
+    }
+}
+
+void StaticFileServer::ReadRange(const RangeReadTask& task) {
+    auto* manager = InputStaticFileCheckpointManager::GetInstance();
+    LogFileReaderPtr reader;
+    {
+        lock_guard<mutex> lock(mUpdateMux);
+        if (mInputFileReaderConfigsMap.find(make_pair(task.mConfigName, task.mInputIdx))
+            == mInputFileReaderConfigsMap.end()) {
+            // the input has been removed
+            return;
+        }
+        string errMsg;
+        reader = CreateReader(task.mConfigName, task.mInputIdx, task.mFingerprint, errMsg);
+        if (!reader) {
+            LOG_WARNING(sLogger,
+                        ("failed to get range reader", errMsg)("config", task.mConfigName)("input idx", task.mInputIdx)(
+                            "filepath", task.mFingerprint.mFilePath.string())("range idx", task.mRangeIdx));
+            manager->InvalidateCurrentFileCheckpoint(task.mConfigName, task.mInputIdx);
+            return;
+        }
+    }
+    reader->SetLastFilePos(task.mRange.mOffset);
+    reader->SetReadEnd(task.mRange.mEnd);
+
+    while (mIsRangeReaderRunning) {
+        if (!ProcessQueueManager::GetInstance()->IsValidToPush(reader->GetQueueKey())) {
+            if (!HasRangesInFlight(task.mConfigName, task.mInputIdx)) {
+                // the input has been removed
+                return;
+            }
+            this_thread::sleep_for(chrono::milliseconds(10));
+            continue;
+        }
+        auto logBuffer = make_unique<LogBuffer>();
+        bool moreData = reader->ReadLog(*logBuffer, nullptr);
+        auto group = LogFileReader::GenerateEventGroup(reader, logBuffer.get());
+        // readers of other ranges may fill the queue after the check above, so retry until the data is pushed. when
+        // stopped before that, the range checkpoint is not advanced, so that the data is read again on restart.
+        auto item = make_unique<ProcessQueueItem>(std::move(group), task.mInputIdx);
+        while (ProcessQueueManager::GetInstance()->PushQueue(reader->GetQueueKey(), std::move(item))
+               != QueueStatus::OK) {
+            if (!mIsRangeReaderRunning || !HasRangesInFlight(task.mConfigName, task.mInputIdx)) {
+                return;
+            }
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+        // the range is done when there is no more data, even if the last line has no line feed
+        uint64_t offset = moreData ? reader->GetLastFilePos() : task.mRange.mEnd;
+        if (!manager->UpdateCurrentFileRangeCheckpoint(task.mConfigName, task.mInputIdx, task.mRangeIdx, offset)
+            || !moreData) {
+            return;
+        }
+    }
+}
+
 void StaticFileServer::UpdateInputs() {
     unique_lock<mutex> lock(mUpdateMux);
     for (const auto& item : mDeletedInputs) {
         mPipelineNameReadersMap.erase(item.first);
     }
+    if (!mDeletedInputs.empty()) {
+        lock_guard<mutex> rangeLock(mRangeTaskMux);
+        for (const auto& item : mDeletedInputs) {
+            mInFlightRangeCnts.erase(item);
+        }
+        mRangeTasks.erase(remove_if(mRangeTasks.begin(),
+                                    mRangeTasks.end(),
+                                    [this](const RangeReadTask& task) {
+                                        return mDeletedInputs.find(make_pair(task.mConfigName, task.mInputIdx))
+                                            != mDeletedInputs.end();
+                                    }),
+                          mRangeTasks.end());
+    }
     mDeletedInputs.clear();
 
     for (const auto& item : mAddedInputs) {
@@ -302,6 +517,9 @@ void StaticFileServer::Clear() {
     mPipelineNameReadersMap.clear();
     mAddedInputs.clear();
     mDeletedInputs.clear();
+    lock_guard<mutex> rangeLock(mRangeTaskMux);
+    mRangeTasks.clear();
+    mInFlightRangeCnts.clear();
 }
 #endif
 
@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <filesystem>
 #include <future>
 #include <map>
@@ -30,6 +32,7 @@
 #include "file_server/FileDiscoveryOptions.h"
 #include "file_server/FileTagOptions.h"
 #include "file_server/MultilineOptions.h"
+#include "file_server/checkpoint/FileCheckpoint.h"
 #include "file_server/reader/FileReaderOptions.h"
 #include "file_server/reader/LogFileReader.h"
 #include "monitor/MetricManager.h"
@@ -69,6 +72,14 @@ public:
 #endif
 
 private:
+    struct RangeReadTask {
+        std::string mConfigName;
+        size_t mInputIdx = 0;
+        FileFingerprint mFingerprint;
+        size_t mRangeIdx = 0;
+        FileRangeCheckpoint mRange;
+    };
+
     StaticFileServer();
     ~StaticFileServer() = default;
 
@@ -76,6 +87,13 @@ private:
     void ReadFiles();
     void UpdateInputs();
     LogFileReaderPtr GetNextAvailableReader(const std::string& configName, size_t idx);
+    LogFileReaderPtr
+    CreateReader(const std::string& configName, size_t idx, const FileFingerprint& fingerprint, std::string& errMsg);
+
+    void RunRangeReader();
+    bool ReadInRanges(const std::string& configName, size_t idx, const LogFileReaderPtr& reader);
+    void ReadRange(const RangeReadTask& task);
+    bool HasRangesInFlight(const std::string& configName, size_t idx) const;
 
     FileDiscoveryConfig GetFileDiscoveryConfig(const std::string& name, size_t idx) const;
     FileReaderConfig GetFileReaderConfig(const std::string& name, size_t idx) const;
@@ -96,6 +114,15 @@ private:
 
     std::multimap<std::string, std::pair<size_t, LogFileReaderPtr>> mPipelineNameReadersMap;
 
+    // large files are split into ranges, which are read by range reader threads, one range per thread at a time
+    std::vector<std::future<void>> mRangeReaderThreadRes;
+    std::atomic_bool mIsRangeReaderRunning = false;
+    mutable std::mutex mRangeTaskMux;
+    std::condition_variable mRangeTaskCV;
+    std::deque<RangeReadTask> mRangeTasks;
+    // number of unfinished ranges of the current file of each input
+    std::map<std::pair<std::string, size_t>, size_t> mInFlightRangeCnts;
+
     // accessed by main thread and input runner thread
     mutable std::mutex mUpdateMux;
     std::map<std::pair<std::string, size_t>, FileDiscoveryConfig> mInputFileDiscoveryConfigsMap;
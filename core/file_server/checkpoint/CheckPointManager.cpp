@@ -27,6 +27,7 @@
 #include "common/StringTools.h"
 #include "file_server/ConfigManager.h"
 #include "file_server/FileDiscoveryOptions.h"
+#include "file_server/checkpoint/CheckpointStore.h"
 #include "logger/Logger.h"
 #include "monitor/AlarmManager.h"
 
@@ -40,9 +41,18 @@ DEFINE_FLAG_INT32(check_point_version, "now check point version xx.xx.xx such as
 DEFINE_FLAG_INT32(check_point_dump_interval, "default 15 min", 15 * 60);
 DEFINE_FLAG_INT32(check_point_max_count, "max check point count", 100000);
 DEFINE_FLAG_INT32(checkpoint_find_max_file_count, "", 1000);
+DEFINE_FLAG_BOOL(enable_incremental_file_checkpoint,
+                 "persist file checkpoints incrementally in a database instead of rewriting the json file",
+                 false);
 
 namespace logtail {
 
+CheckPointManager::CheckPointManager()
+    : mLastCheckTime(time(NULL)), mLastDumpTime(time(NULL)), mLoadVersion(NO_CHECKPOINT_VERSION), mReaderCount(0) {
+}
+
+CheckPointManager::~CheckPointManager() = default;
+
 bool CheckPointManager::CheckVersion() {
     return (mLoadVersion == NO_CHECKPOINT_VERSION) || (mLoadVersion / 10000 == INT32_FLAG(check_point_version) / 10000);
 }
@@ -128,12 +138,22 @@ void CheckPointManager::AddDirCheckPoint(const string& dirname) {
     ptr->mSubDir.insert(dirname);
 }
 void CheckPointManager::LoadCheckPoint() {
+    // the json file is still loaded if the store is empty, so that checkpoints are migrated on first dump
+    if (BOOL_FLAG(enable_incremental_file_checkpoint) && LoadCheckPointFromStore()) {
+        return;
+    }
     Json::Value root;
     ParseConfResult cptRes = ParseConfig(AppConfig::GetInstance()->GetCheckPointFilePath(), root);
     // if new checkpoint file not exist, check old checkpoint file.
     if (cptRes == CONFIG_NOT_EXIST && AppConfig::GetInstance()->GetCheckPointFilePath() != GetCheckPointFileName()) {
         cptRes = ParseConfig(GetCheckPointFileName(), root);
     }
+    // the json file is retired once migrated to the store, so load the store if the incremental checkpoint is disabled
+    // again, and the checkpoints are migrated back on first dump
+    if (cptRes == CONFIG_NOT_EXIST && !BOOL_FLAG(enable_incremental_file_checkpoint)
+        && CheckExistance(GetCheckPointStorePath()) && LoadCheckPointFromStore()) {
+        return;
+    }
     if (cptRes != CONFIG_OK) {
         if (cptRes == CONFIG_NOT_EXIST)
             LOG_INFO(sLogger, ("no check point file to load", AppConfig::GetInstance()->GetCheckPointFilePath()));
@@ -346,6 +366,9 @@ bool CheckPointManager::DumpCheckPointToLocal() {
         AlarmManager::GetInstance()->SendAlarmWarning(CHECKPOINT_ALARM, "open check point file dir failed");
         return false;
     }
+    if (BOOL_FLAG(enable_incremental_file_checkpoint)) {
+        return DumpCheckPointToStore();
+    }
 
     Json::Value root;
     mReaderCount = mDevInodeCheckPointPtrMap.size();
@@ -455,6 +478,11 @@ bool CheckPointManager::DumpCheckPointToLocal() {
             CHECKPOINT_ALARM, std::string("rename check point file fail, errno ") + ToString(errno));
         return false;
     }
+    // the store is stale now, and must not be loaded if the incremental checkpoint is enabled again
+    if (mStore || CheckExistance(GetCheckPointStorePath())) {
+        mStore.reset();
+        CheckpointStore::Destroy(GetCheckPointStorePath());
+    }
     LOG_DEBUG(sLogger,
               ("dump checkpoint, version", INT32_FLAG(check_point_version))(
                   "file check point", mDevInodeCheckPointPtrMap.size())("dir check point", mDirNameMap.size()));
@@ -462,6 +490,80 @@ bool CheckPointManager::DumpCheckPointToLocal() {
     return true;
 }
 
+string CheckPointManager::GetCheckPointStorePath() {
+    return AppConfig::GetInstance()->GetCheckPointFilePath() + ".db";
+}
+
+bool CheckPointManager::LoadCheckPointFromStore() {
+    if (!mStore) {
+        mStore.reset(new CheckpointStore(GetCheckPointStorePath()));
+    }
+    int32_t version = NO_CHECKPOINT_VERSION;
+    vector<CheckPointPtr> fileCheckPoints;
+    unordered_map<string, DirCheckPointPtr> dirCheckPoints;
+    if (!mStore->Load(version, fileCheckPoints, dirCheckPoints)) {
+        return false;
+    }
+    mLoadVersion = version;
+    for (auto& cpt : fileCheckPoints) {
+        mDevInodeCheckPointPtrMap[CheckPointKey(cpt->mDevInode, cpt->mConfigName)] = std::move(cpt);
+    }
+    mDirNameMap.insert(dirCheckPoints.begin(), dirCheckPoints.end());
+    mReaderCount = mDevInodeCheckPointPtrMap.size();
+    LOG_INFO(sLogger,
+             ("load checkpoint from store, version", mLoadVersion)(
+                 "file check point", mDevInodeCheckPointPtrMap.size())("dir check point", mDirNameMap.size()));
+    return true;
+}
+
+bool CheckPointManager::DumpCheckPointToStore() {
+    if (!mStore) {
+        mStore.reset(new CheckpointStore(GetCheckPointStorePath()));
+    }
+    vector<const CheckPoint*> checkPoints;
+    GetCheckPointsToDump(checkPoints);
+    size_t writtenCnt = 0;
+    if (!mStore->Dump(INT32_FLAG(check_point_version), checkPoints, mDirNameMap, &writtenCnt)) {
+        return false;
+    }
+    // the json file is stale once migrated to the store, and must not be loaded if the incremental checkpoint is
+    // disabled again. It is kept as a backup.
+    for (const auto& jsonFile : {AppConfig::GetInstance()->GetCheckPointFilePath(), GetCheckPointFileName()}) {
+        if (CheckExistance(jsonFile)) {
+            string migratedFile = jsonFile + ".migrated";
+#if defined(_MSC_VER)
+            remove(migratedFile.c_str());
+#endif
+            if (rename(jsonFile.c_str(), migratedFile.c_str()) == -1) {
+                LOG_WARNING(sLogger, ("failed to rename migrated check point file", jsonFile)("errno", errno));
+            } else {
+                LOG_INFO(sLogger, ("check point file is migrated to store", jsonFile)("renamed to", migratedFile));
+            }
+        }
+    }
+    LOG_DEBUG(sLogger,
+              ("dump checkpoint to store, version", INT32_FLAG(check_point_version))(
+                  "file check point", checkPoints.size())("dir check point", mDirNameMap.size())("written entries",
+                                                                                                   writtenCnt));
+    return true;
+}
+
+void CheckPointManager::GetCheckPointsToDump(vector<const CheckPoint*>& res) {
+    mReaderCount = mDevInodeCheckPointPtrMap.size();
+    res.reserve(mDevInodeCheckPointPtrMap.size());
+    for (const auto& item : mDevInodeCheckPointPtrMap) {
+        res.push_back(item.second.get());
+    }
+    if (res.size() <= (size_t)INT32_FLAG(check_point_max_count)) {
+        return;
+    }
+    sort(res.begin(), res.end(), CheckPointManager::CheckPointCmpByUpdateTime);
+    res.resize(INT32_FLAG(check_point_max_count));
+    LOG_WARNING(sLogger, ("Too many check point", mDevInodeCheckPointPtrMap.size()));
+    AlarmManager::GetInstance()->SendAlarmWarning(
+        CHECKPOINT_ALARM, "Too many check point:" + ToString(mDevInodeCheckPointPtrMap.size()));
+}
+
 int32_t CheckPointManager::GetReaderCount() {
     return mReaderCount;
 }
@@ -506,6 +608,16 @@ void CheckPointManager::RemoveAllCheckPoint() {
     mDevInodeCheckPointPtrMap.clear();
 }
 
+void CheckPointManager::RemoveCheckPointsOfOtherConfigs(const std::unordered_set<std::string>& configNames) {
+    for (auto it = mDevInodeCheckPointPtrMap.begin(); it != mDevInodeCheckPointPtrMap.end();) {
+        if (configNames.find(it->first.mConfigName) == configNames.end()) {
+            it = mDevInodeCheckPointPtrMap.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 boost::optional<std::string> SearchFilePathByDevInodeInDirectory(const std::string& baseDirPath,
                                                                  const uint16_t searchDepth,
                                                                  const DevInode& devInode,
@@ -21,6 +21,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "boost/optional.hpp"
 #include "json/json.h"
@@ -96,6 +97,8 @@ public:
 typedef std::shared_ptr<DirCheckPoint> DirCheckPointPtr;
 typedef std::shared_ptr<CheckPoint> CheckPointPtr;
 
+class CheckpointStore;
+
 class CheckPointManager {
 public:
     struct CheckPointKey {
@@ -125,8 +128,15 @@ private:
     int32_t mLastDumpTime;
     int32_t mLoadVersion;
     int32_t mReaderCount;
-    CheckPointManager()
-        : mLastCheckTime(time(NULL)), mLastDumpTime(time(NULL)), mLoadVersion(NO_CHECKPOINT_VERSION), mReaderCount(0) {}
+    // only used when enable_incremental_file_checkpoint is set
+    std::unique_ptr<CheckpointStore> mStore;
+    CheckPointManager();
+    ~CheckPointManager();
+
+    static std::string GetCheckPointStorePath();
+    bool LoadCheckPointFromStore();
+    bool DumpCheckPointToStore();
+    void GetCheckPointsToDump(std::vector<const CheckPoint*>& res);
 
 public:
     bool CheckVersion();
@@ -142,6 +152,7 @@ public:
     bool GetCheckPoint(DevInode devInode, const std::string& configName, CheckPointPtr& checkPointPtr);
     bool GetDirCheckPoint(const std::string& filename, DirCheckPointPtr& checkPointPtr);
     void RemoveAllCheckPoint();
+    void RemoveCheckPointsOfOtherConfigs(const std::unordered_set<std::string>& configNames);
     void CheckTimeoutCheckPoint();
     bool NeedDump(int32_t curTime);
     void ResetLastDumpTime();
@@ -0,0 +1,305 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "file_server/checkpoint/CheckpointStore.h"
+
+#include <memory>
+
+#include "leveldb/write_batch.h"
+
+#include "common/Flags.h"
+#include "common/StringTools.h"
+#include "logger/Logger.h"
+#include "monitor/AlarmManager.h"
+#include "protobuf/sls/checkpoint.pb.h"
+
+DECLARE_FLAG_INT32(file_check_point_time_out);
+
+using namespace std;
+
+namespace logtail {
+
+static const string kFileKeyPrefix = "f:";
+static const string kDirKeyPrefix = "d:";
+static const string kVersionKey = "version";
+
+static void LogStoreError(const string& op, const string& path, const leveldb::Status& s) {
+    LOG_ERROR(sLogger, ("failed to access checkpoint store", op)("path", path)("status", s.ToString()));
+    AlarmManager::GetInstance()->SendAlarmWarning(CHECKPOINT_ALARM,
+                                                  "failed to " + op + " checkpoint store: " + s.ToString());
+}
+
+static void SerializeFileCheckpoint(const CheckPoint& cpt, string& res) {
+    FileCheckpointPB pb;
+    pb.set_file_name(cpt.mFileName);
+    pb.set_resolved_file_name(cpt.mResolvedFileName);
+    pb.set_real_file_name(cpt.mRealFileName);
+    pb.set_offset(cpt.mOffset);
+    pb.set_sig_size(cpt.mSignatureSize);
+    pb.set_sig_hash(cpt.mSignatureHash);
+    pb.set_update_time(cpt.mLastUpdateTime);
+    pb.set_dev(cpt.mDevInode.dev);
+    pb.set_inode(cpt.mDevInode.inode);
+    pb.set_file_open(cpt.mFileOpenFlag);
+    pb.set_container_stopped(cpt.mContainerStopped);
+    pb.set_container_id(cpt.mContainerID);
+    pb.set_last_force_read(cpt.mLastForceRead);
+    pb.set_config_name(cpt.mConfigName);
+    pb.set_idx_in_reader_array(cpt.mIdxInReaderArray);
+    pb.SerializeToString(&res);
+}
+
+static void SerializeDirCheckpoint(const DirCheckPoint& cpt, string& res) {
+    DirCheckpointPB pb;
+    pb.set_update_time(cpt.mUpdateTime);
+    for (const auto& subDir : cpt.mSubDir) {
+        pb.add_sub_dir(subDir);
+    }
+    pb.SerializeToString(&res);
+}
+
+string CheckpointStore::GetFileCheckpointKey(const CheckPoint& checkpoint) {
+    // same as the key in json checkpoint file, use filename + dev + inode + configName to prevent conflict
+    return checkpoint.mFileName + "*" + ToString(checkpoint.mDevInode.dev) + "*"
+        + ToString(checkpoint.mDevInode.inode) + "*" + checkpoint.mConfigName;
+}
+
+bool CheckpointStore::IsSameFileCheckpoint(const CheckPoint& lhs, const CheckPoint& rhs) {
+    // all serialized fields, except those in the key
+    return lhs.mOffset == rhs.mOffset && lhs.mSignatureHash == rhs.mSignatureHash
+        && lhs.mSignatureSize == rhs.mSignatureSize && lhs.mLastUpdateTime == rhs.mLastUpdateTime
+        && lhs.mFileOpenFlag == rhs.mFileOpenFlag && lhs.mContainerStopped == rhs.mContainerStopped
+        && lhs.mLastForceRead == rhs.mLastForceRead && lhs.mIdxInReaderArray == rhs.mIdxInReaderArray
+        && lhs.mContainerID == rhs.mContainerID && lhs.mResolvedFileName == rhs.mResolvedFileName
+        && lhs.mRealFileName == rhs.mRealFileName;
+}
+
+bool CheckpointStore::Open() {
+    if (mDatabase != nullptr) {
+        return true;
+    }
+    leveldb::Options options;
+    options.create_if_missing = true;
+    leveldb::Status s = leveldb::DB::Open(options, mPath, &mDatabase);
+    if (!s.ok()) {
+        LogStoreError("open", mPath, s);
+        mDatabase = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void CheckpointStore::Close() {
+    if (mDatabase != nullptr) {
+        delete mDatabase;
+        mDatabase = nullptr;
+    }
+    mPersistedFiles.clear();
+    mPersistedDirs.clear();
+    mPersistedVersion.clear();
+    mStaleKeys.clear();
+}
+
+bool CheckpointStore::Destroy(const string& path) {
+    leveldb::Status s = leveldb::DestroyDB(path, leveldb::Options());
+    if (!s.ok()) {
+        LogStoreError("destroy", path, s);
+        return false;
+    }
+    return true;
+}
+
+bool CheckpointStore::Load(int32_t& version,
+                           vector<CheckPointPtr>& fileCheckpoints,
+                           unordered_map<string, DirCheckPointPtr>& dirCheckpoints) {
+    if (!Open()) {
+        return false;
+    }
+    mPersistedFiles.clear();
+    mPersistedDirs.clear();
+    mPersistedVersion.clear();
+    mStaleKeys.clear();
+    unique_ptr<leveldb::Iterator> iter(mDatabase->NewIterator(leveldb::ReadOptions()));
+    string value;
+    int32_t now = time(nullptr);
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        string key = iter->key().ToString();
+        value.assign(iter->value().data(), iter->value().size());
+        if (key == kVersionKey) {
+            if (!StringTo(value, version)) {
+                version = NO_CHECKPOINT_VERSION;
+            }
+            mPersistedVersion = value;
+            continue;
+        }
+        // stale or broken entries are not recorded as persisted, but deleted on next dump
+        if (StartWith(key, kFileKeyPrefix)) {
+            FileCheckpointPB pb;
+            if (!pb.ParseFromString(value)) {
+                LOG_WARNING(sLogger, ("failed to parse file checkpoint in store, discard it", key));
+                mStaleKeys.emplace_back(std::move(key));
+                continue;
+            }
+            DevInode devInode(pb.dev(), pb.inode());
+            if (!devInode.IsValid()) {
+                LOG_WARNING(sLogger, ("can not find check point dev inode, discard it", pb.file_name()));
+                mStaleKeys.emplace_back(std::move(key));
+                continue;
+            }
+            auto cpt = make_shared<CheckPoint>(pb.file_name(),
+                                               pb.resolved_file_name(),
+                                               pb.offset(),
+                                               pb.sig_size(),
+                                               pb.sig_hash(),
+                                               devInode,
+                                               pb.config_name(),
+                                               pb.real_file_name(),
+                                               pb.file_open(),
+                                               pb.container_stopped(),
+                                               pb.container_id(),
+                                               pb.last_force_read());
+            cpt->mLastUpdateTime = pb.update_time();
+            cpt->mIdxInReaderArray = pb.has_idx_in_reader_array() ? pb.idx_in_reader_array()
+                                                                  : LogFileReader::CHECKPOINT_IDX_UNDEFINED;
+            mPersistedFiles[key].mCheckpoint = *cpt;
+            fileCheckpoints.emplace_back(std::move(cpt));
+        } else if (StartWith(key, kDirKeyPrefix)) {
+            DirCheckpointPB pb;
+            if (!pb.ParseFromString(value)) {
+                LOG_WARNING(sLogger, ("failed to parse dir checkpoint in store, discard it", key));
+                mStaleKeys.emplace_back(std::move(key));
+                continue;
+            }
+            string dirName = key.substr(kDirKeyPrefix.size());
+            if (pb.update_time() < now - INT32_FLAG(file_check_point_time_out)) {
+                LOG_INFO(sLogger, ("load timeout dir check point, ignore", dirName)(ToString(pb.update_time()), now));
+                mStaleKeys.emplace_back(std::move(key));
+                continue;
+            }
+            auto dir = make_shared<DirCheckPoint>(dirName);
+            for (const auto& subDir : pb.sub_dir()) {
+                dir->mSubDir.insert(subDir);
+            }
+            auto& persisted = mPersistedDirs[key];
+            persisted.mSubDir = dir->mSubDir;
+            persisted.mUpdateTime = pb.update_time();
+            dirCheckpoints.emplace(dirName, std::move(dir));
+        }
+    }
+    if (!iter->status().ok()) {
+        LogStoreError("load", mPath, iter->status());
+        return false;
+    }
+    return !fileCheckpoints.empty() || !dirCheckpoints.empty();
+}
+
+bool CheckpointStore::Dump(int32_t version,
+                           const vector<const CheckPoint*>& fileCheckpoints,
+                           const unordered_map<string, DirCheckPointPtr>& dirCheckpoints,
+                           size_t* writtenCnt) {
+    if (!Open()) {
+        return false;
+    }
+    leveldb::WriteBatch batch;
+    size_t cnt = 0;
+    ++mDumpSeq;
+    vector<pair<string, const CheckPoint*>> dirtyFiles;
+    string key, value;
+    for (const auto* cpt : fileCheckpoints) {
+        key = kFileKeyPrefix + GetFileCheckpointKey(*cpt);
+        auto iter = mPersistedFiles.find(key);
+        if (iter != mPersistedFiles.end()) {
+            iter->second.mDumpSeq = mDumpSeq;
+            if (IsSameFileCheckpoint(iter->second.mCheckpoint, *cpt)) {
+                continue;
+            }
+        }
+        SerializeFileCheckpoint(*cpt, value);
+        batch.Put(key, value);
+        dirtyFiles.emplace_back(key, cpt);
+    }
+    // dir checkpoints are recreated with a new update time on each dump, so the update time is only persisted when it
+    // is close to timeout on next load
+    int32_t refreshInterval = INT32_FLAG(file_check_point_time_out) / 2;
+    vector<pair<string, const DirCheckPoint*>> dirtyDirs;
+    for (const auto& item : dirCheckpoints) {
+        key = kDirKeyPrefix + item.first;
+        auto iter = mPersistedDirs.find(key);
+        if (iter != mPersistedDirs.end()) {
+            iter->second.mDumpSeq = mDumpSeq;
+            if (iter->second.mSubDir == item.second->mSubDir
+                && item.second->mUpdateTime - iter->second.mUpdateTime < refreshInterval) {
+                continue;
+            }
+        }
+        SerializeDirCheckpoint(*item.second, value);
+        batch.Put(key, value);
+        dirtyDirs.emplace_back(key, item.second.get());
+    }
+    cnt += dirtyFiles.size() + dirtyDirs.size();
+    for (const auto& item : mPersistedFiles) {
+        if (item.second.mDumpSeq != mDumpSeq) {
+            batch.Delete(item.first);
+            ++cnt;
+        }
+    }
+    for (const auto& item : mPersistedDirs) {
+        if (item.second.mDumpSeq != mDumpSeq) {
+            batch.Delete(item.first);
+            ++cnt;
+        }
+    }
+    for (const auto& item : mStaleKeys) {
+        batch.Delete(item);
+    }
+    string versionStr = ToString(version);
+    if (versionStr != mPersistedVersion) {
+        batch.Put(kVersionKey, versionStr);
+    }
+
+    leveldb::WriteOptions options;
+    options.sync = true;
+    leveldb::Status s = mDatabase->Write(options, &batch);
+    if (!s.ok()) {
+        LogStoreError("write", mPath, s);
+        return false;
+    }
+
+    for (auto iter = mPersistedFiles.begin(); iter != mPersistedFiles.end();) {
+        iter = iter->second.mDumpSeq != mDumpSeq ? mPersistedFiles.erase(iter) : next(iter);
+    }
+    for (auto iter = mPersistedDirs.begin(); iter != mPersistedDirs.end();) {
+        iter = iter->second.mDumpSeq != mDumpSeq ? mPersistedDirs.erase(iter) : next(iter);
+    }
+    for (const auto& item : dirtyFiles) {
+        auto& persisted = mPersistedFiles[item.first];
+        persisted.mCheckpoint = *item.second;
+        persisted.mCheckpoint.mCache.clear();
+        persisted.mDumpSeq = mDumpSeq;
+    }
+    for (const auto& item : dirtyDirs) {
+        auto& persisted = mPersistedDirs[item.first];
+        persisted.mSubDir = item.second->mSubDir;
+        persisted.mUpdateTime = item.second->mUpdateTime;
+        persisted.mDumpSeq = mDumpSeq;
+    }
+    mStaleKeys.clear();
+    mPersistedVersion.swap(versionStr);
+    if (writtenCnt != nullptr) {
+        *writtenCnt = cnt;
+    }
+    return true;
+}
+
+} // namespace logtail
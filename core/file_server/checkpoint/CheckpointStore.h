@@ -0,0 +1,98 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "leveldb/db.h"
+
+#include "file_server/checkpoint/CheckPointManager.h"
+
+namespace logtail {
+
+// CheckpointStore persists v1 file and dir checkpoints incrementally.
+//
+// Unlike the json checkpoint file, which is rewritten as a whole on each dump, each checkpoint is stored as a
+// protobuf value in a LevelDB database, and only entries changed since the last load or dump are written. Dirty
+// entries are found by comparing the fields with the persisted ones, so that unchanged entries are not serialized at
+// all. All writes of one dump are committed in a single synced write batch, so that the store is never left half
+// written. Compaction is done by LevelDB in background.
+class CheckpointStore {
+public:
+    explicit CheckpointStore(const std::string& path) : mPath(path) {}
+    ~CheckpointStore() { Close(); }
+    CheckpointStore(const CheckpointStore&) = delete;
+    CheckpointStore& operator=(const CheckpointStore&) = delete;
+
+    bool Open();
+    void Close();
+    bool IsOpen() const { return mDatabase != nullptr; }
+
+    // Load all checkpoints in the store, which are then treated as persisted.
+    //
+    // @return false if the store cannot be read or contains no checkpoint.
+    bool Load(int32_t& version,
+              std::vector<CheckPointPtr>& fileCheckpoints,
+              std::unordered_map<std::string, DirCheckPointPtr>& dirCheckpoints);
+
+    // Write checkpoints changed since the last load or dump, and delete those no longer given.
+    //
+    // @writtenCnt [out]: number of entries put or deleted, if not nullptr.
+    bool Dump(int32_t version,
+              const std::vector<const CheckPoint*>& fileCheckpoints,
+              const std::unordered_map<std::string, DirCheckPointPtr>& dirCheckpoints,
+              size_t* writtenCnt = nullptr);
+
+    static std::string GetFileCheckpointKey(const CheckPoint& checkpoint);
+    // Remove the store at @path, which must not be open.
+    static bool Destroy(const std::string& path);
+
+private:
+    struct PersistedFileCheckpoint {
+        CheckPoint mCheckpoint;
+        uint64_t mDumpSeq = 0;
+    };
+    struct PersistedDirCheckpoint {
+        std::set<std::string> mSubDir;
+        int32_t mUpdateTime = 0;
+        uint64_t mDumpSeq = 0;
+    };
+
+    static bool IsSameFileCheckpoint(const CheckPoint& lhs, const CheckPoint& rhs);
+
+    std::string mPath;
+    leveldb::DB* mDatabase = nullptr;
+    // persisted entries by key, used to find dirty entries. mDumpSeq marks the entries given in the latest dump, the
+    // others are deleted.
+    std::unordered_map<std::string, PersistedFileCheckpoint> mPersistedFiles;
+    std::unordered_map<std::string, PersistedDirCheckpoint> mPersistedDirs;
+    std::string mPersistedVersion;
+    // broken or timeout entries found on load, deleted on next dump
+    std::vector<std::string> mStaleKeys;
+    uint64_t mDumpSeq = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class CheckpointManagerUnittest;
+#endif
+};
+
+} // namespace logtail
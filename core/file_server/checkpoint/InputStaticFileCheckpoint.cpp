@@ -164,6 +164,81 @@ bool InputStaticFileCheckpoint::GetCurrentFileFingerprint(FileFingerprint* cpt)
     return true;
 }
 
+bool InputStaticFileCheckpoint::SetCurrentFileRanges(vector<FileRangeCheckpoint>&& ranges,
+                                                     uint64_t size,
+                                                     bool& needDump) {
+    if (mCurrentFileIndex >= mFileCheckpoints.size()) {
+        // should not happen
+        return false;
+    }
+    needDump = false;
+    auto& fileCpt = mFileCheckpoints[mCurrentFileIndex];
+    if (!fileCpt.mRanges.empty()
+        || (fileCpt.mStatus != FileStatus::WAITING && fileCpt.mStatus != FileStatus::READING)) {
+        // should not happen
+        return false;
+    }
+    if (fileCpt.mStatus == FileStatus::WAITING) {
+        fileCpt.mStatus = FileStatus::READING;
+        fileCpt.mStartTime = time(nullptr);
+    }
+    fileCpt.mRanges = std::move(ranges);
+    fileCpt.mSize = size;
+    fileCpt.mOffset = 0;
+    fileCpt.mLastUpdateTime = time(nullptr);
+    needDump = true;
+    LOG_INFO(sLogger,
+             ("begin to read file in ranges, config", mConfigName)("input idx", mInputIdx)(
+                 "current file idx", mCurrentFileIndex)("filepath", fileCpt.mFilePath.string())(
+                 "device", fileCpt.mDevInode.dev)("inode", fileCpt.mDevInode.inode)("size", size)(
+                 "range count", fileCpt.mRanges.size()));
+    return true;
+}
+
+bool InputStaticFileCheckpoint::GetCurrentFileRanges(vector<FileRangeCheckpoint>* ranges) const {
+    if (!ranges) {
+        // should not happen
+        return false;
+    }
+    if (mStatus != StaticFileReadingStatus::RUNNING || mCurrentFileIndex >= mFileCheckpoints.size()) {
+        return false;
+    }
+    *ranges = mFileCheckpoints[mCurrentFileIndex].mRanges;
+    return true;
+}
+
+bool InputStaticFileCheckpoint::UpdateCurrentFileRangeCheckpoint(size_t rangeIdx, uint64_t offset, bool& needDump) {
+    if (mCurrentFileIndex >= mFileCheckpoints.size()) {
+        return false;
+    }
+    needDump = false;
+    auto& fileCpt = mFileCheckpoints[mCurrentFileIndex];
+    if (fileCpt.mStatus != FileStatus::READING || rangeIdx >= fileCpt.mRanges.size()) {
+        return false;
+    }
+    auto& range = fileCpt.mRanges[rangeIdx];
+    offset = min(offset, range.mEnd);
+    if (offset < range.mOffset) {
+        // should not happen
+        return false;
+    }
+    fileCpt.mOffset += offset - range.mOffset;
+    fileCpt.mLastUpdateTime = time(nullptr);
+    range.mOffset = offset;
+    if (!range.IsFinished()) {
+        return true;
+    }
+    needDump = true;
+    for (const auto& item : fileCpt.mRanges) {
+        if (!item.IsFinished()) {
+            return true;
+        }
+    }
+    fileCpt.mRanges.clear();
+    bool unused = false;
+    return UpdateCurrentFileCheckpoint(fileCpt.mSize, fileCpt.mSize, unused);
+}
+
 void InputStaticFileCheckpoint::SetAbort() {
     if (mStatus == StaticFileReadingStatus::RUNNING) {
         mStatus = StaticFileReadingStatus::ABORT;
@@ -213,6 +288,16 @@ bool InputStaticFileCheckpoint::Serialize(string* res) const {
                 file["offset"] = cpt.mOffset;
                 file["start_time"] = cpt.mStartTime;
                 file["last_read_time"] = cpt.mLastUpdateTime;
+                if (!cpt.mRanges.empty()) {
+                    file["ranges"] = Json::arrayValue;
+                    for (const auto& range : cpt.mRanges) {
+                        Json::Value rangeJson;
+                        rangeJson["begin"] = range.mBegin;
+                        rangeJson["end"] = range.mEnd;
+                        rangeJson["offset"] = range.mOffset;
+                        file["ranges"].append(rangeJson);
+                    }
+                }
                 break;
             case FileStatus::FINISHED:
                 file["size"] = cpt.mSize;
@@ -351,6 +436,30 @@ bool InputStaticFileCheckpoint::Deserialize(const string& str, string* errMsg) {
                 if (!GetMandatoryIntParam(fileCpt, outerKey + ".last_read_time", cpt.mLastUpdateTime, *errMsg)) {
                     return false;
                 }
+                if (fileCpt.isMember("ranges")) {
+                    const auto& ranges = fileCpt["ranges"];
+                    if (!ranges.isArray()) {
+                        *errMsg = "optional param " + outerKey + ".ranges is not of type array";
+                        return false;
+                    }
+                    for (Json::Value::ArrayIndex j = 0; j < ranges.size(); ++j) {
+                        string rangeKey = outerKey + ".ranges[" + ToString(j) + "]";
+                        if (!ranges[j].isObject()) {
+                            *errMsg = "mandatory param " + rangeKey + " is not of type object";
+                            return false;
+                        }
+                        auto& range = cpt.mRanges.emplace_back();
+                        if (!GetMandatoryUInt64Param(ranges[j], rangeKey + ".begin", range.mBegin, *errMsg)) {
+                            return false;
+                        }
+                        if (!GetMandatoryUInt64Param(ranges[j], rangeKey + ".end", range.mEnd, *errMsg)) {
+                            return false;
+                        }
+                        if (!GetMandatoryUInt64Param(ranges[j], rangeKey + ".offset", range.mOffset, *errMsg)) {
+                            return false;
+                        }
+                    }
+                }
                 break;
             case FileStatus::FINISHED:
                 if (!GetMandatoryUInt64Param(fileCpt, outerKey + ".size", cpt.mSize, *errMsg)) {
@@ -46,6 +46,10 @@ public:
     bool UpdateCurrentFileCheckpoint(uint64_t offset, uint64_t size, bool& needDump);
     bool InvalidateCurrentFileCheckpoint();
     bool GetCurrentFileFingerprint(FileFingerprint* cpt);
+    // ranges can only be set once for each file, and the file is finished when all ranges are finished
+    bool SetCurrentFileRanges(std::vector<FileRangeCheckpoint>&& ranges, uint64_t size, bool& needDump);
+    bool GetCurrentFileRanges(std::vector<FileRangeCheckpoint>* ranges) const;
+    bool UpdateCurrentFileRangeCheckpoint(size_t rangeIdx, uint64_t offset, bool& needDump);
     void SetAbort();
 
     bool Serialize(std::string* res) const;
@@ -234,6 +234,63 @@ bool InputStaticFileCheckpointManager::GetCurrentFileFingerprint(const string& c
     return it->second.GetCurrentFileFingerprint(cpt);
 }
 
+bool InputStaticFileCheckpointManager::SetCurrentFileRanges(const string& configName,
+                                                            size_t idx,
+                                                            vector<FileRangeCheckpoint>&& ranges,
+                                                            uint64_t size) {
+    lock_guard<mutex> lock(mUpdateMux);
+    auto it = mInputCheckpointMap.find(make_pair(configName, idx));
+    if (it == mInputCheckpointMap.end()) {
+        // should not happen
+        return false;
+    }
+    bool needDump = false;
+    if (!it->second.SetCurrentFileRanges(std::move(ranges), size, needDump)) {
+        // should not happen
+        return false;
+    }
+    if (needDump && !DumpCheckpointFile(it->second)) {
+        LOG_WARNING(sLogger,
+                    ("failed to set file ranges", "failed to dump checkpoint file")("config", configName)("input idx",
+                                                                                                       idx));
+    }
+    return true;
+}
+
+bool InputStaticFileCheckpointManager::GetCurrentFileRanges(const string& configName,
+                                                            size_t idx,
+                                                            vector<FileRangeCheckpoint>* ranges) {
+    lock_guard<mutex> lock(mUpdateMux);
+    auto it = mInputCheckpointMap.find(make_pair(configName, idx));
+    if (it == mInputCheckpointMap.end()) {
+        // should not happen
+        return false;
+    }
+    return it->second.GetCurrentFileRanges(ranges);
+}
+
+bool InputStaticFileCheckpointManager::UpdateCurrentFileRangeCheckpoint(const string& configName,
+                                                                        size_t idx,
+                                                                        size_t rangeIdx,
+                                                                        uint64_t offset) {
+    lock_guard<mutex> lock(mUpdateMux);
+    auto it = mInputCheckpointMap.find(make_pair(configName, idx));
+    if (it == mInputCheckpointMap.end()) {
+        // the input has been removed while the range is being read
+        return false;
+    }
+    bool needDump = false;
+    if (!it->second.UpdateCurrentFileRangeCheckpoint(rangeIdx, offset, needDump)) {
+        return false;
+    }
+    if (needDump && !DumpCheckpointFile(it->second)) {
+        LOG_WARNING(sLogger,
+                    ("failed to update file range checkpoint",
+                     "failed to dump checkpoint file")("config", configName)("input idx", idx));
+    }
+    return true;
+}
+
 void InputStaticFileCheckpointManager::DumpAllCheckpointFiles() const {
     lock_guard<mutex> lock(mUpdateMux);
     for (const auto& item : mInputCheckpointMap) {
@@ -51,6 +51,12 @@ public:
     bool UpdateCurrentFileCheckpoint(const std::string& configName, size_t idx, uint64_t offset, uint64_t size);
     bool InvalidateCurrentFileCheckpoint(const std::string& configName, size_t idx);
     bool GetCurrentFileFingerprint(const std::string& configName, size_t idx, FileFingerprint* cpt);
+    bool SetCurrentFileRanges(const std::string& configName,
+                              size_t idx,
+                              std::vector<FileRangeCheckpoint>&& ranges,
+                              uint64_t size);
+    bool GetCurrentFileRanges(const std::string& configName, size_t idx, std::vector<FileRangeCheckpoint>* ranges);
+    bool UpdateCurrentFileRangeCheckpoint(const std::string& configName, size_t idx, size_t rangeIdx, uint64_t offset);
 
     void DumpAllCheckpointFiles() const;
     void GetAllCheckpointFileNames();
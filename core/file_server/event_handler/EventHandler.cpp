@@ -201,6 +201,20 @@ bool CreateModifyHandler::IsAllFileRead() {
     return true;
 }
 
+void CreateModifyHandler::RemoveModifyHandlers(const std::unordered_set<std::string>& configNames) {
+    for (auto iter = mModifyHandlerPtrMap.begin(); iter != mModifyHandlerPtrMap.end();) {
+        if (configNames.find(iter->first) == configNames.end()) {
+            ++iter;
+            continue;
+        }
+        iter->second->DumpReaderMeta(true, true);
+        iter->second->DumpReaderMeta(false, true);
+        // destructed later in the main thread, same as the handlers removed by EventDispatcher::DumpAllHandlersMeta
+        ConfigManager::GetInstance()->AddHandlerToDelete(iter->second);
+        iter = mModifyHandlerPtrMap.erase(iter);
+    }
+}
+
 ModifyHandler* CreateModifyHandler::GetOrCreateModifyHandler(const std::string& configName,
                                                              const FileDiscoveryConfig& pConfig) {
     ModifyHandlerMap::iterator iter = mModifyHandlerPtrMap.find(configName);
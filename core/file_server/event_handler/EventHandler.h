@@ -20,6 +20,7 @@
 #include <deque>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "file_server/reader/LogFileReader.h"
 
@@ -40,6 +41,8 @@ public:
     virtual void HandleTimeOut() = 0;
     virtual bool DumpReaderMeta(bool isRotatorReader, bool checkConfigFlag) = 0;
     virtual bool IsAllFileRead() { return true; }
+    // dump the reader meta of @configNames and drop their readers, other configs are not affected
+    virtual void RemoveModifyHandlers(const std::unordered_set<std::string>& configNames) {}
     virtual ~EventHandler() {}
 };
 
@@ -170,6 +173,7 @@ public:
     virtual void HandleTimeOut();
     virtual bool DumpReaderMeta(bool isRotatorReader, bool checkConfigFlag);
     bool IsAllFileRead() override;
+    void RemoveModifyHandlers(const std::unordered_set<std::string>& configNames) override;
 
     ModifyHandler* GetOrCreateModifyHandler(const std::string& configName, const FileDiscoveryConfig& pConfig);
 
@@ -18,6 +18,7 @@
 
 #include "app_config/AppConfig.h"
 #include "application/Application.h"
+#include "collection_pipeline/limiter/CpuGovernor.h"
 #include "common/FileSystemUtil.h"
 #include "common/HashUtil.h"
 #include "common/LogtailCommonFlags.h"
@@ -153,52 +154,13 @@ void LogInput::TryReadEvents(bool forceRead) {
     mLastReadEventTime = ((int32_t)time(NULL));
 }
 
-void LogInput::FlowControl() {
-    const static int32_t FLOW_CONTROL_SLEEP_MICROSECONDS = 20 * 1000; // 20ms
-    const static int32_t MAX_SLEEP_COUNT = 50; // 1s
-    static int32_t sleepCount = 10;
-    static int32_t lastCheckTime = 0;
-    int32_t i = 0;
-    while (i < sleepCount) {
-        if (mInteruptFlag)
+void LogInput::FlowControl(uint32_t priority) {
+    // events are still handled while waiting for cpu quota, so that they are not lost
+    while (!CpuGovernor::GetInstance()->Acquire(priority, 100)) {
+        if (mInteruptFlag) {
             return;
-        usleep(FLOW_CONTROL_SLEEP_MICROSECONDS);
-        ++i;
-        if (i % 5 == 0)
-            TryReadEvents(true);
-    }
-
-    if (mInteruptFlag)
-        return;
-    int32_t curTime = time(NULL);
-    if (curTime - lastCheckTime >= 1) {
-        lastCheckTime = curTime;
-        double cpuUsageLevel = LogtailMonitor::GetInstance()->GetRealtimeCpuLevel();
-        if (cpuUsageLevel >= 1.5) {
-            sleepCount += 5;
-            if (sleepCount > MAX_SLEEP_COUNT)
-                sleepCount = MAX_SLEEP_COUNT;
-        } else if (cpuUsageLevel >= 1.2) {
-            sleepCount += 2;
-            if (sleepCount > MAX_SLEEP_COUNT)
-                sleepCount = MAX_SLEEP_COUNT;
-        } else if (cpuUsageLevel >= 1.0) {
-            if (sleepCount < MAX_SLEEP_COUNT)
-                ++sleepCount;
-        } else if (cpuUsageLevel >= 0.9) {
-        } else if (cpuUsageLevel >= 0.6) {
-            if (sleepCount > 0)
-                --sleepCount;
-        } else if (cpuUsageLevel >= 0.3) {
-            sleepCount -= 2;
-            if (sleepCount < 0)
-                sleepCount = 0;
-        } else {
-            sleepCount -= 5;
-            if (sleepCount < 0)
-                sleepCount = 0;
         }
-        LOG_DEBUG(sLogger, ("cpuUsageLevel", cpuUsageLevel)("sleepCount", sleepCount));
+        TryReadEvents(true);
     }
 }
 
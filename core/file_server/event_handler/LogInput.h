@@ -45,7 +45,7 @@ public:
     void PushEventQueue(std::vector<Event*>& eventVec);
     void PushEventQueue(Event* ev);
     void TryReadEvents(bool forceRead);
-    void FlowControl();
+    void FlowControl(uint32_t priority);
     bool IsInterupt() { return mInteruptFlag; }
 
     /**
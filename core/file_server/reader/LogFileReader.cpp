@@ -951,7 +951,7 @@ bool LogFileReader::ReadLog(LogBuffer& logBuffer, const Event* event) {
         return false;
     }
     if (AppConfig::GetInstance()->IsInputFlowControl()) {
-        LogInput::GetInstance()->FlowControl();
+        LogInput::GetInstance()->FlowControl(mReaderConfig.second->GetGlobalConfig().mPriority);
     }
     if ((event == nullptr || !event->IsReaderFlushTimeout()) && mFirstWatched && (mLastFilePos == 0)) {
         CheckForFirstOpen();
@@ -1007,6 +1007,11 @@ bool LogFileReader::ReadLog(LogBuffer& logBuffer, const Event* event) {
             GetQueueKey(), GetConfigName(), *event, mDevInode, time(NULL) + mReaderConfig.first->mFlushTimeoutSecs);
     }
     logBuffer.rawBuffer = Trim(logBuffer.rawBuffer, kNullSv);
+    // only the reads producing data count towards the sample interval
+    if (!logBuffer.rawBuffer.empty() && EventGroupTrace::ShouldSample()) {
+        logBuffer.trace = std::make_shared<EventGroupTrace>();
+        logBuffer.trace->Stamp(TraceStamp::READ);
+    }
     return moreData;
 }
 
@@ -2468,6 +2473,7 @@ void LogFileReader::SetEventGroupMetaAndTag(PipelineEventGroup& group) {
 PipelineEventGroup LogFileReader::GenerateEventGroup(LogFileReaderPtr reader, LogBuffer* logBuffer) {
     PipelineEventGroup group{std::shared_ptr<SourceBuffer>(std::move(logBuffer->sourcebuffer))};
     reader->SetEventGroupMetaAndTag(group);
+    group.SetTrace(logBuffer->trace);
 
     LogEvent* event = group.AddLogEvent();
     time_t logtime = time(nullptr);
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <deque>
 #include <string>
@@ -41,6 +42,7 @@
 #include "file_server/event/Event.h"
 #include "file_server/reader/FileReaderOptions.h"
 #include "logger/Logger.h"
+#include "models/EventGroupTrace.h"
 #include "protobuf/sls/sls_logs.pb.h"
 
 namespace logtail {
@@ -256,6 +258,9 @@ public:
 
     int64_t GetFileSize() const { return mLastFileSize; }
 
+    // caps reading at end, which should be the beginning of a line, so that a range of the file is read on its own
+    void SetReadEnd(int64_t end) { mLastFileSize = std::min(mLastFileSize, end); }
+
     int64_t GetLastFilePos() const { return mLastFilePos; }
 
     int32_t GetIdxInReaderArrayFromLastCpt() const { return mIdxInReaderArrayFromLastCpt; }
@@ -743,6 +748,8 @@ struct LogBuffer {
     uint64_t readOffset = 0;
     uint64_t readLength = 0;
     std::unique_ptr<SourceBuffer> sourcebuffer;
+    // Not null only when this read is sampled for latency tracing.
+    EventGroupTracePtr trace;
 
     LogBuffer() : sourcebuffer(new SourceBuffer()) {}
     void SetDependecy(const LogFileReaderPtr& reader) { logFileReader = reader; }
@@ -16,10 +16,15 @@
 
 #include "forward/loongsuite/LoongSuiteForwardService.h"
 
+#include <grpcpp/alarm.h>
 #include <grpcpp/support/status.h>
 
+#include <chrono>
 #include <memory>
+#include <mutex>
 
+#include "collection_pipeline/queue/ProcessQueueItem.h"
+#include "collection_pipeline/queue/ProcessQueueManager.h"
 #include "common/Flags.h"
 #include "common/ParamExtractor.h"
 #include "grpcpp/support/status.h"
@@ -27,6 +32,15 @@
 #include "models/PipelineEventGroup.h"
 #include "runner/ProcessorRunner.h"
 
+DEFINE_FLAG_INT32(grpc_server_forward_stream_batch_size_bytes,
+                  "data of forward stream are pushed to process queue once batched to this size, bytes",
+                  512 * 1024);
+DEFINE_FLAG_INT32(grpc_server_forward_stream_flush_interval_ms,
+                  "max time for data of forward stream to stay in batch, ms",
+                  100);
+DEFINE_FLAG_INT32(grpc_server_forward_stream_max_blocked_ms,
+                  "forward stream fails if process queue remains full for this long, ms",
+                  30000);
 
 DECLARE_FLAG_INT32(grpc_server_forward_max_retry_times);
 
@@ -107,6 +121,238 @@ grpc::ServerUnaryReactor* LoongSuiteForwardServiceImpl::Forward(grpc::CallbackSe
     return reactor;
 }
 
+// Reads a client stream of forward requests, batches data into event groups of target size and pushes them to the
+// process queue. When the queue is full, reading is paused, so that the client is throttled by gRPC flow control.
+//
+// All callbacks are serialized by mMux, and none of them blocks. At most one read and one alarm are pending at any
+// time, and Finish is only called when no read is pending. Data already read is never dropped: if the stream ends
+// before the batch is pushed, e.g., it is cancelled or fails with UNAVAILABLE, the alarm keeps pushing the batch
+// after Finish. So the reactor is deleted by whichever of OnDone and the last alarm comes later.
+class ForwardStreamReactor : public grpc::ServerReadReactor<LoongSuiteForwardRequest> {
+public:
+    explicit ForwardStreamReactor(std::shared_ptr<ForwardConfig> config) : mConfig(std::move(config)) {
+        std::lock_guard<std::mutex> lock(mMux);
+        StartReadLocked();
+    }
+
+    void OnReadDone(bool ok) override {
+        std::lock_guard<std::mutex> lock(mMux);
+        mIsReading = false;
+        if (mIsFinishPending) {
+            FinishLocked(mPendingStatus);
+            return;
+        }
+        if (!ok) {
+            // client half-closed or the call is cancelled
+            mIsReadsDone = true;
+            if (mIsCancelled) {
+                FinishLocked(grpc::Status::CANCELLED);
+            } else if (!TryFlushLocked()) {
+                BlockLocked();
+            } else {
+                FinishLocked(grpc::Status::OK);
+            }
+            return;
+        }
+
+        if (mBatchSize == 0) {
+            mBatchStartTime = std::chrono::steady_clock::now();
+        }
+        mBatchSize += LoongSuiteForwardServiceImpl::AddRawEvents(mRequest, mEventGroup);
+        mRequest.Clear();
+        if (mBatchSize >= static_cast<size_t>(INT32_FLAG(grpc_server_forward_stream_batch_size_bytes))
+            && !TryFlushLocked()) {
+            BlockLocked();
+            return;
+        }
+        StartReadLocked();
+        if (mBatchSize > 0 && !mIsAlarmSet) {
+            SetAlarmLocked(mBatchStartTime
+                           + std::chrono::milliseconds(INT32_FLAG(grpc_server_forward_stream_flush_interval_ms)));
+        }
+    }
+
+    void OnCancel() override {
+        std::lock_guard<std::mutex> lock(mMux);
+        mIsCancelled = true;
+        // the pending read, if any, will be done with ok = false
+        if (mIsAlarmSet && !mIsFinished) {
+            mAlarm.Cancel();
+        }
+    }
+
+    void OnDone() override {
+        std::unique_lock<std::mutex> lock(mMux);
+        mIsDone = true;
+        if (mIsAlarmSet) {
+            // the batch left is still being pushed, the reactor is deleted by the last alarm
+            return;
+        }
+        lock.unlock();
+        delete this;
+    }
+
+private:
+    void OnAlarm(bool ok) {
+        std::unique_lock<std::mutex> lock(mMux);
+        mIsAlarmSet = false;
+        if (mIsFinished) {
+            if (!TryFlushLocked()) {
+                if (mIsQueueExisted) {
+                    SetAlarmLocked(std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
+                    return;
+                }
+                LOG_WARNING(sLogger,
+                            ("discard batch of forward stream", "process queue not found")("config",
+                                                                                          mConfig->configName)(
+                                "batch size", mBatchSize));
+            }
+            if (mIsDone) {
+                lock.unlock();
+                delete this;
+            }
+            return;
+        }
+        if (mIsFinishPending) {
+            // finished once the pending read is done
+            return;
+        }
+        if (mIsCancelled) {
+            FinishLocked(grpc::Status::CANCELLED);
+            return;
+        }
+        if (!ok) {
+            return;
+        }
+        if (!mIsBlocked) {
+            // flush interval reached, try once without pausing the stream
+            if (!TryFlushLocked()) {
+                SetAlarmLocked(std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
+            }
+            return;
+        }
+        if (TryFlushLocked()) {
+            mIsBlocked = false;
+            if (mIsReadsDone) {
+                FinishLocked(grpc::Status::OK);
+            } else {
+                StartReadLocked();
+            }
+            return;
+        }
+        if (std::chrono::steady_clock::now() - mBlockStartTime
+            > std::chrono::milliseconds(INT32_FLAG(grpc_server_forward_stream_max_blocked_ms))) {
+            FinishLocked(grpc::Status(grpc::StatusCode::UNAVAILABLE, "Queue is full, please retry later"));
+            return;
+        }
+        SetAlarmLocked(std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
+    }
+
+    // pushes the batch without waiting, since it runs on gRPC threads
+    bool TryFlushLocked() {
+        if (mEventGroup.GetEvents().empty()) {
+            mBatchSize = 0;
+            return true;
+        }
+        // backs off on the high watermark and the memory budget, instead of only when the queue is completely full.
+        // Once finished, nothing is read any more, so the batch left is pushed as long as there is room, which also
+        // tells whether the queue is removed.
+        if (!mIsFinished && !ProcessQueueManager::GetInstance()->IsValidToPush(mConfig->queueKey)) {
+            return false;
+        }
+        auto item = std::make_unique<ProcessQueueItem>(std::move(mEventGroup), mConfig->inputIndex);
+        auto status = ProcessQueueManager::GetInstance()->PushQueue(mConfig->queueKey, std::move(item));
+        mIsQueueExisted = status != QueueStatus::QUEUE_NOT_EXIST;
+        if (status != QueueStatus::OK) {
+            mEventGroup = std::move(item->mEventGroup);
+            return false;
+        }
+        mEventGroup = PipelineEventGroup(std::make_shared<SourceBuffer>());
+        mBatchSize = 0;
+        return true;
+    }
+
+    // stops reading until the batch is pushed, retrying in the alarm
+    void BlockLocked() {
+        mIsBlocked = true;
+        mBlockStartTime = std::chrono::steady_clock::now();
+        if (!mIsAlarmSet) {
+            SetAlarmLocked(mBlockStartTime + std::chrono::milliseconds(10));
+        }
+    }
+
+    void StartReadLocked() {
+        mIsReading = true;
+        StartRead(&mRequest);
+    }
+
+    void SetAlarmLocked(std::chrono::steady_clock::time_point deadline) {
+        mIsAlarmSet = true;
+        auto systemDeadline = std::chrono::system_clock::now() + (deadline - std::chrono::steady_clock::now());
+        mAlarm.Set(systemDeadline, [this](bool ok) { OnAlarm(ok); });
+    }
+
+    void FinishLocked(const grpc::Status& status) {
+        if (mIsFinished) {
+            return;
+        }
+        if (mIsReading) {
+            // wait for the pending read, which is expedited by cancellation
+            mPendingStatus = status;
+            mIsFinishPending = true;
+            return;
+        }
+        mIsFinished = true;
+        Finish(status);
+        // the batch left is pushed in the alarm, which is set already if blocked
+        if (!mEventGroup.GetEvents().empty() && !mIsAlarmSet) {
+            if (!status.ok()) {
+                LOG_INFO(sLogger,
+                         ("forward stream ends before the batch is pushed, keep pushing it", mConfig->configName)(
+                             "status", status.error_message())("batch size", mBatchSize));
+            }
+            SetAlarmLocked(std::chrono::steady_clock::now());
+        }
+    }
+
+    std::shared_ptr<ForwardConfig> mConfig;
+    LoongSuiteForwardRequest mRequest;
+    PipelineEventGroup mEventGroup = PipelineEventGroup(std::make_shared<SourceBuffer>());
+    size_t mBatchSize = 0;
+    std::chrono::steady_clock::time_point mBatchStartTime;
+    std::chrono::steady_clock::time_point mBlockStartTime;
+
+    grpc::Alarm mAlarm;
+    bool mIsCancelled = false;
+    bool mIsReading = false;
+    bool mIsReadsDone = false;
+    bool mIsAlarmSet = false;
+    bool mIsBlocked = false;
+    bool mIsFinishPending = false;
+    bool mIsFinished = false;
+    bool mIsDone = false;
+    // the batch is dropped once the pipeline is removed
+    bool mIsQueueExisted = true;
+    grpc::Status mPendingStatus;
+    std::mutex mMux;
+};
+
+grpc::ServerReadReactor<LoongSuiteForwardRequest>*
+LoongSuiteForwardServiceImpl::ForwardStream(grpc::CallbackServerContext* context, LoongSuiteForwardResponse* response) {
+    std::shared_ptr<ForwardConfig> config;
+    if (!FindMatchingConfig(context, config)) {
+        class NotFoundReactor : public grpc::ServerReadReactor<LoongSuiteForwardRequest> {
+        public:
+            NotFoundReactor() {
+                Finish(grpc::Status(grpc::StatusCode::NOT_FOUND, "No matching config found for forward request"));
+            }
+            void OnDone() override { delete this; }
+        };
+        return new NotFoundReactor();
+    }
+    return new ForwardStreamReactor(std::move(config));
+}
+
 void LoongSuiteForwardServiceImpl::ProcessForwardRequest(const LoongSuiteForwardRequest* request,
                                                          std::shared_ptr<ForwardConfig> config,
                                                          int32_t retryTimes,
@@ -122,20 +368,18 @@ void LoongSuiteForwardServiceImpl::ProcessForwardRequest(const LoongSuiteForward
     }
 
     auto eventGroup = PipelineEventGroup(std::make_shared<SourceBuffer>());
-    for (const auto& singleData : request->data()) {
-        if (singleData.empty()) {
-            continue;
-        }
-        auto* event = eventGroup.AddRawEvent();
-        event->SetContent(singleData);
-        event->SetTimestamp(time(nullptr), 0);
-    }
-
+    AddRawEvents(*request, eventGroup);
     if (eventGroup.GetEvents().empty()) {
         status = grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "No raw event in forward request");
         return;
     }
 
+    // backs off on the high watermark and the memory budget, so that the client retries later
+    if (!ProcessQueueManager::GetInstance()->IsValidToPush(config->queueKey)) {
+        status = grpc::Status(grpc::StatusCode::UNAVAILABLE, "Queue is full, please retry later");
+        return;
+    }
+
     bool result = ProcessorRunner::GetInstance()->PushQueue(
         config->queueKey, config->inputIndex, std::move(eventGroup), retryTimes);
 
@@ -146,6 +390,22 @@ void LoongSuiteForwardServiceImpl::ProcessForwardRequest(const LoongSuiteForward
     }
 }
 
+size_t LoongSuiteForwardServiceImpl::AddRawEvents(const LoongSuiteForwardRequest& request,
+                                                  PipelineEventGroup& eventGroup) {
+    size_t size = 0;
+    time_t now = time(nullptr);
+    for (const auto& singleData : request.data()) {
+        if (singleData.empty()) {
+            continue;
+        }
+        auto* event = eventGroup.AddRawEvent();
+        event->SetContent(singleData);
+        event->SetTimestamp(now, 0);
+        size += singleData.size();
+    }
+    return size;
+}
+
 bool LoongSuiteForwardServiceImpl::AddToIndex(std::string& configName, ForwardConfig&& config, std::string& errorMsg) {
     errorMsg.clear();
     std::unique_lock<std::shared_mutex> lock(mMatchIndexMutex);
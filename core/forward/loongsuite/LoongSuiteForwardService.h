@@ -24,6 +24,7 @@
 
 #include "collection_pipeline/queue/QueueKey.h"
 #include "forward/BaseService.h"
+#include "models/PipelineEventGroup.h"
 #include "protobuf/forward/loongsuite.grpc.pb.h"
 
 namespace logtail {
@@ -88,6 +89,8 @@ public:
     grpc::ServerUnaryReactor* Forward(grpc::CallbackServerContext* context,
                                       const LoongSuiteForwardRequest* request,
                                       LoongSuiteForwardResponse* response) override;
+    grpc::ServerReadReactor<LoongSuiteForwardRequest>* ForwardStream(grpc::CallbackServerContext* context,
+                                                                    LoongSuiteForwardResponse* response) override;
 
 private:
     static const std::string sName;
@@ -105,6 +108,10 @@ private:
                                std::shared_ptr<ForwardConfig> config,
                                int32_t retryTimes,
                                grpc::Status& status);
+    // @return size of data added to @eventGroup
+    static size_t AddRawEvents(const LoongSuiteForwardRequest& request, PipelineEventGroup& eventGroup);
+
+    friend class ForwardStreamReactor;
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class GrpcInputManagerUnittest;
     friend class LoongSuiteForwardServiceUnittest;
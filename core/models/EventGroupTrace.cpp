@@ -0,0 +1,67 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "models/EventGroupTrace.h"
+
+#include <algorithm>
+
+#include "common/Flags.h"
+
+DEFINE_FLAG_INT32(event_group_trace_sample_interval,
+                  "trace one out of every n event groups from input to flusher ack, 0 means disabled",
+                  0);
+
+using namespace std;
+
+namespace logtail {
+
+static const char* sStageNames[EventGroupTrace::kStageCnt]
+    = {"read", "process_queue", "process", "batch", "sender_queue"};
+
+bool EventGroupTrace::ShouldSample() {
+    int32_t interval = INT32_FLAG(event_group_trace_sample_interval);
+    if (interval <= 0) {
+        return false;
+    }
+    static thread_local uint32_t sCnt = 0;
+    if (++sCnt < static_cast<uint32_t>(interval)) {
+        return false;
+    }
+    sCnt = 0;
+    return true;
+}
+
+const char* EventGroupTrace::GetStageName(size_t stage) {
+    return stage < kStageCnt ? sStageNames[stage] : "unknown";
+}
+
+bool EventGroupTrace::GetStageLatency(size_t stage, chrono::nanoseconds& latency) const {
+    if (stage >= kStageCnt || mStamps[stage] == 0 || mStamps[stage + 1] == 0) {
+        return false;
+    }
+    latency = chrono::nanoseconds(max<int64_t>(mStamps[stage + 1] - mStamps[stage], 0));
+    return true;
+}
+
+bool EventGroupTrace::GetTotalLatency(chrono::nanoseconds& latency) const {
+    if (mStamps.front() == 0 || mStamps.back() == 0) {
+        return false;
+    }
+    latency = chrono::nanoseconds(max<int64_t>(mStamps.back() - mStamps.front(), 0));
+    return true;
+}
+
+} // namespace logtail
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <chrono>
+#include <memory>
+
+namespace logtail {
+
+// the order must follow the data flow, since stage latency is calculated between adjacent stamps
+enum class TraceStamp {
+    READ,
+    PROCESS_QUEUE_PUSH,
+    PROCESS_START,
+    BATCH_ADD,
+    SENDER_QUEUE_PUSH,
+    SEND_DONE,
+    COUNT
+};
+
+// Sampled stage timestamps carried along with an event group from input to flusher ack. Only a small fraction of
+// groups are traced, so that the overhead on the hot path is a single branch for the rest.
+class EventGroupTrace {
+public:
+    static constexpr size_t kStampCnt = static_cast<size_t>(TraceStamp::COUNT);
+    static constexpr size_t kStageCnt = kStampCnt - 1;
+
+    // returns true once every event_group_trace_sample_interval calls per thread, and never if the flag is 0
+    static bool ShouldSample();
+    static const char* GetStageName(size_t stage);
+
+    void Stamp(TraceStamp stamp) {
+        mStamps[static_cast<size_t>(stamp)] = std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+    bool HasStamp(TraceStamp stamp) const { return mStamps[static_cast<size_t>(stamp)] != 0; }
+
+    // stage i starts at stamp i and ends at stamp i + 1, returns false if either of them is missing, e.g., the stages
+    // of the batcher and the sender queue for the flushers without them
+    bool GetStageLatency(size_t stage, std::chrono::nanoseconds& latency) const;
+    bool GetTotalLatency(std::chrono::nanoseconds& latency) const;
+
+private:
+    std::array<int64_t, kStampCnt> mStamps{};
+};
+
+using EventGroupTracePtr = std::shared_ptr<EventGroupTrace>;
+
+} // namespace logtail
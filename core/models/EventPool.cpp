@@ -16,6 +16,9 @@
 
 #include "models/EventPool.h"
 
+#include <atomic>
+#include <memory>
+
 #include "common/Flags.h"
 #include "logger/Logger.h"
 
@@ -25,6 +28,11 @@ using namespace std;
 
 namespace logtail {
 
+static atomic_uint64_t sNextPoolId = 1;
+
+EventPool::EventPool(bool enableLock, size_t magazineSize)
+    : mEnableLock(enableLock), mMagazineSize(enableLock ? magazineSize : 0), mId(sNextPoolId.fetch_add(1)) {}
+
 EventPool::~EventPool() {
     if (mEnableLock) {
         {
@@ -42,6 +50,10 @@ EventPool::~EventPool() {
 
 LogEvent* EventPool::AcquireLogEvent(PipelineEventGroup* ptr) {
     if (mEnableLock) {
+        if (mMagazineSize > 0) {
+            return AcquireEventFromMagazine(
+                ptr, GetThreadMagazines().mLogEvents, mLogEventPool, mLogEventPoolBak, mMinUnusedLogEventsCnt);
+        }
         TransferPoolIfEmpty(mLogEventPool, mLogEventPoolBak);
         lock_guard<mutex> lock(mPoolMux);
         return AcquireEventNoLock(ptr, mLogEventPool, mMinUnusedLogEventsCnt);
@@ -51,6 +63,13 @@ LogEvent* EventPool::AcquireLogEvent(PipelineEventGroup* ptr) {
 
 MetricEvent* EventPool::AcquireMetricEvent(PipelineEventGroup* ptr) {
     if (mEnableLock) {
+        if (mMagazineSize > 0) {
+            return AcquireEventFromMagazine(ptr,
+                                            GetThreadMagazines().mMetricEvents,
+                                            mMetricEventPool,
+                                            mMetricEventPoolBak,
+                                            mMinUnusedMetricEventsCnt);
+        }
         TransferPoolIfEmpty(mMetricEventPool, mMetricEventPoolBak);
         lock_guard<mutex> lock(mPoolMux);
         return AcquireEventNoLock(ptr, mMetricEventPool, mMinUnusedMetricEventsCnt);
@@ -60,6 +79,10 @@ MetricEvent* EventPool::AcquireMetricEvent(PipelineEventGroup* ptr) {
 
 SpanEvent* EventPool::AcquireSpanEvent(PipelineEventGroup* ptr) {
     if (mEnableLock) {
+        if (mMagazineSize > 0) {
+            return AcquireEventFromMagazine(
+                ptr, GetThreadMagazines().mSpanEvents, mSpanEventPool, mSpanEventPoolBak, mMinUnusedSpanEventsCnt);
+        }
         TransferPoolIfEmpty(mSpanEventPool, mSpanEventPoolBak);
         lock_guard<mutex> lock(mPoolMux);
         return AcquireEventNoLock(ptr, mSpanEventPool, mMinUnusedSpanEventsCnt);
@@ -69,6 +92,10 @@ SpanEvent* EventPool::AcquireSpanEvent(PipelineEventGroup* ptr) {
 
 RawEvent* EventPool::AcquireRawEvent(PipelineEventGroup* ptr) {
     if (mEnableLock) {
+        if (mMagazineSize > 0) {
+            return AcquireEventFromMagazine(
+                ptr, GetThreadMagazines().mRawEvents, mRawEventPool, mRawEventPoolBak, mMinUnusedRawEventsCnt);
+        }
         TransferPoolIfEmpty(mRawEventPool, mRawEventPoolBak);
         lock_guard<mutex> lock(mPoolMux);
         return AcquireEventNoLock(ptr, mRawEventPool, mMinUnusedRawEventsCnt);
@@ -76,6 +103,26 @@ RawEvent* EventPool::AcquireRawEvent(PipelineEventGroup* ptr) {
     return AcquireEventNoLock(ptr, mRawEventPool, mMinUnusedRawEventsCnt);
 }
 
+void EventPool::Acquire(PipelineEventGroup* ptr, size_t cnt, vector<LogEvent*>& res) {
+    auto* magazine = mMagazineSize > 0 ? &GetThreadMagazines().mLogEvents : nullptr;
+    AcquireEvents(ptr, cnt, res, magazine, mLogEventPool, mLogEventPoolBak, mMinUnusedLogEventsCnt);
+}
+
+void EventPool::Acquire(PipelineEventGroup* ptr, size_t cnt, vector<MetricEvent*>& res) {
+    auto* magazine = mMagazineSize > 0 ? &GetThreadMagazines().mMetricEvents : nullptr;
+    AcquireEvents(ptr, cnt, res, magazine, mMetricEventPool, mMetricEventPoolBak, mMinUnusedMetricEventsCnt);
+}
+
+void EventPool::Acquire(PipelineEventGroup* ptr, size_t cnt, vector<SpanEvent*>& res) {
+    auto* magazine = mMagazineSize > 0 ? &GetThreadMagazines().mSpanEvents : nullptr;
+    AcquireEvents(ptr, cnt, res, magazine, mSpanEventPool, mSpanEventPoolBak, mMinUnusedSpanEventsCnt);
+}
+
+void EventPool::Acquire(PipelineEventGroup* ptr, size_t cnt, vector<RawEvent*>& res) {
+    auto* magazine = mMagazineSize > 0 ? &GetThreadMagazines().mRawEvents : nullptr;
+    AcquireEvents(ptr, cnt, res, magazine, mRawEventPool, mRawEventPoolBak, mMinUnusedRawEventsCnt);
+}
+
 void EventPool::Release(vector<LogEvent*>&& obj) {
     if (mEnableLock) {
         lock_guard<mutex> lock(mPoolBakMux);
@@ -160,6 +207,38 @@ void EventPool::CheckGC() {
     }
 }
 
+EventPool::Magazines::~Magazines() {
+    for (auto& item : mLogEvents) {
+        delete item;
+    }
+    for (auto& item : mMetricEvents) {
+        delete item;
+    }
+    for (auto& item : mSpanEvents) {
+        delete item;
+    }
+    for (auto& item : mRawEvents) {
+        delete item;
+    }
+}
+
+EventPool::Magazines& EventPool::GetThreadMagazines() {
+    // a thread seldom acquires events from more than one pool, so the last one used is put at the front
+    static thread_local vector<unique_ptr<Magazines>> sMagazines;
+    for (size_t i = 0; i < sMagazines.size(); ++i) {
+        if (sMagazines[i]->mPoolId == mId) {
+            if (i != 0) {
+                swap(sMagazines[0], sMagazines[i]);
+            }
+            return *sMagazines[0];
+        }
+    }
+    sMagazines.emplace_back(make_unique<Magazines>());
+    sMagazines.back()->mPoolId = mId;
+    swap(sMagazines.front(), sMagazines.back());
+    return *sMagazines[0];
+}
+
 void EventPool::DestroyAllEventPool() {
     for (auto& item : mLogEventPool) {
         delete item;
@@ -192,6 +271,14 @@ void EventPool::DestroyAllEventPoolBak() {
 
 #ifdef APSARA_UNIT_TEST_MAIN
 void EventPool::Clear() {
+    if (mMagazineSize > 0) {
+        auto& magazines = GetThreadMagazines();
+        Magazines released;
+        released.mLogEvents.swap(magazines.mLogEvents);
+        released.mMetricEvents.swap(magazines.mMetricEvents);
+        released.mSpanEvents.swap(magazines.mSpanEvents);
+        released.mRawEvents.swap(magazines.mRawEvents);
+    }
     {
         lock_guard<mutex> lock(mPoolMux);
         DestroyAllEventPool();
@@ -33,7 +33,12 @@ class PipelineEventGroup;
 
 class EventPool {
 public:
-    explicit EventPool(bool enableLock = true) : mEnableLock(enableLock) {}
+    static constexpr size_t kDefaultMagazineSize = 256;
+
+    // @magazineSize is only meaningful when @enableLock is true. If positive, each thread takes that many events from
+    // the pool at once into its own magazine, and acquires events from the magazine without any lock. Released events
+    // still go back to the pool. Events left in the magazine of a thread are freed when the thread exits.
+    explicit EventPool(bool enableLock = true, size_t magazineSize = 0);
     ~EventPool();
     EventPool(const EventPool&) = delete;
     EventPool& operator=(const EventPool&) = delete;
@@ -42,6 +47,11 @@ public:
     MetricEvent* AcquireMetricEvent(PipelineEventGroup* ptr);
     SpanEvent* AcquireSpanEvent(PipelineEventGroup* ptr);
     RawEvent* AcquireRawEvent(PipelineEventGroup* ptr);
+    // acquires @cnt events at once and appends them to @res, with the lock taken at most once
+    void Acquire(PipelineEventGroup* ptr, size_t cnt, std::vector<LogEvent*>& res);
+    void Acquire(PipelineEventGroup* ptr, size_t cnt, std::vector<MetricEvent*>& res);
+    void Acquire(PipelineEventGroup* ptr, size_t cnt, std::vector<SpanEvent*>& res);
+    void Acquire(PipelineEventGroup* ptr, size_t cnt, std::vector<RawEvent*>& res);
     void Release(std::vector<LogEvent*>&& obj);
     void Release(std::vector<MetricEvent*>&& obj);
     void Release(std::vector<SpanEvent*>&& obj);
@@ -53,6 +63,16 @@ public:
 #endif
 
 private:
+    struct Magazines {
+        ~Magazines();
+
+        uint64_t mPoolId = 0;
+        std::vector<LogEvent*> mLogEvents;
+        std::vector<MetricEvent*> mMetricEvents;
+        std::vector<SpanEvent*> mSpanEvents;
+        std::vector<RawEvent*> mRawEvents;
+    };
+
     template <class T>
     void TransferPoolIfEmpty(std::vector<T*>& pool, std::vector<T*>& poolBak) {
         std::lock_guard<std::mutex> lock(mPoolMux);
@@ -75,10 +95,81 @@ private:
         return obj;
     }
 
+    // moves at most @cnt events to @res, with events in the backup pool moved to the pool first if not enough
+    template <class T>
+    void TakeEvents(
+        size_t cnt, std::vector<T*>& res, std::vector<T*>& pool, std::vector<T*>& poolBak, size_t& minUnusedCnt) {
+        std::lock_guard<std::mutex> lock(mPoolMux);
+        if (pool.size() < cnt) {
+            std::lock_guard<std::mutex> lk(mPoolBakMux);
+            pool.insert(pool.end(), poolBak.begin(), poolBak.end());
+            poolBak.clear();
+        }
+        cnt = std::min(cnt, pool.size());
+        res.insert(res.end(), pool.end() - cnt, pool.end());
+        pool.resize(pool.size() - cnt);
+        minUnusedCnt = std::min(minUnusedCnt, pool.size());
+    }
+
+    template <class T>
+    T* AcquireEventFromMagazine(PipelineEventGroup* ptr,
+                                std::vector<T*>& magazine,
+                                std::vector<T*>& pool,
+                                std::vector<T*>& poolBak,
+                                size_t& minUnusedCnt) {
+        if (magazine.empty()) {
+            TakeEvents(mMagazineSize, magazine, pool, poolBak, minUnusedCnt);
+            if (magazine.empty()) {
+                return new T(ptr);
+            }
+        }
+        auto obj = magazine.back();
+        obj->ResetPipelineEventGroup(ptr);
+        magazine.pop_back();
+        return obj;
+    }
+
+    template <class T>
+    void AcquireEvents(PipelineEventGroup* ptr,
+                       size_t cnt,
+                       std::vector<T*>& res,
+                       std::vector<T*>* magazine,
+                       std::vector<T*>& pool,
+                       std::vector<T*>& poolBak,
+                       size_t& minUnusedCnt) {
+        size_t begin = res.size();
+        res.reserve(begin + cnt);
+        if (magazine) {
+            size_t sz = std::min(cnt, magazine->size());
+            res.insert(res.end(), magazine->end() - sz, magazine->end());
+            magazine->resize(magazine->size() - sz);
+        }
+        if (res.size() - begin < cnt) {
+            if (mEnableLock) {
+                TakeEvents(begin + cnt - res.size(), res, pool, poolBak, minUnusedCnt);
+            } else {
+                size_t sz = std::min(begin + cnt - res.size(), pool.size());
+                res.insert(res.end(), pool.end() - sz, pool.end());
+                pool.resize(pool.size() - sz);
+                minUnusedCnt = std::min(minUnusedCnt, pool.size());
+            }
+        }
+        for (size_t i = begin; i < res.size(); ++i) {
+            res[i]->ResetPipelineEventGroup(ptr);
+        }
+        while (res.size() < begin + cnt) {
+            res.push_back(new T(ptr));
+        }
+    }
+
+    Magazines& GetThreadMagazines();
+
     void DestroyAllEventPool();
     void DestroyAllEventPoolBak();
 
     bool mEnableLock = true;
+    size_t mMagazineSize = 0;
+    uint64_t mId = 0;
 
     std::mutex mPoolMux;
     std::vector<LogEvent*> mLogEventPool;
@@ -68,6 +68,7 @@ PipelineEventGroup::PipelineEventGroup(PipelineEventGroup&& rhs) noexcept
       mTags(std::move(rhs.mTags)),
       mEvents(std::move(rhs.mEvents)),
       mSourceBuffer(std::move(rhs.mSourceBuffer)),
+      mTrace(std::move(rhs.mTrace)),
       mExtraSourceBuffers(std::move(rhs.mExtraSourceBuffers)) {
     for (auto& item : mEvents) {
         item->ResetPipelineEventGroup(this);
@@ -102,6 +103,7 @@ PipelineEventGroup& PipelineEventGroup::operator=(PipelineEventGroup&& rhs) noex
         mTags = std::move(rhs.mTags);
         mEvents = std::move(rhs.mEvents);
         mSourceBuffer = std::move(rhs.mSourceBuffer);
+        mTrace = std::move(rhs.mTrace);
         mExtraSourceBuffers = std::move(rhs.mExtraSourceBuffers);
         for (auto& item : mEvents) {
             item->ResetPipelineEventGroup(this);
@@ -239,6 +241,42 @@ RawEvent* PipelineEventGroup::AddRawEvent(bool fromPool, EventPool* pool) {
     return e;
 }
 
+template <class T>
+void PipelineEventGroup::AddEvents(size_t cnt, bool fromPool, EventPool* pool) {
+    mEvents.reserve(mEvents.size() + cnt);
+    if (!fromPool) {
+        for (size_t i = 0; i < cnt; ++i) {
+            mEvents.emplace_back(new T(this), false, nullptr);
+        }
+        return;
+    }
+    vector<T*> events;
+    if (pool) {
+        pool->Acquire(this, cnt, events);
+    } else {
+        gThreadedEventPool.Acquire(this, cnt, events);
+    }
+    for (auto* e : events) {
+        mEvents.emplace_back(e, true, pool);
+    }
+}
+
+void PipelineEventGroup::AddLogEvents(size_t cnt, bool fromPool, EventPool* pool) {
+    AddEvents<LogEvent>(cnt, fromPool, pool);
+}
+
+void PipelineEventGroup::AddMetricEvents(size_t cnt, bool fromPool, EventPool* pool) {
+    AddEvents<MetricEvent>(cnt, fromPool, pool);
+}
+
+void PipelineEventGroup::AddSpanEvents(size_t cnt, bool fromPool, EventPool* pool) {
+    AddEvents<SpanEvent>(cnt, fromPool, pool);
+}
+
+void PipelineEventGroup::AddRawEvents(size_t cnt, bool fromPool, EventPool* pool) {
+    AddEvents<RawEvent>(cnt, fromPool, pool);
+}
+
 void PipelineEventGroup::AddSourceBuffer(const std::shared_ptr<SourceBuffer>& sourceBuffer) {
     if (sourceBuffer == nullptr || sourceBuffer == mSourceBuffer) {
         return;
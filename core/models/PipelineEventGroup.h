@@ -24,6 +24,7 @@
 
 #include "common/memory/SourceBuffer.h"
 #include "file_server/checkpoint/RangeCheckpoint.h"
+#include "models/EventGroupTrace.h"
 #include "models/PipelineEventPtr.h"
 
 namespace logtail {
@@ -99,6 +100,11 @@ public:
     MetricEvent* AddMetricEvent(bool fromPool = false, EventPool* pool = nullptr);
     SpanEvent* AddSpanEvent(bool fromPool = false, EventPool* pool = nullptr);
     RawEvent* AddRawEvent(bool fromPool = false, EventPool* pool = nullptr);
+    // appends @cnt events at once, which is cheaper than adding them one by one when the number is known beforehand
+    void AddLogEvents(size_t cnt, bool fromPool = false, EventPool* pool = nullptr);
+    void AddMetricEvents(size_t cnt, bool fromPool = false, EventPool* pool = nullptr);
+    void AddSpanEvents(size_t cnt, bool fromPool = false, EventPool* pool = nullptr);
+    void AddRawEvents(size_t cnt, bool fromPool = false, EventPool* pool = nullptr);
     void SwapEvents(EventsContainer& other) { mEvents.swap(other); }
     void ReserveEvents(size_t size) { mEvents.reserve(size); }
 
@@ -133,6 +139,9 @@ public:
     RangeCheckpointPtr& GetExactlyOnceCheckpoint() { return mExactlyOnceCheckpoint; }
     bool IsReplay() const;
 
+    void SetTrace(const EventGroupTracePtr& trace) { mTrace = trace; }
+    EventGroupTracePtr& GetTrace() { return mTrace; }
+
     size_t DataSize() const;
 
 #ifdef APSARA_UNIT_TEST_MAIN
@@ -144,11 +153,15 @@ public:
 #endif
 
 private:
+    template <class T>
+    void AddEvents(size_t cnt, bool fromPool, EventPool* pool);
+
     GroupMetadata mMetadata; // Used to generate tag/log. Will not output.
     SizedMap mTags; // custom tags to output
     EventsContainer mEvents;
     std::shared_ptr<SourceBuffer> mSourceBuffer;
     RangeCheckpointPtr mExactlyOnceCheckpoint;
+    EventGroupTracePtr mTrace; // not null only when the group is sampled for latency tracing
 
     SourceBufferSet mExtraSourceBuffers;
 };
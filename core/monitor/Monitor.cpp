@@ -29,6 +29,7 @@
 #include "app_config/AppConfig.h"
 #include "application/Application.h"
 #include "collection_pipeline/CollectionPipelineManager.h"
+#include "collection_pipeline/limiter/CpuGovernor.h"
 #include "common/DevInode.h"
 #include "common/ExceptionBase.h"
 #include "common/LogtailCommonFlags.h"
@@ -36,6 +37,7 @@
 #include "common/RuntimeUtil.h"
 #include "common/StringTools.h"
 #include "common/TimeUtil.h"
+#include "common/memory/MemoryBudget.h"
 #include "common/version.h"
 #include "constants/Constants.h"
 #include "file_server/event_handler/LogInput.h"
@@ -55,6 +57,10 @@ using namespace std;
 using namespace sls_logs;
 
 DEFINE_FLAG_BOOL(logtail_dump_monitor_info, "enable to dump Logtail monitor info (CPU, mem)", false);
+DEFINE_FLAG_INT32(memory_budget_percent,
+                  "percent of the memory usage limit that data in pipelines can take before inputs are throttled, "
+                  "0 means no throttling",
+                  60);
 DECLARE_FLAG_BOOL(check_profile_region);
 
 namespace logtail {
@@ -159,9 +165,12 @@ void LogtailMonitor::Monitor() {
             }
             GetCpuStat(curCpuStat);
 
-            // Update mRealtimeCpuStat for InputFlowControl.
+            // Update mRealtimeCpuStat and the cpu governor for InputFlowControl.
             if (AppConfig::GetInstance()->IsInputFlowControl()) {
                 CalCpuStat(curCpuStat, mRealtimeCpuStat);
+                CpuGovernor::GetInstance()->Update(mRealtimeCpuStat.mCpuUsage, GetCpuUsageLimit());
+            } else {
+                CpuGovernor::GetInstance()->Update(0.0, 0.0);
             }
 
             int32_t monitorTime = time(NULL);
@@ -188,6 +197,7 @@ void LogtailMonitor::Monitor() {
 
                 GetMemStat();
                 LoongCollectorMonitor::GetInstance()->SetAgentMemory(mMemStat.mRss);
+                UpdateMemoryBudget();
                 CalCpuStat(curCpuStat, mCpuStat);
                 LoongCollectorMonitor::GetInstance()->SetAgentCpu(mCpuStat.mCpuUsage);
                 if (CheckHardMemLimit()) {
@@ -360,11 +370,13 @@ void LogtailMonitor::CalCpuStat(const CpuStat& curCpu, CpuStat& savedCpu) {
 #endif
 }
 
+float LogtailMonitor::GetCpuUsageLimit() const {
+    return AppConfig::GetInstance()->IsResourceAutoScale() ? AppConfig::GetInstance()->GetScaledCpuUsageUpLimit()
+                                                           : AppConfig::GetInstance()->GetCpuUsageUpLimit();
+}
+
 bool LogtailMonitor::CheckSoftCpuLimit() {
-    float cpuUsageLimit = AppConfig::GetInstance()->IsResourceAutoScale()
-        ? AppConfig::GetInstance()->GetScaledCpuUsageUpLimit()
-        : AppConfig::GetInstance()->GetCpuUsageUpLimit();
-    if (cpuUsageLimit < mCpuStat.mCpuUsage) {
+    if (GetCpuUsageLimit() < mCpuStat.mCpuUsage) {
         if (++mCpuStat.mViolateNum > INT32_FLAG(cpu_limit_num))
             return true;
     } else
@@ -381,6 +393,14 @@ bool LogtailMonitor::CheckSoftMemLimit() {
     return false;
 }
 
+void LogtailMonitor::UpdateMemoryBudget() {
+    // the limit may change on config reload
+    auto* budget = MemoryBudget::GetInstance();
+    budget->SetLimit(AppConfig::GetInstance()->GetMemUsageUpLimit() * 1024 * 1024
+                     * max(INT32_FLAG(memory_budget_percent), 0) / 100);
+    LoongCollectorMonitor::GetInstance()->SetAgentMemoryBudgetUsed(max(budget->GetUsage(), int64_t(0)) / 1024 / 1024);
+}
+
 bool LogtailMonitor::CheckHardMemLimit() {
     return mMemStat.mRss > 5 * AppConfig::GetInstance()->GetMemUsageUpLimit();
 }
@@ -652,12 +672,24 @@ void LoongCollectorMonitor::Init() {
     mAgentCpu = mMetricsRecordRef.CreateDoubleGauge(METRIC_AGENT_CPU);
     mAgentMemory = mMetricsRecordRef.CreateIntGauge(METRIC_AGENT_MEMORY);
     mAgentGoMemory = mMetricsRecordRef.CreateIntGauge(METRIC_AGENT_MEMORY_GO);
+    mAgentMemoryBudgetUsed = mMetricsRecordRef.CreateIntGauge(METRIC_AGENT_MEMORY_BUDGET_USED);
     mAgentGoRoutinesTotal = mMetricsRecordRef.CreateIntGauge(METRIC_AGENT_GO_ROUTINES_TOTAL);
     mAgentOpenFdTotal = mMetricsRecordRef.CreateIntGauge(METRIC_AGENT_OPEN_FD_TOTAL);
     mAgentConfigTotal = mMetricsRecordRef.CreateIntGauge(METRIC_AGENT_PIPELINE_CONFIG_TOTAL);
+    mAgentTimeToFirstSendMs = mMetricsRecordRef.CreateIntGauge(METRIC_AGENT_TIME_TO_FIRST_SEND_MS);
     WriteMetrics::GetInstance()->CommitMetricsRecordRef(mMetricsRecordRef);
 }
 
+void LoongCollectorMonitor::RecordFirstSendOnce() {
+    bool expected = false;
+    if (!mIsFirstSendRecorded.compare_exchange_strong(expected, true)) {
+        return;
+    }
+    uint64_t costMs = GetCurrentTimeInMilliSeconds() - Application::GetInstance()->GetStartTime() * 1000ULL;
+    SET_GAUGE(mAgentTimeToFirstSendMs, costMs);
+    LOG_INFO(sLogger, ("first successful send after start, cost ms", costMs));
+}
+
 void LoongCollectorMonitor::Stop() {
     SelfMonitorServer::GetInstance()->Stop();
     LOG_INFO(sLogger, ("LoongCollector monitor", "stopped successfully"));
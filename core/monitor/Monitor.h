@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <future>
 #include <mutex>
@@ -93,10 +94,6 @@ public:
 
     uint32_t GetCpuCores();
 
-    // GetRealtimeCpuLevel return a value to indicates current CPU usage level.
-    // LogInput use it to do flow control.
-    float GetRealtimeCpuLevel() { return mRealtimeCpuStat.mCpuUsage / mScaledCpuUsageUpLimit; }
-
 private:
     LogtailMonitor();
     ~LogtailMonitor() = default;
@@ -112,6 +109,9 @@ private:
     // set @curCpu to @savedCpu after calculation.
     void CalCpuStat(const CpuStat& curCpu, CpuStat& savedCpu);
 
+    // GetCpuUsageLimit returns the scaled cpu limit if resource auto scale is enabled.
+    float GetCpuUsageLimit() const;
+
     // CheckSoftCpuLimit checks if current cpu usage exceeds limit.
     // @return true if the cpu usage exceeds limit continuously.
     bool CheckSoftCpuLimit();
@@ -120,6 +120,8 @@ private:
     bool CheckSoftMemLimit();
 
     bool CheckHardMemLimit();
+    // UpdateMemoryBudget sets the memory budget of data in pipelines according to the memory usage limit.
+    void UpdateMemoryBudget();
 
     // SendStatusProfile collects status profile and send them to server.
     // @suicide indicates if the target LogStore is logtail_suicide_profile.
@@ -201,6 +203,7 @@ public:
     void SetAgentCpu(double cpu) { SET_GAUGE(mAgentCpu, cpu); }
     void SetAgentMemory(uint64_t mem) { SET_GAUGE(mAgentMemory, mem); }
     void SetAgentGoMemory(uint64_t mem) { SET_GAUGE(mAgentGoMemory, mem); }
+    void SetAgentMemoryBudgetUsed(uint64_t mem) { SET_GAUGE(mAgentMemoryBudgetUsed, mem); }
     void SetAgentGoRoutinesTotal(uint64_t total) { SET_GAUGE(mAgentGoRoutinesTotal, total); }
     void SetAgentOpenFdTotal(uint64_t total) {
 #ifndef APSARA_UNIT_TEST_MAIN
@@ -212,6 +215,12 @@ public:
         SET_GAUGE(mAgentConfigTotal, total);
 #endif
     }
+    // record the time from process start to the first successful send, only the first call takes effect
+    void RecordFirstSend() {
+        if (!mIsFirstSendRecorded.load(std::memory_order_relaxed)) {
+            RecordFirstSendOnce();
+        }
+    }
 
     static std::string mHostname;
     static std::string mIpAddr;
@@ -227,6 +236,8 @@ private:
     LoongCollectorMonitor();
     ~LoongCollectorMonitor();
 
+    void RecordFirstSendOnce();
+
     // 一个全局级别指标的副本，由 SelfMonitorServer::PushSelfMonitorMetricEvents 更新，格式为：
     // {MetricCategory: {key:MetricValue}}
     // 现支持 Agent 和 Runner 指标的保存、获取
@@ -243,9 +254,12 @@ private:
     DoubleGaugePtr mAgentCpu;
     IntGaugePtr mAgentMemory;
     IntGaugePtr mAgentGoMemory;
+    IntGaugePtr mAgentMemoryBudgetUsed;
     IntGaugePtr mAgentGoRoutinesTotal;
     IntGaugePtr mAgentOpenFdTotal;
     IntGaugePtr mAgentConfigTotal;
+    IntGaugePtr mAgentTimeToFirstSendMs;
+    std::atomic_bool mIsFirstSendRecorded = false;
 };
 
 } // namespace logtail
@@ -39,7 +39,9 @@ const string METRIC_AGENT_GO_ROUTINES_TOTAL = "go_routines_total";
 const string METRIC_AGENT_INSTANCE_CONFIG_TOTAL = "instance_config_total"; // Not Implemented
 const string METRIC_AGENT_MEMORY = "memory_used_mb";
 const string METRIC_AGENT_MEMORY_GO = "go_memory_used_mb";
+const string METRIC_AGENT_MEMORY_BUDGET_USED = "memory_budget_used_mb";
 const string METRIC_AGENT_OPEN_FD_TOTAL = "open_fd_total";
 const string METRIC_AGENT_PIPELINE_CONFIG_TOTAL = "pipeline_config_total";
+const string METRIC_AGENT_TIME_TO_FIRST_SEND_MS = "time_to_first_send_ms";
 
 } // namespace logtail
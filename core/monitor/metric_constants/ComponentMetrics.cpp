@@ -37,6 +37,7 @@ const string METRIC_LABEL_KEY_GROUP_BATCH_ENABLED = "group_batch_enabled";
 // label values
 const string METRIC_LABEL_VALUE_COMPONENT_NAME_BATCHER = "batcher";
 const string METRIC_LABEL_VALUE_COMPONENT_NAME_COMPRESSOR = "compressor";
+const string METRIC_LABEL_VALUE_COMPONENT_NAME_MEMORY_BUDGET = "memory_budget";
 const string METRIC_LABEL_VALUE_COMPONENT_NAME_PROCESS_QUEUE = "process_queue";
 const string METRIC_LABEL_VALUE_COMPONENT_NAME_ROUTER = "router";
 const string METRIC_LABEL_VALUE_COMPONENT_NAME_SENDER_QUEUE = "sender_queue";
@@ -62,6 +63,16 @@ const string METRIC_COMPONENT_BATCHER_BUFFERED_GROUPS_TOTAL = "buffered_groups_t
 const string METRIC_COMPONENT_BATCHER_BUFFERED_EVENTS_TOTAL = "buffered_events_total";
 const string METRIC_COMPONENT_BATCHER_BUFFERED_SIZE_BYTES = "buffered_size_bytes";
 const string METRIC_COMPONENT_BATCHER_TOTAL_ADD_TIME_MS = "total_add_time_ms";
+const string METRIC_COMPONENT_BATCHER_OUT_BATCHES_TOTAL = "out_batches_total";
+const string METRIC_COMPONENT_BATCHER_OUT_BATCH_SIZE_BYTES = "out_batch_size_bytes";
+const string METRIC_COMPONENT_BATCHER_SEND_LATENCY_MS = "send_latency_ms";
+const string METRIC_COMPONENT_BATCHER_TARGET_BATCH_SIZE_BYTES = "target_batch_size_bytes";
+const string METRIC_COMPONENT_BATCHER_TARGET_BATCH_TIMEOUT_SECS = "target_batch_timeout_secs";
+
+/**********************************************************
+ *   memory budget
+ **********************************************************/
+const string METRIC_COMPONENT_MEMORY_USAGE_BYTES = "memory_usage_bytes";
 
 /**********************************************************
  *   queue
@@ -71,6 +82,8 @@ const string METRIC_COMPONENT_QUEUE_SIZE_BYTES = "queue_size_bytes";
 const string METRIC_COMPONENT_QUEUE_VALID_TO_PUSH_FLAG = "valid_to_push_status";
 const string METRIC_COMPONENT_QUEUE_EXTRA_BUFFER_SIZE = "extra_buffer_size";
 const string METRIC_COMPONENT_QUEUE_EXTRA_BUFFER_SIZE_BYTES = "extra_buffer_size_bytes";
+const string METRIC_COMPONENT_QUEUE_SPILL_SIZE = "spill_size";
+const string METRIC_COMPONENT_QUEUE_SPILL_SIZE_BYTES = "spill_size_bytes";
 const string& METRIC_COMPONENT_QUEUE_DISCARDED_EVENTS_TOTAL = METRIC_DISCARDED_EVENTS_TOTAL;
 
 const string METRIC_COMPONENT_QUEUE_FETCHED_ITEMS_TOTAL = "fetched_items_total";
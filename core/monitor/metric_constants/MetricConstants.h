@@ -43,8 +43,10 @@ extern const std::string METRIC_AGENT_GO_ROUTINES_TOTAL;
 extern const std::string METRIC_AGENT_INSTANCE_CONFIG_TOTAL;
 extern const std::string METRIC_AGENT_MEMORY;
 extern const std::string METRIC_AGENT_MEMORY_GO;
+extern const std::string METRIC_AGENT_MEMORY_BUDGET_USED;
 extern const std::string METRIC_AGENT_OPEN_FD_TOTAL;
 extern const std::string METRIC_AGENT_PIPELINE_CONFIG_TOTAL;
+extern const std::string METRIC_AGENT_TIME_TO_FIRST_SEND_MS;
 
 //////////////////////////////////////////////////////////////////////////
 // pipeline
@@ -65,6 +67,39 @@ extern const std::string METRIC_PIPELINE_FLUSHERS_IN_EVENT_GROUPS_TOTAL;
 extern const std::string METRIC_PIPELINE_FLUSHERS_IN_SIZE_BYTES;
 extern const std::string METRIC_PIPELINE_FLUSHERS_TOTAL_PACKAGE_TIME_MS;
 extern const std::string METRIC_PIPELINE_START_TIME;
+extern const std::string METRIC_PIPELINE_CPU_TIME_MS;
+extern const std::string METRIC_PIPELINE_ALLOCATED_SIZE_BYTES;
+extern const std::string METRIC_PIPELINE_TRACED_EVENT_GROUPS_TOTAL;
+extern const std::string METRIC_PIPELINE_READ_LATENCY_MS;
+extern const std::string METRIC_PIPELINE_READ_LATENCY_LE_10MS_TOTAL;
+extern const std::string METRIC_PIPELINE_READ_LATENCY_LE_100MS_TOTAL;
+extern const std::string METRIC_PIPELINE_READ_LATENCY_LE_1000MS_TOTAL;
+extern const std::string METRIC_PIPELINE_READ_LATENCY_LE_10000MS_TOTAL;
+extern const std::string METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_MS;
+extern const std::string METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_LE_10MS_TOTAL;
+extern const std::string METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_LE_100MS_TOTAL;
+extern const std::string METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_LE_1000MS_TOTAL;
+extern const std::string METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_LE_10000MS_TOTAL;
+extern const std::string METRIC_PIPELINE_PROCESS_LATENCY_MS;
+extern const std::string METRIC_PIPELINE_PROCESS_LATENCY_LE_10MS_TOTAL;
+extern const std::string METRIC_PIPELINE_PROCESS_LATENCY_LE_100MS_TOTAL;
+extern const std::string METRIC_PIPELINE_PROCESS_LATENCY_LE_1000MS_TOTAL;
+extern const std::string METRIC_PIPELINE_PROCESS_LATENCY_LE_10000MS_TOTAL;
+extern const std::string METRIC_PIPELINE_BATCH_LATENCY_MS;
+extern const std::string METRIC_PIPELINE_BATCH_LATENCY_LE_10MS_TOTAL;
+extern const std::string METRIC_PIPELINE_BATCH_LATENCY_LE_100MS_TOTAL;
+extern const std::string METRIC_PIPELINE_BATCH_LATENCY_LE_1000MS_TOTAL;
+extern const std::string METRIC_PIPELINE_BATCH_LATENCY_LE_10000MS_TOTAL;
+extern const std::string METRIC_PIPELINE_SENDER_QUEUE_LATENCY_MS;
+extern const std::string METRIC_PIPELINE_SENDER_QUEUE_LATENCY_LE_10MS_TOTAL;
+extern const std::string METRIC_PIPELINE_SENDER_QUEUE_LATENCY_LE_100MS_TOTAL;
+extern const std::string METRIC_PIPELINE_SENDER_QUEUE_LATENCY_LE_1000MS_TOTAL;
+extern const std::string METRIC_PIPELINE_SENDER_QUEUE_LATENCY_LE_10000MS_TOTAL;
+extern const std::string METRIC_PIPELINE_END_TO_END_LATENCY_MS;
+extern const std::string METRIC_PIPELINE_END_TO_END_LATENCY_LE_10MS_TOTAL;
+extern const std::string METRIC_PIPELINE_END_TO_END_LATENCY_LE_100MS_TOTAL;
+extern const std::string METRIC_PIPELINE_END_TO_END_LATENCY_LE_1000MS_TOTAL;
+extern const std::string METRIC_PIPELINE_END_TO_END_LATENCY_LE_10000MS_TOTAL;
 
 //////////////////////////////////////////////////////////////////////////
 // plugin
@@ -235,6 +270,7 @@ extern const std::string METRIC_LABEL_KEY_GROUP_BATCH_ENABLED;
 // label values
 extern const std::string METRIC_LABEL_VALUE_COMPONENT_NAME_BATCHER;
 extern const std::string METRIC_LABEL_VALUE_COMPONENT_NAME_COMPRESSOR;
+extern const std::string METRIC_LABEL_VALUE_COMPONENT_NAME_MEMORY_BUDGET;
 extern const std::string METRIC_LABEL_VALUE_COMPONENT_NAME_PROCESS_QUEUE;
 extern const std::string METRIC_LABEL_VALUE_COMPONENT_NAME_ROUTER;
 extern const std::string METRIC_LABEL_VALUE_COMPONENT_NAME_SENDER_QUEUE;
@@ -260,6 +296,16 @@ extern const std::string METRIC_COMPONENT_BATCHER_BUFFERED_GROUPS_TOTAL;
 extern const std::string METRIC_COMPONENT_BATCHER_BUFFERED_EVENTS_TOTAL;
 extern const std::string METRIC_COMPONENT_BATCHER_BUFFERED_SIZE_BYTES;
 extern const std::string METRIC_COMPONENT_BATCHER_TOTAL_ADD_TIME_MS;
+extern const std::string METRIC_COMPONENT_BATCHER_OUT_BATCHES_TOTAL;
+extern const std::string METRIC_COMPONENT_BATCHER_OUT_BATCH_SIZE_BYTES;
+extern const std::string METRIC_COMPONENT_BATCHER_SEND_LATENCY_MS;
+extern const std::string METRIC_COMPONENT_BATCHER_TARGET_BATCH_SIZE_BYTES;
+extern const std::string METRIC_COMPONENT_BATCHER_TARGET_BATCH_TIMEOUT_SECS;
+
+/**********************************************************
+ *   memory budget
+ **********************************************************/
+extern const std::string METRIC_COMPONENT_MEMORY_USAGE_BYTES;
 
 /**********************************************************
  *   queue
@@ -269,6 +315,8 @@ extern const std::string METRIC_COMPONENT_QUEUE_SIZE_BYTES;
 extern const std::string METRIC_COMPONENT_QUEUE_VALID_TO_PUSH_FLAG;
 extern const std::string METRIC_COMPONENT_QUEUE_EXTRA_BUFFER_SIZE;
 extern const std::string METRIC_COMPONENT_QUEUE_EXTRA_BUFFER_SIZE_BYTES;
+extern const std::string METRIC_COMPONENT_QUEUE_SPILL_SIZE;
+extern const std::string METRIC_COMPONENT_QUEUE_SPILL_SIZE_BYTES;
 extern const std::string& METRIC_COMPONENT_QUEUE_DISCARDED_EVENTS_TOTAL;
 
 extern const std::string METRIC_COMPONENT_QUEUE_FETCHED_ITEMS_TOTAL;
@@ -309,6 +357,9 @@ extern const std::string& METRIC_RUNNER_TOTAL_DELAY_MS;
 extern const std::string METRIC_RUNNER_CLIENT_REGISTER_STATE;
 extern const std::string METRIC_RUNNER_CLIENT_REGISTER_RETRY_TOTAL;
 extern const std::string METRIC_RUNNER_JOBS_TOTAL;
+extern const std::string METRIC_RUNNER_INFLIGHT_SCRAPES;
+extern const std::string METRIC_RUNNER_PENDING_SCRAPES;
+extern const std::string METRIC_RUNNER_SCRAPE_QUEUEING_DELAY_MS;
 
 /**********************************************************
  *   all sinks
@@ -319,6 +370,9 @@ extern const std::string METRIC_RUNNER_SINK_SUCCESSFUL_ITEM_TOTAL_RESPONSE_TIME_
 extern const std::string METRIC_RUNNER_SINK_FAILED_ITEM_TOTAL_RESPONSE_TIME_MS;
 extern const std::string METRIC_RUNNER_SINK_SENDING_ITEMS_TOTAL;
 extern const std::string METRIC_RUNNER_SINK_SEND_CONCURRENCY;
+extern const std::string METRIC_RUNNER_SINK_HEDGED_ITEMS_TOTAL;
+extern const std::string METRIC_RUNNER_SINK_HEDGE_WON_ITEMS_TOTAL;
+extern const std::string METRIC_RUNNER_SINK_LOW_SPEED_ABORTED_ITEMS_TOTAL;
 
 /**********************************************************
  *   flusher runner
@@ -336,6 +390,7 @@ extern const std::string METRIC_RUNNER_FILE_ENABLE_FILE_INCLUDED_BY_MULTI_CONFIG
 extern const std::string METRIC_RUNNER_FILE_POLLING_MODIFY_CACHE_SIZE;
 extern const std::string METRIC_RUNNER_FILE_POLLING_DIR_CACHE_SIZE;
 extern const std::string METRIC_RUNNER_FILE_POLLING_FILE_CACHE_SIZE;
+extern const std::string METRIC_RUNNER_FILE_LAST_CONFIG_UPDATE_PAUSE_MS;
 
 /**********************************************************
  *   static file server
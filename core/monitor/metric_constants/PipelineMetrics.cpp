@@ -33,5 +33,39 @@ const string METRIC_PIPELINE_FLUSHERS_IN_EVENT_GROUPS_TOTAL = "flusher_in_event_
 const string METRIC_PIPELINE_FLUSHERS_IN_SIZE_BYTES = "flusher_in_size_bytes";
 const string METRIC_PIPELINE_FLUSHERS_TOTAL_PACKAGE_TIME_MS = "flusher_total_package_time_ms";
 const string METRIC_PIPELINE_START_TIME = "start_time";
+const string METRIC_PIPELINE_CPU_TIME_MS = "cpu_time_ms";
+const string METRIC_PIPELINE_ALLOCATED_SIZE_BYTES = "allocated_size_bytes";
+const string METRIC_PIPELINE_TRACED_EVENT_GROUPS_TOTAL = "traced_event_groups_total";
+// sampled stage latency, the buckets are cumulative
+const string METRIC_PIPELINE_READ_LATENCY_MS = "read_latency_ms";
+const string METRIC_PIPELINE_READ_LATENCY_LE_10MS_TOTAL = "read_latency_le_10ms_total";
+const string METRIC_PIPELINE_READ_LATENCY_LE_100MS_TOTAL = "read_latency_le_100ms_total";
+const string METRIC_PIPELINE_READ_LATENCY_LE_1000MS_TOTAL = "read_latency_le_1000ms_total";
+const string METRIC_PIPELINE_READ_LATENCY_LE_10000MS_TOTAL = "read_latency_le_10000ms_total";
+const string METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_MS = "process_queue_latency_ms";
+const string METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_LE_10MS_TOTAL = "process_queue_latency_le_10ms_total";
+const string METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_LE_100MS_TOTAL = "process_queue_latency_le_100ms_total";
+const string METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_LE_1000MS_TOTAL = "process_queue_latency_le_1000ms_total";
+const string METRIC_PIPELINE_PROCESS_QUEUE_LATENCY_LE_10000MS_TOTAL = "process_queue_latency_le_10000ms_total";
+const string METRIC_PIPELINE_PROCESS_LATENCY_MS = "process_latency_ms";
+const string METRIC_PIPELINE_PROCESS_LATENCY_LE_10MS_TOTAL = "process_latency_le_10ms_total";
+const string METRIC_PIPELINE_PROCESS_LATENCY_LE_100MS_TOTAL = "process_latency_le_100ms_total";
+const string METRIC_PIPELINE_PROCESS_LATENCY_LE_1000MS_TOTAL = "process_latency_le_1000ms_total";
+const string METRIC_PIPELINE_PROCESS_LATENCY_LE_10000MS_TOTAL = "process_latency_le_10000ms_total";
+const string METRIC_PIPELINE_BATCH_LATENCY_MS = "batch_latency_ms";
+const string METRIC_PIPELINE_BATCH_LATENCY_LE_10MS_TOTAL = "batch_latency_le_10ms_total";
+const string METRIC_PIPELINE_BATCH_LATENCY_LE_100MS_TOTAL = "batch_latency_le_100ms_total";
+const string METRIC_PIPELINE_BATCH_LATENCY_LE_1000MS_TOTAL = "batch_latency_le_1000ms_total";
+const string METRIC_PIPELINE_BATCH_LATENCY_LE_10000MS_TOTAL = "batch_latency_le_10000ms_total";
+const string METRIC_PIPELINE_SENDER_QUEUE_LATENCY_MS = "sender_queue_latency_ms";
+const string METRIC_PIPELINE_SENDER_QUEUE_LATENCY_LE_10MS_TOTAL = "sender_queue_latency_le_10ms_total";
+const string METRIC_PIPELINE_SENDER_QUEUE_LATENCY_LE_100MS_TOTAL = "sender_queue_latency_le_100ms_total";
+const string METRIC_PIPELINE_SENDER_QUEUE_LATENCY_LE_1000MS_TOTAL = "sender_queue_latency_le_1000ms_total";
+const string METRIC_PIPELINE_SENDER_QUEUE_LATENCY_LE_10000MS_TOTAL = "sender_queue_latency_le_10000ms_total";
+const string METRIC_PIPELINE_END_TO_END_LATENCY_MS = "end_to_end_latency_ms";
+const string METRIC_PIPELINE_END_TO_END_LATENCY_LE_10MS_TOTAL = "end_to_end_latency_le_10ms_total";
+const string METRIC_PIPELINE_END_TO_END_LATENCY_LE_100MS_TOTAL = "end_to_end_latency_le_100ms_total";
+const string METRIC_PIPELINE_END_TO_END_LATENCY_LE_1000MS_TOTAL = "end_to_end_latency_le_1000ms_total";
+const string METRIC_PIPELINE_END_TO_END_LATENCY_LE_10000MS_TOTAL = "end_to_end_latency_le_10000ms_total";
 
 } // namespace logtail
@@ -45,6 +45,9 @@ const string& METRIC_RUNNER_TOTAL_DELAY_MS = METRIC_TOTAL_DELAY_MS;
 const string METRIC_RUNNER_CLIENT_REGISTER_STATE = "client_register_state";
 const string METRIC_RUNNER_CLIENT_REGISTER_RETRY_TOTAL = "client_register_retry_total";
 const string METRIC_RUNNER_JOBS_TOTAL = "jobs_total";
+const string METRIC_RUNNER_INFLIGHT_SCRAPES = "inflight_scrapes";
+const string METRIC_RUNNER_PENDING_SCRAPES = "pending_scrapes";
+const string METRIC_RUNNER_SCRAPE_QUEUEING_DELAY_MS = "scrape_queueing_delay_ms";
 
 /**********************************************************
  *   all sinks
@@ -55,6 +58,9 @@ const string METRIC_RUNNER_SINK_SUCCESSFUL_ITEM_TOTAL_RESPONSE_TIME_MS = "succes
 const string METRIC_RUNNER_SINK_FAILED_ITEM_TOTAL_RESPONSE_TIME_MS = "failed_response_time_ms";
 const string METRIC_RUNNER_SINK_SENDING_ITEMS_TOTAL = "sending_items_total";
 const string METRIC_RUNNER_SINK_SEND_CONCURRENCY = "send_concurrency";
+const string METRIC_RUNNER_SINK_HEDGED_ITEMS_TOTAL = "hedged_items_total";
+const string METRIC_RUNNER_SINK_HEDGE_WON_ITEMS_TOTAL = "hedge_won_items_total";
+const string METRIC_RUNNER_SINK_LOW_SPEED_ABORTED_ITEMS_TOTAL = "low_speed_aborted_items_total";
 
 /**********************************************************
  *   flusher runner
@@ -72,6 +78,7 @@ const string METRIC_RUNNER_FILE_ENABLE_FILE_INCLUDED_BY_MULTI_CONFIGS_FLAG = "en
 const string METRIC_RUNNER_FILE_POLLING_MODIFY_CACHE_SIZE = "polling_modify_cache_size";
 const string METRIC_RUNNER_FILE_POLLING_DIR_CACHE_SIZE = "polling_dir_cache_size";
 const string METRIC_RUNNER_FILE_POLLING_FILE_CACHE_SIZE = "polling_file_cache_size";
+const string METRIC_RUNNER_FILE_LAST_CONFIG_UPDATE_PAUSE_MS = "last_config_update_pause_ms";
 
 /**********************************************************
  *   static file server
@@ -99,6 +99,7 @@ bool FlusherFile::SerializeAndPush(PipelineEventGroup&& group) {
         }
         mFileWriter->info(serializedData);
         mFileWriter->flush();
+        RecordTraceOnSendDone(group.GetTrace());
     } else {
         LOG_ERROR(sLogger, ("serialize pipeline event group error", errorMsg));
     }
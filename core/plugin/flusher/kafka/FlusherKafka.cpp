@@ -168,6 +168,8 @@ bool FlusherKafka::SerializeAndSend(PipelineEventGroup&& group) {
     const auto& sizedTags = group.GetSizedTags();
     auto& sourceBuffer = group.GetSourceBuffer();
     auto& checkpoint = group.GetExactlyOnceCheckpoint();
+    // the group is traced by the delivery of its first event
+    EventGroupTracePtr trace = std::move(group.GetTrace());
 
     bool allSuccess = true;
     std::string serializedData;
@@ -217,9 +219,10 @@ bool FlusherKafka::SerializeAndSend(PipelineEventGroup&& group) {
         mProducer->ProduceAsync(
             topic,
             std::move(serializedData),
-            [this, bytes](bool success, const KafkaProducer::ErrorInfo& errorInfo) {
+            [this, bytes, trace = std::move(trace)](bool success, const KafkaProducer::ErrorInfo& errorInfo) {
                 if (success) {
                     LOG_DEBUG(mContext->GetLogger(), ("kafka message queued", bytes));
+                    RecordTraceOnSendDone(trace);
                 }
                 HandleDeliveryResult(success, errorInfo);
             },
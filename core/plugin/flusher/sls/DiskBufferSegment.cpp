@@ -0,0 +1,186 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "plugin/flusher/sls/DiskBufferSegment.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+#include <fstream>
+#include <iterator>
+
+#include "common/ErrorUtil.h"
+#include "common/FileSystemUtil.h"
+#include "common/StringTools.h"
+#include "logger/Logger.h"
+#include "monitor/AlarmManager.h"
+
+using namespace std;
+
+namespace logtail {
+
+const int32_t DiskBufferSegment::BUFFER_META_BASE_SIZE = 65536;
+
+bool DiskBufferSegment::Open(const string& filename, size_t headerSize) {
+    Close();
+    mFileName = filename;
+#if defined(__linux__)
+    mFd = open(filename.c_str(), O_RDWR);
+    if (mFd < 0) {
+        string errorStr = ErrnoToString(GetErrno());
+        AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
+                                                       string("open file error:") + filename + ",error:" + errorStr);
+        LOG_ERROR(sLogger, ("open file error", filename)("error", errorStr));
+        return false;
+    }
+    struct stat buf;
+    if (fstat(mFd, &buf) != 0) {
+        string errorStr = ErrnoToString(GetErrno());
+        LOG_ERROR(sLogger, ("stat file error", filename)("error", errorStr));
+        Close();
+        return false;
+    }
+    mSize = static_cast<size_t>(buf.st_size);
+    if (mSize > 0) {
+        void* addr = mmap(nullptr, mSize, PROT_READ, MAP_SHARED, mFd, 0);
+        if (addr == MAP_FAILED) {
+            string errorStr = ErrnoToString(GetErrno());
+            AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
+                                                           string("mmap file error:") + filename + ",error:" + errorStr);
+            LOG_ERROR(sLogger, ("mmap file error", filename)("error", errorStr));
+            mSize = 0;
+            Close();
+            return false;
+        }
+        // records are read once from head to tail
+        madvise(addr, mSize, MADV_SEQUENTIAL);
+        mData = static_cast<const char*>(addr);
+    }
+#else
+    ifstream fin(filename, ios::binary);
+    if (!fin) {
+        string errorStr = ErrnoToString(GetErrno());
+        AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
+                                                       string("open file error:") + filename + ",error:" + errorStr);
+        LOG_ERROR(sLogger, ("open file error", filename)("error", errorStr));
+        return false;
+    }
+    mContent.assign(istreambuf_iterator<char>(fin), istreambuf_iterator<char>());
+    mData = mContent.data();
+    mSize = mContent.size();
+#endif
+    BuildIndex(headerSize);
+    return true;
+}
+
+void DiskBufferSegment::Close() {
+#if defined(__linux__)
+    if (mData != nullptr) {
+        munmap(const_cast<char*>(mData), mSize);
+    }
+    if (mFd >= 0) {
+        close(mFd);
+        mFd = -1;
+    }
+#else
+    mContent.clear();
+#endif
+    mData = nullptr;
+    mSize = 0;
+    mRecords.clear();
+    mIsTruncated = false;
+}
+
+void DiskBufferSegment::BuildIndex(size_t headerSize) {
+    size_t pos = headerSize;
+    while (pos < mSize) {
+        Record record;
+        record.mMetaPos = pos;
+        if (mSize - pos < sizeof(EncryptionStateMeta)) {
+            AlarmManager::GetInstance()->SendAlarmCritical(
+                SECONDARY_READ_WRITE_ALARM,
+                string("read encryption file meta error:") + mFileName + ", pos: " + ToString(pos)
+                    + ", file size: " + ToString(mSize));
+            LOG_ERROR(sLogger, ("read encryption file meta error", mFileName)("pos", pos)("file size", mSize));
+            mIsTruncated = true;
+            break;
+        }
+        memcpy(&record.mMeta, mData + pos, sizeof(EncryptionStateMeta));
+        int32_t encodedInfoSize = record.mMeta.mEncodedInfoSize;
+        if (encodedInfoSize > BUFFER_META_BASE_SIZE) {
+            encodedInfoSize -= BUFFER_META_BASE_SIZE;
+            record.mIsPbMeta = true;
+        }
+        if (record.mMeta.mEncryptionSize < 0 || encodedInfoSize < 0) {
+            AlarmManager::GetInstance()->SendAlarmCritical(
+                SECONDARY_READ_WRITE_ALARM,
+                string("meta of encryption file invalid:" + mFileName + ", meta.mEncryptionSize:"
+                       + ToString(record.mMeta.mEncryptionSize)
+                       + ", meta.mEncodedInfoSize:" + ToString(record.mMeta.mEncodedInfoSize)));
+            LOG_ERROR(sLogger,
+                      ("meta of encryption file invalid", mFileName)("meta.mEncryptionSize", record.mMeta.mEncryptionSize)(
+                          "meta.mEncodedInfoSize", record.mMeta.mEncodedInfoSize));
+            mIsTruncated = true;
+            break;
+        }
+        size_t recordSize = sizeof(EncryptionStateMeta) + encodedInfoSize + record.mMeta.mEncryptionSize;
+        if (mSize - pos < recordSize) {
+            AlarmManager::GetInstance()->SendAlarmCritical(
+                SECONDARY_READ_WRITE_ALARM,
+                string("read encryption from file error:") + mFileName + ", record size: " + ToString(recordSize)
+                    + ", pos: " + ToString(pos) + ", file size: " + ToString(mSize));
+            LOG_ERROR(sLogger,
+                      ("read encryption from file error", mFileName)("record size", recordSize)("pos", pos)("file size",
+                                                                                                          mSize));
+            mIsTruncated = true;
+            break;
+        }
+        record.mEncodedInfo = mData + pos + sizeof(EncryptionStateMeta);
+        record.mEncodedInfoSize = encodedInfoSize;
+        record.mEncryption = record.mEncodedInfo + encodedInfoSize;
+        mRecords.emplace_back(record);
+        pos += recordSize;
+    }
+}
+
+bool DiskBufferSegment::MarkHandled(Record& record) {
+    record.mMeta.mHandled = 1;
+#if defined(__linux__)
+    if (pwrite(mFd, &record.mMeta, sizeof(EncryptionStateMeta), record.mMetaPos) < 0) {
+#else
+    FILE* f = FileWriteOnlyOpen(mFileName.c_str(), "r+b");
+    bool failed = f == nullptr || fseek(f, static_cast<long>(record.mMetaPos), SEEK_SET) != 0
+        || fwrite(&record.mMeta, 1, sizeof(EncryptionStateMeta), f) != sizeof(EncryptionStateMeta);
+    if (f != nullptr) {
+        fclose(f);
+    }
+    if (failed) {
+#endif
+        string errorStr = ErrnoToString(GetErrno());
+        AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
+                                                       string("write secondary file for write meta fail:") + mFileName
+                                                           + ",reason:" + errorStr);
+        LOG_ERROR(sLogger, ("can not write back meta", mFileName));
+        return false;
+    }
+    return true;
+}
+
+} // namespace logtail
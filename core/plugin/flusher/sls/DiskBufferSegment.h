@@ -0,0 +1,89 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+namespace logtail {
+
+// on-disk meta of each record in a buffer file, followed by encoded buffer meta and encrypted data
+struct EncryptionStateMeta {
+    int32_t mLogDataSize;
+    int32_t mEncryptionSize;
+    int32_t mEncodedInfoSize;
+    int32_t mTimeStamp;
+    int32_t mHandled;
+    int32_t mRetryTime;
+};
+
+// DiskBufferSegment is a read only view of one buffer file written by DiskBufferWriter.
+//
+// The file is mapped into memory (read as a whole on platforms without mmap) and indexed once on open, so that
+// replay does not reopen and seek the file for each record. The handled flag of a record is written back in place.
+class DiskBufferSegment {
+public:
+    // encoded info size larger than this means the encoded info is a serialized LogtailBufferMeta
+    static const int32_t BUFFER_META_BASE_SIZE;
+
+    struct Record {
+        size_t mMetaPos = 0;
+        EncryptionStateMeta mMeta{};
+        const char* mEncodedInfo = nullptr;
+        size_t mEncodedInfoSize = 0;
+        bool mIsPbMeta = false;
+        const char* mEncryption = nullptr;
+    };
+
+    DiskBufferSegment() = default;
+    ~DiskBufferSegment() { Close(); }
+    DiskBufferSegment(const DiskBufferSegment&) = delete;
+    DiskBufferSegment& operator=(const DiskBufferSegment&) = delete;
+
+    // @headerSize: size of the encryption header at the beginning of the file
+    // @return false if the file cannot be opened or mapped. A corrupted tail is excluded from the index, and the
+    // records before it are still available.
+    bool Open(const std::string& filename, size_t headerSize);
+    void Close();
+
+    const std::string& GetFileName() const { return mFileName; }
+    std::vector<Record>& GetRecords() { return mRecords; }
+    const std::vector<Record>& GetRecords() const { return mRecords; }
+    // true if the index stopped at a corrupted record before the end of the file
+    bool IsTruncated() const { return mIsTruncated; }
+
+    bool MarkHandled(Record& record);
+
+private:
+    void BuildIndex(size_t headerSize);
+
+    std::string mFileName;
+    const char* mData = nullptr;
+    size_t mSize = 0;
+#if defined(__linux__)
+    int mFd = -1;
+#else
+    std::string mContent;
+#endif
+    std::vector<Record> mRecords;
+    bool mIsTruncated = false;
+};
+
+} // namespace logtail
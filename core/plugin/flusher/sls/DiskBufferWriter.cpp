@@ -14,6 +14,10 @@
 
 #include "plugin/flusher/sls/DiskBufferWriter.h"
 
+#if defined(_MSC_VER)
+#include <io.h>
+#endif
+
 #include <cstddef>
 
 #include "Flags.h"
@@ -50,6 +54,8 @@ DEFINE_FLAG_INT32(send_retry_sleep_interval, "sleep microseconds when sync send
 DEFINE_FLAG_INT32(buffer_check_period, "check logtail local storage buffer period", 60);
 DEFINE_FLAG_INT32(unauthorized_wait_interval, "", 1);
 DEFINE_FLAG_INT32(send_retrytimes, "how many times should retry if PostLogStoreLogs operation fail", 3);
+DEFINE_FLAG_INT32(disk_buffer_replay_thread_count, "number of buffer files replayed in parallel", 1);
+DEFINE_FLAG_BOOL(enable_disk_buffer_fsync, "sync buffer file to disk after each batch of writes", true);
 
 DECLARE_FLAG_INT32(discard_send_fail_interval);
 
@@ -103,7 +109,6 @@ static const string& GetSLSCompressTypeString(sls_logs::SlsCompressType compress
     }
 }
 
-const int32_t DiskBufferWriter::BUFFER_META_BASE_SIZE = 65536;
 const size_t DiskBufferWriter::BUFFER_META_MAX_SIZE = 1 * 1024 * 1024;
 
 void DiskBufferWriter::Init() {
@@ -190,10 +195,14 @@ void DiskBufferWriter::BufferWriterThread() {
         }
 
         if (!res.empty()) {
+            // group commit: all items popped at once are written with one open and one sync
+            FILE* fout = nullptr;
+            string bufferFileName;
             for (auto itr = res.begin(); itr != res.end(); ++itr) {
-                SendToBufferFile(*itr);
+                SendToBufferFile(*itr, fout, bufferFileName);
                 delete *itr;
             }
+            CloseBufferFile(fout, bufferFileName);
             res.clear();
         }
     }
@@ -212,43 +221,35 @@ void DiskBufferWriter::BufferSenderThread() {
             continue;
         }
         lock.unlock();
-        // mIsSendingBuffer = true;
         int32_t fileToSendCount = int32_t(filesToSend.size());
         int32_t bufferFileNumValue = AppConfig::GetInstance()->GetNumOfBufferFile();
-        for (int32_t i = (fileToSendCount > bufferFileNumValue ? fileToSendCount - bufferFileNumValue : 0);
-             i < fileToSendCount && mIsSendBufferThreadRunning;
-             ++i) {
-            string fileName = GetBufferFilePath() + filesToSend[i];
-            unordered_map<string, string> kvMap;
-            if (FileEncryption::CheckHeader(fileName, kvMap)) {
-                int32_t keyVersion = -1;
-                if (kvMap.find(STRING_FLAG(file_encryption_field_key_version)) != kvMap.end()) {
-                    if (!StringTo(kvMap[STRING_FLAG(file_encryption_field_key_version)], keyVersion)) {
-                        LOG_ERROR(sLogger,
-                                  ("convert key_version to int32_t fail",
-                                   kvMap[STRING_FLAG(file_encryption_field_key_version)]));
+        int32_t begin = fileToSendCount > bufferFileNumValue ? fileToSendCount - bufferFileNumValue : 0;
+        int32_t threadCnt = min(INT32_FLAG(disk_buffer_replay_thread_count), fileToSendCount - begin);
+        if (threadCnt <= 1) {
+            for (int32_t i = begin; i < fileToSendCount && IsSendBufferThreadRunning(); ++i) {
+                SendBufferFile(GetBufferFilePath() + filesToSend[i]);
+            }
+        } else {
+            // files are independent segments, so they can be replayed in parallel, with requests still limited by
+            // the concurrency limiters shared with the normal sending
+            atomic_int32_t next(begin);
+            vector<future<void>> replayers;
+            for (int32_t i = 0; i < threadCnt; ++i) {
+                replayers.emplace_back(async(launch::async, [&]() {
+                    for (int32_t idx = next++; idx < fileToSendCount && IsSendBufferThreadRunning(); idx = next++) {
+                        SendBufferFile(GetBufferFilePath() + filesToSend[idx]);
                     }
-                }
-                if (keyVersion >= 1 && keyVersion <= FileEncryption::GetInstance()->GetDefaultKeyVersion()) {
-                    LOG_INFO(sLogger, ("check local encryption file", fileName)("key_version", keyVersion));
-                    SendEncryptionBuffer(fileName, keyVersion);
-                } else {
-                    remove(fileName.c_str());
-                    LOG_ERROR(sLogger,
-                              ("invalid key_version in header",
-                               kvMap[STRING_FLAG(file_encryption_field_key_version)])("delete bufffer file", fileName));
-                    AlarmManager::GetInstance()->SendAlarmCritical(
-                        DISCARD_SECONDARY_ALARM, "key version in buffer file invalid, delete file: " + fileName);
-                }
-            } else {
-                remove(fileName.c_str());
-                LOG_WARNING(sLogger, ("check header of buffer file failed, delete file", fileName));
-                AlarmManager::GetInstance()->SendAlarmCritical(
-                    DISCARD_SECONDARY_ALARM, "check header of buffer file failed, delete file: " + fileName);
+                }));
+            }
+            for (auto& replayer : replayers) {
+                replayer.get();
             }
         }
 #ifdef __ENTERPRISE__
-        mCandidateHostsInfos.clear();
+        {
+            lock_guard<mutex> hostsLock(mCandidateHostsInfosMux);
+            mCandidateHostsInfos.clear();
+        }
 #endif
         // mIsSendingBuffer = false;
         lock.lock();
@@ -258,6 +259,41 @@ void DiskBufferWriter::BufferSenderThread() {
     }
 }
 
+void DiskBufferWriter::SendBufferFile(const string& fileName) {
+    unordered_map<string, string> kvMap;
+    if (FileEncryption::CheckHeader(fileName, kvMap)) {
+        int32_t keyVersion = -1;
+        if (kvMap.find(STRING_FLAG(file_encryption_field_key_version)) != kvMap.end()) {
+            if (!StringTo(kvMap[STRING_FLAG(file_encryption_field_key_version)], keyVersion)) {
+                LOG_ERROR(sLogger,
+                          ("convert key_version to int32_t fail",
+                           kvMap[STRING_FLAG(file_encryption_field_key_version)]));
+            }
+        }
+        if (keyVersion >= 1 && keyVersion <= FileEncryption::GetInstance()->GetDefaultKeyVersion()) {
+            LOG_INFO(sLogger, ("check local encryption file", fileName)("key_version", keyVersion));
+            SendEncryptionBuffer(fileName, keyVersion);
+        } else {
+            remove(fileName.c_str());
+            LOG_ERROR(sLogger,
+                      ("invalid key_version in header",
+                       kvMap[STRING_FLAG(file_encryption_field_key_version)])("delete bufffer file", fileName));
+            AlarmManager::GetInstance()->SendAlarmCritical(
+                DISCARD_SECONDARY_ALARM, "key version in buffer file invalid, delete file: " + fileName);
+        }
+    } else {
+        remove(fileName.c_str());
+        LOG_WARNING(sLogger, ("check header of buffer file failed, delete file", fileName));
+        AlarmManager::GetInstance()->SendAlarmCritical(DISCARD_SECONDARY_ALARM,
+                                                       "check header of buffer file failed, delete file: " + fileName);
+    }
+}
+
+bool DiskBufferWriter::IsSendBufferThreadRunning() const {
+    lock_guard<mutex> lock(mBufferSenderThreadRunningMux);
+    return mIsSendBufferThreadRunning;
+}
+
 void DiskBufferWriter::SetBufferFilePath(const std::string& bufferfilepath) {
     lock_guard<mutex> lock(mBufferFileLock);
     if (bufferfilepath == "") {
@@ -331,112 +367,22 @@ bool DiskBufferWriter::LoadFileToSend(time_t timeLine, std::vector<std::string>&
     return true;
 }
 
-bool DiskBufferWriter::ReadNextEncryption(int32_t& pos,
-                                          const std::string& filename,
-                                          std::string& encryption,
-                                          EncryptionStateMeta& meta,
-                                          bool& readResult,
-                                          sls_logs::LogtailBufferMeta& bufferMeta) {
+bool DiskBufferWriter::ParseBufferMeta(const DiskBufferSegment::Record& record,
+                                       const std::string& filename,
+                                       sls_logs::LogtailBufferMeta& bufferMeta) {
     bufferMeta.Clear();
-    readResult = false;
-    encryption.clear();
-    int retryTimes = 0;
-
-    FILE* fin = NULL;
-    while (true) {
-        retryTimes++;
-        fin = FileReadOnlyOpen(filename.c_str(), "rb");
-        if (fin)
-            break;
-        if (retryTimes >= 3) {
-            string errorStr = ErrnoToString(GetErrno());
-            AlarmManager::GetInstance()->SendAlarmCritical(
-                SECONDARY_READ_WRITE_ALARM, string("open file error:") + filename + ",error:" + errorStr);
-            LOG_ERROR(sLogger, ("open file error", filename)("error", errorStr));
-            return false;
-        }
-        usleep(5000);
-    }
-    fseek(fin, 0, SEEK_END);
-    auto const currentSize = ftell(fin);
-    if (currentSize == pos) {
-        fclose(fin);
-        return false;
-    }
-    fseek(fin, pos, SEEK_SET);
-    auto nbytes = fread(static_cast<void*>(&meta), sizeof(char), sizeof(meta), fin);
-    if (nbytes != sizeof(meta)) {
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarmCritical(
-            SECONDARY_READ_WRITE_ALARM,
-            string("read encryption file meta error:") + filename + ", error:" + errorStr
-                + ", meta.mEncryptionSize:" + ToString(meta.mEncryptionSize) + ", nbytes: " + ToString(nbytes)
-                + ", pos: " + ToString(pos) + ", ftell: " + ToString(currentSize));
-        LOG_ERROR(sLogger,
-                  ("read encryption file meta error",
-                   filename)("error", errorStr)("nbytes", nbytes)("pos", pos)("ftell", currentSize));
-        fclose(fin);
-        return false;
-    }
-
-    bool pbMeta = false;
-    int32_t encodedInfoSize = meta.mEncodedInfoSize;
-    if (encodedInfoSize > BUFFER_META_BASE_SIZE) {
-        encodedInfoSize -= BUFFER_META_BASE_SIZE;
-        pbMeta = true;
-    }
-
-    if (meta.mEncryptionSize < 0 || encodedInfoSize < 0) {
-        AlarmManager::GetInstance()->SendAlarmCritical(
-            SECONDARY_READ_WRITE_ALARM,
-            string("meta of encryption file invalid:" + filename + ", meta.mEncryptionSize:"
-                   + ToString(meta.mEncryptionSize) + ", meta.mEncodedInfoSize:" + ToString(meta.mEncodedInfoSize)));
-        LOG_ERROR(sLogger,
-                  ("meta of encryption file invalid", filename)("meta.mEncryptionSize", meta.mEncryptionSize)(
-                      "meta.mEncodedInfoSize", meta.mEncodedInfoSize));
-        fclose(fin);
-        return false;
-    }
-
-    pos += sizeof(meta) + encodedInfoSize + meta.mEncryptionSize;
-    if ((time(NULL) - meta.mTimeStamp) > INT32_FLAG(log_expire_time) || meta.mHandled == 1) {
-        fclose(fin);
-        if (meta.mHandled != 1) {
-            LOG_WARNING(sLogger, ("timeout buffer file, meta.mTimeStamp", meta.mTimeStamp));
-            AlarmManager::GetInstance()->SendAlarmCritical(DISCARD_SECONDARY_ALARM,
-                                                           "buffer file timeout (1day), delete file: " + filename);
-        }
-        return true;
-    }
-
-    char* buffer = new char[encodedInfoSize + 1];
-    nbytes = fread(buffer, sizeof(char), encodedInfoSize, fin);
-    if (nbytes != static_cast<size_t>(encodedInfoSize)) {
-        fclose(fin);
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarmCritical(
-            SECONDARY_READ_WRITE_ALARM,
-            string("read projectname from file error:") + filename + ", error:" + errorStr
-                + ", meta.mEncodedInfoSize:" + ToString(meta.mEncodedInfoSize) + ", nbytes:" + ToString(nbytes));
-        LOG_ERROR(sLogger,
-                  ("read encodedInfo from file error",
-                   filename)("error", errorStr)("meta.mEncodedInfoSize", meta.mEncodedInfoSize)("nbytes", nbytes));
-        delete[] buffer;
-        return true;
-    }
-    string encodedInfo = string(buffer, encodedInfoSize);
-    delete[] buffer;
-    if (pbMeta) {
-        if (!bufferMeta.ParseFromString(encodedInfo)) {
-            fclose(fin);
+    if (record.mIsPbMeta) {
+        if (!bufferMeta.ParseFromArray(record.mEncodedInfo, static_cast<int>(record.mEncodedInfoSize))) {
             AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
                                                            string("parse buffer meta from file error:") + filename);
-            LOG_ERROR(sLogger, ("parse buffer meta from file error", filename)("buffer meta", encodedInfo));
+            LOG_ERROR(sLogger,
+                      ("parse buffer meta from file error",
+                       filename)("buffer meta", string(record.mEncodedInfo, record.mEncodedInfoSize)));
             bufferMeta.Clear();
-            return true;
+            return false;
         }
     } else {
-        bufferMeta.set_project(encodedInfo);
+        bufferMeta.set_project(string(record.mEncodedInfo, record.mEncodedInfoSize));
         bufferMeta.set_region(FlusherSLS::GetDefaultRegion()); // new mode
         bufferMeta.set_aliuid("");
     }
@@ -454,55 +400,41 @@ bool DiskBufferWriter::ReadNextEncryption(int32_t& pos,
     if (!bufferMeta.has_endpoint()) {
         bufferMeta.set_endpoint("");
     }
-
-    buffer = new char[meta.mEncryptionSize + 1];
-    nbytes = fread(buffer, sizeof(char), meta.mEncryptionSize, fin);
-    if (nbytes != static_cast<size_t>(meta.mEncryptionSize)) {
-        fclose(fin);
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarmCritical(
-            SECONDARY_READ_WRITE_ALARM,
-            string("read encryption from file error:") + filename + ",error:" + errorStr
-                + ",meta.mEncryptionSize:" + ToString(meta.mEncryptionSize) + ", nbytes:" + ToString(nbytes),
-            bufferMeta.region(),
-            bufferMeta.project(),
-            "",
-            bufferMeta.logstore());
-        LOG_ERROR(sLogger,
-                  ("read encryption from file error",
-                   filename)("error", errorStr)("meta.mEncryptionSize", meta.mEncryptionSize)("nbytes", nbytes));
-        delete[] buffer;
-        return true;
-    }
-    encryption = string(buffer, meta.mEncryptionSize);
-    readResult = true;
-    delete[] buffer;
-    fclose(fin);
     return true;
 }
 
 void DiskBufferWriter::SendEncryptionBuffer(const std::string& filename, int32_t keyVersion) {
-    string encryption;
+    DiskBufferSegment segment;
+    if (!segment.Open(filename, INT32_FLAG(file_encryption_header_length))) {
+        return;
+    }
     string logData;
-    EncryptionStateMeta meta;
-    bool readResult;
     bool writeBack = false;
-    int32_t pos = INT32_FLAG(file_encryption_header_length);
     sls_logs::LogtailBufferMeta bufferMeta;
     int32_t discardCount = 0;
-    while (ReadNextEncryption(pos, filename, encryption, meta, readResult, bufferMeta)) {
+    for (auto& record : segment.GetRecords()) {
+        const auto& meta = record.mMeta;
+        if (meta.mHandled == 1) {
+            continue;
+        }
+        if ((time(NULL) - meta.mTimeStamp) > INT32_FLAG(log_expire_time)) {
+            LOG_WARNING(sLogger, ("timeout buffer file, meta.mTimeStamp", meta.mTimeStamp));
+            AlarmManager::GetInstance()->SendAlarmCritical(DISCARD_SECONDARY_ALARM,
+                                                           "buffer file timeout (1day), delete file: " + filename);
+            segment.MarkHandled(record);
+            discardCount++;
+            continue;
+        }
         logData.clear();
         bool sendResult = false;
-        if (!readResult || !CheckBufferMetaValidation(filename, bufferMeta)) {
-            if (meta.mHandled == 1)
-                continue;
+        if (!ParseBufferMeta(record, filename, bufferMeta) || !CheckBufferMetaValidation(filename, bufferMeta)) {
             sendResult = true;
             discardCount++;
         }
         if (!sendResult) {
             char* des = new char[meta.mLogDataSize];
             if (!FileEncryption::GetInstance()->Decrypt(
-                    encryption.c_str(), meta.mEncryptionSize, des, meta.mLogDataSize, keyVersion)) {
+                    record.mEncryption, meta.mEncryptionSize, des, meta.mLogDataSize, keyVersion)) {
                 sendResult = true;
                 discardCount++;
                 LOG_ERROR(sLogger,
@@ -555,116 +487,147 @@ void DiskBufferWriter::SendEncryptionBuffer(const std::string& filename, int32_t
                     }
                 }
                 if (!sendResult) {
-                    time_t beginTime = time(nullptr);
-                    while (true) {
-                        string host;
-                        auto response = SendBufferFileData(bufferMeta, logData, host);
-                        SendResult sendRes = SEND_OK;
-                        if (response.mStatusCode != 200) {
-                            sendRes = ConvertErrorCode(response.mErrorCode);
-                        }
-                        switch (sendRes) {
-                            case SEND_OK:
-                                sendResult = true;
-                                break;
-                            case SEND_NETWORK_ERROR:
-                            case SEND_SERVER_ERROR:
-                                if (response.mErrorMsg != kNoHostErrorMsg) {
-                                    LOG_WARNING(
-                                        sLogger,
-                                        ("send data to SLS fail", "retry later")("request id", response.mRequestId)(
-                                            "error_code", response.mErrorCode)("error_message", response.mErrorMsg)(
-                                            "endpoint", host)("projectName", bufferMeta.project())(
-                                            "logstore", bufferMeta.logstore())("rawsize", bufferMeta.rawsize()));
-                                }
-                                usleep(INT32_FLAG(send_retry_sleep_interval));
-                                break;
-                            case SEND_QUOTA_EXCEED:
-                                AlarmManager::GetInstance()->SendAlarmError(
-                                    SEND_QUOTA_EXCEED_ALARM,
-                                    "error_code: " + response.mErrorCode + ", error_message: " + response.mErrorMsg,
-                                    bufferMeta.region(),
-                                    bufferMeta.project(),
-                                    "",
-                                    bufferMeta.logstore());
-                                // no region
-                                if (!GetProfileSender()->IsProfileData("", bufferMeta.project(), bufferMeta.logstore()))
-                                    LOG_WARNING(
-                                        sLogger,
-                                        ("send data to SLS fail", "retry later")("request id", response.mRequestId)(
-                                            "error_code", response.mErrorCode)("error_message", response.mErrorMsg)(
-                                            "endpoint", host)("projectName", bufferMeta.project())(
-                                            "logstore", bufferMeta.logstore())("rawsize", bufferMeta.rawsize()));
-                                usleep(INT32_FLAG(quota_exceed_wait_interval));
-                                break;
-                            case SEND_UNAUTHORIZED:
-                                usleep(INT32_FLAG(unauthorized_wait_interval));
-                                break;
-                            default:
-                                sendResult = true;
-                                discardCount++;
-                                break;
-                        }
-#ifdef __ENTERPRISE__
-                        if (sendRes != SEND_NETWORK_ERROR && sendRes != SEND_SERVER_ERROR) {
-                            bool hasAuthError = sendRes == SEND_UNAUTHORIZED && response.mErrorMsg != kAKErrorMsg;
-                            EnterpriseSLSClientManager::GetInstance()->UpdateAccessKeyStatus(bufferMeta.aliuid(),
-                                                                                             !hasAuthError);
-                            EnterpriseSLSClientManager::GetInstance()->UpdateProjectAnonymousWriteStatus(
-                                bufferMeta.project(), !hasAuthError);
-                        }
-#endif
-                        if (time(nullptr) - beginTime >= INT32_FLAG(discard_send_fail_interval)) {
-                            sendResult = true;
-                            discardCount++;
-                        }
-                        if (sendResult) {
-                            break;
-                        }
-                        {
-                            lock_guard<mutex> lock(mBufferSenderThreadRunningMux);
-                            if (!mIsSendBufferThreadRunning) {
-                                break;
-                            }
-                        }
-                    }
+                    sendResult = SendBufferRecord(bufferMeta, logData, discardCount);
                 }
             }
             delete[] des;
         }
-        if (sendResult)
-            meta.mHandled = 1;
         LOG_DEBUG(sLogger,
                   ("send LogGroup from local buffer file", filename)("rawsize", bufferMeta.rawsize())("sendResult",
                                                                                                       sendResult));
-        WriteBackMeta(pos - meta.mEncryptionSize - sizeof(meta)
-                          - (meta.mEncodedInfoSize > BUFFER_META_BASE_SIZE
-                                 ? (meta.mEncodedInfoSize - BUFFER_META_BASE_SIZE)
-                                 : meta.mEncodedInfoSize),
-                      (char*)&meta,
-                      sizeof(meta),
-                      filename);
-        if (!sendResult)
+        if (sendResult) {
+            segment.MarkHandled(record);
+        } else {
             writeBack = true;
-        {
-            lock_guard<mutex> lock(mBufferSenderThreadRunningMux);
-            if (!mIsSendBufferThreadRunning) {
-                return;
-            }
+        }
+        if (!IsSendBufferThreadRunning()) {
+            return;
         }
     }
+    // the records after a corrupted one cannot be located, so they are lost once the file is deleted
+    bool truncated = segment.IsTruncated();
+    segment.Close();
     if (!writeBack) {
         remove(filename.c_str());
-        if (discardCount > 0) {
-            LOG_ERROR(sLogger, ("send buffer file, discard LogGroup count", discardCount)("delete file", filename));
-            AlarmManager::GetInstance()->SendAlarmCritical(DISCARD_SECONDARY_ALARM,
-                                                           "delete buffer file: " + filename + ", discard "
-                                                               + ToString(discardCount) + " logGroups");
+        if (discardCount > 0 || truncated) {
+            LOG_ERROR(sLogger,
+                      ("send buffer file, discard LogGroup count", discardCount)("corrupted tail discarded", truncated)(
+                          "delete file", filename));
+            AlarmManager::GetInstance()->SendAlarmCritical(
+                DISCARD_SECONDARY_ALARM,
+                "delete buffer file: " + filename + ", discard " + ToString(discardCount) + " logGroups"
+                    + (truncated ? " and the corrupted tail" : ""));
         } else
             LOG_INFO(sLogger, ("send buffer file success, delete buffer file", filename));
     }
 }
 
+bool DiskBufferWriter::SendBufferRecord(const sls_logs::LogtailBufferMeta& bufferMeta,
+                                        const std::string& logData,
+                                        int32_t& discardCount) {
+    // parallel replay shares the concurrency limiters with normal sending, so that it does not flood the server on
+    // recovery. Serial replay sends one request at a time and is not limited, as before.
+    shared_ptr<ConcurrencyLimiter> regionLimiter, projectLimiter;
+    if (INT32_FLAG(disk_buffer_replay_thread_count) > 1) {
+        regionLimiter = FlusherSLS::GetRegionConcurrencyLimiter(bufferMeta.region());
+        projectLimiter = FlusherSLS::GetProjectConcurrencyLimiter(bufferMeta.project());
+    }
+    time_t beginTime = time(nullptr);
+    while (true) {
+        if (regionLimiter) {
+            while (!regionLimiter->IsValidToPop() || !projectLimiter->IsValidToPop()) {
+                if (!IsSendBufferThreadRunning()) {
+                    return false;
+                }
+                this_thread::sleep_for(chrono::milliseconds(10));
+            }
+            regionLimiter->PostPop();
+            projectLimiter->PostPop();
+        }
+        string host;
+        auto response = SendBufferFileData(bufferMeta, logData, host);
+        if (regionLimiter) {
+            regionLimiter->OnSendDone();
+            projectLimiter->OnSendDone();
+        }
+
+        bool sendResult = false;
+        SendResult sendRes = SEND_OK;
+        if (response.mStatusCode != 200) {
+            sendRes = ConvertErrorCode(response.mErrorCode);
+        }
+        auto curSystemTime = chrono::system_clock::now();
+        switch (sendRes) {
+            case SEND_OK:
+                if (regionLimiter) {
+                    regionLimiter->OnSuccess(curSystemTime);
+                    projectLimiter->OnSuccess(curSystemTime);
+                }
+                sendResult = true;
+                break;
+            case SEND_NETWORK_ERROR:
+            case SEND_SERVER_ERROR:
+                if (response.mErrorMsg != kNoHostErrorMsg) {
+                    if (regionLimiter) {
+                        regionLimiter->OnFail(curSystemTime);
+                    }
+                    LOG_WARNING(sLogger,
+                                ("send data to SLS fail", "retry later")("request id", response.mRequestId)(
+                                    "error_code", response.mErrorCode)("error_message", response.mErrorMsg)(
+                                    "endpoint", host)("projectName", bufferMeta.project())(
+                                    "logstore", bufferMeta.logstore())("rawsize", bufferMeta.rawsize()));
+                }
+                usleep(INT32_FLAG(send_retry_sleep_interval));
+                break;
+            case SEND_QUOTA_EXCEED:
+                if (projectLimiter) {
+                    projectLimiter->OnFail(curSystemTime);
+                }
+                AlarmManager::GetInstance()->SendAlarmError(SEND_QUOTA_EXCEED_ALARM,
+                                                            "error_code: " + response.mErrorCode
+                                                                + ", error_message: " + response.mErrorMsg,
+                                                            bufferMeta.region(),
+                                                            bufferMeta.project(),
+                                                            "",
+                                                            bufferMeta.logstore());
+                // no region
+                if (!GetProfileSender()->IsProfileData("", bufferMeta.project(), bufferMeta.logstore()))
+                    LOG_WARNING(sLogger,
+                                ("send data to SLS fail", "retry later")("request id", response.mRequestId)(
+                                    "error_code", response.mErrorCode)("error_message", response.mErrorMsg)(
+                                    "endpoint", host)("projectName", bufferMeta.project())(
+                                    "logstore", bufferMeta.logstore())("rawsize", bufferMeta.rawsize()));
+                usleep(INT32_FLAG(quota_exceed_wait_interval));
+                break;
+            case SEND_UNAUTHORIZED:
+                usleep(INT32_FLAG(unauthorized_wait_interval));
+                break;
+            default:
+                sendResult = true;
+                discardCount++;
+                break;
+        }
+#ifdef __ENTERPRISE__
+        if (sendRes != SEND_NETWORK_ERROR && sendRes != SEND_SERVER_ERROR) {
+            bool hasAuthError = sendRes == SEND_UNAUTHORIZED && response.mErrorMsg != kAKErrorMsg;
+            EnterpriseSLSClientManager::GetInstance()->UpdateAccessKeyStatus(bufferMeta.aliuid(), !hasAuthError);
+            EnterpriseSLSClientManager::GetInstance()->UpdateProjectAnonymousWriteStatus(bufferMeta.project(),
+                                                                                         !hasAuthError);
+        }
+#endif
+        if (time(nullptr) - beginTime >= INT32_FLAG(discard_send_fail_interval)) {
+            sendResult = true;
+            discardCount++;
+        }
+        if (sendResult) {
+            return true;
+        }
+        if (!IsSendBufferThreadRunning()) {
+            return false;
+        }
+    }
+}
+
 // file is not really created when call CreateNewFile(), file created happened when SendToBufferFile() first called
 bool DiskBufferWriter::CreateNewFile() {
     vector<string> filesToSend;
@@ -689,53 +652,6 @@ bool DiskBufferWriter::CreateNewFile() {
     return true;
 }
 
-bool DiskBufferWriter::WriteBackMeta(int32_t pos, const void* buf, int32_t length, const string& filename) {
-    // TODO: Why not use fopen or fstream???
-    // TODO: Make sure and merge them.
-#if defined(__linux__)
-    int fd = open(filename.c_str(), O_WRONLY);
-    if (fd < 0) {
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
-                                                       string("open secondary file for write meta fail:") + filename
-                                                           + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("open file error", filename));
-        return false;
-    }
-    lseek(fd, pos, SEEK_SET);
-    if (write(fd, buf, length) < 0) {
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
-                                                       string("write secondary file for write meta fail:") + filename
-                                                           + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("can not write back meta", filename));
-    }
-    close(fd);
-    return true;
-#elif defined(_MSC_VER)
-    FILE* f = FileWriteOnlyOpen(filename.c_str(), "wb");
-    if (!f) {
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
-                                                       string("open secondary file for write meta fail:") + filename
-                                                           + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("open file error", filename));
-        return false;
-    }
-    fseek(f, pos, SEEK_SET);
-    auto nbytes = fwrite(buf, 1, length, f);
-    if (nbytes != length) {
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
-                                                       string("write secondary file for write meta fail:") + filename
-                                                           + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("can not write back meta", filename));
-    }
-    fclose(f);
-    return true;
-#endif
-}
-
 string DiskBufferWriter::GetBufferFileHeader() {
     string reserve = STRING_FLAG(file_encryption_field_key_version) + STRING_FLAG(file_encryption_key_value_splitter)
         + ToString(FileEncryption::GetInstance()->GetDefaultKeyVersion());
@@ -745,16 +661,18 @@ string DiskBufferWriter::GetBufferFileHeader() {
     return (STRING_FLAG(file_encryption_magic_number) + reserve + nullHeader);
 }
 
-bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
+bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr, FILE*& fout, string& bufferFileName) {
     auto data = static_cast<SLSSenderQueueItem*>(dataPtr);
     auto flusher = static_cast<const FlusherSLS*>(data->mFlusher);
-    string bufferFileName = GetBufferFileName();
-    if (bufferFileName.empty()) {
-        CreateNewFile();
+    if (fout == nullptr) {
         bufferFileName = GetBufferFileName();
+        if (bufferFileName.empty()) {
+            CreateNewFile();
+            bufferFileName = GetBufferFileName();
+        }
+        // if file not exist, create it new
+        fout = FileAppendOpen(bufferFileName.c_str(), "ab");
     }
-    // if file not exist, create it new
-    FILE* fout = FileAppendOpen(bufferFileName.c_str(), "ab");
     if (!fout) {
         string errorStr = ErrnoToString(GetErrno());
         AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
@@ -781,7 +699,7 @@ bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
                                                            "",
                                                            data->mLogstore);
             LOG_ERROR(sLogger, ("error write encryption header", bufferFileName)("error", errorStr)("nbytes", nbytes));
-            fclose(fout);
+            CloseBufferFile(fout, bufferFileName);
             return false;
         }
     }
@@ -789,7 +707,6 @@ bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
     char* des;
     int32_t desLength;
     if (!FileEncryption::GetInstance()->Encrypt(data->mData.c_str(), data->mData.size(), des, desLength)) {
-        fclose(fout);
         LOG_ERROR(sLogger, ("encrypt error, project_name", flusher->mProject));
         AlarmManager::GetInstance()->SendAlarmCritical(ENCRYPT_DECRYPT_FAIL_ALARM,
                                                        string("encrypt error, project_name:" + flusher->mProject),
@@ -821,7 +738,7 @@ bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
 
     EncryptionStateMeta meta;
     int32_t encodedInfoSize = encodedInfo.size();
-    meta.mEncodedInfoSize = encodedInfoSize + BUFFER_META_BASE_SIZE;
+    meta.mEncodedInfoSize = encodedInfoSize + DiskBufferSegment::BUFFER_META_BASE_SIZE;
     meta.mLogDataSize = data->mData.size();
     meta.mTimeStamp = time(NULL);
     meta.mHandled = 0;
@@ -847,21 +764,48 @@ bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
             sLogger,
             ("write meta of buffer file", "fail")("filename", bufferFileName)("errorStr", errorStr)("nbytes", nbytes));
         delete[] buffer;
-        fclose(fout);
+        CloseBufferFile(fout, bufferFileName);
         return false;
     }
     delete[] buffer;
-    if (ftell(fout) > AppConfig::GetInstance()->GetLocalFileSize())
-        CreateNewFile();
-    fclose(fout);
     LOG_DEBUG(sLogger, ("write buffer file", bufferFileName));
+    if (ftell(fout) > AppConfig::GetInstance()->GetLocalFileSize()) {
+        CloseBufferFile(fout, bufferFileName);
+        CreateNewFile();
+    }
     return true;
 }
 
+void DiskBufferWriter::CloseBufferFile(FILE*& fout, const string& bufferFileName) {
+    if (fout == nullptr) {
+        return;
+    }
+    if (BOOL_FLAG(enable_disk_buffer_fsync)) {
+        bool synced = fflush(fout) == 0;
+#if defined(__linux__)
+        synced = synced && fsync(fileno(fout)) == 0;
+#elif defined(_MSC_VER)
+        synced = synced && _commit(_fileno(fout)) == 0;
+#endif
+        if (!synced) {
+            string errorStr = ErrnoToString(GetErrno());
+            AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
+                                                           string("sync file error:") + bufferFileName
+                                                               + ", error:" + errorStr);
+            LOG_ERROR(sLogger, ("sync buffer file error", bufferFileName)("error", errorStr));
+        }
+    }
+    fclose(fout);
+    fout = nullptr;
+}
+
 SLSResponse DiskBufferWriter::SendBufferFileData(const sls_logs::LogtailBufferMeta& bufferMeta,
                                                  const std::string& logData,
                                                  std::string& host) {
-    RateLimiter::FlowControl(bufferMeta.rawsize(), mSendLastTime, mSendLastByte, false);
+    {
+        lock_guard<mutex> lock(mFlowControlMux);
+        RateLimiter::FlowControl(bufferMeta.rawsize(), mSendLastTime, mSendLastByte, false);
+    }
     string region = bufferMeta.region();
 #ifdef __ENTERPRISE__
     // old buffer file which record the endpoint
@@ -898,7 +842,10 @@ SLSResponse DiskBufferWriter::SendBufferFileData(const sls_logs::LogtailBufferMe
     }
     auto info = EnterpriseSLSClientManager::GetInstance()->GetCandidateHostsInfo(
         region, bufferMeta.project(), GetEndpointMode(bufferMeta.endpointmode()));
-    mCandidateHostsInfos.insert(info);
+    {
+        lock_guard<mutex> lock(mCandidateHostsInfosMux);
+        mCandidateHostsInfos.insert(info);
+    }
 
     host = info->GetCurrentHost();
     if (host.empty()) {
@@ -29,6 +29,7 @@
 
 #include "collection_pipeline/queue/SenderQueueItem.h"
 #include "common/SafeQueue.h"
+#include "plugin/flusher/sls/DiskBufferSegment.h"
 #include "plugin/flusher/sls/SLSClientManager.h"
 #include "plugin/flusher/sls/SLSResponse.h"
 #include "protobuf/sls/logtail_buffer_meta.pb.h"
@@ -56,18 +57,8 @@ public:
     bool PushToDiskBuffer(SenderQueueItem* item, uint32_t retryTimes);
 
 private:
-    static const int32_t BUFFER_META_BASE_SIZE;
     static const size_t BUFFER_META_MAX_SIZE;
 
-    struct EncryptionStateMeta {
-        int32_t mLogDataSize;
-        int32_t mEncryptionSize;
-        int32_t mEncodedInfoSize;
-        int32_t mTimeStamp;
-        int32_t mHandled;
-        int32_t mRetryTime;
-    };
-
     DiskBufferWriter() = default;
     ~DiskBufferWriter() = default;
 
@@ -76,17 +67,21 @@ private:
 
     SLSResponse
     SendBufferFileData(const sls_logs::LogtailBufferMeta& bufferMeta, const std::string& logData, std::string& host);
-    bool SendToBufferFile(SenderQueueItem* dataPtr);
+    // records of one batch are appended to the opened file, which is synced once by CloseBufferFile
+    bool SendToBufferFile(SenderQueueItem* dataPtr, FILE*& fout, std::string& bufferFileName);
+    void CloseBufferFile(FILE*& fout, const std::string& bufferFileName);
     bool LoadFileToSend(time_t timeLine, std::vector<std::string>& filesToSend);
     bool CreateNewFile();
-    bool WriteBackMeta(const int32_t pos, const void* buf, int32_t length, const std::string& filename);
-    bool ReadNextEncryption(int32_t& pos,
-                            const std::string& filename,
-                            std::string& encryption,
-                            EncryptionStateMeta& meta,
-                            bool& readResult,
-                            sls_logs::LogtailBufferMeta& bufferMeta);
+    bool ParseBufferMeta(const DiskBufferSegment::Record& record,
+                         const std::string& filename,
+                         sls_logs::LogtailBufferMeta& bufferMeta);
+    void SendBufferFile(const std::string& filename);
     void SendEncryptionBuffer(const std::string& filename, int32_t keyVersion);
+    // @return true if the data is sent or discarded, false if interrupted by stop
+    bool SendBufferRecord(const sls_logs::LogtailBufferMeta& bufferMeta,
+                          const std::string& logData,
+                          int32_t& discardCount);
+    bool IsSendBufferThreadRunning() const;
     void SetBufferFilePath(const std::string& bufferfilepath);
     std::string GetBufferFilePath();
     std::string GetBufferFileName();
@@ -118,6 +113,7 @@ private:
         }
     };
 
+    mutable std::mutex mCandidateHostsInfosMux;
     std::unordered_set<std::shared_ptr<CandidateHostsInfo>, PointerHash, PointerEqual> mCandidateHostsInfos;
 #endif
 
@@ -128,8 +124,14 @@ private:
     volatile time_t mBufferDivideTime = 0;
     int64_t mCheckPeriod = 0;
 
+    // buffer files may be replayed by several threads, which share the same flow control
+    mutable std::mutex mFlowControlMux;
     int64_t mSendLastTime = 0;
     int32_t mSendLastByte = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class DiskBufferBenchmark;
+#endif
 };
 
 } // namespace logtail
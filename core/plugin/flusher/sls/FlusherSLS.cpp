@@ -719,6 +719,20 @@ void FlusherSLS::OnSendDone(const HttpResponse& response, SenderQueueItem* item)
     bool isProfileData = GetProfileSender()->IsProfileData(mRegion, mProject, data->mLogstore);
     int32_t curTime = time(NULL);
     auto curSystemTime = chrono::system_clock::now();
+    {
+        // the limiters must be checked before the in-sending count of the item is decreased
+        uint32_t concurrency = numeric_limits<uint32_t>::max();
+        bool saturated = false;
+        for (const auto& limiter : {GetRegionConcurrencyLimiter(mRegion),
+                                    GetProjectConcurrencyLimiter(mProject),
+                                    GetLogstoreConcurrencyLimiter(mProject, mLogstore)}) {
+            uint32_t limit = limiter->GetCurrentLimit();
+            concurrency = min(concurrency, limit);
+            saturated = saturated || limiter->GetInSendingCount() >= limit;
+        }
+        mBatcher.OnSendDone(
+            chrono::duration_cast<chrono::milliseconds>(curSystemTime - item->mLastSendTime), concurrency, saturated);
+    }
     SendResult sendResult = SEND_OK;
     if (slsResponse.mStatusCode == 200) {
         auto& cpt = data->mExactlyOnceCheckpoint;
@@ -742,6 +756,7 @@ void FlusherSLS::OnSendDone(const HttpResponse& response, SenderQueueItem* item)
         GetLogstoreConcurrencyLimiter(mProject, mLogstore)->OnSuccess(curSystemTime);
         SenderQueueManager::GetInstance()->DecreaseConcurrencyLimiterInSendingCnt(item->mQueueKey);
         ADD_COUNTER(mSuccessCnt, 1);
+        RecordTraceOnSendDone(item->mTrace);
         DealSenderQueueItemAfterSend(item, false);
     } else {
         OperationOnFail operation;
@@ -991,11 +1006,13 @@ bool FlusherSLS::SerializeAndPush(PipelineEventGroup&& group) {
                     std::move(group.GetSizedTags()),
                     std::move(group.GetSourceBuffer()),
                     group.GetMetadata(EventGroupMetaKey::SOURCE_ID),
-                    std::move(group.GetExactlyOnceCheckpoint()));
+                    std::move(group.GetExactlyOnceCheckpoint()),
+                    std::move(group.GetTrace()));
     for (const auto& extraSourceBuffer : group.GetExtraSourceBuffers()) {
         g.mSourceBuffers.emplace_back(extraSourceBuffer);
     }
     AddPackId(g);
+    EventGroupTracePtr trace = std::move(g.mTrace);
     string errorMsg;
     if (!mGroupSerializer->DoSerialize(std::move(g), serializedData, errorMsg)) {
         LOG_WARNING(mContext->GetLogger(),
@@ -1031,16 +1048,17 @@ bool FlusherSLS::SerializeAndPush(PipelineEventGroup&& group) {
     }
     // must create a tmp, because eoo checkpoint is moved in second param
     auto fbKey = g.mExactlyOnceCheckpoint->fbKey;
-    return PushToQueue(fbKey,
-                       make_unique<SLSSenderQueueItem>(std::move(compressedData),
-                                                       serializedData.size(),
-                                                       this,
-                                                       fbKey,
-                                                       mLogstore,
-                                                       RawDataType::EVENT_GROUP,
-                                                       g.mExactlyOnceCheckpoint->data.hash_key(),
-                                                       std::move(g.mExactlyOnceCheckpoint),
-                                                       false));
+    auto item = make_unique<SLSSenderQueueItem>(std::move(compressedData),
+                                                serializedData.size(),
+                                                this,
+                                                fbKey,
+                                                mLogstore,
+                                                RawDataType::EVENT_GROUP,
+                                                g.mExactlyOnceCheckpoint->data.hash_key(),
+                                                std::move(g.mExactlyOnceCheckpoint),
+                                                false);
+    item->mTrace = std::move(trace);
+    return PushToQueue(fbKey, std::move(item));
 }
 
 bool FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
@@ -1051,6 +1069,7 @@ bool FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
     string shardHashKey, serializedData, compressedData;
     size_t packageSize = 0;
     bool enablePackageList = groupList.size() > 1;
+    EventGroupTracePtr packageTrace;
 
     bool allSucceeded = true;
     for (auto& group : groupList) {
@@ -1058,6 +1077,7 @@ bool FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
             shardHashKey = GetShardHashKey(group);
         }
         AddPackId(group);
+        EventGroupTracePtr trace = std::move(group.mTrace);
         string errorMsg;
         if (!mGroupSerializer->DoSerialize(std::move(group), serializedData, errorMsg)) {
             LOG_WARNING(mContext->GetLogger(),
@@ -1096,41 +1116,44 @@ bool FlusherSLS::SerializeAndPush(BatchedEventsList&& groupList) {
         if (enablePackageList) {
             packageSize += serializedData.size();
             compressedLogGroups.emplace_back(std::move(compressedData), serializedData.size());
+            if (!packageTrace) {
+                packageTrace = std::move(trace);
+            }
         } else {
             if (group.mExactlyOnceCheckpoint) {
                 // must create a tmp, because eoo checkpoint is moved in second param
                 auto fbKey = group.mExactlyOnceCheckpoint->fbKey;
-                allSucceeded
-                    = PushToQueue(fbKey,
-                                  make_unique<SLSSenderQueueItem>(std::move(compressedData),
-                                                                  serializedData.size(),
-                                                                  this,
-                                                                  fbKey,
-                                                                  mLogstore,
-                                                                  RawDataType::EVENT_GROUP,
-                                                                  group.mExactlyOnceCheckpoint->data.hash_key(),
-                                                                  std::move(group.mExactlyOnceCheckpoint),
-                                                                  false))
-                    && allSucceeded;
+                auto item = make_unique<SLSSenderQueueItem>(std::move(compressedData),
+                                                            serializedData.size(),
+                                                            this,
+                                                            fbKey,
+                                                            mLogstore,
+                                                            RawDataType::EVENT_GROUP,
+                                                            group.mExactlyOnceCheckpoint->data.hash_key(),
+                                                            std::move(group.mExactlyOnceCheckpoint),
+                                                            false);
+                item->mTrace = std::move(trace);
+                allSucceeded = PushToQueue(fbKey, std::move(item)) && allSucceeded;
             } else {
-                allSucceeded = Flusher::PushToQueue(make_unique<SLSSenderQueueItem>(std::move(compressedData),
-                                                                                    serializedData.size(),
-                                                                                    this,
-                                                                                    mQueueKey,
-                                                                                    mLogstore,
-                                                                                    RawDataType::EVENT_GROUP,
-                                                                                    shardHashKey))
-                    && allSucceeded;
+                auto item = make_unique<SLSSenderQueueItem>(std::move(compressedData),
+                                                            serializedData.size(),
+                                                            this,
+                                                            mQueueKey,
+                                                            mLogstore,
+                                                            RawDataType::EVENT_GROUP,
+                                                            shardHashKey);
+                item->mTrace = std::move(trace);
+                allSucceeded = Flusher::PushToQueue(std::move(item)) && allSucceeded;
             }
         }
     }
     if (enablePackageList) {
         string errorMsg;
         mGroupListSerializer->DoSerialize(std::move(compressedLogGroups), serializedData, errorMsg);
-        allSucceeded
-            = Flusher::PushToQueue(make_unique<SLSSenderQueueItem>(
-                  std::move(serializedData), packageSize, this, mQueueKey, mLogstore, RawDataType::EVENT_GROUP_LIST))
-            && allSucceeded;
+        auto item = make_unique<SLSSenderQueueItem>(
+            std::move(serializedData), packageSize, this, mQueueKey, mLogstore, RawDataType::EVENT_GROUP_LIST);
+        item->mTrace = std::move(packageTrace);
+        allSucceeded = Flusher::PushToQueue(std::move(item)) && allSucceeded;
     }
     return allSucceeded;
 }
@@ -22,8 +22,7 @@
 #include "models/PipelineEventPtr.h"
 #include "models/RawEvent.h"
 #include "monitor/metric_models/MetricTypes.h"
-#include "protobuf/models/ProtocolConversion.h"
-#include "protobuf/models/pipeline_event_group.pb.h"
+#include "protobuf/models/PipelineEventGroupDecoder.h"
 
 using namespace std;
 
@@ -88,13 +87,16 @@ void ProcessorParseFromPBNative::Process(std::vector<PipelineEventGroup>& eventG
             const auto& sourceEvent = e.Cast<RawEvent>();
 
             std::string errMsg;
-            models::PipelineEventGroup pbGroup;
             auto eventGroup = PipelineEventGroup(std::make_shared<SourceBuffer>());
+            // events decoded point into the raw event content, so the source buffers holding it must be retained
+            eventGroup.AddSourceBuffer(rawEventGroup.GetSourceBuffer());
+            for (const auto& buffer : rawEventGroup.GetExtraSourceBuffers()) {
+                eventGroup.AddSourceBuffer(buffer);
+            }
 
             // parse event group from raw event
             const auto& content = sourceEvent.GetContent();
-            if (!pbGroup.ParseFromArray(content.data(), content.size())
-                || !TransferPBToPipelineEventGroup(pbGroup, eventGroup, errMsg)) {
+            if (!DecodePBToPipelineEventGroup(content, eventGroup, errMsg)) {
                 LOG_WARNING(sLogger,
                             ("error transfer PB to PipelineEventGroup", errMsg)("content size", content.size()));
                 ADD_COUNTER(mOutFailedEventGroupsTotal, 1);
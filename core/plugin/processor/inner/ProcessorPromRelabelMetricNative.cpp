@@ -18,7 +18,10 @@
 #include <cstddef>
 #include <json/json.h>
 
+#include <algorithm>
+#include <functional>
 #include <numeric>
+#include <string_view>
 
 #include "common/Flags.h"
 #include "common/StringTools.h"
@@ -31,6 +34,9 @@
 
 using namespace std;
 
+DEFINE_FLAG_INT32(prom_relabel_cache_max_size,
+                  "max relabel results cached by each metric relabel processor, 0 to disable the cache",
+                  100000);
 DECLARE_FLAG_STRING(_pod_name_);
 
 namespace logtail {
@@ -45,6 +51,10 @@ bool ProcessorPromRelabelMetricNative::Init(const Json::Value& config) {
         return false;
     }
 
+    if (!mScrapeConfigPtr->mMetricRelabelConfigs.Empty() && INT32_FLAG(prom_relabel_cache_max_size) > 0) {
+        mRelabelResultCache = std::make_unique<RelabelResultCache>(INT32_FLAG(prom_relabel_cache_max_size));
+    }
+
     mLoongCollectorScraper = STRING_FLAG(_pod_name_);
 
     return true;
@@ -113,8 +123,7 @@ bool ProcessorPromRelabelMetricNative::ProcessEvent(PipelineEventPtr& e, const G
         appendLabels(k, v, mScrapeConfigPtr->mHonorLabels);
     }
 
-    if (!mScrapeConfigPtr->mMetricRelabelConfigs.Empty()
-        && !mScrapeConfigPtr->mMetricRelabelConfigs.Process(sourceEvent)) {
+    if (!mScrapeConfigPtr->mMetricRelabelConfigs.Empty() && !RelabelMetric(sourceEvent)) {
         return false;
     }
 
@@ -142,6 +151,92 @@ bool ProcessorPromRelabelMetricNative::ProcessEvent(PipelineEventPtr& e, const G
     return true;
 }
 
+bool ProcessorPromRelabelMetricNative::RelabelMetric(MetricEvent& e) {
+    if (!mRelabelResultCache) {
+        return mScrapeConfigPtr->mMetricRelabelConfigs.Process(e);
+    }
+
+    auto& inner = e.mTags.mInner;
+    auto hash = GetSeriesHash(e);
+    auto cached = mRelabelResultCache->Find(hash);
+    if (cached && IsSameSource(*cached, e)) {
+        if (!cached->mKeep) {
+            return false;
+        }
+        std::vector<std::pair<StringView, StringView>> labels;
+        labels.reserve(cached->mLabels.size());
+        for (const auto& label : cached->mLabels) {
+            if (label.mInputIndex >= 0 && static_cast<size_t>(label.mInputIndex) < inner.size()) {
+                labels.emplace_back(inner[label.mInputIndex]);
+            } else {
+                auto k = e.GetSourceBuffer()->CopyString(label.mKey);
+                auto v = e.GetSourceBuffer()->CopyString(label.mValue);
+                labels.emplace_back(StringView(k.data, k.size), StringView(v.data, v.size));
+            }
+        }
+        // allocated size is recalculated after relabeling
+        inner.swap(labels);
+        return true;
+    }
+
+    auto input = inner;
+    auto result = std::make_shared<RelabelResult>();
+    result->mSourceName = e.GetName().to_string();
+    result->mSourceLabels.reserve(input.size());
+    for (const auto& [k, v] : input) {
+        result->mSourceLabels.emplace_back(k.to_string(), v.to_string());
+    }
+    bool keep = mScrapeConfigPtr->mMetricRelabelConfigs.Process(e);
+    result->mKeep = keep;
+    if (keep) {
+        result->mLabels.reserve(inner.size());
+        for (size_t i = 0; i < inner.size(); ++i) {
+            // removed after relabeling, so there is no need to copy them on cache hit
+            if (inner[i].first.starts_with("__") || inner[i].second.empty()) {
+                continue;
+            }
+            auto& label = result->mLabels.emplace_back();
+            auto it = std::find(input.begin(), input.end(), inner[i]);
+            if (it != input.end()) {
+                label.mInputIndex = static_cast<int32_t>(it - input.begin());
+            } else {
+                label.mKey = inner[i].first.to_string();
+                label.mValue = inner[i].second.to_string();
+            }
+        }
+    }
+    mRelabelResultCache->Insert(hash, std::move(result));
+    return keep;
+}
+
+uint64_t ProcessorPromRelabelMetricNative::GetSeriesHash(const MetricEvent& e) {
+    // labels are in the same order for the same series, so there is no need to sort them
+    uint64_t hash = prometheus::OFFSET64;
+    auto mix = [&hash](StringView s) {
+        hash ^= std::hash<std::string_view>{}(std::string_view(s.data(), s.size()));
+        hash *= prometheus::PRIME64;
+    };
+    mix(e.GetName());
+    for (const auto& [k, v] : e.mTags.mInner) {
+        mix(k);
+        mix(v);
+    }
+    return hash;
+}
+
+bool ProcessorPromRelabelMetricNative::IsSameSource(const RelabelResult& result, const MetricEvent& e) {
+    const auto& inner = e.mTags.mInner;
+    if (result.mSourceLabels.size() != inner.size() || e.GetName() != result.mSourceName) {
+        return false;
+    }
+    for (size_t i = 0; i < inner.size(); ++i) {
+        if (inner[i].first != result.mSourceLabels[i].first || inner[i].second != result.mSourceLabels[i].second) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void ProcessorPromRelabelMetricNative::UpdateAutoMetrics(const PipelineEventGroup& eGroup,
                                                          prom::AutoMetric& autoMetric) const {
     if (eGroup.HasMetadata(EventGroupMetaKey::PROMETHEUS_SCRAPE_DURATION)) {
@@ -21,6 +21,7 @@
 #include "collection_pipeline/plugin/interface/Processor.h"
 #include "models/PipelineEventGroup.h"
 #include "models/PipelineEventPtr.h"
+#include "prometheus/labels/Relabel.h"
 #include "prometheus/schedulers/ScrapeConfig.h"
 
 namespace logtail {
@@ -51,6 +52,9 @@ protected:
 
 private:
     bool ProcessEvent(PipelineEventPtr& e, const GroupTags& targetTags);
+    bool RelabelMetric(MetricEvent& e);
+    static uint64_t GetSeriesHash(const MetricEvent& e);
+    static bool IsSameSource(const RelabelResult& result, const MetricEvent& e);
 
     void AddAutoMetrics(PipelineEventGroup& eGroup, const prom::AutoMetric& autoMetric) const;
     void UpdateAutoMetrics(const PipelineEventGroup& eGroup, prom::AutoMetric& autoMetric) const;
@@ -62,6 +66,8 @@ private:
                    const GroupTags& targetTags) const;
 
     std::unique_ptr<ScrapeConfig> mScrapeConfigPtr;
+    // null if metric relabel configs are empty or the cache is disabled
+    std::unique_ptr<RelabelResultCache> mRelabelResultCache;
     std::string mLoongCollectorScraper;
 
 #ifdef APSARA_UNIT_TEST_MAIN
@@ -32,6 +32,7 @@
 #include "monitor/metric_constants/MetricConstants.h"
 #include "prometheus/Constants.h"
 #include "prometheus/Utils.h"
+#include "prometheus/component/ScrapeQueue.h"
 
 using namespace std;
 
@@ -45,7 +46,7 @@ PrometheusInputRunner::PrometheusInputRunner()
     : mServiceHost(STRING_FLAG(operator_service)),
       mServicePort(INT32_FLAG(operator_service_port)),
       mPodName(STRING_FLAG(_pod_name_)),
-      mEventPool(true),
+      mEventPool(true, EventPool::kDefaultMagazineSize),
       mUnRegisterMs(0) {
     // self monitor
     MetricLabels labels;
@@ -64,6 +65,7 @@ PrometheusInputRunner::PrometheusInputRunner()
     mPromRegisterState = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_CLIENT_REGISTER_STATE);
     mPromJobNum = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_JOBS_TOTAL);
     mPromRegisterRetryTotal = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_CLIENT_REGISTER_RETRY_TOTAL);
+    ScrapeQueue::GetInstance()->InitMetrics(mMetricsRecordRef);
     WriteMetrics::GetInstance()->CommitMetricsRecordRef(mMetricsRecordRef);
 }
 
@@ -210,6 +212,7 @@ void PrometheusInputRunner::Stop() {
         WriteLock lock(mSubscriberMapRWLock);
         mTargetSubscriberSchedulerMap.clear();
     }
+    ScrapeQueue::GetInstance()->Clear();
 
     // only unregister when operator exist
     if (!mServiceHost.empty()) {
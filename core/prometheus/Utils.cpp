@@ -157,6 +157,7 @@ std::string NetworkCodeToState(NetworkCode code) {
                                                     {NetworkCode::ConnectionFailed, "ERR_CONN_FAILED"},
                                                     {NetworkCode::RemoteAccessDenied, "ERR_ACCESS_DENIED"},
                                                     {NetworkCode::Timeout, "ERR_TIMEOUT"},
+                                                    {NetworkCode::LowSpeed, "ERR_LOW_SPEED"},
                                                     {NetworkCode::SSLConnectError, "ERR_SSL_CONN_ERR"},
                                                     {NetworkCode::SSLCertError, "ERR_SSL_CERT_ERR"},
                                                     {NetworkCode::SSLOtherProblem, "ERR_SSL_OTHER_PROBLEM"},
@@ -7,6 +7,7 @@
 #include <utility>
 
 #include "common/http/HttpRequest.h"
+#include "prometheus/component/ScrapeQueue.h"
 
 namespace logtail {
 
@@ -47,6 +48,9 @@ void PromHttpRequest::OnSendDone(HttpResponse& response) {
         mFuture->Process(
             response, std::chrono::duration_cast<std::chrono::milliseconds>(mLastSendTime.time_since_epoch()).count());
     }
+    if (mFromScrapeQueue) {
+        ScrapeQueue::GetInstance()->OnScrapeDone();
+    }
 }
 
 [[nodiscard]] bool PromHttpRequest::IsContextValid() const {
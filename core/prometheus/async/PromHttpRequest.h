@@ -32,6 +32,9 @@ public:
     void OnSendDone(HttpResponse& response) override;
     [[nodiscard]] bool IsContextValid() const override;
 
+    // set when sent by ScrapeQueue, which is then notified when the request is done
+    bool mFromScrapeQueue = false;
+
 private:
     void SetNextExecTime(std::chrono::steady_clock::time_point execTime);
 
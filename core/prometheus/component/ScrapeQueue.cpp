@@ -0,0 +1,103 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "prometheus/component/ScrapeQueue.h"
+
+#include <limits>
+
+#include "common/Flags.h"
+#include "common/http/AsynCurlRunner.h"
+#include "monitor/metric_constants/MetricConstants.h"
+
+DEFINE_FLAG_INT32(prom_max_inflight_scrapes, "max number of in-flight scrapes of all targets, 0 means unlimited", 0);
+
+using namespace std;
+
+namespace logtail {
+
+ScrapeQueue::ScrapeQueue()
+    : mMaxInFlightCnt(INT32_FLAG(prom_max_inflight_scrapes) > 0 ? INT32_FLAG(prom_max_inflight_scrapes)
+                                                                 : numeric_limits<size_t>::max()) {
+}
+
+void ScrapeQueue::InitMetrics(MetricsRecordRef& metricsRecordRef) {
+    mInFlightScrapes = metricsRecordRef.CreateIntGauge(METRIC_RUNNER_INFLIGHT_SCRAPES);
+    mPendingScrapes = metricsRecordRef.CreateIntGauge(METRIC_RUNNER_PENDING_SCRAPES);
+    mScrapeQueueingDelayMs = metricsRecordRef.CreateCounter(METRIC_RUNNER_SCRAPE_QUEUEING_DELAY_MS);
+}
+
+void ScrapeQueue::PushRequest(unique_ptr<PromHttpRequest>&& request, chrono::steady_clock::time_point execTime) {
+    {
+        lock_guard<mutex> lock(mMux);
+        if (!mPending.empty() || mInFlightCnt >= mMaxInFlightCnt) {
+            mPending.emplace_back(std::move(request), execTime);
+            SET_GAUGE(mPendingScrapes, mPending.size());
+            return;
+        }
+        ++mInFlightCnt;
+        SET_GAUGE(mInFlightScrapes, mInFlightCnt);
+    }
+    Send(std::move(request), execTime);
+}
+
+void ScrapeQueue::OnScrapeDone() {
+    unique_ptr<PromHttpRequest> request;
+    chrono::steady_clock::time_point execTime;
+    {
+        lock_guard<mutex> lock(mMux);
+        if (mInFlightCnt > 0) {
+            --mInFlightCnt;
+        }
+        if (mPending.empty() || mInFlightCnt >= mMaxInFlightCnt) {
+            SET_GAUGE(mInFlightScrapes, mInFlightCnt);
+            return;
+        }
+        request = std::move(mPending.front().first);
+        execTime = mPending.front().second;
+        mPending.pop_front();
+        ++mInFlightCnt;
+        SET_GAUGE(mPendingScrapes, mPending.size());
+        SET_GAUGE(mInFlightScrapes, mInFlightCnt);
+    }
+    Send(std::move(request), execTime);
+}
+
+void ScrapeQueue::Clear() {
+    lock_guard<mutex> lock(mMux);
+    mPending.clear();
+    SET_GAUGE(mPendingScrapes, 0);
+}
+
+size_t ScrapeQueue::InFlightCount() const {
+    lock_guard<mutex> lock(mMux);
+    return mInFlightCnt;
+}
+
+size_t ScrapeQueue::PendingCount() const {
+    lock_guard<mutex> lock(mMux);
+    return mPending.size();
+}
+
+void ScrapeQueue::Send(unique_ptr<PromHttpRequest>&& request, chrono::steady_clock::time_point execTime) {
+    auto now = chrono::steady_clock::now();
+    if (now > execTime) {
+        ADD_COUNTER(mScrapeQueueingDelayMs, chrono::duration_cast<chrono::milliseconds>(now - execTime).count());
+    }
+    request->mFromScrapeQueue = true;
+    AsynCurlRunner::GetInstance()->AddRequest(std::move(request));
+}
+
+} // namespace logtail
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "monitor/metric_models/MetricRecord.h"
+#include "monitor/metric_models/MetricTypes.h"
+#include "prometheus/async/PromHttpRequest.h"
+
+namespace logtail {
+
+// Sends scrape requests of all targets to AsynCurlRunner within a global budget of in-flight scrapes, i.e.,
+// prom_max_inflight_scrapes, and keeps the others in FIFO order until a scrape is done, so that a burst of targets due
+// at the same time is smoothed instead of hitting the curl runner and process queues at once.
+class ScrapeQueue {
+public:
+    ScrapeQueue(const ScrapeQueue&) = delete;
+    ScrapeQueue& operator=(const ScrapeQueue&) = delete;
+
+    static ScrapeQueue* GetInstance() {
+        static ScrapeQueue sInstance;
+        return &sInstance;
+    }
+
+    void InitMetrics(MetricsRecordRef& metricsRecordRef);
+
+    void PushRequest(std::unique_ptr<PromHttpRequest>&& request, std::chrono::steady_clock::time_point execTime);
+    // called once for each request sent by the queue when it is done
+    void OnScrapeDone();
+    void Clear();
+
+    size_t InFlightCount() const;
+    size_t PendingCount() const;
+
+private:
+    ScrapeQueue();
+    ~ScrapeQueue() = default;
+
+    void Send(std::unique_ptr<PromHttpRequest>&& request, std::chrono::steady_clock::time_point execTime);
+
+    size_t mMaxInFlightCnt = 0;
+
+    mutable std::mutex mMux;
+    size_t mInFlightCnt = 0;
+    std::deque<std::pair<std::unique_ptr<PromHttpRequest>, std::chrono::steady_clock::time_point>> mPending;
+
+    IntGaugePtr mInFlightScrapes;
+    IntGaugePtr mPendingScrapes;
+    CounterPtr mScrapeQueueingDelayMs;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ScrapeQueueUnittest;
+    friend class ScrapeQueueBenchmark;
+#endif
+};
+
+} // namespace logtail
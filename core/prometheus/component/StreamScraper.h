@@ -6,7 +6,10 @@
 
 #include "Labels.h"
 #include "collection_pipeline/queue/QueueKey.h"
+#include "common/http/HttpResponse.h"
 #include "models/PipelineEventGroup.h"
+#include "prometheus/labels/ProtobufParser.h"
+#include "prometheus/labels/TextParser.h"
 
 #ifdef APSARA_UNIT_TEST_MAIN
 #include <vector>
@@ -28,13 +31,24 @@ public:
     void SendMetrics();
     void Reset();
     void SetAutoMetricMeta(double scrapeDurationSeconds, bool upState, const std::string& scrapeState);
+    // parses samples into MetricEvents in the write callback, instead of sending lines as RawEvents to be parsed by
+    // ProcessorPromParseMetricNative, with metric names and label keys interned by @interner across scrapes
+    void EnableParse(bool honorTimestamps, std::shared_ptr<LabelInterner> interner);
+    // parses the body as the protobuf exposition format if the Content-Type of @response says so, which is checked
+    // when the body starts since all headers are received by then
+    void EnableProtobuf(const HttpResponse* response, bool honorTimestamps);
 
     size_t mRawSize = 0;
     static size_t mMaxSampleLength;
     uint64_t mStreamIndex = 0;
 
 private:
+    void AddTextData(const char* data, size_t len);
+    void AddProtobufData(const char* data, size_t len);
+    void DetectFormat();
     void AddEvent(const char* line, size_t len);
+    void AddMetricEvent(StringView line);
+    void HoldInternerBuffer();
     void PushEventGroup(PipelineEventGroup&&) const;
     void SetTargetLabels(PipelineEventGroup& eGroup) const;
     std::string GetId();
@@ -53,6 +67,19 @@ private:
 
     Labels mTargetLabels;
 
+    // null if samples are not parsed in the scraper
+    std::unique_ptr<TextParser> mParser;
+    std::shared_ptr<LabelInterner> mInterner;
+    // the interner source buffer last added to mEventGroup
+    const SourceBuffer* mInternerBufferInGroup = nullptr;
+
+    // null if the protobuf exposition format is not accepted
+    const HttpResponse* mResponse = nullptr;
+    bool mHonorTimestamps = true;
+    // non-null if the body is in the protobuf exposition format, where mCache holds the incomplete message
+    std::unique_ptr<ProtobufParser> mProtobufParser;
+    bool mProtobufError = false;
+
     // auto metrics
     uint64_t mScrapeTimestampMilliSec = 0;
 #ifdef APSARA_UNIT_TEST_MAIN
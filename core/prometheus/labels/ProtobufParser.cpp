@@ -0,0 +1,630 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "prometheus/labels/ProtobufParser.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+
+#include "common/ProtobufWireReader.h"
+#include "logger/Logger.h"
+#include "models/MetricEvent.h"
+#include "prometheus/Constants.h"
+
+using namespace std;
+
+namespace logtail {
+
+namespace {
+
+constexpr uint32_t kVarint = ProtobufWireReader::kVarint;
+constexpr uint32_t kFixed64 = ProtobufWireReader::kFixed64;
+constexpr uint32_t kLengthDelimited = ProtobufWireReader::kLengthDelimited;
+
+// a varint takes at most 10 bytes
+constexpr size_t kMaxVarintSize = 10;
+
+enum MetricType : uint64_t {
+    kCounter = 0,
+    kGauge = 1,
+    kSummary = 2,
+    kUntyped = 3,
+    kHistogram = 4,
+    kGaugeHistogram = 5,
+};
+
+const char* const kLabelLe = "le";
+const char* const kLabelQuantile = "quantile";
+const char* const kPositiveInf = "+Inf";
+
+// reads the field if it is of the expected wire type, otherwise skips it as an unknown field, the same as protobuf
+bool ReadDouble(ProtobufWireReader& reader, uint32_t wireType, double& value) {
+    return wireType == kFixed64 ? reader.ReadDouble(value) : reader.Skip(wireType);
+}
+
+bool ReadVarint(ProtobufWireReader& reader, uint32_t wireType, uint64_t& value) {
+    return wireType == kVarint ? reader.ReadVarint(value) : reader.Skip(wireType);
+}
+
+bool ReadView(ProtobufWireReader& reader, uint32_t wireType, StringView& value) {
+    return wireType == kLengthDelimited ? reader.ReadLengthDelimited(value) : reader.Skip(wireType);
+}
+
+// calls @handler with each field of the message in @data, which must read or skip the field
+template <typename Handler>
+bool ForEachField(StringView data, const Handler& handler) {
+    ProtobufWireReader reader(data);
+    while (!reader.Done()) {
+        uint32_t field = 0;
+        uint32_t wireType = 0;
+        if (!reader.ReadTag(field, wireType) || !handler(reader, field, wireType)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Gauge, Counter and Untyped, where value = 1
+bool ParseSingleValue(StringView data, double& value) {
+    value = 0;
+    return ForEachField(data, [&value](ProtobufWireReader& reader, uint32_t field, uint32_t wireType) {
+        return field == 1 ? ReadDouble(reader, wireType, value) : reader.Skip(wireType);
+    });
+}
+
+// repeated sint64, which is packed by default but may also be sent unpacked
+bool ReadSint64s(ProtobufWireReader& reader, uint32_t wireType, vector<int64_t>& values) {
+    uint64_t value = 0;
+    if (wireType == kVarint) {
+        if (!reader.ReadVarint(value)) {
+            return false;
+        }
+        values.push_back(ProtobufWireReader::DecodeZigZag(value));
+        return true;
+    }
+    StringView packed;
+    if (!ReadView(reader, wireType, packed)) {
+        return false;
+    }
+    ProtobufWireReader packedReader(packed);
+    while (!packedReader.Done()) {
+        if (!packedReader.ReadVarint(value)) {
+            return false;
+        }
+        values.push_back(ProtobufWireReader::DecodeZigZag(value));
+    }
+    return true;
+}
+
+// repeated double, which is packed by default but may also be sent unpacked
+bool ReadDoubles(ProtobufWireReader& reader, uint32_t wireType, vector<double>& values) {
+    double value = 0;
+    if (wireType == kFixed64) {
+        if (!reader.ReadDouble(value)) {
+            return false;
+        }
+        values.push_back(value);
+        return true;
+    }
+    StringView packed;
+    if (!ReadView(reader, wireType, packed)) {
+        return false;
+    }
+    ProtobufWireReader packedReader(packed);
+    while (!packedReader.Done()) {
+        if (!packedReader.ReadDouble(value)) {
+            return false;
+        }
+        values.push_back(value);
+    }
+    return true;
+}
+
+// BucketSpan, where offset = 1 is sint32 and length = 2
+bool ReadSpan(ProtobufWireReader& reader, uint32_t wireType, vector<pair<int32_t, uint32_t>>& spans) {
+    StringView data;
+    if (wireType != kLengthDelimited) {
+        return reader.Skip(wireType);
+    }
+    if (!reader.ReadLengthDelimited(data)) {
+        return false;
+    }
+    uint64_t offset = 0;
+    uint64_t length = 0;
+    if (!ForEachField(data, [&](ProtobufWireReader& spanReader, uint32_t field, uint32_t type) {
+            switch (field) {
+                case 1:
+                    return ReadVarint(spanReader, type, offset);
+                case 2:
+                    return ReadVarint(spanReader, type, length);
+                default:
+                    return spanReader.Skip(type);
+            }
+        })) {
+        return false;
+    }
+    spans.emplace_back(static_cast<int32_t>(ProtobufWireReader::DecodeZigZag(offset)), static_cast<uint32_t>(length));
+    return true;
+}
+
+// the shortest representation which reads back the same, as strconv.FormatFloat(value, 'g', -1, 64) used by client
+// libraries to format le and quantile
+string FormatFloat(double value) {
+    if (std::isnan(value)) {
+        return "NaN";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? kPositiveInf : "-Inf";
+    }
+    char buf[32];
+    int digits = 1;
+    for (; digits < 17; ++digits) {
+        snprintf(buf, sizeof(buf), "%.*e", digits - 1, value);
+        if (strtod(buf, nullptr) == value) {
+            break;
+        }
+    }
+    snprintf(buf, sizeof(buf), "%.*e", digits - 1, value);
+    int exp = atoi(strchr(buf, 'e') + 1);
+    if (exp < -4 || exp >= 6) {
+        return buf;
+    }
+    snprintf(buf, sizeof(buf), "%.*f", max(digits - 1 - exp, 0), value);
+    return buf;
+}
+
+} // namespace
+
+void ProtobufParser::Histogram::Clear() {
+    mCount = 0;
+    mSum = 0;
+    mBuckets.clear();
+    mSchema = 0;
+    mZeroThreshold = 0;
+    mZeroCount = 0;
+    mNegativeSpans.clear();
+    mNegativeDeltas.clear();
+    mNegativeCounts.clear();
+    mPositiveSpans.clear();
+    mPositiveDeltas.clear();
+    mPositiveCounts.clear();
+}
+
+ProtobufParser::ProtobufParser(bool honorTimestamps) : mHonorTimestamps(honorTimestamps) {
+}
+
+void ProtobufParser::SetDefaultTimestamp(uint64_t defaultTimestamp, uint32_t defaultNanoSec) {
+    mDefaultTimestamp = defaultTimestamp;
+    mDefaultNanoTimestamp = defaultNanoSec;
+}
+
+bool ProtobufParser::IsProtobufContentType(const string& contentType) {
+    static const string sMediaType = "application/vnd.google.protobuf";
+    return contentType.compare(0, sMediaType.size(), sMediaType) == 0
+        && contentType.find("io.prometheus.client.MetricFamily") != string::npos;
+}
+
+bool ProtobufParser::Parse(StringView data, PipelineEventGroup& eGroup, size_t& consumed, EventPool* pool) {
+    consumed = 0;
+    while (consumed < data.size()) {
+        ProtobufWireReader reader(data.substr(consumed));
+        uint64_t len = 0;
+        if (!reader.ReadVarint(len)) {
+            // the length itself may be incomplete
+            return data.size() - consumed < kMaxVarintSize;
+        }
+        if (len > reader.Remaining()) {
+            return true;
+        }
+        size_t lenSize = data.size() - consumed - reader.Remaining();
+        if (!ParseMetricFamily(data.substr(consumed + lenSize, len), eGroup, pool)) {
+            LOG_WARNING(sLogger, ("protobuf parser error parsing metric family", mName.to_string()));
+            return false;
+        }
+        consumed += lenSize + len;
+    }
+    return true;
+}
+
+// MetricFamily: name = 1, help = 2, type = 3, metric = 4, unit = 5
+bool ProtobufParser::ParseMetricFamily(StringView data, PipelineEventGroup& eGroup, EventPool* pool) {
+    StringView name;
+    mType = kUntyped;
+    mMetrics.clear();
+    mSuffixedNames.clear();
+    mBounds.clear();
+    // metrics are parsed after all fields are read, since the type may come after them
+    if (!ForEachField(data, [&](ProtobufWireReader& reader, uint32_t field, uint32_t wireType) {
+            StringView view;
+            switch (field) {
+                case 1:
+                    return ReadView(reader, wireType, name);
+                case 3:
+                    return ReadVarint(reader, wireType, mType);
+                case 4:
+                    if (wireType != kLengthDelimited) {
+                        return reader.Skip(wireType);
+                    }
+                    if (!reader.ReadLengthDelimited(view)) {
+                        return false;
+                    }
+                    mMetrics.push_back(view);
+                    return true;
+                default:
+                    return reader.Skip(wireType);
+            }
+        })) {
+        return false;
+    }
+    if (name.empty()) {
+        return false;
+    }
+    auto sb = eGroup.GetSourceBuffer()->CopyString(name);
+    mName = StringView(sb.data, sb.size);
+    for (const auto& metric : mMetrics) {
+        if (!ParseMetric(metric, eGroup, pool)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Metric: label = 1, gauge = 2, counter = 3, summary = 4, untyped = 5, timestamp_ms = 6, histogram = 7
+bool ProtobufParser::ParseMetric(StringView data, PipelineEventGroup& eGroup, EventPool* pool) {
+    mLabels.clear();
+    uint64_t timestampMs = 0;
+    StringView gauge, counter, summary, untyped, histogram;
+    if (!ForEachField(data, [&](ProtobufWireReader& reader, uint32_t field, uint32_t wireType) {
+            StringView label;
+            switch (field) {
+                case 1:
+                    if (wireType != kLengthDelimited) {
+                        return reader.Skip(wireType);
+                    }
+                    if (!reader.ReadLengthDelimited(label)) {
+                        return false;
+                    }
+                    break;
+                case 2:
+                    return ReadView(reader, wireType, gauge);
+                case 3:
+                    return ReadView(reader, wireType, counter);
+                case 4:
+                    return ReadView(reader, wireType, summary);
+                case 5:
+                    return ReadView(reader, wireType, untyped);
+                case 6:
+                    return ReadVarint(reader, wireType, timestampMs);
+                case 7:
+                    return ReadView(reader, wireType, histogram);
+                default:
+                    return reader.Skip(wireType);
+            }
+            // LabelPair: name = 1, value = 2
+            StringView key, value;
+            if (!ForEachField(label, [&](ProtobufWireReader& labelReader, uint32_t labelField, uint32_t type) {
+                    switch (labelField) {
+                        case 1:
+                            return ReadView(labelReader, type, key);
+                        case 2:
+                            return ReadView(labelReader, type, value);
+                        default:
+                            return labelReader.Skip(type);
+                    }
+                })) {
+                return false;
+            }
+            auto keySb = eGroup.GetSourceBuffer()->CopyString(key);
+            auto valueSb = eGroup.GetSourceBuffer()->CopyString(value);
+            mLabels.emplace_back(StringView(keySb.data, keySb.size), StringView(valueSb.data, valueSb.size));
+            return true;
+        })) {
+        return false;
+    }
+
+    auto signedTimestampMs = static_cast<int64_t>(timestampMs);
+    if (mHonorTimestamps && signedTimestampMs > 0) {
+        mTimestamp = signedTimestampMs / 1000;
+        mNanoTimestamp = signedTimestampMs % 1000 * 1000000;
+    } else {
+        mTimestamp = mDefaultTimestamp;
+        mNanoTimestamp = mDefaultNanoTimestamp;
+    }
+
+    double value = 0;
+    switch (mType) {
+        case kCounter:
+            if (!ParseSingleValue(counter, value)) {
+                return false;
+            }
+            AddSample(mName, value, eGroup, pool);
+            return true;
+        case kGauge:
+            if (!ParseSingleValue(gauge, value)) {
+                return false;
+            }
+            AddSample(mName, value, eGroup, pool);
+            return true;
+        case kSummary:
+            return ParseSummary(summary, eGroup, pool);
+        case kHistogram:
+        case kGaugeHistogram:
+            if (!ParseHistogram(histogram)) {
+                return false;
+            }
+            AddHistogramSamples(eGroup, pool);
+            return true;
+        default:
+            if (!ParseSingleValue(untyped, value)) {
+                return false;
+            }
+            AddSample(mName, value, eGroup, pool);
+            return true;
+    }
+}
+
+// Summary: sample_count = 1, sample_sum = 2, quantile = 3
+bool ProtobufParser::ParseSummary(StringView data, PipelineEventGroup& eGroup, EventPool* pool) {
+    uint64_t count = 0;
+    double sum = 0;
+    size_t index = 0;
+    auto name = mName;
+    if (!ForEachField(data, [&](ProtobufWireReader& reader, uint32_t field, uint32_t wireType) {
+            StringView quantile;
+            switch (field) {
+                case 1:
+                    return ReadVarint(reader, wireType, count);
+                case 2:
+                    return ReadDouble(reader, wireType, sum);
+                case 3:
+                    if (wireType != kLengthDelimited) {
+                        return reader.Skip(wireType);
+                    }
+                    if (!reader.ReadLengthDelimited(quantile)) {
+                        return false;
+                    }
+                    break;
+                default:
+                    return reader.Skip(wireType);
+            }
+            // Quantile: quantile = 1, value = 2
+            double q = 0;
+            double value = 0;
+            if (!ForEachField(quantile, [&](ProtobufWireReader& quantileReader, uint32_t quantileField, uint32_t type) {
+                    switch (quantileField) {
+                        case 1:
+                            return ReadDouble(quantileReader, type, q);
+                        case 2:
+                            return ReadDouble(quantileReader, type, value);
+                        default:
+                            return quantileReader.Skip(type);
+                    }
+                })) {
+                return false;
+            }
+            AddSample(name, value, eGroup, pool, kLabelQuantile, FormatBound(q, index++, eGroup));
+            return true;
+        })) {
+        return false;
+    }
+    AddSample(GetSuffixedName("_sum", eGroup), sum, eGroup, pool);
+    AddSample(GetSuffixedName("_count", eGroup), static_cast<double>(count), eGroup, pool);
+    return true;
+}
+
+// Histogram: sample_count = 1, sample_sum = 2, bucket = 3, sample_count_float = 4, schema = 5, zero_threshold = 6,
+// zero_count = 7, zero_count_float = 8, negative_span = 9, negative_delta = 10, negative_count = 11,
+// positive_span = 12, positive_delta = 13, positive_count = 14
+bool ProtobufParser::ParseHistogram(StringView data) {
+    auto& h = mHistogram;
+    h.Clear();
+    uint64_t count = 0;
+    double countFloat = 0;
+    uint64_t schema = 0;
+    uint64_t zeroCount = 0;
+    double zeroCountFloat = 0;
+    if (!ForEachField(data, [&](ProtobufWireReader& reader, uint32_t field, uint32_t wireType) {
+            StringView bucket;
+            switch (field) {
+                case 1:
+                    return ReadVarint(reader, wireType, count);
+                case 2:
+                    return ReadDouble(reader, wireType, h.mSum);
+                case 3:
+                    if (wireType != kLengthDelimited) {
+                        return reader.Skip(wireType);
+                    }
+                    if (!reader.ReadLengthDelimited(bucket)) {
+                        return false;
+                    }
+                    break;
+                case 4:
+                    return ReadDouble(reader, wireType, countFloat);
+                case 5:
+                    return ReadVarint(reader, wireType, schema);
+                case 6:
+                    return ReadDouble(reader, wireType, h.mZeroThreshold);
+                case 7:
+                    return ReadVarint(reader, wireType, zeroCount);
+                case 8:
+                    return ReadDouble(reader, wireType, zeroCountFloat);
+                case 9:
+                    return ReadSpan(reader, wireType, h.mNegativeSpans);
+                case 10:
+                    return ReadSint64s(reader, wireType, h.mNegativeDeltas);
+                case 11:
+                    return ReadDoubles(reader, wireType, h.mNegativeCounts);
+                case 12:
+                    return ReadSpan(reader, wireType, h.mPositiveSpans);
+                case 13:
+                    return ReadSint64s(reader, wireType, h.mPositiveDeltas);
+                case 14:
+                    return ReadDoubles(reader, wireType, h.mPositiveCounts);
+                default:
+                    return reader.Skip(wireType);
+            }
+            // Bucket: cumulative_count = 1, upper_bound = 2, cumulative_count_float = 4
+            uint64_t cumulativeCount = 0;
+            double cumulativeCountFloat = 0;
+            double upperBound = 0;
+            if (!ForEachField(bucket, [&](ProtobufWireReader& bucketReader, uint32_t bucketField, uint32_t type) {
+                    switch (bucketField) {
+                        case 1:
+                            return ReadVarint(bucketReader, type, cumulativeCount);
+                        case 2:
+                            return ReadDouble(bucketReader, type, upperBound);
+                        case 4:
+                            return ReadDouble(bucketReader, type, cumulativeCountFloat);
+                        default:
+                            return bucketReader.Skip(type);
+                    }
+                })) {
+                return false;
+            }
+            h.mBuckets.emplace_back(upperBound,
+                                    cumulativeCountFloat > 0 ? cumulativeCountFloat
+                                                             : static_cast<double>(cumulativeCount));
+            return true;
+        })) {
+        return false;
+    }
+    // float histograms set the float fields instead
+    h.mCount = countFloat > 0 ? countFloat : static_cast<double>(count);
+    h.mZeroCount = zeroCountFloat > 0 ? zeroCountFloat : static_cast<double>(zeroCount);
+    h.mSchema = static_cast<int32_t>(ProtobufWireReader::DecodeZigZag(schema));
+    return true;
+}
+
+void ProtobufParser::AddHistogramSamples(PipelineEventGroup& eGroup, EventPool* pool) {
+    const auto& h = mHistogram;
+    auto bucketName = GetSuffixedName("_bucket", eGroup);
+    bool hasInf = false;
+    if (!h.mBuckets.empty()) {
+        for (size_t i = 0; i < h.mBuckets.size(); ++i) {
+            const auto& bucket = h.mBuckets[i];
+            AddSample(bucketName, bucket.second, eGroup, pool, kLabelLe, FormatBound(bucket.first, i, eGroup));
+            hasInf = std::isinf(bucket.first) && bucket.first > 0;
+        }
+    } else if (!h.mNegativeSpans.empty() || !h.mPositiveSpans.empty() || h.mZeroCount > 0) {
+        AddNativeBuckets(eGroup, pool);
+    }
+    // the +Inf bucket is implicit in protobuf
+    if (!hasInf) {
+        AddSample(bucketName, h.mCount, eGroup, pool, kLabelLe, kPositiveInf);
+    }
+    AddSample(GetSuffixedName("_sum", eGroup), h.mSum, eGroup, pool);
+    AddSample(GetSuffixedName("_count", eGroup), h.mCount, eGroup, pool);
+}
+
+// For schema s, the positive bucket of index i is (2^((i-1)*2^-s), 2^(i*2^-s)], and the negative bucket of index i
+// is its mirror, while the zero bucket is [-zero_threshold, zero_threshold].
+// see for detail: https://prometheus.io/docs/specs/native_histograms/
+void ProtobufParser::AddNativeBuckets(PipelineEventGroup& eGroup, EventPool* pool) {
+    const auto& h = mHistogram;
+    double base = std::ldexp(1.0, -h.mSchema);
+    mNativeBuckets.clear();
+    auto collect = [this, base](const vector<pair<int32_t, uint32_t>>& spans,
+                                const vector<int64_t>& deltas,
+                                const vector<double>& counts,
+                                bool negative) {
+        int64_t index = 0;
+        size_t pos = 0;
+        int64_t count = 0;
+        for (const auto& span : spans) {
+            index += span.first;
+            for (uint32_t i = 0; i < span.second; ++i, ++index, ++pos) {
+                double bucketCount = 0;
+                if (!counts.empty()) {
+                    if (pos >= counts.size()) {
+                        return;
+                    }
+                    bucketCount = counts[pos];
+                } else {
+                    if (pos >= deltas.size()) {
+                        return;
+                    }
+                    count += deltas[pos];
+                    bucketCount = static_cast<double>(count);
+                }
+                double bound = negative ? -std::exp2(static_cast<double>(index - 1) * base)
+                                        : std::exp2(static_cast<double>(index) * base);
+                mNativeBuckets.emplace_back(bound, bucketCount);
+            }
+        }
+    };
+    // in ascending order of upper bounds
+    collect(h.mNegativeSpans, h.mNegativeDeltas, h.mNegativeCounts, true);
+    std::reverse(mNativeBuckets.begin(), mNativeBuckets.end());
+    if (h.mZeroThreshold > 0 || h.mZeroCount > 0) {
+        mNativeBuckets.emplace_back(h.mZeroThreshold, h.mZeroCount);
+    }
+    collect(h.mPositiveSpans, h.mPositiveDeltas, h.mPositiveCounts, false);
+
+    auto bucketName = GetSuffixedName("_bucket", eGroup);
+    double cumulativeCount = 0;
+    for (size_t i = 0; i < mNativeBuckets.size(); ++i) {
+        cumulativeCount += mNativeBuckets[i].second;
+        AddSample(bucketName, cumulativeCount, eGroup, pool, kLabelLe, FormatBound(mNativeBuckets[i].first, i, eGroup));
+    }
+}
+
+void ProtobufParser::AddSample(StringView name,
+                               double value,
+                               PipelineEventGroup& eGroup,
+                               EventPool* pool,
+                               StringView extraKey,
+                               StringView extraValue) {
+    auto metricEvent = eGroup.CreateMetricEvent(true, pool);
+    metricEvent->SetNameNoCopy(name);
+    metricEvent->SetValue<UntypedSingleValue>(value);
+    metricEvent->SetTimestamp(mTimestamp, mNanoTimestamp);
+    for (const auto& label : mLabels) {
+        metricEvent->SetTagNoCopy(label.first, label.second);
+    }
+    if (!extraKey.empty()) {
+        metricEvent->SetTagNoCopy(extraKey, extraValue);
+    }
+    metricEvent->SetTagNoCopy(StringView(prometheus::NAME), name);
+    eGroup.MutableEvents().emplace_back(std::move(metricEvent), true, pool);
+}
+
+StringView ProtobufParser::GetSuffixedName(const char* suffix, PipelineEventGroup& eGroup) {
+    for (const auto& item : mSuffixedNames) {
+        if (item.first == suffix) {
+            return item.second;
+        }
+    }
+    auto sb = eGroup.GetSourceBuffer()->CopyString(mName.to_string() + suffix);
+    mSuffixedNames.emplace_back(suffix, StringView(sb.data, sb.size));
+    return mSuffixedNames.back().second;
+}
+
+StringView ProtobufParser::FormatBound(double bound, size_t index, PipelineEventGroup& eGroup) {
+    if (index < mBounds.size() && mBounds[index].first == bound) {
+        return mBounds[index].second;
+    }
+    auto sb = eGroup.GetSourceBuffer()->CopyString(FormatFloat(bound));
+    if (index >= mBounds.size()) {
+        mBounds.resize(index + 1);
+    }
+    mBounds[index] = {bound, StringView(sb.data, sb.size)};
+    return mBounds[index].second;
+}
+
+} // namespace logtail
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/StringView.h"
+#include "models/PipelineEventGroup.h"
+
+namespace logtail {
+
+// Parses the protobuf exposition format, i.e., a stream of varint length-delimited io.prometheus.client.MetricFamily
+// messages, into MetricEvents with one event per sample, the same as TextParser does for the text format, e.g.,
+// a summary gives samples of each quantile, _sum and _count.
+//
+// Native histograms are flattened into cumulative _bucket samples with the upper bound of each populated bucket as
+// "le", since there is no histogram value in MetricEvent.
+// see for detail: https://github.com/prometheus/client_model/blob/master/io/prometheus/client/metrics.proto
+class ProtobufParser {
+public:
+    ProtobufParser() = default;
+    explicit ProtobufParser(bool honorTimestamps);
+
+    void SetDefaultTimestamp(uint64_t defaultTimestamp, uint32_t defaultNanoSec);
+
+    // Parses the complete messages at the beginning of @data and appends the samples to @eGroup, with all strings
+    // copied to the source buffer of @eGroup. The metric name is also added as tag __name__.
+    // @return false if @data is invalid, otherwise @consumed is the size of the complete messages parsed
+    bool Parse(StringView data, PipelineEventGroup& eGroup, size_t& consumed, EventPool* pool = nullptr);
+
+    static bool IsProtobufContentType(const std::string& contentType);
+
+private:
+    struct Histogram {
+        void Clear();
+
+        double mCount = 0;
+        double mSum = 0;
+        // upper bound and cumulative count of classic buckets
+        std::vector<std::pair<double, double>> mBuckets;
+        // native buckets, where each span is the offset and length of consecutive buckets, and the count of a bucket
+        // is either the delta to the previous one or the absolute value for float histograms
+        int32_t mSchema = 0;
+        double mZeroThreshold = 0;
+        double mZeroCount = 0;
+        std::vector<std::pair<int32_t, uint32_t>> mNegativeSpans;
+        std::vector<int64_t> mNegativeDeltas;
+        std::vector<double> mNegativeCounts;
+        std::vector<std::pair<int32_t, uint32_t>> mPositiveSpans;
+        std::vector<int64_t> mPositiveDeltas;
+        std::vector<double> mPositiveCounts;
+    };
+
+    bool ParseMetricFamily(StringView data, PipelineEventGroup& eGroup, EventPool* pool);
+    bool ParseMetric(StringView data, PipelineEventGroup& eGroup, EventPool* pool);
+    bool ParseSummary(StringView data, PipelineEventGroup& eGroup, EventPool* pool);
+    bool ParseHistogram(StringView data);
+    void AddHistogramSamples(PipelineEventGroup& eGroup, EventPool* pool);
+    void AddNativeBuckets(PipelineEventGroup& eGroup, EventPool* pool);
+    void AddSample(StringView name,
+                   double value,
+                   PipelineEventGroup& eGroup,
+                   EventPool* pool,
+                   StringView extraKey = StringView(),
+                   StringView extraValue = StringView());
+    StringView GetSuffixedName(const char* suffix, PipelineEventGroup& eGroup);
+    StringView FormatBound(double bound, size_t index, PipelineEventGroup& eGroup);
+
+    bool mHonorTimestamps{true};
+    time_t mDefaultTimestamp{0};
+    uint32_t mDefaultNanoTimestamp{0};
+
+    // state of the current family, kept as members to reuse the memory
+    StringView mName;
+    uint64_t mType{0};
+    std::vector<StringView> mMetrics;
+    std::vector<std::pair<const char*, StringView>> mSuffixedNames;
+    // formatted le or quantile of the last metric, which are the same for most metrics of a family
+    std::vector<std::pair<double, StringView>> mBounds;
+
+    // state of the current metric
+    std::vector<std::pair<StringView, StringView>> mLabels;
+    time_t mTimestamp{0};
+    uint32_t mNanoTimestamp{0};
+    Histogram mHistogram;
+    std::vector<std::pair<double, double>> mNativeBuckets;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ProtobufParserUnittest;
+#endif
+};
+
+} // namespace logtail
@@ -286,4 +286,41 @@ bool RelabelConfigList::Empty() const {
     return mRelabelConfigs.empty();
 }
 
+shared_ptr<const RelabelResult> RelabelResultCache::Find(uint64_t hash) {
+    lock_guard<mutex> lock(mMux);
+    auto it = mCurrent.find(hash);
+    if (it != mCurrent.end()) {
+        return it->second;
+    }
+    it = mPrevious.find(hash);
+    if (it == mPrevious.end()) {
+        return nullptr;
+    }
+    auto res = std::move(it->second);
+    mPrevious.erase(it);
+    if (mCurrent.size() >= mMaxSize) {
+        mPrevious = std::move(mCurrent);
+        mCurrent.clear();
+    }
+    mCurrent.emplace(hash, res);
+    return res;
+}
+
+void RelabelResultCache::Insert(uint64_t hash, shared_ptr<const RelabelResult> result) {
+    lock_guard<mutex> lock(mMux);
+    if (mMaxSize == 0) {
+        return;
+    }
+    if (mCurrent.size() >= mMaxSize) {
+        mPrevious = std::move(mCurrent);
+        mCurrent.clear();
+    }
+    mCurrent[hash] = std::move(result);
+}
+
+size_t RelabelResultCache::Size() const {
+    lock_guard<mutex> lock(mMux);
+    return mCurrent.size() + mPrevious.size();
+}
+
 } // namespace logtail
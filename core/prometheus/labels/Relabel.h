@@ -18,7 +18,12 @@
 #include <json/json.h>
 
 #include <boost/regex.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "prometheus/labels/Labels.h"
 
@@ -89,5 +94,50 @@ private:
 #endif
 };
 
+// Outcome of relabeling a label set, which only depends on the label set and the relabel configs.
+struct RelabelResult {
+    struct Label {
+        // index of the same label in the label set before relabeling, or -1 if the label is added or changed, in which
+        // case key and value are kept
+        int32_t mInputIndex = -1;
+        std::string mKey;
+        std::string mValue;
+    };
+
+    bool mKeep = false;
+    // labels after relabeling in order, empty if dropped. Labels removed after relabeling anyway, i.e., those with
+    // reserved names or empty values, are not included.
+    std::vector<Label> mLabels;
+    // name and labels before relabeling, which are checked on lookup, since different series may have the same hash
+    std::string mSourceName;
+    std::vector<std::pair<std::string, std::string>> mSourceLabels;
+};
+
+// Caches relabel results by the hash of the label set before relabeling, since most series are the same between
+// scrapes. Callers must check the source labels of the result found. The cache holds two generations: when the
+// current one is full, it becomes the previous one, and results still in use are promoted back on lookup, so that
+// series gone are evicted without tracking access time.
+//
+// The cache must be owned together with the relabel configs, so that it is dropped on config change.
+class RelabelResultCache {
+public:
+    explicit RelabelResultCache(size_t maxSize) : mMaxSize(maxSize) {}
+
+    std::shared_ptr<const RelabelResult> Find(uint64_t hash);
+    void Insert(uint64_t hash, std::shared_ptr<const RelabelResult> result);
+    size_t Size() const;
+
+private:
+    using ResultMap = std::unordered_map<uint64_t, std::shared_ptr<const RelabelResult>>;
+
+    size_t mMaxSize = 0;
+    ResultMap mCurrent;
+    ResultMap mPrevious;
+    mutable std::mutex mMux;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class RelabelConfigUnittest;
+#endif
+};
 
 } // namespace logtail
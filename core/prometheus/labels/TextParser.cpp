@@ -38,6 +38,23 @@ bool IsValidNumberChar(char c) {
     return sValidChars.count(c);
 };
 
+StringView LabelInterner::Intern(StringView str) {
+    auto it = mStrings.find(std::string_view(str.data(), str.size()));
+    if (it != mStrings.end()) {
+        return it->second;
+    }
+    if (mInternedSize + str.size() > kMaxInternedSize) {
+        mStrings.clear();
+        mSourceBuffer = make_shared<SourceBuffer>();
+        mInternedSize = 0;
+    }
+    auto buffer = mSourceBuffer->CopyString(str);
+    StringView res(buffer.data, buffer.size);
+    mStrings.emplace(std::string_view(buffer.data, buffer.size), res);
+    mInternedSize += str.size();
+    return res;
+}
+
 TextParser::TextParser(bool honorTimestamps) : mHonorTimestamps(honorTimestamps) {
 }
 
@@ -101,7 +118,8 @@ void TextParser::HandleMetricName(MetricEvent& metricEvent) {
         ++mPos;
         c = (mPos < mLine.size()) ? mLine[mPos] : '\0';
     }
-    metricEvent.SetNameNoCopy(mLine.substr(mPos - mTokenLength, mTokenLength));
+    auto name = mLine.substr(mPos - mTokenLength, mTokenLength);
+    metricEvent.SetNameNoCopy(mInterner ? mInterner->Intern(name) : name);
     mTokenLength = 0;
     SkipLeadingWhitespace();
     if (mPos < mLine.size()) {
@@ -127,6 +145,9 @@ void TextParser::HandleLabelName(MetricEvent& metricEvent) {
             c = (mPos < mLine.size()) ? mLine[mPos] : '\0';
         }
         mLabelName = mLine.substr(mPos - mTokenLength, mTokenLength);
+        if (mInterner) {
+            mLabelName = mInterner->Intern(mLabelName);
+        }
         mTokenLength = 0;
         SkipLeadingWhitespace();
         if (mPos == mLine.size() || mLine[mPos] != '=') {
@@ -205,7 +226,16 @@ void TextParser::HandleLabelValue(MetricEvent& metricEvent) {
     }
 
     if (!escaped) {
-        metricEvent.SetTagNoCopy(mLabelName, mLine.substr(mPos - mTokenLength, mTokenLength));
+        auto value = mLine.substr(mPos - mTokenLength, mTokenLength);
+        if (mInterner) {
+            auto buffer = metricEvent.GetSourceBuffer()->CopyString(value);
+            value = StringView(buffer.data, buffer.size);
+        }
+        metricEvent.SetTagNoCopy(mLabelName, value);
+    } else if (mInterner) {
+        auto buffer = metricEvent.GetSourceBuffer()->CopyString(mEscapedLabelValue);
+        metricEvent.SetTagNoCopy(mLabelName, StringView(buffer.data, buffer.size));
+        mEscapedLabelValue.clear();
     } else {
         metricEvent.SetTag(mLabelName.to_string(), mEscapedLabelValue);
         mEscapedLabelValue.clear();
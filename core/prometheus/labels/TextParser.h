@@ -16,8 +16,12 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
+#include "common/memory/SourceBuffer.h"
 #include "models/MetricEvent.h"
 #include "models/PipelineEventGroup.h"
 
@@ -25,6 +29,30 @@ namespace logtail {
 
 enum class TextState { Start, Done, Error };
 
+// Interns metric names and label keys of a scrape target, which rarely change between scrapes, so that each one is
+// stored once in a source buffer shared by all event groups of the target instead of once per sample. Groups using
+// interned strings must hold the source buffer returned by GetSourceBuffer.
+//
+// When too many strings are interned, e.g., due to label churn, a new source buffer is started, and the old one is
+// released once all groups holding it are released.
+class LabelInterner {
+public:
+    StringView Intern(StringView str);
+    const std::shared_ptr<SourceBuffer>& GetSourceBuffer() const { return mSourceBuffer; }
+
+private:
+    static const size_t kMaxInternedSize = 1024 * 1024;
+
+    std::shared_ptr<SourceBuffer> mSourceBuffer = std::make_shared<SourceBuffer>();
+    // key points into the source buffer
+    std::unordered_map<std::string_view, StringView> mStrings;
+    size_t mInternedSize = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class TextParserUnittest;
+#endif
+};
+
 class TextParser {
 public:
     TextParser() = default;
@@ -36,6 +64,10 @@ public:
 
     bool ParseLine(StringView line, MetricEvent& metricEvent);
 
+    // By default, the parsed event points into the line. With @interner set, metric names and label keys are interned
+    // and label values are copied to the source buffer of the event, so that the line can be released after parsing.
+    void SetLabelInterner(LabelInterner* interner) { mInterner = interner; }
+
 private:
     void HandleError(const std::string& errMsg);
 
@@ -62,6 +94,8 @@ private:
     std::size_t mTokenLength{0};
     std::string mDoubleStr;
 
+    LabelInterner* mInterner{nullptr};
+
     bool mHonorTimestamps{true};
     time_t mDefaultTimestamp{0};
     uint32_t mDefaultNanoTimestamp{0};
@@ -23,19 +23,23 @@
 #include <string>
 #include <utility>
 
+#include "collection_pipeline/limiter/CpuGovernor.h"
 #include "collection_pipeline/queue/ProcessQueueManager.h"
 #include "collection_pipeline/queue/QueueKey.h"
+#include "common/Flags.h"
 #include "common/StringTools.h"
 #include "common/TimeUtil.h"
 #include "common/http/Constant.h"
-#include "common/timer/HttpRequestTimerEvent.h"
 #include "logger/Logger.h"
 #include "prometheus/Constants.h"
 #include "prometheus/Utils.h"
 #include "prometheus/async/PromFuture.h"
 #include "prometheus/async/PromHttpRequest.h"
+#include "prometheus/component/ScrapeTimerEvent.h"
 #include "prometheus/component/StreamScraper.h"
 
+DECLARE_FLAG_BOOL(enable_prom_parse_in_scraper);
+
 using namespace std;
 
 namespace logtail {
@@ -108,6 +112,8 @@ void ScrapeScheduler::OnMetricResult(HttpResponse& response, uint64_t) {
     streamScraper->Reset();
 
     ADD_COUNTER(mPluginTotalDelayMs, scrapeDurationMilliSeconds);
+    // parsing is done by the curl runner thread shared by all requests, so that it is charged but never waits
+    CpuGovernor::GetInstance()->Charge(CpuGovernor::sDefaultPriority);
 }
 
 
@@ -185,6 +191,14 @@ std::unique_ptr<TimerEvent> ScrapeScheduler::BuildScrapeTimerEvent(std::chrono::
         retry -= 1;
     }
 
+    auto* streamScraper = new prom::StreamScraper(
+        mTargetInfo.mLabels, mQueueKey, mInputIndex, mTargetInfo.mHash, mEventPool, mLatestScrapeTime);
+    if (BOOL_FLAG(enable_prom_parse_in_scraper)) {
+        if (!mLabelInterner) {
+            mLabelInterner = std::make_shared<LabelInterner>();
+        }
+        streamScraper->EnableParse(mScrapeConfigPtr->mHonorTimestamps, mLabelInterner);
+    }
     auto request = std::make_unique<PromHttpRequest>(
         HTTP_GET,
         mScheme == prometheus::HTTPS,
@@ -195,8 +209,7 @@ std::unique_ptr<TimerEvent> ScrapeScheduler::BuildScrapeTimerEvent(std::chrono::
         mScrapeConfigPtr->mRequestHeaders,
         "",
         HttpResponse(
-            new prom::StreamScraper(
-                mTargetInfo.mLabels, mQueueKey, mInputIndex, mTargetInfo.mHash, mEventPool, mLatestScrapeTime),
+            streamScraper,
             [](void* p) { delete static_cast<prom::StreamScraper*>(p); },
             prom::StreamScraper::MetricWriteCallback),
         mScrapeTimeoutSeconds,
@@ -205,8 +218,10 @@ std::unique_ptr<TimerEvent> ScrapeScheduler::BuildScrapeTimerEvent(std::chrono::
         this->mIsContextValidFuture,
         mScrapeConfigPtr->mFollowRedirects,
         mScrapeConfigPtr->mEnableTLS ? std::optional<CurlTLS>(mScrapeConfigPtr->mTLS) : std::nullopt);
+    // the exporter may choose the protobuf exposition format if it is accepted, see ScrapeConfig::InitScrapeProtocols
+    streamScraper->EnableProtobuf(&request->mResponse, mScrapeConfigPtr->mHonorTimestamps);
 
-    auto timerEvent = std::make_unique<HttpRequestTimerEvent>(execTime, std::move(request));
+    auto timerEvent = std::make_unique<ScrapeTimerEvent>(execTime, std::move(request));
     return timerEvent;
 }
 
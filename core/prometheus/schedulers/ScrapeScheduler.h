@@ -24,6 +24,7 @@
 #include "common/http/HttpResponse.h"
 #include "monitor/metric_models/MetricTypes.h"
 #include "prometheus/PromSelfMonitor.h"
+#include "prometheus/labels/TextParser.h"
 #include "prometheus/schedulers/ScrapeConfig.h"
 
 #ifdef APSARA_UNIT_TEST_MAIN
@@ -86,6 +87,9 @@ private:
     QueueKey mQueueKey;
     size_t mInputIndex;
 
+    // shared by scrapes of the target when samples are parsed in the scraper
+    std::shared_ptr<LabelInterner> mLabelInterner;
+
     // auto metrics
     std::atomic_int mScrapeResponseSizeBytes;
 
@@ -0,0 +1,444 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "protobuf/models/PipelineEventGroupDecoder.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "common/ProtobufWireReader.h"
+#include "models/LogEvent.h"
+#include "models/MetricEvent.h"
+#include "models/SpanEvent.h"
+
+using namespace std;
+
+namespace logtail {
+
+namespace {
+
+constexpr uint32_t kVarint = ProtobufWireReader::kVarint;
+constexpr uint32_t kFixed64 = ProtobufWireReader::kFixed64;
+constexpr uint32_t kLengthDelimited = ProtobufWireReader::kLengthDelimited;
+
+// field numbers are defined in protobuf_public/models/*.proto
+enum GroupField : uint32_t { kGroupTags = 2, kGroupLogs = 3, kGroupMetrics = 4, kGroupSpans = 5 };
+enum LogField : uint32_t { kLogTimestamp = 1, kLogContents = 2, kLogLevel = 3, kLogFileOffset = 4, kLogRawSize = 5 };
+enum MetricField : uint32_t { kMetricTimestamp = 1, kMetricName = 2, kMetricTags = 3, kMetricSingleValue = 4 };
+enum SpanField : uint32_t {
+    kSpanTimestamp = 1,
+    kSpanTraceId = 2,
+    kSpanSpanId = 3,
+    kSpanTraceState = 4,
+    kSpanParentSpanId = 5,
+    kSpanName = 6,
+    kSpanKind = 7,
+    kSpanStartTime = 8,
+    kSpanEndTime = 9,
+    kSpanTags = 10,
+    kSpanInnerEvents = 11,
+    kSpanLinks = 12,
+    kSpanStatus = 13,
+    kSpanScopeTags = 14
+};
+
+// every known field is either varint or length-delimited, except the value of UntypedSingleValue
+inline uint32_t ExpectedWireType(uint32_t field, uint32_t varintFieldMask) {
+    return field < 32 && ((varintFieldMask >> field) & 1) ? kVarint : kLengthDelimited;
+}
+
+// reads the next field, where fields with unexpected wire type are skipped as unknown fields, the same as protobuf
+// @return false if the wire format is invalid, otherwise @field is 0 if the field is skipped
+bool ReadField(ProtobufWireReader& reader, uint32_t varintFieldMask, uint32_t& field, uint64_t& num, StringView& view) {
+    uint32_t wireType = 0;
+    if (!reader.ReadTag(field, wireType)) {
+        return false;
+    }
+    if (wireType != ExpectedWireType(field, varintFieldMask)) {
+        field = 0;
+        return reader.Skip(wireType);
+    }
+    return wireType == kVarint ? reader.ReadVarint(num) : reader.ReadLengthDelimited(view);
+}
+
+// map<string, bytes> entry, where key = 1 and value = 2
+template <typename T>
+bool DecodeTag(StringView data, const T& setter) {
+    StringView key, value;
+    ProtobufWireReader reader(data);
+    while (!reader.Done()) {
+        uint32_t field = 0;
+        uint64_t num = 0;
+        StringView view;
+        if (!ReadField(reader, 0, field, num, view)) {
+            return false;
+        }
+        if (field == 1) {
+            key = view;
+        } else if (field == 2) {
+            value = view;
+        }
+    }
+    setter(key, value);
+    return true;
+}
+
+void SetTimestampNs(PipelineEvent& e, uint64_t timestampNs) {
+    e.SetTimestamp(timestampNs / 1000000000, static_cast<uint32_t>(timestampNs % 1000000000));
+}
+
+bool DecodeLogEvent(StringView data, LogEvent& dst) {
+    static const uint32_t kVarintFields = (1 << kLogTimestamp) | (1 << kLogFileOffset) | (1 << kLogRawSize);
+    uint64_t timestamp = 0, fileOffset = 0, rawSize = 0;
+    StringView level;
+    auto setter = [&dst](StringView key, StringView val) { dst.SetContentNoCopy(key, val); };
+    ProtobufWireReader reader(data);
+    while (!reader.Done()) {
+        uint32_t field = 0;
+        uint64_t num = 0;
+        StringView view;
+        if (!ReadField(reader, kVarintFields, field, num, view)) {
+            return false;
+        }
+        switch (field) {
+            case kLogTimestamp:
+                timestamp = num;
+                break;
+            case kLogContents:
+                if (!DecodeTag(view, setter)) {
+                    return false;
+                }
+                break;
+            case kLogLevel:
+                level = view;
+                break;
+            case kLogFileOffset:
+                fileOffset = num;
+                break;
+            case kLogRawSize:
+                rawSize = num;
+                break;
+            default:
+                break;
+        }
+    }
+    SetTimestampNs(dst, timestamp);
+    dst.SetLevelNoCopy(level);
+    dst.SetPosition(fileOffset, rawSize);
+    return true;
+}
+
+// UntypedSingleValue, where value = 1 is a double
+bool DecodeUntypedSingleValue(StringView data, double& value) {
+    ProtobufWireReader reader(data);
+    while (!reader.Done()) {
+        uint32_t field = 0, wireType = 0;
+        if (!reader.ReadTag(field, wireType)) {
+            return false;
+        }
+        if (field == 1 && wireType == kFixed64) {
+            uint64_t bits = 0;
+            if (!reader.ReadFixed64(bits)) {
+                return false;
+            }
+            memcpy(&value, &bits, sizeof(value));
+        } else if (!reader.Skip(wireType)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DecodeMetricEvent(StringView data, MetricEvent& dst, string& errMsg) {
+    static const uint32_t kVarintFields = 1 << kMetricTimestamp;
+    uint64_t timestamp = 0;
+    bool hasValue = false;
+    double value = 0;
+    auto setter = [&dst](StringView key, StringView val) { dst.SetTagNoCopy(key, val); };
+    ProtobufWireReader reader(data);
+    while (!reader.Done()) {
+        uint32_t field = 0;
+        uint64_t num = 0;
+        StringView view;
+        if (!ReadField(reader, kVarintFields, field, num, view)) {
+            return false;
+        }
+        switch (field) {
+            case kMetricTimestamp:
+                timestamp = num;
+                break;
+            case kMetricName:
+                dst.SetNameNoCopy(view);
+                break;
+            case kMetricTags:
+                if (!DecodeTag(view, setter)) {
+                    return false;
+                }
+                break;
+            case kMetricSingleValue:
+                // repeated occurrences of a message field are merged
+                if (!DecodeUntypedSingleValue(view, value)) {
+                    return false;
+                }
+                hasValue = true;
+                break;
+            default:
+                break;
+        }
+    }
+    if (!hasValue) {
+        errMsg = "error transfer PB to MetricEvent: unsupported value type";
+        return false;
+    }
+    SetTimestampNs(dst, timestamp);
+    dst.SetValue(UntypedSingleValue{value});
+    return true;
+}
+
+// SpanEvent.InnerEvent, where timestamp = 1, name = 2 and tags = 3
+bool DecodeSpanInnerEvent(StringView data, SpanEvent::InnerEvent& dst) {
+    auto setter = [&dst](StringView key, StringView val) { dst.SetTagNoCopy(key, val); };
+    ProtobufWireReader reader(data);
+    while (!reader.Done()) {
+        uint32_t field = 0;
+        uint64_t num = 0;
+        StringView view;
+        if (!ReadField(reader, 1 << 1, field, num, view)) {
+            return false;
+        }
+        switch (field) {
+            case 1:
+                dst.SetTimestampNs(num);
+                break;
+            case 2:
+                dst.SetNameNoCopy(view);
+                break;
+            case 3:
+                if (!DecodeTag(view, setter)) {
+                    return false;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+// SpanEvent.SpanLink, where traceID = 1, spanID = 2, traceState = 3 and tags = 4
+bool DecodeSpanLink(StringView data, SpanEvent::SpanLink& dst) {
+    auto setter = [&dst](StringView key, StringView val) { dst.SetTagNoCopy(key, val); };
+    ProtobufWireReader reader(data);
+    while (!reader.Done()) {
+        uint32_t field = 0;
+        uint64_t num = 0;
+        StringView view;
+        if (!ReadField(reader, 0, field, num, view)) {
+            return false;
+        }
+        switch (field) {
+            case 1:
+                dst.SetTraceIdNoCopy(view);
+                break;
+            case 2:
+                dst.SetSpanIdNoCopy(view);
+                break;
+            case 3:
+                dst.SetTraceStateNoCopy(view);
+                break;
+            case 4:
+                if (!DecodeTag(view, setter)) {
+                    return false;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+bool DecodeSpanEvent(StringView data, SpanEvent& dst) {
+    static const uint32_t kVarintFields = (1 << kSpanTimestamp) | (1 << kSpanKind) | (1 << kSpanStartTime)
+        | (1 << kSpanEndTime) | (1 << kSpanStatus);
+    uint64_t timestamp = 0;
+    auto tagSetter = [&dst](StringView key, StringView val) { dst.SetTagNoCopy(key, val); };
+    auto scopeTagSetter = [&dst](StringView key, StringView val) { dst.SetScopeTagNoCopy(key, val); };
+    ProtobufWireReader reader(data);
+    while (!reader.Done()) {
+        uint32_t field = 0;
+        uint64_t num = 0;
+        StringView view;
+        if (!ReadField(reader, kVarintFields, field, num, view)) {
+            return false;
+        }
+        switch (field) {
+            case kSpanTimestamp:
+                timestamp = num;
+                break;
+            case kSpanTraceId:
+                dst.SetTraceIdNoCopy(view);
+                break;
+            case kSpanSpanId:
+                dst.SetSpanIdNoCopy(view);
+                break;
+            case kSpanTraceState:
+                dst.SetTraceStateNoCopy(view);
+                break;
+            case kSpanParentSpanId:
+                dst.SetParentSpanIdNoCopy(view);
+                break;
+            case kSpanName:
+                dst.SetNameNoCopy(view);
+                break;
+            case kSpanKind:
+                dst.SetKind(static_cast<SpanEvent::Kind>(num));
+                break;
+            case kSpanStartTime:
+                dst.SetStartTimeNs(num);
+                break;
+            case kSpanEndTime:
+                dst.SetEndTimeNs(num);
+                break;
+            case kSpanTags:
+                if (!DecodeTag(view, tagSetter)) {
+                    return false;
+                }
+                break;
+            case kSpanInnerEvents:
+                if (!DecodeSpanInnerEvent(view, *dst.AddEvent())) {
+                    return false;
+                }
+                break;
+            case kSpanLinks:
+                if (!DecodeSpanLink(view, *dst.AddLink())) {
+                    return false;
+                }
+                break;
+            case kSpanStatus:
+                dst.SetStatus(static_cast<SpanEvent::StatusCode>(num));
+                break;
+            case kSpanScopeTags:
+                if (!DecodeTag(view, scopeTagSetter)) {
+                    return false;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    SetTimestampNs(dst, timestamp);
+    return true;
+}
+
+// LogEvents, MetricEvents and SpanEvents, where events = 1
+bool DecodeEvents(StringView data, uint32_t type, PipelineEventGroup& dst, string& errMsg) {
+    ProtobufWireReader reader(data);
+    while (!reader.Done()) {
+        uint32_t field = 0;
+        uint64_t num = 0;
+        StringView view;
+        if (!ReadField(reader, 0, field, num, view)) {
+            return false;
+        }
+        if (field != 1) {
+            continue;
+        }
+        bool res = false;
+        switch (type) {
+            case kGroupLogs:
+                res = DecodeLogEvent(view, *dst.AddLogEvent());
+                break;
+            case kGroupMetrics:
+                res = DecodeMetricEvent(view, *dst.AddMetricEvent(), errMsg);
+                break;
+            case kGroupSpans:
+                res = DecodeSpanEvent(view, *dst.AddSpanEvent());
+                break;
+            default:
+                break;
+        }
+        if (!res) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool DecodePBToPipelineEventGroup(StringView data, PipelineEventGroup& dst, string& errMsg) {
+    uint32_t eventsType = 0;
+    auto tagSetter = [&dst](StringView key, StringView val) { dst.SetTagNoCopy(key, val); };
+    ProtobufWireReader reader(data);
+    while (!reader.Done()) {
+        uint32_t field = 0;
+        uint64_t num = 0;
+        StringView view;
+        bool res = ReadField(reader, 0, field, num, view);
+        if (res) {
+            switch (field) {
+                case kGroupTags:
+                    res = DecodeTag(view, tagSetter);
+                    break;
+                case kGroupLogs:
+                case kGroupMetrics:
+                case kGroupSpans:
+                    // events is a oneof, where the same one is merged and a different one replaces the former
+                    if (eventsType != 0 && eventsType != field) {
+                        dst.MutableEvents().clear();
+                    }
+                    eventsType = field;
+                    res = DecodeEvents(view, field, dst, errMsg);
+                    break;
+                default:
+                    // metadata is not transferred, see TransferPBToPipelineEventGroup
+                    break;
+            }
+        }
+        if (!res) {
+            if (errMsg.empty()) {
+                errMsg = "error decode PB to PipelineEventGroup: invalid wire format";
+            }
+            return false;
+        }
+    }
+
+    switch (eventsType) {
+        case kGroupLogs:
+            if (dst.GetEvents().empty()) {
+                errMsg = "error transfer PB to PipelineEventGroup: no log events";
+                return false;
+            }
+            break;
+        case kGroupMetrics:
+            if (dst.GetEvents().empty()) {
+                errMsg = "error transfer PB to PipelineEventGroup: no metric events";
+                return false;
+            }
+            break;
+        case kGroupSpans:
+            if (dst.GetEvents().empty()) {
+                errMsg = "error transfer PB to PipelineEventGroup: no span events";
+                return false;
+            }
+            break;
+        default:
+            errMsg = "error transfer PB to PipelineEventGroup: unsupported event type";
+            return false;
+    }
+    return true;
+}
+
+} // namespace logtail
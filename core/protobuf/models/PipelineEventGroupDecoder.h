@@ -0,0 +1,34 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "common/StringView.h"
+#include "models/PipelineEventGroup.h"
+
+namespace logtail {
+
+// Decodes a serialized models::PipelineEventGroup directly from the protobuf wire format into @dst, which gives the
+// same result as ParseFromArray followed by TransferPBToPipelineEventGroup, without building the protobuf objects.
+//
+// No string is copied: all keys and values of @dst point into @data, so @data must be kept alive by the source
+// buffer of @dst, e.g., @data is the content of a raw event in a group sharing the same source buffer.
+// see for detail: https://protobuf.dev/programming-guides/encoding/
+bool DecodePBToPipelineEventGroup(StringView data, PipelineEventGroup& dst, std::string& errMsg);
+
+} // namespace logtail
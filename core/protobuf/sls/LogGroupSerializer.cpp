@@ -142,6 +142,12 @@ void LogGroupSerializer::AddLogTimeNs(uint32_t logTimeNs) {
     fixed32_pack(logTimeNs, mRes);
 }
 
+void LogGroupSerializer::AddCategory(StringView category) {
+    // field = 2, wire_type = 2
+    mRes.push_back(0x12);
+    AddString(category);
+}
+
 void LogGroupSerializer::AddTopic(StringView topic) {
     // field = 3, wire_type = 2
     mRes.push_back(0x1A);
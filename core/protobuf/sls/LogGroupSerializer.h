@@ -41,6 +41,7 @@ public:
     void AddLogTime(uint32_t logTime);
     void AddLogContent(StringView key, StringView value);
     void AddLogTimeNs(uint32_t logTimeNs);
+    void AddCategory(StringView category);
     void AddTopic(StringView topic);
     void AddSource(StringView source);
     void AddMachineUUID(StringView machineUUID);
@@ -16,6 +16,7 @@
 
 #include "app_config/AppConfig.h"
 #include "application/Application.h"
+#include "collection_pipeline/limiter/CpuGovernor.h"
 #include "collection_pipeline/plugin/interface/HttpFlusher.h"
 #include "collection_pipeline/queue/QueueKeyManager.h"
 #include "collection_pipeline/queue/SenderQueueItem.h"
@@ -29,6 +30,10 @@
 #include "runner/sink/http/HttpSink.h"
 
 DEFINE_FLAG_INT32(flusher_runner_exit_timeout_sec, "", 60);
+DEFINE_FLAG_INT32(flusher_runner_thread_num,
+                  "number of threads building requests for items fetched from sender queues, 1 means items are "
+                  "dispatched by the fetching thread",
+                  1);
 
 DECLARE_FLAG_INT32(discard_send_fail_interval);
 
@@ -56,6 +61,16 @@ bool FlusherRunner::Init() {
     mWaitingItemsTotal = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_FLUSHER_WAITING_ITEMS_TOTAL);
     WriteMetrics::GetInstance()->CommitMetricsRecordRef(mMetricsRecordRef);
 
+    mIsDispatcherStopped = false;
+    mDispatchingCnt = 0;
+    if (INT32_FLAG(flusher_runner_thread_num) > 1) {
+        for (int32_t i = 0; i < INT32_FLAG(flusher_runner_thread_num); ++i) {
+            mDispatcherQueues.emplace_back(make_unique<SafeQueue<DispatchTask>>());
+        }
+        for (size_t i = 0; i < mDispatcherQueues.size(); ++i) {
+            mDispatcherThreadRes.emplace_back(async(launch::async, &FlusherRunner::RunDispatcher, this, i));
+        }
+    }
     mThreadRes = async(launch::async, &FlusherRunner::Run, this);
     mLastCheckSendClientTime = time(nullptr);
     mIsFlush = false;
@@ -113,20 +128,30 @@ void FlusherRunner::DecreaseHttpSendingCnt() {
 }
 
 bool FlusherRunner::PushToHttpSink(SenderQueueItem* item, bool withLimit) {
+    // the sending slot is reserved before building the request, since items may be dispatched by several threads
     // TODO: use semaphore instead
-    while (withLimit && !Application::GetInstance()->IsExiting()
-           && GetSendingBufferCount() >= AppConfig::GetInstance()->GetSendRequestGlobalConcurrency()) {
+    int32_t cnt = mHttpSendingCnt.load();
+    while (true) {
+        if (!withLimit || Application::GetInstance()->IsExiting()
+            || cnt < AppConfig::GetInstance()->GetSendRequestGlobalConcurrency()) {
+            if (mHttpSendingCnt.compare_exchange_weak(cnt, cnt + 1)) {
+                break;
+            }
+            continue;
+        }
         this_thread::sleep_for(chrono::milliseconds(10));
+        cnt = mHttpSendingCnt.load();
     }
 
     unique_ptr<HttpSinkRequest> req;
     bool keepItem = false;
     string errMsg;
     if (!static_cast<HttpFlusher*>(item->mFlusher)->BuildRequest(item, req, &keepItem, &errMsg)) {
+        --mHttpSendingCnt;
         if (keepItem
             && chrono::duration_cast<chrono::seconds>(chrono::system_clock::now() - item->mFirstEnqueTime).count()
                 < INT32_FLAG(discard_send_fail_interval)) {
-            item->mStatus = SendingStatus::IDLE;
+            SenderQueueManager::GetInstance()->SetItemIdle(item);
             LOG_TRACE(
                 sLogger,
                 ("failed to build request", "retry later")("item address", item)(
@@ -147,9 +172,8 @@ bool FlusherRunner::PushToHttpSink(SenderQueueItem* item, bool withLimit) {
     LOG_TRACE(sLogger,
               ("send item to http sink, item address", item)("config-flusher-dst",
                                                              QueueKeyManager::GetInstance()->GetName(item->mQueueKey))(
-                  "sending cnt", ToString(mHttpSendingCnt.load() + 1)));
+                  "sending cnt", ToString(mHttpSendingCnt.load())));
     HttpSink::GetInstance()->AddRequest(std::move(req));
-    ++mHttpSendingCnt;
     return true;
 }
 
@@ -163,6 +187,14 @@ void FlusherRunner::Run() {
         int32_t limit = Application::GetInstance()->IsExiting()
             ? -1
             : AppConfig::GetInstance()->GetSendRequestGlobalConcurrency();
+        if (!mDispatcherQueues.empty()) {
+            // items are left in sender queues when the dispatchers fall behind, so that dispatcher queues are bounded
+            limit = AppConfig::GetInstance()->GetSendRequestGlobalConcurrency() - mDispatchingCnt.load();
+            if (limit <= 0) {
+                this_thread::sleep_for(chrono::milliseconds(10));
+                continue;
+            }
+        }
         SenderQueueManager::GetInstance()->GetAvailableItems(items, limit);
         if (items.empty()) {
             SenderQueueManager::GetInstance()->Wait(1000);
@@ -173,10 +205,8 @@ void FlusherRunner::Run() {
         }
 
         for (auto itr = items.begin(); itr != items.end(); ++itr) {
-            auto rawSize = (*itr)->mRawSize;
-            auto dataSize = (*itr)->mData.size();
-            ADD_COUNTER(mInItemDataSizeBytes, dataSize);
-            ADD_COUNTER(mInItemRawDataSizeBytes, rawSize);
+            ADD_COUNTER(mInItemDataSizeBytes, (*itr)->mData.size());
+            ADD_COUNTER(mInItemRawDataSizeBytes, (*itr)->mRawSize);
             LOG_TRACE(
                 sLogger,
                 ("got item from sender queue, item address",
@@ -185,24 +215,69 @@ void FlusherRunner::Run() {
                     ToString(chrono::duration_cast<chrono::milliseconds>(curTime - (*itr)->mFirstEnqueTime).count())
                         + "ms")("try cnt", ToString((*itr)->mTryCnt)));
 
-            if (Dispatch(*itr)) {
-                // TODO: use rate limiter instead
-                if (!Application::GetInstance()->IsExiting() && mEnableRateLimiter) {
-                    RateLimiter::FlowControl(rawSize, mSendLastTime, mSendLastByte, true);
-                }
-                ADD_COUNTER(mOutItemsTotal, 1);
-                ADD_COUNTER(mOutItemDataSizeBytes, dataSize);
-                ADD_COUNTER(mOutItemRawDataSizeBytes, rawSize);
+            if (mDispatcherQueues.empty()) {
+                DispatchItem(*itr, curTime);
+            } else {
+                ++mDispatchingCnt;
+                mDispatcherQueues[GetDispatcherIndex((*itr)->mFlusher)]->Push(make_pair(*itr, curTime));
             }
-
-            SUB_GAUGE(mWaitingItemsTotal, 1);
-            ADD_COUNTER(mTotalDelayMs, chrono::system_clock::now() - curTime);
         }
 
         if (mIsFlush && SenderQueueManager::GetInstance()->IsAllQueueEmpty()) {
             break;
         }
     }
+
+    mIsDispatcherStopped = true;
+    for (auto& res : mDispatcherThreadRes) {
+        res.wait();
+    }
+    mDispatcherThreadRes.clear();
+    mDispatcherQueues.clear();
+}
+
+void FlusherRunner::RunDispatcher(size_t index) {
+    auto& queue = *mDispatcherQueues[index];
+    while (true) {
+        DispatchTask task;
+        if (queue.WaitAndPop(task, 100)) {
+            DispatchItem(task.first, task.second);
+            --mDispatchingCnt;
+        } else if (mIsDispatcherStopped) {
+            break;
+        }
+    }
+}
+
+size_t FlusherRunner::GetDispatcherIndex(const Flusher* flusher) const {
+    // flushers are heap allocated and thus aligned, so the address is mixed before being sharded
+    auto addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(flusher));
+    return static_cast<size_t>((addr * 0x9E3779B97F4A7C15ULL) >> 32) % mDispatcherQueues.size();
+}
+
+void FlusherRunner::DispatchItem(SenderQueueItem* item, chrono::system_clock::time_point fetchTime) {
+    // item may be destructed after dispatch
+    auto rawSize = item->mRawSize;
+    auto dataSize = item->mData.size();
+    // flushers of the agent itself, e.g., the ones for alarms, have no context
+    auto priority = item->mFlusher->HasContext() ? item->mFlusher->GetContext().GetGlobalConfig().mPriority
+                                                 : CpuGovernor::sDefaultPriority;
+    if (Dispatch(item)) {
+        // TODO: use rate limiter instead
+        if (!Application::GetInstance()->IsExiting() && mEnableRateLimiter) {
+            lock_guard<mutex> lock(mFlowControlMux);
+            RateLimiter::FlowControl(rawSize, mSendLastTime, mSendLastByte, true);
+        }
+        ADD_COUNTER(mOutItemsTotal, 1);
+        ADD_COUNTER(mOutItemDataSizeBytes, dataSize);
+        ADD_COUNTER(mOutItemRawDataSizeBytes, rawSize);
+    }
+
+    SUB_GAUGE(mWaitingItemsTotal, 1);
+    ADD_COUNTER(mTotalDelayMs, chrono::system_clock::now() - fetchTime);
+    // the cpu time spent on the item is charged to the priority of the pipeline, but sending frees memory, so it never
+    // waits
+    CpuGovernor::GetInstance()->Charge(priority);
 }
 
 bool FlusherRunner::Dispatch(SenderQueueItem* item) {
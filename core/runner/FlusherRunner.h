@@ -19,10 +19,16 @@
 #include <cstdint>
 
 #include <atomic>
+#include <chrono>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 #include "collection_pipeline/plugin/interface/Flusher.h"
 #include "collection_pipeline/queue/SenderQueueItem.h"
+#include "common/SafeQueue.h"
 #include "monitor/MetricManager.h"
 #include "runner/sink/SinkType.h"
 
@@ -52,7 +58,12 @@ private:
     FlusherRunner() = default;
     ~FlusherRunner() = default;
 
+    using DispatchTask = std::pair<SenderQueueItem*, std::chrono::system_clock::time_point>;
+
     void Run();
+    void RunDispatcher(size_t index);
+    size_t GetDispatcherIndex(const Flusher* flusher) const;
+    void DispatchItem(SenderQueueItem* item, std::chrono::system_clock::time_point fetchTime);
     bool Dispatch(SenderQueueItem* item);
     bool LoadModuleConfig(bool isInit);
     void UpdateSendFlowControl();
@@ -62,10 +73,19 @@ private:
     std::future<void> mThreadRes;
     std::atomic_bool mIsFlush = false;
 
+    // items of the same flusher are always dispatched by the same thread, so that requests of a flusher are built
+    // sequentially and in order, even if the flusher owns several queues, e.g., exactly once
+    std::vector<std::unique_ptr<SafeQueue<DispatchTask>>> mDispatcherQueues;
+    // items pushed to dispatcher queues but not yet dispatched, no more than send_request_global_concurrency
+    std::atomic_int32_t mDispatchingCnt{0};
+    std::vector<std::future<void>> mDispatcherThreadRes;
+    std::atomic_bool mIsDispatcherStopped = false;
+
     std::atomic_int32_t mHttpSendingCnt{0};
 
     // TODO: temporarily here
     int32_t mLastCheckSendClientTime = 0;
+    std::mutex mFlowControlMux;
     int64_t mSendLastTime = 0;
     int32_t mSendLastByte = 0;
 
@@ -17,6 +17,9 @@
 #include "app_config/AppConfig.h"
 #include "batch/TimeoutFlushManager.h"
 #include "collection_pipeline/CollectionPipelineManager.h"
+#include "collection_pipeline/batch/BatchedEvents.h"
+#include "collection_pipeline/limiter/CpuGovernor.h"
+#include "collection_pipeline/serializer/SLSSerializer.h"
 #include "common/Flags.h"
 #include "go_pipeline/LogtailPlugin.h"
 #include "models/EventPool.h"
@@ -28,8 +31,6 @@
 DEFINE_FLAG_INT32(default_flush_merged_buffer_interval, "default flush merged buffer, seconds", 1);
 DEFINE_FLAG_INT32(processor_runner_exit_timeout_sec, "", 60);
 
-DECLARE_FLAG_INT32(max_send_log_group_size);
-
 using namespace std;
 
 namespace logtail {
@@ -121,6 +122,9 @@ void ProcessorRunner::Run(uint32_t threadNo) {
             continue;
         }
 
+        if (item->mEventGroup.GetTrace()) {
+            item->mEventGroup.GetTrace()->Stamp(TraceStamp::PROCESS_START);
+        }
         ADD_COUNTER(sInEventsCnt, item->mEventGroup.GetEvents().size());
         ADD_COUNTER(sInGroupsCnt, 1);
         ADD_COUNTER(sInGroupDataSizeBytes, item->mEventGroup.DataSize());
@@ -134,8 +138,6 @@ void ProcessorRunner::Run(uint32_t threadNo) {
             continue;
         }
 
-        bool isLog = !item->mEventGroup.GetEvents().empty() && item->mEventGroup.GetEvents()[0].Is<LogEvent>();
-
         vector<PipelineEventGroup> eventGroupList;
         eventGroupList.emplace_back(std::move(item->mEventGroup));
         // TODO: use old pipeline input index to find inner processor in new pipeline, maybe cause some issues when
@@ -143,35 +145,33 @@ void ProcessorRunner::Run(uint32_t threadNo) {
         pipeline->Process(eventGroupList, item->mInputIndex);
 
         if (pipeline->IsFlushingThroughGoPipeline()) {
-            // TODO:
-            // 1. allow all event types to be sent to Go pipelines
-            // 2. use event group protobuf instead
-            if (isLog) {
-                for (auto& group : eventGroupList) {
-                    string res, errorMsg;
-                    if (!Serialize(group,
-                                   pipeline->GetContext().GetGlobalConfig().mEnableTimestampNanosecond,
-                                   pipeline->GetContext().GetLogstoreName(),
-                                   res,
-                                   errorMsg)) {
-                        LOG_WARNING(pipeline->GetContext().GetLogger(),
-                                    ("failed to serialize event group",
-                                     errorMsg)("action", "discard data")("config", configName));
-                        pipeline->GetContext().GetAlarm().SendAlarmWarning(
-                            SERIALIZE_FAIL_ALARM,
-                            "failed to serialize event group: " + errorMsg
-                                + "\taction: discard data\tconfig: " + configName,
-                            pipeline->GetContext().GetRegion(),
-                            pipeline->GetContext().GetProjectName(),
-                            configName,
-                            pipeline->GetContext().GetLogstoreName());
-                        continue;
-                    }
-                    LogtailPlugin::GetInstance()->ProcessLogGroup(
-                        pipeline->GetContext().GetConfigName(),
-                        res,
-                        group.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
+            // TODO: use event group protobuf instead, so that metrics and spans are not converted to logs
+            // the buffer is reused by all groups in the thread, since Go copies the data before returning
+            thread_local LogGroupSerializer serializer;
+            PipelineResourceUsageGuard guard(*pipeline);
+            for (auto& group : eventGroupList) {
+                if (group.GetEvents().empty()) {
+                    continue;
                 }
+                string errorMsg;
+                if (!Serialize(group, pipeline->GetContext(), serializer, errorMsg)) {
+                    LOG_WARNING(pipeline->GetContext().GetLogger(),
+                                ("failed to serialize event group",
+                                 errorMsg)("action", "discard data")("config", configName));
+                    pipeline->GetContext().GetAlarm().SendAlarmWarning(
+                        SERIALIZE_FAIL_ALARM,
+                        "failed to serialize event group: " + errorMsg
+                            + "\taction: discard data\tconfig: " + configName,
+                        pipeline->GetContext().GetRegion(),
+                        pipeline->GetContext().GetProjectName(),
+                        configName,
+                        pipeline->GetContext().GetLogstoreName());
+                    continue;
+                }
+                LogtailPlugin::GetInstance()->ProcessLogGroup(
+                    pipeline->GetContext().GetConfigName(),
+                    serializer.GetResult(),
+                    group.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
             }
         } else {
             pipeline->Send(std::move(eventGroupList));
@@ -179,47 +179,39 @@ void ProcessorRunner::Run(uint32_t threadNo) {
         pipeline->SubInProcessCnt();
 
         gThreadedEventPool.CheckGC();
+        // the cpu time spent on the item is charged to the priority of the pipeline
+        CpuGovernor::GetInstance()->Acquire(pipeline->GetContext().GetGlobalConfig().mPriority);
     }
 }
 
-bool ProcessorRunner::Serialize(
-    const PipelineEventGroup& group, bool enableNanosecond, const string& logstore, string& res, string& errorMsg) {
-    sls_logs::LogGroup logGroup;
-    for (const auto& e : group.GetEvents()) {
-        if (e.Is<LogEvent>()) {
-            const auto& logEvent = e.Cast<LogEvent>();
-            auto log = logGroup.add_logs();
-            for (const auto& kv : logEvent) {
-                auto contPtr = log->add_contents();
-                contPtr->set_key(kv.first.to_string());
-                contPtr->set_value(kv.second.to_string());
-            }
-            log->set_time(logEvent.GetTimestamp());
-            if (enableNanosecond && logEvent.GetTimestampNanosecond()) {
-                log->set_time_ns(logEvent.GetTimestampNanosecond().value());
-            }
+// Go pipelines only accept log groups, so events are serialized the same way as flusher_sls does, except that tags
+// other than topic are kept as log tags and category is set to the logstore.
+bool ProcessorRunner::Serialize(PipelineEventGroup& group,
+                                const CollectionPipelineContext& ctx,
+                                LogGroupSerializer& serializer,
+                                string& errorMsg) {
+    size_t tagsSZ = GetStringSize(ctx.GetLogstoreName().size());
+    for (const auto& tag : group.GetTags()) {
+        if (tag.first == LOG_RESERVED_KEY_TOPIC) {
+            tagsSZ += GetStringSize(tag.second.size());
         } else {
-            errorMsg = "unsupported event type in event group";
-            return false;
+            tagsSZ += GetLogTagSize(tag.first.size(), tag.second.size());
         }
     }
+    // the source buffer is still owned by the group, which outlives the batch
+    BatchedEvents batch;
+    batch.mEvents = std::move(group.MutableEvents());
+    if (!SLSEventGroupSerializer::SerializeEvents(batch, ctx, tagsSZ, serializer, errorMsg)) {
+        return false;
+    }
     for (const auto& tag : group.GetTags()) {
         if (tag.first == LOG_RESERVED_KEY_TOPIC) {
-            logGroup.set_topic(tag.second.to_string());
+            serializer.AddTopic(tag.second);
         } else {
-            auto logTag = logGroup.add_logtags();
-            logTag->set_key(tag.first.to_string());
-            logTag->set_value(tag.second.to_string());
+            serializer.AddLogTag(tag.first, tag.second);
         }
     }
-    logGroup.set_category(logstore);
-    size_t size = logGroup.ByteSizeLong();
-    if (static_cast<int32_t>(size) > INT32_FLAG(max_send_log_group_size)) {
-        errorMsg = "log group exceeds size limit\tgroup size: " + ToString(size)
-            + "\tsize limit: " + ToString(INT32_FLAG(max_send_log_group_size));
-        return false;
-    }
-    res = logGroup.SerializeAsString();
+    serializer.AddCategory(ctx.GetLogstoreName());
     return true;
 }
 
@@ -23,9 +23,11 @@
 #include <string>
 #include <vector>
 
+#include "collection_pipeline/CollectionPipelineContext.h"
 #include "collection_pipeline/queue/QueueKey.h"
 #include "models/PipelineEventGroup.h"
 #include "monitor/MetricManager.h"
+#include "protobuf/sls/LogGroupSerializer.h"
 
 namespace logtail {
 
@@ -51,11 +53,11 @@ private:
 
     void Run(uint32_t threadNo);
 
-    bool Serialize(const PipelineEventGroup& group,
-                   bool enableNanosecond,
-                   const std::string& logstore,
-                   std::string& res,
-                   std::string& errorMsg);
+    // events of @group are consumed, and the result is kept in @serializer
+    static bool Serialize(PipelineEventGroup& group,
+                          const CollectionPipelineContext& ctx,
+                          LogGroupSerializer& serializer,
+                          std::string& errorMsg);
 
     uint32_t mThreadCount = 1;
     std::vector<std::future<void>> mThreadRes;
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "runner/sink/http/EndpointLatencyTracker.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+namespace logtail {
+
+void EndpointLatencyTracker::Record(const string& endpoint, chrono::milliseconds latency) {
+    auto& window = mWindows[endpoint];
+    window.mSamples[window.mNext] = latency.count();
+    window.mNext = (window.mNext + 1) % sWindowSize;
+    window.mCnt = min(window.mCnt + 1, sWindowSize);
+    window.mCachedPercentile = 0;
+}
+
+optional<chrono::milliseconds> EndpointLatencyTracker::GetPercentile(const string& endpoint, uint32_t percentile) {
+    auto it = mWindows.find(endpoint);
+    if (it == mWindows.end() || it->second.mCnt < sMinSampleCnt) {
+        return nullopt;
+    }
+    auto& window = it->second;
+    percentile = min(max(percentile, 1U), 100U);
+    if (window.mCachedPercentile != percentile) {
+        vector<int64_t> samples(window.mSamples.begin(), window.mSamples.begin() + window.mCnt);
+        auto nth = samples.begin() + (samples.size() * percentile + 99) / 100 - 1;
+        nth_element(samples.begin(), nth, samples.end());
+        window.mCachedPercentile = percentile;
+        window.mCachedValue = chrono::milliseconds(*nth);
+    }
+    return window.mCachedValue;
+}
+
+} // namespace logtail
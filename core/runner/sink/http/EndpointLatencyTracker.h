@@ -0,0 +1,56 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace logtail {
+
+// Keeps the response times of the latest requests to each endpoint, so that requests much slower than usual can be
+// told apart. Not thread safe, since it is only used by the http sink thread.
+class EndpointLatencyTracker {
+public:
+    static constexpr size_t sWindowSize = 128;
+    // percentiles are not reliable with fewer samples
+    static constexpr size_t sMinSampleCnt = 20;
+
+    void Record(const std::string& endpoint, std::chrono::milliseconds latency);
+    // returns the response time at @percentile of the latest requests to the endpoint, or nullopt if there are too
+    // few samples
+    std::optional<std::chrono::milliseconds> GetPercentile(const std::string& endpoint, uint32_t percentile);
+
+private:
+    struct Window {
+        std::array<int64_t, sWindowSize> mSamples{};
+        size_t mCnt = 0;
+        size_t mNext = 0;
+        // the percentile is only recomputed after new samples are recorded
+        uint32_t mCachedPercentile = 0;
+        std::optional<std::chrono::milliseconds> mCachedValue;
+    };
+
+    std::unordered_map<std::string, Window> mWindows;
+};
+
+} // namespace logtail
@@ -14,16 +14,20 @@
 
 #include "runner/sink/http/HttpSink.h"
 
+#include <algorithm>
 #include <optional>
 
 #include "app_config/AppConfig.h"
 #include "collection_pipeline/plugin/interface/HttpFlusher.h"
 #include "collection_pipeline/queue/QueueKeyManager.h"
 #include "collection_pipeline/queue/SenderQueueItem.h"
+#include "collection_pipeline/queue/SenderQueueManager.h"
 #include "common/Flags.h"
 #include "common/StringTools.h"
 #include "common/http/Curl.h"
+#include "common/http/CurlHandlePool.h"
 #include "logger/Logger.h"
+#include "monitor/Monitor.h"
 #include "monitor/metric_constants/MetricConstants.h"
 #include "runner/FlusherRunner.h"
 #ifdef APSARA_UNIT_TEST_MAIN
@@ -31,11 +35,33 @@
 #endif
 
 DEFINE_FLAG_INT32(http_sink_exit_timeout_sec, "", 5);
+DEFINE_FLAG_BOOL(enable_http_sink_hedging,
+                 "send a duplicate of the request much slower than usual for the endpoint, data may be duplicated",
+                 false);
+DEFINE_FLAG_INT32(http_sink_hedging_latency_percentile,
+                  "requests slower than the percentile of the response time of the endpoint are hedged",
+                  95);
+DEFINE_FLAG_INT32(http_sink_hedging_min_delay_ms, "", 200);
+DEFINE_FLAG_INT32(http_sink_low_speed_limit_bytes, "", 1);
+DEFINE_FLAG_INT32(http_sink_low_speed_time_sec,
+                  "abort the request if it transfers less than http_sink_low_speed_limit_bytes per second for the "
+                  "time, 0 means no limit",
+                  0);
 
 using namespace std;
 
 namespace logtail {
 
+// hedges are limited to a small part of the in-sending requests, so that a slow endpoint is not overloaded by them
+static constexpr double kMaxHedgeRatio = 0.1;
+
+static void SetLowSpeedLimit(CURL* curl) {
+    if (INT32_FLAG(http_sink_low_speed_time_sec) > 0) {
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, static_cast<long>(INT32_FLAG(http_sink_low_speed_limit_bytes)));
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, static_cast<long>(INT32_FLAG(http_sink_low_speed_time_sec)));
+    }
+}
+
 HttpSink* HttpSink::GetInstance() {
 #ifndef APSARA_UNIT_TEST_MAIN
     static HttpSink instance;
@@ -66,6 +92,9 @@ bool HttpSink::Init() {
         = mMetricsRecordRef.CreateTimeCounter(METRIC_RUNNER_SINK_FAILED_ITEM_TOTAL_RESPONSE_TIME_MS);
     mSendingItemsTotal = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_SINK_SENDING_ITEMS_TOTAL);
     mSendConcurrency = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_SINK_SEND_CONCURRENCY);
+    mHedgedItemsTotal = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_SINK_HEDGED_ITEMS_TOTAL);
+    mHedgeWonItemsTotal = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_SINK_HEDGE_WON_ITEMS_TOTAL);
+    mLowSpeedAbortedItemsTotal = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_SINK_LOW_SPEED_ABORTED_ITEMS_TOTAL);
     WriteMetrics::GetInstance()->CommitMetricsRecordRef(mMetricsRecordRef);
 
     // TODO: should be dynamic
@@ -139,7 +168,7 @@ bool HttpSink::AddRequestToClient(unique_ptr<HttpSinkRequest>&& request) {
                                    std::nullopt,
                                    std::move(request->mSocket));
     if (curl == nullptr) {
-        request->mItem->mStatus = SendingStatus::IDLE;
+        SenderQueueManager::GetInstance()->SetItemIdle(request->mItem);
         request->mResponse.SetNetworkStatus(NetworkCode::Other, "failed to init curl handler");
         FlusherRunner::GetInstance()->DecreaseHttpSendingCnt();
         ADD_COUNTER(mOutFailedItemsTotal, 1);
@@ -151,16 +180,18 @@ bool HttpSink::AddRequestToClient(unique_ptr<HttpSinkRequest>&& request) {
         return false;
     }
 
+    SetLowSpeedLimit(curl);
     request->mPrivateData = headers;
     curl_easy_setopt(curl, CURLOPT_PRIVATE, request.get());
     request->mLastSendTime = chrono::system_clock::now();
 
     auto res = curl_multi_add_handle(mClient, curl);
     if (res != CURLM_OK) {
-        request->mItem->mStatus = SendingStatus::IDLE;
+        SenderQueueManager::GetInstance()->SetItemIdle(request->mItem);
         request->mResponse.SetNetworkStatus(NetworkCode::Other, "failed to add the easy curl handle to multi_handle");
         FlusherRunner::GetInstance()->DecreaseHttpSendingCnt();
-        curl_easy_cleanup(curl);
+        CurlHandlePool::GetInstance()->Release(
+            CurlHandlePool::GetEndpoint(request->mHTTPSFlag, request->mHost, request->mPort), curl);
         ADD_COUNTER(mOutFailedItemsTotal, 1);
         LOG_ERROR(sLogger,
                   ("failed to send request",
@@ -170,11 +201,135 @@ bool HttpSink::AddRequestToClient(unique_ptr<HttpSinkRequest>&& request) {
                       "sending cnt", ToString(FlusherRunner::GetInstance()->GetSendingBufferCount())));
         return false;
     }
+    request->mHandle = curl;
+    request->mIsHedged = false;
+    mSendingRequests.insert(request.get());
     // let sink destruct the request
     request.release();
     return true;
 }
 
+chrono::milliseconds HttpSink::HedgeSlowRequests(int& runningHandlers) {
+    auto wait = chrono::milliseconds::max();
+    if (!BOOL_FLAG(enable_http_sink_hedging)) {
+        return wait;
+    }
+    auto now = chrono::system_clock::now();
+    if (now < mNextHedgeCheckTime) {
+        return chrono::duration_cast<chrono::milliseconds>(mNextHedgeCheckTime - now);
+    }
+    size_t maxHedgeCnt = max(static_cast<size_t>(mSendingRequests.size() * kMaxHedgeRatio), static_cast<size_t>(1));
+    auto minDelay = chrono::milliseconds(INT32_FLAG(http_sink_hedging_min_delay_ms));
+    for (auto* request : mSendingRequests) {
+        if (mHedgeCnt >= maxHedgeCnt) {
+            break;
+        }
+        if (request->mIsHedged) {
+            continue;
+        }
+        // a duplicate would break the checkpoint of exactly once
+        const auto* flusher = request->mItem->mFlusher;
+        if (flusher->HasContext() && flusher->GetContext().IsExactlyOnceEnabled()) {
+            continue;
+        }
+        auto endpoint = CurlHandlePool::GetEndpoint(request->mHTTPSFlag, request->mHost, request->mPort);
+        auto percentile = mLatencyTracker.GetPercentile(endpoint, INT32_FLAG(http_sink_hedging_latency_percentile));
+        if (!percentile) {
+            continue;
+        }
+        auto delay = max(*percentile, minDelay);
+        auto elapsed = chrono::duration_cast<chrono::milliseconds>(now - request->mLastSendTime);
+        if (elapsed < delay) {
+            wait = min(wait, delay - elapsed);
+            continue;
+        }
+        if (AddHedgeToClient(request)) {
+            ++runningHandlers;
+        }
+    }
+    // requests sent from now on cannot become slow within the min delay
+    wait = min(wait, minDelay);
+    mNextHedgeCheckTime = now + wait;
+    return wait;
+}
+
+bool HttpSink::AddHedgeToClient(HttpSinkRequest* request) {
+    // only one hedge is tried even if it cannot be sent
+    request->mIsHedged = true;
+    auto hedge = make_unique<HttpSinkHedge>();
+    CURL* curl = CreateCurlHandler(request->mMethod,
+                                   request->mHTTPSFlag,
+                                   request->mHost,
+                                   request->mPort,
+                                   request->mUrl,
+                                   request->mQueryString,
+                                   request->mHeader,
+                                   request->mBody,
+                                   hedge->mResponse,
+                                   hedge->mHeaders,
+                                   request->mTimeout,
+                                   AppConfig::GetInstance()->IsHostIPReplacePolicyEnabled(),
+                                   AppConfig::GetInstance()->GetBindInterface(),
+                                   false,
+                                   std::nullopt,
+                                   request->mSocket);
+    if (curl == nullptr) {
+        LOG_WARNING(sLogger,
+                    ("failed to hedge request", "failed to init curl handler")("item address", request->mItem));
+        return false;
+    }
+    SetLowSpeedLimit(curl);
+    // the connection of the slow request may be stuck
+    curl_easy_setopt(curl, CURLOPT_FRESH_CONNECT, 1L);
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, request);
+
+    auto res = curl_multi_add_handle(mClient, curl);
+    if (res != CURLM_OK) {
+        CurlHandlePool::GetInstance()->Release(
+            CurlHandlePool::GetEndpoint(request->mHTTPSFlag, request->mHost, request->mPort), curl);
+        if (hedge->mHeaders) {
+            curl_slist_free_all(hedge->mHeaders);
+        }
+        LOG_WARNING(sLogger,
+                    ("failed to hedge request", "failed to add the easy curl handle to multi_handle")(
+                        "errMsg", curl_multi_strerror(res))("item address", request->mItem));
+        return false;
+    }
+    hedge->mHandle = curl;
+    hedge->mSendTime = chrono::system_clock::now();
+    request->mHedge = std::move(hedge);
+    ++mHedgeCnt;
+    ADD_COUNTER(mHedgedItemsTotal, 1);
+    LOG_DEBUG(sLogger,
+              ("hedge slow request, item address", request->mItem)(
+                  "config-flusher-dst", QueueKeyManager::GetInstance()->GetName(request->mItem->mQueueKey))(
+                  "elapsed time",
+                  ToString(chrono::duration_cast<chrono::milliseconds>(request->mHedge->mSendTime
+                                                                       - request->mLastSendTime)
+                               .count())
+                      + "ms")("try cnt", ToString(request->mTryCnt)));
+    return true;
+}
+
+void HttpSink::RemoveAttempt(HttpSinkRequest* request, CURL* handle) {
+    curl_multi_remove_handle(mClient, handle);
+    CurlHandlePool::GetInstance()->Release(
+        CurlHandlePool::GetEndpoint(request->mHTTPSFlag, request->mHost, request->mPort), handle);
+    if (request->mHedge && request->mHedge->mHandle == handle) {
+        if (request->mHedge->mHeaders) {
+            curl_slist_free_all(request->mHedge->mHeaders);
+        }
+        request->mHedge.reset();
+        --mHedgeCnt;
+    } else {
+        if (request->mPrivateData) {
+            curl_slist_free_all((curl_slist*)request->mPrivateData);
+            request->mPrivateData = nullptr;
+        }
+        request->mHandle = nullptr;
+    }
+}
+
 void HttpSink::DoRun() {
     CURLMcode mc;
     int runningHandlers = 1;
@@ -210,6 +365,7 @@ void HttpSink::DoRun() {
         if (hasRequest) {
             continue;
         }
+        auto hedgeWait = HedgeSlowRequests(runningHandlers);
 
         struct timeval timeout {
             1, 0
@@ -228,6 +384,13 @@ void HttpSink::DoRun() {
                 timeout.tv_usec = (curlTimeout % 1000) * 1000;
             }
         }
+        // wake up in time to hedge the next slow request
+        if (hedgeWait < chrono::milliseconds(timeout.tv_sec * 1000 + timeout.tv_usec / 1000)) {
+            timeout.tv_sec = hedgeWait.count() / 1000;
+            timeout.tv_usec = (hedgeWait.count() % 1000) * 1000;
+            curlTimeout = curlTimeout >= 0 ? min(curlTimeout, static_cast<long>(hedgeWait.count()))
+                                           : static_cast<long>(hedgeWait.count());
+        }
 
         int maxfd = -1;
         fd_set fdread;
@@ -256,18 +419,51 @@ void HttpSink::HandleCompletedRequests(int& runningHandlers) {
         if (msg->msg == CURLMSG_DONE) {
             bool requestReused = false;
             CURL* handler = msg->easy_handle;
+            // msg is no longer valid once the handle is removed
+            CURLcode result = msg->data.result;
             HttpSinkRequest* request = nullptr;
             curl_easy_getinfo(handler, CURLINFO_PRIVATE, &request);
+            auto endpoint = CurlHandlePool::GetEndpoint(request->mHTTPSFlag, request->mHost, request->mPort);
             auto pipelinePlaceHolder = request->mItem->mPipeline; // keep pipeline alive
-            auto responseTime = chrono::system_clock::now() - request->mLastSendTime;
+            bool isHedge = request->mHedge && request->mHedge->mHandle == handler;
+            auto responseTime
+                = chrono::system_clock::now() - (isHedge ? request->mHedge->mSendTime : request->mLastSendTime);
             auto responseTimeMs = chrono::duration_cast<chrono::milliseconds>(responseTime);
-            switch (msg->data.result) {
+            CURL* other = isHedge ? request->mHandle : (request->mHedge ? request->mHedge->mHandle : nullptr);
+            long statusCode = 0;
+            if (result == CURLE_OK) {
+                curl_easy_getinfo(handler, CURLINFO_RESPONSE_CODE, &statusCode);
+                mLatencyTracker.Record(endpoint, responseTimeMs);
+            }
+            // aborted by the low speed limit
+            bool isLowSpeed = result == CURLE_OPERATION_TIMEDOUT && INT32_FLAG(http_sink_low_speed_time_sec) > 0
+                && responseTime < chrono::seconds(request->mTimeout);
+            if (other != nullptr) {
+                if (result != CURLE_OK) {
+                    // wait for the other attempt
+                    RemoveAttempt(request, handler);
+                    msg = curl_multi_info_read(mClient, &msgsLeft);
+                    continue;
+                }
+                RemoveAttempt(request, other);
+                --runningHandlers;
+            }
+            if (isHedge) {
+                request->mResponse = std::move(request->mHedge->mResponse);
+                if (result == CURLE_OK) {
+                    ADD_COUNTER(mHedgeWonItemsTotal, 1);
+                }
+            }
+            RemoveAttempt(request, handler);
+            mSendingRequests.erase(request);
+            switch (result) {
                 case CURLE_OK: {
-                    long statusCode = 0;
-                    curl_easy_getinfo(handler, CURLINFO_RESPONSE_CODE, &statusCode);
                     request->mResponse.SetNetworkStatus(NetworkCode::Ok, "");
                     request->mResponse.SetStatusCode(statusCode);
                     request->mResponse.SetResponseTime(responseTimeMs);
+                    if (statusCode >= 200 && statusCode < 300) {
+                        LoongCollectorMonitor::GetInstance()->RecordFirstSend();
+                    }
                     LOG_TRACE(sLogger,
                               ("send http request succeeded, item address",
                                request->mItem)("config-flusher-dst",
@@ -284,25 +480,25 @@ void HttpSink::HandleCompletedRequests(int& runningHandlers) {
                 }
                 default:
                     // considered as network error
-                    if (request->mTryCnt <= request->mMaxTryCnt) {
+                    if (isLowSpeed) {
+                        ADD_COUNTER(mLowSpeedAbortedItemsTotal, 1);
+                    }
+                    // the endpoint of a stalled request is reported to the flusher at once instead of after all tries
+                    if (!isLowSpeed && request->mTryCnt <= request->mMaxTryCnt) {
                         LOG_DEBUG(sLogger,
                                   ("failed to send http request", "retry immediately")("item address", request->mItem)(
                                       "config-flusher-dst",
                                       QueueKeyManager::GetInstance()->GetName(request->mItem->mFlusher->GetQueueKey()))(
-                                      "try cnt", request->mTryCnt)("errMsg", curl_easy_strerror(msg->data.result)));
-                        // free first，becase mPrivateData will be reset in AddRequestToClient
-                        if (request->mPrivateData) {
-                            curl_slist_free_all((curl_slist*)request->mPrivateData);
-                            request->mPrivateData = nullptr;
-                        }
+                                      "try cnt", request->mTryCnt)("errMsg", curl_easy_strerror(result)));
                         ++request->mTryCnt;
                         AddRequestToClient(unique_ptr<HttpSinkRequest>(request));
                         ++runningHandlers;
                         ADD_GAUGE(mSendingItemsTotal, 1);
                         requestReused = true;
                     } else {
-                        auto errMsg = curl_easy_strerror(msg->data.result);
-                        request->mResponse.SetNetworkStatus(GetNetworkStatus(msg->data.result), errMsg);
+                        auto errMsg = curl_easy_strerror(result);
+                        auto code = isLowSpeed ? NetworkCode::LowSpeed : GetNetworkStatus(result);
+                        request->mResponse.SetNetworkStatus(code, errMsg);
                         LOG_DEBUG(sLogger,
                                   ("failed to send http request", "abort")("item address", request->mItem)(
                                       "config-flusher-dst",
@@ -319,12 +515,7 @@ void HttpSink::HandleCompletedRequests(int& runningHandlers) {
                     SUB_GAUGE(mSendingItemsTotal, 1);
                     break;
             }
-            curl_multi_remove_handle(mClient, handler);
-            curl_easy_cleanup(handler);
             if (!requestReused) {
-                if (request->mPrivateData) {
-                    curl_slist_free_all((curl_slist*)request->mPrivateData);
-                }
                 delete request;
             }
         }
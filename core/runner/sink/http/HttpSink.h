@@ -17,14 +17,17 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <future>
 #include <mutex>
+#include <unordered_set>
 
 #include "curl/multi.h"
 
 #include "monitor/MetricManager.h"
 #include "runner/sink/Sink.h"
+#include "runner/sink/http/EndpointLatencyTracker.h"
 #include "runner/sink/http/HttpSinkRequest.h"
 
 namespace logtail {
@@ -45,10 +48,19 @@ private:
 
     void Run();
     bool AddRequestToClient(std::unique_ptr<HttpSinkRequest>&& request);
+    // sends hedges for the requests slower than usual, returns the time until the next request becomes slow
+    std::chrono::milliseconds HedgeSlowRequests(int& runningHandlers);
+    bool AddHedgeToClient(HttpSinkRequest* request);
+    // removes a completed or cancelled attempt of the request from the client
+    void RemoveAttempt(HttpSinkRequest* request, CURL* handle);
     void DoRun();
     void HandleCompletedRequests(int& runningHandlers);
 
     CURLM* mClient = nullptr;
+    std::unordered_set<HttpSinkRequest*> mSendingRequests;
+    EndpointLatencyTracker mLatencyTracker;
+    size_t mHedgeCnt = 0;
+    std::chrono::system_clock::time_point mNextHedgeCheckTime;
 
     std::future<void> mThreadRes;
     std::atomic_bool mIsFlush = false;
@@ -62,10 +74,14 @@ private:
     IntGaugePtr mSendingItemsTotal;
     IntGaugePtr mSendConcurrency;
     IntGaugePtr mLastRunTime;
+    CounterPtr mHedgedItemsTotal;
+    CounterPtr mHedgeWonItemsTotal;
+    CounterPtr mLowSpeedAbortedItemsTotal;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class FlusherRunnerUnittest;
     friend class HttpSinkMock;
+    friend class HttpSinkUnittest;
 #endif
 };
 
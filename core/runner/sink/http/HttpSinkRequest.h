@@ -16,15 +16,31 @@
 
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include <optional>
 
+#include "curl/curl.h"
+
 #include "collection_pipeline/queue/SenderQueueItem.h"
 #include "common/http/HttpRequest.h"
 
 namespace logtail {
 
+// a duplicate of a request which is slower than usual, the one completed first is used and the other is cancelled
+struct HttpSinkHedge {
+    CURL* mHandle = nullptr;
+    curl_slist* mHeaders = nullptr;
+    HttpResponse mResponse;
+    std::chrono::system_clock::time_point mSendTime;
+};
+
 struct HttpSinkRequest : public AsynHttpRequest {
     SenderQueueItem* mItem = nullptr;
+    CURL* mHandle = nullptr;
+    std::unique_ptr<HttpSinkHedge> mHedge;
+    // at most one hedge is sent for each try
+    bool mIsHedged = false;
 
     HttpSinkRequest(const std::string& method,
                     bool httpsFlag,
@@ -0,0 +1,354 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "collection_pipeline/batch/AdaptiveFlushController.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class AdaptiveFlushControllerUnittest : public ::testing::Test {
+public:
+    void TestQuietPipeline();
+    void TestBusyPipeline();
+    void TestSaturatedSender();
+    void TestBounds();
+    void TestMockEndpoint();
+
+protected:
+    void SetUp() override {
+        mOptions.mMinSizeBytesLowerBound = 32 * 1024;
+        mOptions.mMinSizeBytesUpperBound = 2 * 1024 * 1024;
+        mOptions.mTimeoutSecsLowerBound = 1;
+        mOptions.mTimeoutSecsUpperBound = 3;
+        mNow = chrono::steady_clock::time_point(chrono::seconds(1000));
+    }
+
+    // adds @rate bytes per second for @secs seconds, with one adjustment and one send per second
+    void Run(AdaptiveFlushController& controller,
+             size_t rate,
+             size_t secs,
+             chrono::milliseconds latency,
+             uint32_t concurrency,
+             bool saturated) {
+        for (size_t i = 0; i < secs; ++i) {
+            controller.OnAdd(rate);
+            controller.OnSendDone(latency, concurrency, saturated);
+            mNow += chrono::seconds(1);
+            controller.Adjust(mNow);
+        }
+    }
+
+    AdaptiveFlushOptions mOptions;
+    chrono::steady_clock::time_point mNow;
+};
+
+void AdaptiveFlushControllerUnittest::TestQuietPipeline() {
+    AdaptiveFlushController controller(mOptions);
+    APSARA_TEST_EQUAL(2U * 1024 * 1024, controller.GetMinSizeBytes());
+    APSARA_TEST_EQUAL(3U, controller.GetTimeoutSecs());
+
+    // the first call only starts the period
+    APSARA_TEST_FALSE(controller.Adjust(mNow));
+    // not a whole period
+    APSARA_TEST_FALSE(controller.Adjust(mNow + chrono::milliseconds(500)));
+
+    // thresholds are lowered step by step for a quiet pipeline
+    controller.OnAdd(1024);
+    controller.OnSendDone(chrono::milliseconds(50), 10, false);
+    mNow += chrono::seconds(1);
+    APSARA_TEST_TRUE(controller.Adjust(mNow));
+    APSARA_TEST_EQUAL(3U * 512 * 1024, controller.GetMinSizeBytes());
+    APSARA_TEST_EQUAL(1U, controller.GetTimeoutSecs());
+    APSARA_TEST_EQUAL(50.0, controller.GetSendLatencyMs());
+
+    Run(controller, 1024, 20, chrono::milliseconds(50), 10, false);
+    APSARA_TEST_EQUAL(32U * 1024, controller.GetMinSizeBytes());
+    APSARA_TEST_EQUAL(1U, controller.GetTimeoutSecs());
+    APSARA_TEST_FALSE(controller.Adjust(mNow + chrono::seconds(1)));
+}
+
+void AdaptiveFlushControllerUnittest::TestBusyPipeline() {
+    AdaptiveFlushController controller(mOptions);
+    controller.Adjust(mNow);
+
+    // batches are just large enough for the concurrent requests to keep up with the inflow
+    Run(controller, 10 * 1024 * 1024, 10, chrono::milliseconds(100), 4, false);
+    EXPECT_NEAR(10.0 * 1024 * 1024, controller.GetInflowRate(), 10 * 1024);
+    APSARA_TEST_EQUAL(100.0, controller.GetSendLatencyMs());
+    // 10MB/s * 0.1s / 4 * 2
+    EXPECT_NEAR(512 * 1024, controller.GetMinSizeBytes(), 1024);
+    APSARA_TEST_EQUAL(1U, controller.GetTimeoutSecs());
+
+    // a slower endpoint needs larger batches
+    Run(controller, 10 * 1024 * 1024, 10, chrono::milliseconds(300), 4, false);
+    EXPECT_NEAR(3 * 512 * 1024, controller.GetMinSizeBytes(), 3 * 1024);
+
+    // and so does a lower concurrency
+    Run(controller, 10 * 1024 * 1024, 10, chrono::milliseconds(300), 1, false);
+    APSARA_TEST_EQUAL(2U * 1024 * 1024, controller.GetMinSizeBytes());
+}
+
+void AdaptiveFlushControllerUnittest::TestSaturatedSender() {
+    AdaptiveFlushController controller(mOptions);
+    controller.Adjust(mNow);
+    Run(controller, 48 * 1024, 30, chrono::milliseconds(100), 4, false);
+    APSARA_TEST_EQUAL(32U * 1024, controller.GetMinSizeBytes());
+    APSARA_TEST_EQUAL(1U, controller.GetTimeoutSecs());
+
+    // the size is doubled in each period while the sender is saturated, and the timeout follows
+    Run(controller, 48 * 1024, 1, chrono::milliseconds(100), 4, true);
+    APSARA_TEST_EQUAL(64U * 1024, controller.GetMinSizeBytes());
+    APSARA_TEST_EQUAL(2U, controller.GetTimeoutSecs());
+    Run(controller, 48 * 1024, 1, chrono::milliseconds(100), 4, true);
+    APSARA_TEST_EQUAL(128U * 1024, controller.GetMinSizeBytes());
+    APSARA_TEST_EQUAL(3U, controller.GetTimeoutSecs());
+    Run(controller, 48 * 1024, 5, chrono::milliseconds(100), 4, true);
+    APSARA_TEST_EQUAL(2U * 1024 * 1024, controller.GetMinSizeBytes());
+    APSARA_TEST_EQUAL(3U, controller.GetTimeoutSecs());
+
+    // decays slowly once the pressure is gone
+    Run(controller, 48 * 1024, 1, chrono::milliseconds(100), 4, false);
+    APSARA_TEST_EQUAL(3U * 512 * 1024, controller.GetMinSizeBytes());
+    APSARA_TEST_EQUAL(1U, controller.GetTimeoutSecs());
+
+    // saturation reported by any send in the period counts
+    controller.OnAdd(48 * 1024);
+    controller.OnSendDone(chrono::milliseconds(100), 4, true);
+    controller.OnSendDone(chrono::milliseconds(100), 4, false);
+    mNow += chrono::seconds(1);
+    controller.Adjust(mNow);
+    APSARA_TEST_EQUAL(2U * 1024 * 1024, controller.GetMinSizeBytes());
+}
+
+void AdaptiveFlushControllerUnittest::TestBounds() {
+    mOptions.mMinSizeBytesLowerBound = 0;
+    mOptions.mTimeoutSecsLowerBound = 0;
+    AdaptiveFlushController controller(mOptions);
+    controller.Adjust(mNow);
+
+    // no data
+    Run(controller, 0, 100, chrono::milliseconds(100), 4, false);
+    APSARA_TEST_EQUAL(0U, controller.GetMinSizeBytes());
+    APSARA_TEST_EQUAL(0U, controller.GetTimeoutSecs());
+
+    // no feedback from the sender yet, e.g., the flusher never reports sends, the upper bounds are kept
+    AdaptiveFlushController other(mOptions);
+    other.Adjust(mNow);
+    for (size_t i = 0; i < 100; ++i) {
+        other.OnAdd(1024);
+        mNow += chrono::seconds(1);
+        APSARA_TEST_FALSE(other.Adjust(mNow));
+    }
+    APSARA_TEST_EQUAL(2U * 1024 * 1024, other.GetMinSizeBytes());
+    APSARA_TEST_EQUAL(3U, other.GetTimeoutSecs());
+    EXPECT_NEAR(1024.0, other.GetInflowRate(), 1.0);
+
+    Run(other, 10 * 1024, 10, chrono::milliseconds(10000), 1, true);
+    APSARA_TEST_EQUAL(2U * 1024 * 1024, other.GetMinSizeBytes());
+    APSARA_TEST_EQUAL(3U, other.GetTimeoutSecs());
+}
+
+namespace {
+
+struct Phase {
+    const char* mName;
+    size_t mSecs;
+    // bytes per second
+    size_t mInflowRate;
+    double mBaseLatencySecs;
+};
+
+struct PhaseResult {
+    size_t mRequestCnt = 0;
+    size_t mSentBytes = 0;
+    double mTotalDelayBytesSecs = 0.0;
+    size_t mBacklogBytes = 0;
+
+    double GetAvgBatchSize() const { return mRequestCnt == 0 ? 0.0 : static_cast<double>(mSentBytes) / mRequestCnt; }
+    double GetAvgDelaySecs() const { return mSentBytes == 0 ? 0.0 : mTotalDelayBytesSecs / mSentBytes; }
+};
+
+// a local endpoint accepting a fixed number of concurrent requests, whose latency consists of a varying base latency
+// and the transfer time of the request
+class MockEndpointSimulator {
+public:
+    static constexpr uint32_t sConcurrency = 4;
+    static constexpr double sBandwidth = 10.0 * 1024 * 1024;
+    static constexpr double sStepSecs = 0.001;
+
+    // @controller is null for fixed thresholds
+    MockEndpointSimulator(AdaptiveFlushController* controller, uint32_t minSizeBytes, uint32_t timeoutSecs)
+        : mController(controller), mMinSizeBytes(minSizeBytes), mTimeoutSecs(timeoutSecs) {}
+
+    PhaseResult Run(const Phase& phase) {
+        PhaseResult res;
+        size_t steps = static_cast<size_t>(phase.mSecs / sStepSecs);
+        for (size_t i = 0; i < steps; ++i) {
+            mNow += sStepSecs;
+            Complete(phase, res);
+            if (mController) {
+                auto now = chrono::steady_clock::time_point(chrono::milliseconds(static_cast<int64_t>(mNow * 1000)));
+                if (mController->Adjust(now)) {
+                    mMinSizeBytes = mController->GetMinSizeBytes();
+                    mTimeoutSecs = mController->GetTimeoutSecs();
+                }
+            }
+            Add(static_cast<size_t>(phase.mInflowRate * sStepSecs));
+            Send(phase);
+        }
+        for (const auto& request : mPending) {
+            res.mBacklogBytes += request.mSize;
+        }
+        return res;
+    }
+
+private:
+    struct Request {
+        size_t mSize = 0;
+        // bytes weighted arrival time
+        double mArrivalBytesSecs = 0.0;
+        double mSendTime = 0.0;
+        double mDoneTime = 0.0;
+    };
+
+    void Add(size_t size) {
+        if (mBatch.mSize == 0) {
+            mBatchCreateTime = mNow;
+        }
+        mBatch.mSize += size;
+        mBatch.mArrivalBytesSecs += size * mNow;
+        if (mController) {
+            mController->OnAdd(size);
+        }
+        if (mBatch.mSize >= mMinSizeBytes || mNow - mBatchCreateTime >= mTimeoutSecs) {
+            mPending.push_back(mBatch);
+            mBatch = Request();
+        }
+    }
+
+    void Send(const Phase& phase) {
+        while (mInFlight.size() < sConcurrency && !mPending.empty()) {
+            auto request = mPending.front();
+            mPending.pop_front();
+            request.mSendTime = mNow;
+            request.mDoneTime = mNow + phase.mBaseLatencySecs + request.mSize / sBandwidth;
+            mInFlight.push_back(request);
+        }
+    }
+
+    void Complete(const Phase& phase, PhaseResult& res) {
+        bool saturated = mInFlight.size() >= sConcurrency;
+        for (auto it = mInFlight.begin(); it != mInFlight.end();) {
+            if (it->mDoneTime > mNow) {
+                ++it;
+                continue;
+            }
+            ++res.mRequestCnt;
+            res.mSentBytes += it->mSize;
+            res.mTotalDelayBytesSecs += it->mSize * mNow - it->mArrivalBytesSecs;
+            if (mController) {
+                auto latency = chrono::milliseconds(static_cast<int64_t>((mNow - it->mSendTime) * 1000));
+                mController->OnSendDone(latency, sConcurrency, saturated);
+            }
+            it = mInFlight.erase(it);
+        }
+    }
+
+    AdaptiveFlushController* mController = nullptr;
+    uint32_t mMinSizeBytes = 0;
+    uint32_t mTimeoutSecs = 0;
+
+    double mNow = 1000.0;
+    Request mBatch;
+    double mBatchCreateTime = 0.0;
+    deque<Request> mPending;
+    vector<Request> mInFlight;
+};
+
+} // namespace
+
+/*
+quiet, 4KB/s, base latency 50ms
+    fixed 32KB/1s: 59 requests, avg batch 3KB, avg delay 0.5515s, backlog 0KB
+    fixed 512KB/3s: 19 requests, avg batch 11KB, avg delay 1.5525s, backlog 0KB
+    adaptive: 59 requests, avg batch 3KB, avg delay 0.5515s, backlog 0KB
+busy, 8192KB/s, base latency 50ms
+    fixed 32KB/1s: 4441 requests, avg batch 32KB, avg delay 21.1308s, backlog 345841KB
+    fixed 512KB/3s: 951 requests, avg batch 515KB, avg delay 0.132016s, backlog 0KB
+    adaptive: 1536 requests, avg batch 319KB, avg delay 0.284992s, backlog 0KB
+slow, 8192KB/s, base latency 400ms
+    fixed 32KB/1s: 596 requests, avg batch 32KB, avg delay 70.957s, backlog 817797KB
+    fixed 512KB/3s: 530 requests, avg batch 516KB, avg delay 13.5162s, backlog 216744KB
+    adaptive: 264 requests, avg batch 1844KB, avg delay 0.795784s, backlog 0KB
+quiet, 4KB/s, base latency 50ms
+    fixed 32KB/1s: 4431 requests, avg batch 32KB, avg delay 121.085s, backlog 672843KB
+    fixed 512KB/3s: 443 requests, avg batch 494KB, avg delay 18.852s, backlog 0KB
+    adaptive: 61 requests, avg batch 92KB, avg delay 0.806288s, backlog 0KB
+*/
+void AdaptiveFlushControllerUnittest::TestMockEndpoint() {
+    static const vector<Phase> kPhases = {{"quiet", 60, 4 * 1024, 0.05},
+                                          {"busy", 60, 8 * 1024 * 1024, 0.05},
+                                          {"slow", 60, 8 * 1024 * 1024, 0.4},
+                                          {"quiet", 60, 4 * 1024, 0.05}};
+    AdaptiveFlushController controller(mOptions);
+    vector<pair<string, unique_ptr<MockEndpointSimulator>>> simulators;
+    simulators.emplace_back("fixed 32KB/1s", make_unique<MockEndpointSimulator>(nullptr, 32 * 1024, 1));
+    simulators.emplace_back("fixed 512KB/3s", make_unique<MockEndpointSimulator>(nullptr, 512 * 1024, 3));
+    simulators.emplace_back("adaptive",
+                            make_unique<MockEndpointSimulator>(&controller,
+                                                               controller.GetMinSizeBytes(),
+                                                               controller.GetTimeoutSecs()));
+
+    vector<vector<PhaseResult>> results(kPhases.size());
+    for (size_t i = 0; i < kPhases.size(); ++i) {
+        const auto& phase = kPhases[i];
+        cout << phase.mName << ", " << phase.mInflowRate / 1024 << "KB/s, base latency "
+             << phase.mBaseLatencySecs * 1000 << "ms" << endl;
+        for (auto& simulator : simulators) {
+            results[i].push_back(simulator.second->Run(phase));
+            const auto& res = results[i].back();
+            cout << "    " << simulator.first << ": " << res.mRequestCnt << " requests, avg batch "
+                 << static_cast<size_t>(res.GetAvgBatchSize() / 1024) << "KB, avg delay " << res.GetAvgDelaySecs()
+                 << "s, backlog " << res.mBacklogBytes / 1024 << "KB" << endl;
+        }
+    }
+
+    // quiet pipelines are flushed as quickly as with small batches
+    for (size_t i : {0, 3}) {
+        APSARA_TEST_TRUE(results[i][2].GetAvgDelaySecs() < results[i][0].GetAvgDelaySecs() * 1.5);
+        APSARA_TEST_TRUE(results[i][2].GetAvgDelaySecs() < results[i][1].GetAvgDelaySecs() / 2);
+    }
+    // busy pipelines keep up with the inflow
+    for (size_t i : {1, 2}) {
+        APSARA_TEST_TRUE(results[i][2].mBacklogBytes < results[i][0].mBacklogBytes);
+        APSARA_TEST_TRUE(results[i][2].mBacklogBytes <= results[i][1].mBacklogBytes);
+        APSARA_TEST_TRUE(results[i][2].GetAvgDelaySecs() < 1.0);
+    }
+}
+
+UNIT_TEST_CASE(AdaptiveFlushControllerUnittest, TestQuietPipeline)
+UNIT_TEST_CASE(AdaptiveFlushControllerUnittest, TestBusyPipeline)
+UNIT_TEST_CASE(AdaptiveFlushControllerUnittest, TestSaturatedSender)
+UNIT_TEST_CASE(AdaptiveFlushControllerUnittest, TestBounds)
+UNIT_TEST_CASE(AdaptiveFlushControllerUnittest, TestMockEndpoint)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -35,6 +35,8 @@ public:
     void TestFlushAllWithoutGroupBatch();
     void TestFlushAllWithGroupBatch();
     void TestMetric();
+    void TestTrace();
+    void TestAdaptive();
 
 protected:
     static void SetUpTestCase() { sFlusher = make_unique<FlusherMock>(); }
@@ -657,6 +659,127 @@ void BatcherUnittest::TestMetric() {
     }
 }
 
+void BatcherUnittest::TestTrace() {
+    DefaultFlushStrategyOptions strategy;
+    strategy.mMinCnt = 3;
+    strategy.mMinSizeBytes = 1000;
+    strategy.mTimeoutSecs = 3;
+
+    Batcher<> batch;
+    batch.Init(Json::Value(), sFlusher.get(), strategy);
+
+    vector<BatchedEventsList> res;
+    PipelineEventGroup group1 = CreateEventGroup(1);
+    auto trace1 = make_shared<EventGroupTrace>();
+    group1.SetTrace(trace1);
+    batch.Add(std::move(group1), res);
+
+    PipelineEventGroup group2 = CreateEventGroup(2);
+    auto trace2 = make_shared<EventGroupTrace>();
+    group2.SetTrace(trace2);
+    batch.Add(std::move(group2), res);
+
+    // only the first traced group in the batch is kept
+    APSARA_TEST_EQUAL(1U, res.size());
+    APSARA_TEST_EQUAL(1U, res[0].size());
+    APSARA_TEST_EQUAL(trace1.get(), res[0][0].mTrace.get());
+    APSARA_TEST_TRUE(trace1->HasStamp(TraceStamp::BATCH_ADD));
+    APSARA_TEST_TRUE(trace2->HasStamp(TraceStamp::BATCH_ADD));
+}
+
+void BatcherUnittest::TestAdaptive() {
+    DefaultFlushStrategyOptions strategy;
+    strategy.mMaxSizeBytes = 10000;
+    strategy.mMinSizeBytes = 1000;
+    strategy.mTimeoutSecs = 3;
+    {
+        // disabled by default
+        Batcher<> batch;
+        batch.Init(Json::Value(), sFlusher.get(), strategy, false);
+        APSARA_TEST_EQUAL(nullptr, batch.mAdaptiveFlushController);
+        APSARA_TEST_EQUAL(1000U, batch.mTargetBatchSizeBytes->GetValue());
+        APSARA_TEST_EQUAL(3U, batch.mTargetBatchTimeoutSecs->GetValue());
+    }
+    {
+        // default bounds
+        Json::Value configJson;
+        string configStr, errorMsg;
+        configStr = R"(
+            {
+                "EnableAdaptive": true
+            }
+        )";
+        APSARA_TEST_TRUE(ParseJsonTable(configStr, configJson, errorMsg));
+        Batcher<> batch;
+        batch.Init(configJson, sFlusher.get(), strategy, false);
+        APSARA_TEST_NOT_EQUAL(nullptr, batch.mAdaptiveFlushController);
+        const auto& options = batch.mAdaptiveFlushController->mOptions;
+        APSARA_TEST_EQUAL(62U, options.mMinSizeBytesLowerBound);
+        APSARA_TEST_EQUAL(1000U, options.mMinSizeBytesUpperBound);
+        APSARA_TEST_EQUAL(1U, options.mTimeoutSecsLowerBound);
+        APSARA_TEST_EQUAL(3U, options.mTimeoutSecsUpperBound);
+        APSARA_TEST_EQUAL(1000U, batch.mEventFlushStrategy.GetMinSizeBytes());
+        APSARA_TEST_EQUAL(3U, batch.mEventFlushStrategy.GetTimeoutSecs());
+    }
+    {
+        // invalid bounds
+        Json::Value configJson;
+        string configStr, errorMsg;
+        configStr = R"(
+            {
+                "EnableAdaptive": true,
+                "MinSizeBytesUpperBound": 20000,
+                "MinSizeBytesLowerBound": 3000,
+                "TimeoutSecsLowerBound": 5
+            }
+        )";
+        APSARA_TEST_TRUE(ParseJsonTable(configStr, configJson, errorMsg));
+        Batcher<> batch;
+        batch.Init(configJson, sFlusher.get(), strategy, false);
+        const auto& options = batch.mAdaptiveFlushController->mOptions;
+        APSARA_TEST_EQUAL(62U, options.mMinSizeBytesLowerBound);
+        APSARA_TEST_EQUAL(1000U, options.mMinSizeBytesUpperBound);
+        APSARA_TEST_EQUAL(1U, options.mTimeoutSecsLowerBound);
+    }
+    {
+        // thresholds are adjusted on adding groups
+        Json::Value configJson;
+        string configStr, errorMsg;
+        configStr = R"(
+            {
+                "EnableAdaptive": true,
+                "MinSizeBytesUpperBound": 2000,
+                "MinSizeBytesLowerBound": 100
+            }
+        )";
+        APSARA_TEST_TRUE(ParseJsonTable(configStr, configJson, errorMsg));
+        Batcher<> batch;
+        batch.Init(configJson, sFlusher.get(), strategy, true);
+        APSARA_TEST_EQUAL(2000U, batch.mEventFlushStrategy.GetMinSizeBytes());
+        APSARA_TEST_EQUAL(2000U, batch.mGroupFlushStrategy->GetMinSizeBytes());
+        APSARA_TEST_EQUAL(2U, batch.mEventFlushStrategy.GetTimeoutSecs());
+        APSARA_TEST_EQUAL(1U, batch.mGroupFlushStrategy->GetTimeoutSecs());
+
+        batch.OnSendDone(chrono::milliseconds(50), 4, false);
+        APSARA_TEST_EQUAL(50U, batch.mSendLatencyMs->GetValue());
+        batch.mAdaptiveFlushController->mLastAdjustTime = chrono::steady_clock::now() - chrono::seconds(2);
+        vector<BatchedEventsList> res;
+        batch.Add(CreateEventGroup(3), res);
+        APSARA_TEST_EQUAL(1500U, batch.mEventFlushStrategy.GetMinSizeBytes());
+        APSARA_TEST_EQUAL(1500U, batch.mGroupFlushStrategy->GetMinSizeBytes());
+        APSARA_TEST_EQUAL(1U, batch.mEventFlushStrategy.GetTimeoutSecs());
+        APSARA_TEST_EQUAL(0U, batch.mGroupFlushStrategy->GetTimeoutSecs());
+        APSARA_TEST_EQUAL(1500U, batch.mTargetBatchSizeBytes->GetValue());
+        APSARA_TEST_EQUAL(1U, batch.mTargetBatchTimeoutSecs->GetValue());
+
+        // achieved batch size
+        size_t dataSize = batch.mBufferedDataSizeByte->GetValue();
+        batch.FlushAll(res);
+        APSARA_TEST_EQUAL(1U, batch.mOutBatchesTotal->GetValue());
+        APSARA_TEST_EQUAL(dataSize, batch.mOutBatchSizeBytes->GetValue());
+    }
+}
+
 PipelineEventGroup BatcherUnittest::CreateEventGroup(size_t cnt) {
     PipelineEventGroup group(make_shared<SourceBuffer>());
     group.SetTag(string("key"), string("val"));
@@ -681,6 +804,8 @@ UNIT_TEST_CASE(BatcherUnittest, TestFlushGroupQueue)
 UNIT_TEST_CASE(BatcherUnittest, TestFlushAllWithoutGroupBatch)
 UNIT_TEST_CASE(BatcherUnittest, TestFlushAllWithGroupBatch)
 UNIT_TEST_CASE(BatcherUnittest, TestMetric)
+UNIT_TEST_CASE(BatcherUnittest, TestTrace)
+UNIT_TEST_CASE(BatcherUnittest, TestAdaptive)
 
 } // namespace logtail
 
@@ -0,0 +1,131 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "app_config/AppConfig.h"
+#include "common/FileSystemUtil.h"
+#include "common/Flags.h"
+#include "file_server/checkpoint/CheckPointManager.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(check_point_max_count);
+DECLARE_FLAG_BOOL(enable_incremental_file_checkpoint);
+
+using namespace std;
+
+namespace logtail {
+
+class CheckpointBenchmark : public ::testing::Test {
+public:
+    void TestDumpAndLoad_10K();
+    void TestDumpAndLoad_100K();
+    void TestDumpAndLoad_1M();
+
+protected:
+    static void SetUpTestCase() {
+        sRootDir = (bfs::path(GetProcessExecutionDir()) / "CheckpointBenchmark").string();
+        INT32_FLAG(check_point_max_count) = 10000000;
+    }
+
+    void SetUp() override {
+        bfs::remove_all(sRootDir);
+        bfs::create_directories(sRootDir);
+        AppConfig::GetInstance()->mCheckPointFilePath = (bfs::path(sRootDir) / "checkpoint").string();
+    }
+
+    void TearDown() override {
+        CheckPointManager::Instance()->RemoveAllCheckPoint();
+        CheckPointManager::Instance()->mStore.reset();
+        bfs::remove_all(sRootDir);
+    }
+
+private:
+    void TestDumpAndLoad(size_t cnt);
+    void AddCheckPoints(size_t cnt);
+
+    static string sRootDir;
+};
+
+string CheckpointBenchmark::sRootDir;
+
+void CheckpointBenchmark::AddCheckPoints(size_t cnt) {
+    for (size_t i = 0; i < cnt; ++i) {
+        string path = "/var/log/app/" + to_string(i % 1000) + "/app-" + to_string(i) + ".log";
+        auto cpt = new CheckPoint(
+            path, path, i, 1024, i, DevInode(2049, i + 1), "config", path, false, false, "", false);
+        cpt->mLastUpdateTime = time(nullptr);
+        CheckPointManager::Instance()->AddCheckPoint(cpt);
+    }
+}
+
+void CheckpointBenchmark::TestDumpAndLoad(size_t cnt) {
+    auto manager = CheckPointManager::Instance();
+    auto measure = [](const string& name, const function<void()>& f) {
+        auto start = chrono::high_resolution_clock::now();
+        f();
+        chrono::duration<double, milli> elapsed = chrono::high_resolution_clock::now() - start;
+        cout << name << " elapsed: " << elapsed.count() << " ms" << endl;
+    };
+    cout << "checkpoint count: " << cnt << endl;
+
+    BOOL_FLAG(enable_incremental_file_checkpoint) = false;
+    AddCheckPoints(cnt);
+    measure("json dump", [&]() { APSARA_TEST_TRUE(manager->DumpCheckPointToLocal()); });
+    manager->RemoveAllCheckPoint();
+    measure("json load", [&]() { manager->LoadCheckPoint(); });
+    APSARA_TEST_EQUAL(cnt, manager->GetAllFileCheckPoint().size());
+    manager->RemoveAllCheckPoint();
+
+    BOOL_FLAG(enable_incremental_file_checkpoint) = true;
+    AddCheckPoints(cnt);
+    measure("store full dump", [&]() { APSARA_TEST_TRUE(manager->DumpCheckPointToLocal()); });
+    manager->RemoveAllCheckPoint();
+    // the typical case: only a small part of files are being written between two dumps
+    AddCheckPoints(cnt);
+    for (size_t i = 0; i < cnt / 100; ++i) {
+        CheckPointPtr cpt;
+        manager->GetCheckPoint(DevInode(2049, i + 1), "config", cpt);
+        cpt->mOffset += 1;
+    }
+    measure("store 1% dirty dump", [&]() { APSARA_TEST_TRUE(manager->DumpCheckPointToLocal()); });
+    manager->RemoveAllCheckPoint();
+    manager->mStore.reset();
+    measure("store load", [&]() { manager->LoadCheckPoint(); });
+    APSARA_TEST_EQUAL(cnt, manager->GetAllFileCheckPoint().size());
+    BOOL_FLAG(enable_incremental_file_checkpoint) = false;
+}
+
+void CheckpointBenchmark::TestDumpAndLoad_10K() {
+    TestDumpAndLoad(10000);
+}
+
+void CheckpointBenchmark::TestDumpAndLoad_100K() {
+    TestDumpAndLoad(100000);
+}
+
+void CheckpointBenchmark::TestDumpAndLoad_1M() {
+    TestDumpAndLoad(1000000);
+}
+
+UNIT_TEST_CASE(CheckpointBenchmark, TestDumpAndLoad_10K)
+UNIT_TEST_CASE(CheckpointBenchmark, TestDumpAndLoad_100K)
+UNIT_TEST_CASE(CheckpointBenchmark, TestDumpAndLoad_1M)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
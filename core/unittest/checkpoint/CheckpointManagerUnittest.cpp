@@ -15,9 +15,12 @@
 #include "common/FileSystemUtil.h"
 #include "common/Flags.h"
 #include "file_server/checkpoint/CheckPointManager.h"
+#include "file_server/checkpoint/CheckpointStore.h"
 #include "unittest/Unittest.h"
 
 DECLARE_FLAG_INT32(checkpoint_find_max_file_count);
+DECLARE_FLAG_INT32(file_check_point_time_out);
+DECLARE_FLAG_BOOL(enable_incremental_file_checkpoint);
 
 namespace logtail {
 
@@ -35,9 +38,13 @@ public:
     static void TearDownTestCase() { bfs::remove_all(kTestRootDir); }
 
     void TestSearchFilePathByDevInodeInDirectory();
+    void TestCheckpointStore();
+    void TestMigrateCheckpointStore();
 };
 
 UNIT_TEST_CASE(CheckpointManagerUnittest, TestSearchFilePathByDevInodeInDirectory);
+UNIT_TEST_CASE(CheckpointManagerUnittest, TestCheckpointStore);
+UNIT_TEST_CASE(CheckpointManagerUnittest, TestMigrateCheckpointStore);
 
 void CheckpointManagerUnittest::TestSearchFilePathByDevInodeInDirectory() {
     const std::string kRotateFileName = "test.log.5";
@@ -96,6 +103,147 @@ void CheckpointManagerUnittest::TestSearchFilePathByDevInodeInDirectory() {
     }
 }
 
+void CheckpointManagerUnittest::TestCheckpointStore() {
+    const std::string kStorePath = (bfs::path(kTestRootDir) / "checkpoint_store").string();
+    std::vector<CheckPointPtr> cpts;
+    std::vector<const CheckPoint*> cptPtrs;
+    for (uint64_t i = 0; i < 3; ++i) {
+        cpts.emplace_back(std::make_shared<CheckPoint>("/log/" + std::to_string(i) + ".log",
+                                                       "/log/" + std::to_string(i) + ".log",
+                                                       100 * i,
+                                                       1024,
+                                                       i,
+                                                       DevInode(1, i + 1),
+                                                       "config",
+                                                       "",
+                                                       false,
+                                                       false,
+                                                       "",
+                                                       false));
+        cptPtrs.push_back(cpts.back().get());
+    }
+    std::unordered_map<std::string, DirCheckPointPtr> dirs;
+    dirs["/log"] = std::make_shared<DirCheckPoint>("/log");
+    dirs["/log"]->mSubDir.insert("/log/sub");
+
+    {
+        CheckpointStore store(kStorePath);
+        size_t writtenCnt = 0;
+        // all entries are new
+        EXPECT_TRUE(store.Dump(1, cptPtrs, dirs, &writtenCnt));
+        EXPECT_EQ(4U, writtenCnt);
+        // nothing changed
+        EXPECT_TRUE(store.Dump(1, cptPtrs, dirs, &writtenCnt));
+        EXPECT_EQ(0U, writtenCnt);
+        // 1 updated and 1 removed
+        cpts[0]->mOffset = 12345;
+        cptPtrs.pop_back();
+        EXPECT_TRUE(store.Dump(1, cptPtrs, dirs, &writtenCnt));
+        EXPECT_EQ(2U, writtenCnt);
+        // 1 renamed
+        cpts[1]->mFileName = "/log/1.log.1";
+        EXPECT_TRUE(store.Dump(1, cptPtrs, dirs, &writtenCnt));
+        EXPECT_EQ(2U, writtenCnt);
+        // dir checkpoints are recreated on each dump, but only persisted when sub dirs change or close to timeout
+        dirs["/log"] = std::make_shared<DirCheckPoint>("/log");
+        dirs["/log"]->mSubDir.insert("/log/sub");
+        EXPECT_TRUE(store.Dump(1, cptPtrs, dirs, &writtenCnt));
+        EXPECT_EQ(0U, writtenCnt);
+        dirs["/log"]->mUpdateTime += INT32_FLAG(file_check_point_time_out) / 2;
+        EXPECT_TRUE(store.Dump(1, cptPtrs, dirs, &writtenCnt));
+        EXPECT_EQ(1U, writtenCnt);
+        dirs["/log"]->mSubDir.insert("/log/sub2");
+        EXPECT_TRUE(store.Dump(1, cptPtrs, dirs, &writtenCnt));
+        EXPECT_EQ(1U, writtenCnt);
+        dirs["/log"]->mSubDir.erase("/log/sub2");
+        EXPECT_TRUE(store.Dump(1, cptPtrs, dirs, &writtenCnt));
+        EXPECT_EQ(1U, writtenCnt);
+    }
+    {
+        CheckpointStore store(kStorePath);
+        int32_t version = 0;
+        std::vector<CheckPointPtr> loadedCpts;
+        std::unordered_map<std::string, DirCheckPointPtr> loadedDirs;
+        EXPECT_TRUE(store.Load(version, loadedCpts, loadedDirs));
+        EXPECT_EQ(1, version);
+        EXPECT_EQ(2U, loadedCpts.size());
+        EXPECT_EQ(1U, loadedDirs.size());
+        EXPECT_EQ(1U, loadedDirs["/log"]->mSubDir.count("/log/sub"));
+        for (const auto& cpt : loadedCpts) {
+            EXPECT_EQ("config", cpt->mConfigName);
+            if (cpt->mDevInode.inode == 1) {
+                EXPECT_EQ(12345, cpt->mOffset);
+            } else {
+                EXPECT_EQ(2U, cpt->mDevInode.inode);
+                EXPECT_EQ("/log/1.log.1", cpt->mFileName);
+                EXPECT_EQ(100, cpt->mOffset);
+                EXPECT_EQ(1U, cpt->mSignatureHash);
+            }
+        }
+        // loaded entries are treated as persisted
+        size_t writtenCnt = 0;
+        std::vector<const CheckPoint*> loadedPtrs;
+        for (const auto& cpt : loadedCpts) {
+            loadedPtrs.push_back(cpt.get());
+        }
+        EXPECT_TRUE(store.Dump(1, loadedPtrs, loadedDirs, &writtenCnt));
+        EXPECT_EQ(0U, writtenCnt);
+    }
+}
+
+void CheckpointManagerUnittest::TestMigrateCheckpointStore() {
+    auto* manager = CheckPointManager::Instance();
+    const std::string bakCheckpointPath = AppConfig::GetInstance()->mCheckPointFilePath;
+    AppConfig::GetInstance()->mCheckPointFilePath = (bfs::path(kTestRootDir) / "migrate_checkpoint").string();
+    const std::string jsonPath = AppConfig::GetInstance()->mCheckPointFilePath;
+    const std::string storePath = CheckPointManager::GetCheckPointStorePath();
+    auto addCheckpoint = [&](int64_t offset) {
+        manager->RemoveAllCheckPoint();
+        manager->AddCheckPoint(
+            new CheckPoint("/log/a.log", "", offset, 1024, 1, DevInode(1, 1), "config", "", false, false, "", false));
+    };
+    auto getOffset = [&]() -> int64_t {
+        CheckPointPtr cpt;
+        return manager->GetCheckPoint(DevInode(1, 1), "config", cpt) ? cpt->mOffset : -1;
+    };
+
+    // dumped to json
+    addCheckpoint(100);
+    EXPECT_TRUE(manager->DumpCheckPointToLocal());
+    EXPECT_TRUE(bfs::exists(jsonPath));
+
+    // migrated to the store, and the json file is retired
+    BOOL_FLAG(enable_incremental_file_checkpoint) = true;
+    manager->RemoveAllCheckPoint();
+    manager->LoadCheckPoint();
+    EXPECT_EQ(100, getOffset());
+    addCheckpoint(200);
+    EXPECT_TRUE(manager->DumpCheckPointToLocal());
+    EXPECT_FALSE(bfs::exists(jsonPath));
+    EXPECT_TRUE(bfs::exists(jsonPath + ".migrated"));
+
+    // disabled again, the store is loaded instead of the stale json file, and retired after dumped to json
+    BOOL_FLAG(enable_incremental_file_checkpoint) = false;
+    manager->RemoveAllCheckPoint();
+    manager->LoadCheckPoint();
+    EXPECT_EQ(200, getOffset());
+    addCheckpoint(300);
+    EXPECT_TRUE(manager->DumpCheckPointToLocal());
+    EXPECT_TRUE(bfs::exists(jsonPath));
+    EXPECT_FALSE(bfs::exists(storePath));
+
+    // enabled again, the json file is migrated again
+    BOOL_FLAG(enable_incremental_file_checkpoint) = true;
+    manager->RemoveAllCheckPoint();
+    manager->LoadCheckPoint();
+    EXPECT_EQ(300, getOffset());
+
+    BOOL_FLAG(enable_incremental_file_checkpoint) = false;
+    manager->RemoveAllCheckPoint();
+    manager->mStore.reset();
+    AppConfig::GetInstance()->mCheckPointFilePath = bakCheckpointPath;
+}
+
 } // namespace logtail
 
 UNIT_TEST_MAIN
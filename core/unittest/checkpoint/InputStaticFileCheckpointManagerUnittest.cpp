@@ -24,6 +24,7 @@ class InputStaticFileCheckpointManagerUnittest : public testing::Test {
 public:
     void TestUpdateCheckpointMap() const;
     void TestUpdateCheckpoint() const;
+    void TestUpdateRangeCheckpoint() const;
     void TestCheckpointFileNames() const;
     void TestDumpCheckpoints() const;
     void TestInvalidCheckpointFile() const;
@@ -337,6 +338,76 @@ void InputStaticFileCheckpointManagerUnittest::TestUpdateCheckpoint() const {
     filesystem::remove_all("test_logs");
 }
 
+void InputStaticFileCheckpointManagerUnittest::TestUpdateRangeCheckpoint() const {
+    // prepare logs
+    filesystem::create_directories("test_logs");
+    vector<filesystem::path> files{"./test_logs/test_file_1.log", "./test_logs/test_file_2.log"};
+    vector<string> contents{string(2000, 'a') + "\n", string(200, 'b') + "\n"};
+    for (size_t i = 0; i < files.size(); ++i) {
+        ofstream fout(files[i], std::ios_base::binary);
+        fout << contents[i];
+    }
+
+    sManager->CreateCheckpoint("test_config_1", 0, files);
+    {
+        // from waiting to reading in ranges
+        APSARA_TEST_TRUE(sManager->SetCurrentFileRanges(
+            "test_config_1", 0, vector<FileRangeCheckpoint>{{0, 1000}, {1000, 2001}}, 2001));
+        const auto& cpt = sManager->mInputCheckpointMap.at(make_pair("test_config_1", 0));
+        APSARA_TEST_EQUAL(FileStatus::READING, cpt.mFileCheckpoints[0].mStatus);
+        APSARA_TEST_EQUAL(2001U, cpt.mFileCheckpoints[0].mSize);
+        APSARA_TEST_EQUAL(2U, cpt.mFileCheckpoints[0].mRanges.size());
+        APSARA_TEST_NOT_EQUAL(0, cpt.mFileCheckpoints[0].mStartTime);
+        // ranges can only be set once
+        APSARA_TEST_FALSE(
+            sManager->SetCurrentFileRanges("test_config_1", 0, vector<FileRangeCheckpoint>{{0, 2001}}, 2001));
+    }
+    {
+        // range updated
+        APSARA_TEST_TRUE(sManager->UpdateCurrentFileRangeCheckpoint("test_config_1", 0, 1, 1500));
+        APSARA_TEST_FALSE(sManager->UpdateCurrentFileRangeCheckpoint("test_config_1", 0, 1, 1200));
+        APSARA_TEST_FALSE(sManager->UpdateCurrentFileRangeCheckpoint("test_config_1", 0, 2, 1500));
+        sManager->DumpAllCheckpointFiles();
+        const auto& cpt = sManager->mInputCheckpointMap.at(make_pair("test_config_1", 0));
+        APSARA_TEST_EQUAL(500U, cpt.mFileCheckpoints[0].mOffset);
+        InputStaticFileCheckpoint cptLoaded;
+        APSARA_TEST_TRUE(
+            sManager->LoadCheckpointFile(sManager->mCheckpointRootPath / "test_config_1@0.json", &cptLoaded));
+        vector<FileRangeCheckpoint> ranges;
+        APSARA_TEST_TRUE(cptLoaded.GetCurrentFileRanges(&ranges));
+        APSARA_TEST_EQUAL(2U, ranges.size());
+        APSARA_TEST_EQUAL(0U, ranges[0].mBegin);
+        APSARA_TEST_EQUAL(1000U, ranges[0].mEnd);
+        APSARA_TEST_EQUAL(0U, ranges[0].mOffset);
+        APSARA_TEST_EQUAL(1000U, ranges[1].mBegin);
+        APSARA_TEST_EQUAL(2001U, ranges[1].mEnd);
+        APSARA_TEST_EQUAL(1500U, ranges[1].mOffset);
+    }
+    {
+        // one range finished
+        APSARA_TEST_TRUE(sManager->UpdateCurrentFileRangeCheckpoint("test_config_1", 0, 1, 2001));
+        const auto& cpt = sManager->mInputCheckpointMap.at(make_pair("test_config_1", 0));
+        APSARA_TEST_EQUAL(0U, cpt.mCurrentFileIndex);
+        APSARA_TEST_EQUAL(1001U, cpt.mFileCheckpoints[0].mOffset);
+        APSARA_TEST_EQUAL(FileStatus::READING, cpt.mFileCheckpoints[0].mStatus);
+    }
+    {
+        // all ranges finished
+        APSARA_TEST_TRUE(sManager->UpdateCurrentFileRangeCheckpoint("test_config_1", 0, 0, 1000));
+        const auto& cpt = sManager->mInputCheckpointMap.at(make_pair("test_config_1", 0));
+        APSARA_TEST_EQUAL(1U, cpt.mCurrentFileIndex);
+        APSARA_TEST_EQUAL(2001U, cpt.mFileCheckpoints[0].mOffset);
+        APSARA_TEST_EQUAL(FileStatus::FINISHED, cpt.mFileCheckpoints[0].mStatus);
+        APSARA_TEST_TRUE(cpt.mFileCheckpoints[0].mRanges.empty());
+        vector<FileRangeCheckpoint> ranges;
+        APSARA_TEST_TRUE(sManager->GetCurrentFileRanges("test_config_1", 0, &ranges));
+        APSARA_TEST_TRUE(ranges.empty());
+        // stale range of the finished file
+        APSARA_TEST_FALSE(sManager->UpdateCurrentFileRangeCheckpoint("test_config_1", 0, 0, 1000));
+    }
+    filesystem::remove_all("test_logs");
+}
+
 void InputStaticFileCheckpointManagerUnittest::TestCheckpointFileNames() const {
     // valid checkpoint root path
     filesystem::create_directories(sManager->mCheckpointRootPath / "dir");
@@ -637,6 +708,7 @@ void InputStaticFileCheckpointManagerUnittest::TestInvalidCheckpointFile() const
 
 UNIT_TEST_CASE(InputStaticFileCheckpointManagerUnittest, TestUpdateCheckpointMap)
 UNIT_TEST_CASE(InputStaticFileCheckpointManagerUnittest, TestUpdateCheckpoint)
+UNIT_TEST_CASE(InputStaticFileCheckpointManagerUnittest, TestUpdateRangeCheckpoint)
 UNIT_TEST_CASE(InputStaticFileCheckpointManagerUnittest, TestCheckpointFileNames)
 UNIT_TEST_CASE(InputStaticFileCheckpointManagerUnittest, TestDumpCheckpoints)
 UNIT_TEST_CASE(InputStaticFileCheckpointManagerUnittest, TestInvalidCheckpointFile)
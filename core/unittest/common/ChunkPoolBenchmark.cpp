@@ -0,0 +1,150 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <malloc.h>
+
+#include <cmath>
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "common/Flags.h"
+#include "common/memory/ChunkPool.h"
+#include "common/memory/SourceBuffer.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(source_buffer_chunk_pool_max_mb);
+
+using namespace std;
+
+namespace logtail {
+
+class ChunkPoolBenchmark : public testing::Test {
+public:
+    void TestAllocateAndFree();
+    void TestRssStability();
+
+private:
+    // source buffers are filled by one thread and released by another, as inputs and flushers do
+    static double RunPipeline(size_t groupCnt, size_t inflightCnt, size_t maxStringSize, size_t seed);
+    static size_t GetRssKB();
+};
+
+double ChunkPoolBenchmark::RunPipeline(size_t groupCnt, size_t inflightCnt, size_t maxStringSize, size_t seed) {
+    mutex mux;
+    condition_variable cv;
+    deque<unique_ptr<SourceBuffer>> queue;
+    bool finished = false;
+
+    thread consumer([&]() {
+        unique_lock<mutex> lock(mux);
+        while (!finished || !queue.empty()) {
+            cv.wait(lock, [&]() { return finished || !queue.empty(); });
+            while (!queue.empty()) {
+                auto buffer = std::move(queue.front());
+                queue.pop_front();
+                lock.unlock();
+                buffer.reset();
+                lock.lock();
+            }
+            cv.notify_all();
+        }
+    });
+
+    mt19937 generator(seed);
+    uniform_int_distribution<size_t> sizeDistribution(1, maxStringSize);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < groupCnt; ++i) {
+        auto buffer = make_unique<SourceBuffer>();
+        for (size_t j = 0; j < 64; ++j) {
+            buffer->AllocateStringBuffer(sizeDistribution(generator));
+        }
+        unique_lock<mutex> lock(mux);
+        cv.wait(lock, [&]() { return queue.size() < inflightCnt; });
+        queue.push_back(std::move(buffer));
+        cv.notify_all();
+    }
+    {
+        lock_guard<mutex> lock(mux);
+        finished = true;
+    }
+    cv.notify_all();
+    consumer.join();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+size_t ChunkPoolBenchmark::GetRssKB() {
+    size_t size = 0, resident = 0;
+    ifstream fin("/proc/self/statm");
+    fin >> size >> resident;
+    return resident * 4;
+}
+
+/*
+[ RUN      ] ChunkPoolBenchmark.TestAllocateAndFree
+pool disabled: 200000 groups in 1.56046 seconds, 128167 groups/s
+pool enabled: 200000 groups in 0.679374 seconds, 294388 groups/s
+*/
+void ChunkPoolBenchmark::TestAllocateAndFree() {
+    static const size_t kGroupCnt = 200000;
+    int32_t maxMb = INT32_FLAG(source_buffer_chunk_pool_max_mb);
+    for (bool enabled : {false, true}) {
+        // with a zero cap, chunks are freed as soon as the thread caches are full
+        INT32_FLAG(source_buffer_chunk_pool_max_mb) = enabled ? maxMb : 0;
+        double elapsed = RunPipeline(kGroupCnt, 16, 1024, 0);
+        cout << "pool " << (enabled ? "enabled" : "disabled") << ": " << kGroupCnt << " groups in " << elapsed
+             << " seconds, " << static_cast<size_t>(kGroupCnt / elapsed) << " groups/s" << endl;
+    }
+    INT32_FLAG(source_buffer_chunk_pool_max_mb) = maxMb;
+}
+
+// a day compressed into 24 rounds, with the data rate and the size of logs following a daily curve, and the idle chunks
+// trimmed at the end of each round, the rss should go back to the same level each night
+/*
+hour 0: load 0.1, 418042 groups/s, idle chunks 1688KB, rss 8216KB
+hour 6: load 0.55, 182009 groups/s, idle chunks 18406KB, rss 20540KB
+hour 12: load 1, 174848 groups/s, idle chunks 58878KB, rss 48996KB
+hour 18: load 0.55, 192832 groups/s, idle chunks 18692KB, rss 27436KB
+hour 23: load 0.115333, 293181 groups/s, idle chunks 1280KB, rss 8984KB
+*/
+void ChunkPoolBenchmark::TestRssStability() {
+    static const size_t kBaseGroupCnt = 20000;
+    auto* pool = ChunkPool::GetInstance();
+    for (size_t hour = 0; hour < 24; ++hour) {
+        double load = 0.55 + 0.45 * sin((static_cast<double>(hour) - 6) / 24 * 2 * M_PI);
+        size_t groupCnt = static_cast<size_t>(kBaseGroupCnt * load);
+        size_t inflightCnt = static_cast<size_t>(256 * load) + 1;
+        size_t maxStringSize = static_cast<size_t>(4096 * load) + 64;
+        double elapsed = RunPipeline(groupCnt, inflightCnt, maxStringSize, hour);
+        pool->Trim();
+        // as tcmalloc releases free memory periodically in the agent
+        malloc_trim(0);
+        cout << "hour " << hour << ": load " << load << ", " << static_cast<size_t>(groupCnt / elapsed)
+             << " groups/s, idle chunks " << pool->GetIdleBytes() / 1024 << "KB, rss " << GetRssKB() << "KB" << endl;
+    }
+}
+
+UNIT_TEST_CASE(ChunkPoolBenchmark, TestAllocateAndFree)
+UNIT_TEST_CASE(ChunkPoolBenchmark, TestRssStability)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,288 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "common/Flags.h"
+#include "common/memory/ChunkPool.h"
+#include "common/memory/SourceBuffer.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(source_buffer_chunk_pool_max_mb);
+
+using namespace std;
+
+namespace logtail {
+
+class ChunkPoolUnittest : public testing::Test {
+public:
+    void TestSizeClass();
+    void TestRecycle();
+    void TestRecycleAcrossThreads();
+    void TestCap();
+    void TestTrim();
+    void TestThreadCacheLimit();
+    void TestTrimThreadCache();
+    void TestSourceBuffer();
+
+protected:
+    void TearDown() override {
+        INT32_FLAG(source_buffer_chunk_pool_max_mb) = 64;
+        // free all chunks in the shared lists and the thread caches
+        auto* pool = ChunkPool::GetInstance();
+        for (size_t i = 0; i < ChunkPool::sClassCount; ++i) {
+            pool->mLowWatermarks[i] = pool->mChunks[i].size();
+        }
+        for (auto* cache : pool->mThreadCaches) {
+            cache->mIsUsedSinceTrim = false;
+        }
+        pool->Trim();
+    }
+
+private:
+    // allocates and frees chunks in a new thread, which returns its cached chunks to the shared lists on exit
+    static set<uint8_t*> FreeInThread(size_t size, size_t count) {
+        set<uint8_t*> res;
+        thread t([&]() {
+            vector<uint8_t*> chunks;
+            for (size_t i = 0; i < count; ++i) {
+                size_t capacity = size;
+                chunks.push_back(ChunkPool::GetInstance()->Allocate(capacity));
+                res.insert(chunks.back());
+            }
+            for (auto* chunk : chunks) {
+                ChunkPool::GetInstance()->Free(chunk, size);
+            }
+        });
+        t.join();
+        return res;
+    }
+};
+
+void ChunkPoolUnittest::TestSizeClass() {
+    APSARA_TEST_EQUAL(0U, ChunkPool::GetClassIndex(1));
+    APSARA_TEST_EQUAL(1024U, ChunkPool::GetClassSize(ChunkPool::GetClassIndex(1000)));
+    APSARA_TEST_EQUAL(1280U, ChunkPool::GetClassSize(ChunkPool::GetClassIndex(1025)));
+    APSARA_TEST_EQUAL(4096U, ChunkPool::GetClassSize(ChunkPool::GetClassIndex(4096)));
+    APSARA_TEST_EQUAL(5120U, ChunkPool::GetClassSize(ChunkPool::GetClassIndex(4097)));
+    APSARA_TEST_EQUAL(ChunkPool::sClassCount - 1, ChunkPool::GetClassIndex(ChunkPool::sMaxChunkSize));
+    for (size_t i = 0; i < ChunkPool::sClassCount; ++i) {
+        size_t size = ChunkPool::GetClassSize(i);
+        APSARA_TEST_EQUAL(i, ChunkPool::GetClassIndex(size));
+        if (i + 1 < ChunkPool::sClassCount) {
+            APSARA_TEST_EQUAL(i + 1, ChunkPool::GetClassIndex(size + 1));
+            // at most a quarter is wasted by rounding
+            APSARA_TEST_TRUE(ChunkPool::GetClassSize(i + 1) - size <= size / 4);
+        }
+    }
+
+    // not pooled
+    size_t size = ChunkPool::sMaxChunkSize + 1;
+    auto* chunk = ChunkPool::GetInstance()->Allocate(size);
+    APSARA_TEST_EQUAL(ChunkPool::sMaxChunkSize + 1, size);
+    ChunkPool::GetInstance()->Free(chunk, size);
+    APSARA_TEST_EQUAL(0U, ChunkPool::GetInstance()->GetIdleBytes());
+}
+
+void ChunkPoolUnittest::TestRecycle() {
+    auto* pool = ChunkPool::GetInstance();
+    size_t size = 3000;
+    auto* chunk = pool->Allocate(size);
+    APSARA_TEST_EQUAL(3072U, size);
+    pool->Free(chunk, size);
+
+    // from the thread cache
+    size_t other = 2900;
+    APSARA_TEST_EQUAL(chunk, pool->Allocate(other));
+    APSARA_TEST_EQUAL(3072U, other);
+    APSARA_TEST_EQUAL(0U, pool->GetIdleBytes());
+    pool->Free(chunk, other);
+    // still idle while cached by the thread
+    APSARA_TEST_EQUAL(3072U, pool->GetIdleBytes());
+}
+
+void ChunkPoolUnittest::TestRecycleAcrossThreads() {
+    static const size_t kSize = 16 * 1024;
+    auto* pool = ChunkPool::GetInstance();
+    auto chunks = FreeInThread(kSize, 10);
+    APSARA_TEST_EQUAL(10 * kSize, pool->GetIdleBytes());
+
+    // chunks released by other threads are reused
+    size_t size = kSize;
+    auto* chunk = pool->Allocate(size);
+    APSARA_TEST_TRUE(chunks.find(chunk) != chunks.end());
+    // the thread cache is refilled in batch
+    APSARA_TEST_EQUAL(6 * kSize, pool->mIdleBytes.load());
+    APSARA_TEST_EQUAL(9 * kSize, pool->GetIdleBytes());
+    pool->Free(chunk, size);
+}
+
+void ChunkPoolUnittest::TestCap() {
+    static const size_t kSize = 256 * 1024;
+    INT32_FLAG(source_buffer_chunk_pool_max_mb) = 1;
+    auto* pool = ChunkPool::GetInstance();
+    FreeInThread(kSize, 10);
+    APSARA_TEST_EQUAL(4 * kSize, pool->GetIdleBytes());
+    FreeInThread(kSize / 2, 10);
+    APSARA_TEST_EQUAL(4 * kSize, pool->GetIdleBytes());
+}
+
+void ChunkPoolUnittest::TestTrim() {
+    static const size_t kSize = 16 * 1024;
+    auto* pool = ChunkPool::GetInstance();
+    FreeInThread(kSize, 10);
+    APSARA_TEST_EQUAL(10 * kSize, pool->GetIdleBytes());
+
+    // chunks stay for at least a whole period
+    pool->Trim();
+    APSARA_TEST_EQUAL(10 * kSize, pool->GetIdleBytes());
+
+    // only chunks idle during the whole period are freed
+    thread t([&]() {
+        vector<uint8_t*> chunks;
+        for (size_t i = 0; i < 4; ++i) {
+            size_t size = kSize;
+            chunks.push_back(pool->Allocate(size));
+        }
+        for (auto* chunk : chunks) {
+            pool->Free(chunk, kSize);
+        }
+    });
+    t.join();
+    APSARA_TEST_EQUAL(10 * kSize, pool->GetIdleBytes());
+    pool->Trim();
+    APSARA_TEST_EQUAL(4 * kSize, pool->GetIdleBytes());
+    pool->Trim();
+    APSARA_TEST_EQUAL(0U, pool->GetIdleBytes());
+}
+
+void ChunkPoolUnittest::TestThreadCacheLimit() {
+    auto* pool = ChunkPool::GetInstance();
+    thread t([&]() {
+        // two chunks of each class from 256KB to 448KB, which are within the limit of each class
+        vector<pair<uint8_t*, size_t>> chunks;
+        size_t totalBytes = 0;
+        for (size_t size = 256 * 1024; size <= 448 * 1024; size += 64 * 1024) {
+            for (size_t i = 0; i < 2; ++i) {
+                size_t capacity = size;
+                chunks.emplace_back(pool->Allocate(capacity), capacity);
+                totalBytes += capacity;
+            }
+        }
+        for (const auto& item : chunks) {
+            pool->Free(item.first, item.second);
+        }
+
+        auto* cache = ChunkPool::GetThreadCache();
+        size_t cachedBytes = 0;
+        for (size_t i = 0; i < ChunkPool::sClassCount; ++i) {
+            cachedBytes += cache->mChunks[i].size() * ChunkPool::GetClassSize(i);
+        }
+        APSARA_TEST_EQUAL(cachedBytes, cache->mBytes.load());
+        APSARA_TEST_TRUE(cachedBytes <= 1024 * 1024);
+        // the rest are moved to the shared lists
+        APSARA_TEST_EQUAL(totalBytes, pool->GetIdleBytes());
+    });
+    t.join();
+}
+
+void ChunkPoolUnittest::TestTrimThreadCache() {
+    static const size_t kSize = 16 * 1024;
+    auto* pool = ChunkPool::GetInstance();
+    mutex mux;
+    condition_variable cv;
+    bool isCached = false;
+    bool isDone = false;
+    // the thread stays alive but stops using the pool
+    thread t([&]() {
+        vector<uint8_t*> chunks;
+        for (size_t i = 0; i < 4; ++i) {
+            size_t size = kSize;
+            chunks.push_back(pool->Allocate(size));
+        }
+        for (auto* chunk : chunks) {
+            pool->Free(chunk, kSize);
+        }
+        unique_lock<mutex> lock(mux);
+        isCached = true;
+        cv.notify_all();
+        cv.wait(lock, [&]() { return isDone; });
+    });
+    {
+        unique_lock<mutex> lock(mux);
+        cv.wait(lock, [&]() { return isCached; });
+    }
+    APSARA_TEST_EQUAL(4 * kSize, pool->GetIdleBytes());
+
+    // the thread cache has been used during the period
+    pool->Trim();
+    APSARA_TEST_EQUAL(4 * kSize, pool->GetIdleBytes());
+    // and then stays idle during the whole period
+    pool->Trim();
+    APSARA_TEST_EQUAL(0U, pool->GetIdleBytes());
+
+    {
+        lock_guard<mutex> lock(mux);
+        isDone = true;
+    }
+    cv.notify_all();
+    t.join();
+    APSARA_TEST_EQUAL(0U, pool->GetIdleBytes());
+}
+
+void ChunkPoolUnittest::TestSourceBuffer() {
+    static const size_t kSize = 512 * 1024;
+    auto* pool = ChunkPool::GetInstance();
+    auto chunks = FreeInThread(kSize, 2);
+
+    // chunks released by groups in other threads are reused by new groups
+    auto buffer = make_unique<SourceBuffer>(kSize);
+    APSARA_TEST_TRUE(chunks.find(buffer->mAllocator.mAllocatedChunks[0].first) != chunks.end());
+
+    // the space left by rounding a large allocation up is used by later allocations
+    buffer->AllocateStringBuffer(kSize - 1024);
+    buffer->AllocateStringBuffer(kSize + 1024 * 10);
+    APSARA_TEST_EQUAL(2U, buffer->mAllocator.mAllocatedChunks.size());
+    APSARA_TEST_EQUAL(kSize + kSize / 4, buffer->mAllocator.mAllocatedChunks[1].second);
+    auto* ptr = buffer->mAllocator.mAllocatedChunks[1].first;
+    auto sb = buffer->AllocateStringBuffer(100);
+    APSARA_TEST_TRUE(reinterpret_cast<uint8_t*>(sb.data) > ptr);
+    APSARA_TEST_TRUE(reinterpret_cast<uint8_t*>(sb.data) < ptr + kSize + kSize / 4);
+    APSARA_TEST_EQUAL(2U, buffer->mAllocator.mAllocatedChunks.size());
+
+    size_t idleBytes = pool->GetIdleBytes();
+    size_t sharedIdleBytes = pool->mIdleBytes.load();
+    buffer.reset();
+    // returned to the thread cache, except for the chunk beyond the limit of the thread cache
+    APSARA_TEST_EQUAL(idleBytes + kSize + kSize + kSize / 4, pool->GetIdleBytes());
+    APSARA_TEST_EQUAL(kSize, ChunkPool::GetThreadCache()->mBytes.load());
+    APSARA_TEST_EQUAL(sharedIdleBytes + kSize + kSize / 4, pool->mIdleBytes.load());
+}
+
+UNIT_TEST_CASE(ChunkPoolUnittest, TestSizeClass)
+UNIT_TEST_CASE(ChunkPoolUnittest, TestRecycle)
+UNIT_TEST_CASE(ChunkPoolUnittest, TestRecycleAcrossThreads)
+UNIT_TEST_CASE(ChunkPoolUnittest, TestCap)
+UNIT_TEST_CASE(ChunkPoolUnittest, TestTrim)
+UNIT_TEST_CASE(ChunkPoolUnittest, TestThreadCacheLimit)
+UNIT_TEST_CASE(ChunkPoolUnittest, TestTrimThreadCache)
+UNIT_TEST_CASE(ChunkPoolUnittest, TestSourceBuffer)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,299 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "openssl/evp.h"
+#include "openssl/ssl.h"
+#include "openssl/x509.h"
+
+#include "common/http/AsynCurlRunner.h"
+#include "common/http/Curl.h"
+#include "common/http/CurlHandlePool.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+static const size_t kThreadCnt = 4;
+static const size_t kRequestCntPerThread = 250;
+static const size_t kAsynRequestCnt = 1000;
+
+// a local https server with a self-signed certificate, which answers each request on a keep-alive connection with a
+// small body, and counts accepted connections and resumed tls sessions, i.e., full and abbreviated handshakes
+class MockTLSServer {
+public:
+    bool Start() {
+        if (!InitSSLContext()) {
+            return false;
+        }
+        mListenFd = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(mListenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (bind(mListenFd, reinterpret_cast<sockaddr*>(&addr), len) != 0 || listen(mListenFd, 1024) != 0
+            || getsockname(mListenFd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            return false;
+        }
+        mPort = ntohs(addr.sin_port);
+        mIsRunning = true;
+        mAcceptThread = thread(&MockTLSServer::Accept, this);
+        return true;
+    }
+
+    void Stop() {
+        mIsRunning = false;
+        if (mAcceptThread.joinable()) {
+            mAcceptThread.join();
+        }
+        vector<thread> threads;
+        {
+            lock_guard<mutex> lock(mMux);
+            for (auto fd : mConnFds) {
+                shutdown(fd, SHUT_RDWR);
+            }
+            threads.swap(mConnThreads);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        close(mListenFd);
+        SSL_CTX_free(mCtx);
+    }
+
+    int32_t GetPort() const { return mPort; }
+
+    void ResetStats() {
+        mConnCnt = 0;
+        mResumedCnt = 0;
+    }
+
+    atomic_size_t mConnCnt = 0;
+    atomic_size_t mResumedCnt = 0;
+
+private:
+    bool InitSSLContext() {
+        EVP_PKEY* key = nullptr;
+        auto* keyCtx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+        if (EVP_PKEY_keygen_init(keyCtx) <= 0
+            || EVP_PKEY_CTX_set_ec_paramgen_curve_nid(keyCtx, NID_X9_62_prime256v1) <= 0
+            || EVP_PKEY_keygen(keyCtx, &key) <= 0) {
+            EVP_PKEY_CTX_free(keyCtx);
+            return false;
+        }
+        EVP_PKEY_CTX_free(keyCtx);
+
+        X509* cert = X509_new();
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+        X509_set_pubkey(cert, key);
+        auto* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char*)"127.0.0.1", -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        X509_sign(cert, key, EVP_sha256());
+
+        mCtx = SSL_CTX_new(TLS_server_method());
+        bool res = SSL_CTX_use_certificate(mCtx, cert) == 1 && SSL_CTX_use_PrivateKey(mCtx, key) == 1;
+        SSL_CTX_set_session_cache_mode(mCtx, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_set_session_id_context(mCtx, (const unsigned char*)"bench", 5);
+        X509_free(cert);
+        EVP_PKEY_free(key);
+        return res;
+    }
+
+    void Accept() {
+        pollfd pfd{mListenFd, POLLIN, 0};
+        while (mIsRunning) {
+            if (poll(&pfd, 1, 10) <= 0) {
+                continue;
+            }
+            int fd = accept(mListenFd, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+            lock_guard<mutex> lock(mMux);
+            ++mConnCnt;
+            mConnFds.push_back(fd);
+            mConnThreads.emplace_back(&MockTLSServer::Serve, this, fd);
+        }
+    }
+
+    void Serve(int fd) {
+        static const string kResponse = "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: 2\r\n\r\nok";
+        SSL* ssl = SSL_new(mCtx);
+        SSL_set_fd(ssl, fd);
+        if (SSL_accept(ssl) == 1) {
+            if (SSL_session_reused(ssl)) {
+                ++mResumedCnt;
+            }
+            string buffer;
+            char buf[4096];
+            int n = 0;
+            while ((n = SSL_read(ssl, buf, sizeof(buf))) > 0) {
+                buffer.append(buf, n);
+                for (auto pos = buffer.find("\r\n\r\n"); pos != string::npos; pos = buffer.find("\r\n\r\n")) {
+                    SSL_write(ssl, kResponse.data(), kResponse.size());
+                    buffer.erase(0, pos + 4);
+                }
+            }
+        }
+        SSL_free(ssl);
+        lock_guard<mutex> lock(mMux);
+        mConnFds.erase(find(mConnFds.begin(), mConnFds.end(), fd));
+        close(fd);
+    }
+
+    SSL_CTX* mCtx = nullptr;
+    int mListenFd = -1;
+    int32_t mPort = 0;
+    atomic_bool mIsRunning = false;
+    thread mAcceptThread;
+
+    mutex mMux;
+    vector<int> mConnFds;
+    vector<thread> mConnThreads;
+};
+
+class BenchmarkRequest : public AsynHttpRequest {
+public:
+    BenchmarkRequest(int32_t port, atomic_size_t& doneCnt, atomic_size_t& failCnt)
+        : AsynHttpRequest("GET", true, "127.0.0.1", port, "/", "", map<string, string>(), ""),
+          mDoneCnt(doneCnt),
+          mFailCnt(failCnt) {}
+
+    bool IsContextValid() const override { return true; }
+    void OnSendDone(HttpResponse& response) override {
+        if (response.GetStatusCode() != 200) {
+            ++mFailCnt;
+        }
+        ++mDoneCnt;
+    }
+
+private:
+    atomic_size_t& mDoneCnt;
+    atomic_size_t& mFailCnt;
+};
+
+// reports requests per second and handshakes against a local https server, with and without handle pooling and the
+// share handle, for both synchronous requests from multiple threads and asynchronous requests via AsynCurlRunner
+class CurlBenchmark : public testing::Test {
+public:
+    void TestSendHttpRequest();
+    void TestAsynRequest();
+
+protected:
+    static void SetUpTestCase() { APSARA_TEST_TRUE_FATAL(sServer.Start()); }
+    static void TearDownTestCase() {
+        CurlHandlePool::GetInstance()->Clear();
+        sServer.Stop();
+    }
+
+private:
+    static void SetReuse(bool reuse);
+    static void Report(const string& name, bool reuse, size_t requestCnt, size_t failCnt, double elapsedMs);
+
+    static MockTLSServer sServer;
+};
+
+MockTLSServer CurlBenchmark::sServer;
+
+void CurlBenchmark::SetReuse(bool reuse) {
+    static CURLSH* sShare = CurlHandlePool::GetInstance()->mShare;
+    static size_t sMaxIdleCntPerEndpoint = CurlHandlePool::GetInstance()->mMaxIdleCntPerEndpoint;
+
+    auto* pool = CurlHandlePool::GetInstance();
+    pool->Clear();
+    pool->mShare = reuse ? sShare : nullptr;
+    pool->mMaxIdleCntPerEndpoint = reuse ? sMaxIdleCntPerEndpoint : 0;
+    sServer.ResetStats();
+}
+
+void CurlBenchmark::Report(const string& name, bool reuse, size_t requestCnt, size_t failCnt, double elapsedMs) {
+    cout << name << (reuse ? " with" : " without") << " reuse: " << requestCnt * 1000 / elapsedMs << " req/s, "
+         << sServer.mConnCnt.load() << " connections, " << sServer.mResumedCnt.load()
+         << " resumed tls sessions, failed " << failCnt << endl;
+    APSARA_TEST_EQUAL(0U, failCnt);
+}
+
+void CurlBenchmark::TestSendHttpRequest() {
+    for (bool reuse : {false, true}) {
+        SetReuse(reuse);
+        atomic_size_t failCnt = 0;
+        auto start = chrono::steady_clock::now();
+        vector<thread> threads;
+        for (size_t t = 0; t < kThreadCnt; ++t) {
+            threads.emplace_back([&failCnt]() {
+                for (size_t i = 0; i < kRequestCntPerThread; ++i) {
+                    HttpResponse response;
+                    auto request = make_unique<HttpRequest>(
+                        "GET", true, "127.0.0.1", sServer.GetPort(), "/", "", map<string, string>(), "", 10, 1);
+                    if (!SendHttpRequest(std::move(request), response) || response.GetStatusCode() != 200) {
+                        ++failCnt;
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        auto elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        Report("SendHttpRequest", reuse, kThreadCnt * kRequestCntPerThread, failCnt.load(), elapsedMs);
+    }
+}
+
+void CurlBenchmark::TestAsynRequest() {
+    for (bool reuse : {false, true}) {
+        SetReuse(reuse);
+        // the multi handle keeps its own connection cache, so it is recreated each round
+        AsynCurlRunner::GetInstance()->Init();
+        atomic_size_t doneCnt = 0;
+        atomic_size_t failCnt = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < kAsynRequestCnt; ++i) {
+            AsynCurlRunner::GetInstance()->AddRequest(
+                make_unique<BenchmarkRequest>(sServer.GetPort(), doneCnt, failCnt));
+        }
+        while (doneCnt.load() < kAsynRequestCnt) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        auto elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        AsynCurlRunner::GetInstance()->Stop();
+        Report("AsynCurlRunner", reuse, kAsynRequestCnt, failCnt.load(), elapsedMs);
+    }
+}
+
+UNIT_TEST_CASE(CurlBenchmark, TestSendHttpRequest)
+UNIT_TEST_CASE(CurlBenchmark, TestAsynRequest)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
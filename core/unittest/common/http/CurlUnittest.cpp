@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "common/http/Curl.h"
+#include "common/http/CurlHandlePool.h"
 #include "common/http/HttpRequest.h"
 #include "common/http/HttpResponse.h"
 #include "unittest/Unittest.h"
@@ -27,6 +28,7 @@ public:
     void TestSendHttpRequest();
     void TestCurlTLS();
     void TestFollowRedirect();
+    void TestHandlePool();
 };
 
 
@@ -99,9 +101,54 @@ void CurlUnittest::TestFollowRedirect() {
     APSARA_TEST_EQUAL(404, res.GetStatusCode());
 }
 
+void CurlUnittest::TestHandlePool() {
+    auto* pool = CurlHandlePool::GetInstance();
+    pool->Clear();
+    auto maxIdleCntPerEndpoint = pool->mMaxIdleCntPerEndpoint;
+    auto maxIdleCnt = pool->mMaxIdleCnt;
+    pool->mMaxIdleCntPerEndpoint = 2;
+    pool->mMaxIdleCnt = 3;
+
+    auto endpoint1 = CurlHandlePool::GetEndpoint(true, "example.com", 443);
+    auto endpoint2 = CurlHandlePool::GetEndpoint(false, "example.com", 80);
+    APSARA_TEST_EQUAL("https://example.com:443", endpoint1);
+    APSARA_TEST_EQUAL("http://example.com:80", endpoint2);
+
+    // handles are reused only for the same endpoint
+    CURL* handle = pool->Acquire(endpoint1);
+    APSARA_TEST_NOT_EQUAL(nullptr, handle);
+    pool->Release(endpoint1, handle);
+    APSARA_TEST_EQUAL(1U, pool->IdleCount());
+    CURL* handle2 = pool->Acquire(endpoint2);
+    APSARA_TEST_NOT_EQUAL(handle, handle2);
+    APSARA_TEST_EQUAL(handle, pool->Acquire(endpoint1));
+    APSARA_TEST_EQUAL(0U, pool->IdleCount());
+    pool->Release(endpoint1, handle);
+    pool->Release(endpoint2, handle2);
+
+    // idle handles are bounded by endpoint and in total
+    vector<CURL*> handles;
+    for (size_t i = 0; i < 3; ++i) {
+        handles.push_back(pool->Acquire(endpoint1));
+    }
+    APSARA_TEST_EQUAL(1U, pool->IdleCount());
+    for (auto* h : handles) {
+        pool->Release(endpoint1, h);
+    }
+    APSARA_TEST_EQUAL(3U, pool->IdleCount());
+    pool->Release(endpoint2, pool->Acquire("http://other:80"));
+    APSARA_TEST_EQUAL(3U, pool->IdleCount());
+
+    pool->Clear();
+    APSARA_TEST_EQUAL(0U, pool->IdleCount());
+    pool->mMaxIdleCntPerEndpoint = maxIdleCntPerEndpoint;
+    pool->mMaxIdleCnt = maxIdleCnt;
+}
+
 UNIT_TEST_CASE(CurlUnittest, TestSendHttpRequest)
 UNIT_TEST_CASE(CurlUnittest, TestCurlTLS)
 UNIT_TEST_CASE(CurlUnittest, TestFollowRedirect)
+UNIT_TEST_CASE(CurlUnittest, TestHandlePool)
 
 } // namespace logtail
 
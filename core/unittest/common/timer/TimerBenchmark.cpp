@@ -0,0 +1,117 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/timer/Timer.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+static const chrono::milliseconds kInterval(1000);
+static const size_t kRounds = 3;
+static const size_t kPushThreadCnt = 8;
+
+struct JitterRecorder {
+    void Record(chrono::steady_clock::duration delay) {
+        lock_guard<mutex> lock(mMux);
+        mDelays.push_back(chrono::duration<double, micro>(delay).count());
+    }
+
+    mutex mMux;
+    vector<double> mDelays;
+};
+
+// a periodic event like the scrape scheduler, which pushes the next round to the timer when executed
+class PeriodicTimerEvent : public TimerEvent {
+public:
+    PeriodicTimerEvent(chrono::steady_clock::time_point execTime, size_t round, JitterRecorder& recorder)
+        : TimerEvent(execTime), mRound(round), mRecorder(recorder) {}
+
+    bool IsValid() const override { return true; }
+    bool Execute() override {
+        mRecorder.Record(chrono::steady_clock::now() - GetExecTime());
+        if (mRound + 1 < kRounds) {
+            Timer::GetInstance()->PushEvent(
+                make_unique<PeriodicTimerEvent>(GetExecTime() + kInterval, mRound + 1, mRecorder));
+        }
+        return true;
+    }
+
+private:
+    size_t mRound;
+    JitterRecorder& mRecorder;
+};
+
+// measures the delay between the exec time and the actual execution of periodic events, whose first exec times are
+// spread evenly over one interval, and the time to push the first round from multiple threads
+class TimerBenchmark : public ::testing::Test {
+public:
+    void TestScheduleJitter10K() { ScheduleJitter(10000); }
+    void TestScheduleJitter100K() { ScheduleJitter(100000); }
+
+protected:
+    static void SetUpTestCase() { Timer::GetInstance()->Init(); }
+    static void TearDownTestCase() { Timer::GetInstance()->Stop(); }
+
+private:
+    void ScheduleJitter(size_t timerCnt);
+};
+
+void TimerBenchmark::ScheduleJitter(size_t timerCnt) {
+    JitterRecorder recorder;
+    recorder.mDelays.reserve(timerCnt * kRounds);
+    auto start = chrono::steady_clock::now() + chrono::milliseconds(100);
+
+    auto pushStart = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (size_t t = 0; t < kPushThreadCnt; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = t; i < timerCnt; i += kPushThreadCnt) {
+                auto execTime = start + kInterval * i / timerCnt;
+                Timer::GetInstance()->PushEvent(make_unique<PeriodicTimerEvent>(execTime, 0, recorder));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto pushCost = chrono::duration<double, milli>(chrono::steady_clock::now() - pushStart).count();
+
+    this_thread::sleep_for(start + kInterval * kRounds - chrono::steady_clock::now() + chrono::milliseconds(500));
+
+    lock_guard<mutex> lock(recorder.mMux);
+    auto& delays = recorder.mDelays;
+    APSARA_TEST_EQUAL(timerCnt * kRounds, delays.size());
+    if (delays.empty()) {
+        return;
+    }
+    sort(delays.begin(), delays.end());
+    cout << timerCnt << " timers: push cost " << pushCost << " ms, delay p50 " << delays[delays.size() / 2]
+         << " us, p99 " << delays[delays.size() * 99 / 100] << " us, max " << delays.back() << " us" << endl;
+}
+
+UNIT_TEST_CASE(TimerBenchmark, TestScheduleJitter10K)
+UNIT_TEST_CASE(TimerBenchmark, TestScheduleJitter100K)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -12,9 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
+#include <thread>
 #include <vector>
 
 #include "common/timer/Timer.h"
+#include "common/timer/TimingWheel.h"
 #include "unittest/Unittest.h"
 
 using namespace std;
@@ -30,9 +33,27 @@ struct TimerEventMock : public TimerEvent {
     bool mIsValid = false;
 };
 
+struct CountingTimerEvent : public TimerEvent {
+    CountingTimerEvent(const chrono::steady_clock::time_point& execTime, atomic_int& cnt)
+        : TimerEvent(execTime), mCnt(cnt) {}
+
+    bool IsValid() const override { return true; }
+    bool Execute() override {
+        if (chrono::steady_clock::now() >= GetExecTime()) {
+            ++mCnt;
+        }
+        return true;
+    }
+
+    atomic_int& mCnt;
+};
+
 class TimerUnittest : public ::testing::Test {
 public:
     void TestPushEvent();
+    void TestTimingWheel();
+    void TestTimingWheelOutOfRange();
+    void TestRun();
     void TestPeriodicEvent();
     void TestGetTimeStamp();
 
@@ -48,16 +69,85 @@ void TimerUnittest::TestPushEvent() {
     timer.PushEvent(make_unique<TimerEventMock>(now + chrono::seconds(1)));
     timer.PushEvent(make_unique<TimerEventMock>(now + chrono::seconds(3)));
 
-    APSARA_TEST_EQUAL(3U, timer.mQueue.size());
-    APSARA_TEST_EQUAL(now + chrono::seconds(1), timer.mQueue.top()->GetExecTime());
-    timer.mQueue.pop();
-    APSARA_TEST_EQUAL(now + chrono::seconds(2), timer.mQueue.top()->GetExecTime());
-    timer.mQueue.pop();
-    APSARA_TEST_EQUAL(now + chrono::seconds(3), timer.mQueue.top()->GetExecTime());
-    timer.mQueue.pop();
+    APSARA_TEST_EQUAL(3U, timer.Size());
+    APSARA_TEST_EQUAL(now + chrono::seconds(1), timer.PopEarliest()->GetExecTime());
+    APSARA_TEST_EQUAL(now + chrono::seconds(2), timer.PopEarliest()->GetExecTime());
+    APSARA_TEST_EQUAL(now + chrono::seconds(3), timer.PopEarliest()->GetExecTime());
+    APSARA_TEST_EQUAL(0U, timer.Size());
+}
+
+void TimerUnittest::TestTimingWheel() {
+    auto now = chrono::steady_clock::now();
+    TimingWheel wheel(100);
+    // level 0, level 1, level 2 and already due
+    vector<uint64_t> ticks = {101, 255, 256, 300, 1000, 65536, 70000, 50};
+    for (auto tick : ticks) {
+        wheel.Add(make_unique<TimerEventMock>(now + chrono::milliseconds(tick)), tick);
+    }
+    APSARA_TEST_EQUAL(ticks.size(), wheel.Size());
+    APSARA_TEST_EQUAL(100U, wheel.NextTick());
+
+    vector<unique_ptr<TimerEvent>> expired;
+    wheel.Advance(100, expired);
+    APSARA_TEST_EQUAL(1U, expired.size());
+    APSARA_TEST_EQUAL(101U, wheel.NextTick());
+
+    vector<uint64_t> expected = {101, 255, 256, 300, 1000, 65536, 70000};
+    for (auto tick : expected) {
+        expired.clear();
+        wheel.Advance(tick - 1, expired);
+        APSARA_TEST_TRUE(expired.empty());
+        APSARA_TEST_TRUE(wheel.NextTick() <= tick);
+        wheel.Advance(tick, expired);
+        APSARA_TEST_EQUAL_FATAL(1U, expired.size());
+        APSARA_TEST_EQUAL(now + chrono::milliseconds(tick), expired[0]->GetExecTime());
+    }
+    APSARA_TEST_TRUE(wheel.Empty());
+    APSARA_TEST_EQUAL(TimingWheel::kMaxTick, wheel.NextTick());
+
+    // jump when empty
+    wheel.Advance(1000000, expired);
+    APSARA_TEST_EQUAL(1000000U, wheel.CurrentTick());
+}
+
+void TimerUnittest::TestTimingWheelOutOfRange() {
+    auto now = chrono::steady_clock::now();
+    TimingWheel wheel;
+    uint64_t far = (uint64_t(1) << 32) + 5;
+    wheel.Add(make_unique<TimerEventMock>(now), far);
+    vector<unique_ptr<TimerEvent>> expired;
+    for (uint64_t tick = 1 << 24; tick < far; tick += 1 << 24) {
+        wheel.Advance(tick, expired);
+        APSARA_TEST_TRUE_FATAL(expired.empty());
+    }
+    wheel.Advance(far - 1, expired);
+    APSARA_TEST_TRUE(expired.empty());
+    wheel.Advance(far, expired);
+    APSARA_TEST_EQUAL(1U, expired.size());
+}
+
+void TimerUnittest::TestRun() {
+    Timer timer;
+    timer.Init();
+    atomic_int cnt = 0;
+    auto now = chrono::steady_clock::now();
+    timer.PushEvent(make_unique<CountingTimerEvent>(now + chrono::milliseconds(300), cnt));
+    timer.PushEvent(make_unique<CountingTimerEvent>(now + chrono::milliseconds(100), cnt));
+    timer.PushEvent(make_unique<CountingTimerEvent>(now - chrono::milliseconds(100), cnt));
+    this_thread::sleep_for(chrono::milliseconds(50));
+    APSARA_TEST_EQUAL(1, cnt.load());
+    this_thread::sleep_for(chrono::milliseconds(100));
+    APSARA_TEST_EQUAL(2, cnt.load());
+    this_thread::sleep_for(chrono::milliseconds(200));
+    APSARA_TEST_EQUAL(3, cnt.load());
+    APSARA_TEST_EQUAL(0U, timer.Size());
+    timer.Stop();
 }
 
 UNIT_TEST_CASE(TimerUnittest, TestPushEvent)
+UNIT_TEST_CASE(TimerUnittest, TestTimingWheel)
+UNIT_TEST_CASE(TimerUnittest, TestTimingWheelOutOfRange)
+UNIT_TEST_CASE(TimerUnittest, TestRun)
 
 } // namespace logtail
 
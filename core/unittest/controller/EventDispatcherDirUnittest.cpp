@@ -16,10 +16,13 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <fstream>
 #include <memory>
 #include <string>
 
+#include "common/FileSystemUtil.h"
 #include "common/Flags.h"
+#include "common/HashUtil.h"
 #include "file_server/EventDispatcher.h"
 #include "file_server/event/Event.h"
 #include "file_server/event_handler/EventHandler.h"
@@ -27,6 +30,7 @@
 using namespace std;
 
 DECLARE_FLAG_STRING(ilogtail_config);
+DECLARE_FLAG_INT32(checkpoint_restore_thread_count);
 
 #if defined(_MSC_VER)
 const char* Basepath = "\\basepath";
@@ -145,11 +149,73 @@ public:
             }
         }
     }
+
+    void TestPrefetchCheckpointFileStates() {
+        LOG_INFO(sLogger, ("TestPrefetchCheckpointFileStates() begin", time(NULL)));
+        auto rootDir = bfs::path(GetProcessExecutionDir()) / "PrefetchCheckpointFileStates";
+        bfs::remove_all(rootDir);
+        bfs::create_directories(rootDir);
+        const string content = "line of the file\n";
+        vector<unique_ptr<CheckPoint>> cpts;
+        for (int i = 0; i < 20; ++i) {
+            string filePath = (rootDir / ("test" + to_string(i) + ".log")).string();
+            { ofstream(filePath) << content; }
+            auto devInode = GetFileDevInode(filePath);
+            uint64_t sigHash = (uint64_t)HashSignatureString(content.c_str(), content.size());
+            if (i % 4 == 1) {
+                // signature changed
+                ++sigHash;
+            } else if (i % 4 == 2) {
+                // inode changed
+                devInode.inode += 1000000;
+            } else if (i % 4 == 3) {
+                // file deleted
+                bfs::remove(filePath);
+            }
+            cpts.emplace_back(new CheckPoint(
+                filePath, filePath, 0, content.size(), sigHash, devInode, "config", filePath, false, false, "", false));
+        }
+        vector<const CheckPoint*> checkpoints;
+        for (const auto& cpt : cpts) {
+            checkpoints.push_back(cpt.get());
+        }
+
+        INT32_FLAG(checkpoint_restore_thread_count) = 4;
+        vector<EventDispatcher::CheckpointFileState> states;
+        size_t missingCnt = EventDispatcher::GetInstance()->PrefetchCheckpointFileStates(checkpoints, states);
+        APSARA_TEST_EQUAL_FATAL(checkpoints.size(), states.size());
+        // 1 of every 4 files is deleted
+        APSARA_TEST_EQUAL(5U, missingCnt);
+        for (size_t i = 0; i < states.size(); ++i) {
+            switch (i % 4) {
+                case 0:
+                    APSARA_TEST_TRUE(checkpoints[i]->mDevInode == states[i].mDevInode);
+                    APSARA_TEST_TRUE(states[i].mSigMatched);
+                    APSARA_TEST_TRUE(states[i].mMtime > 0);
+                    break;
+                case 1:
+                    APSARA_TEST_TRUE(checkpoints[i]->mDevInode == states[i].mDevInode);
+                    APSARA_TEST_FALSE(states[i].mSigMatched);
+                    break;
+                case 2:
+                    APSARA_TEST_TRUE(checkpoints[i]->mDevInode.inode != states[i].mDevInode.inode);
+                    APSARA_TEST_FALSE(states[i].mSigMatched);
+                    break;
+                case 3:
+                    APSARA_TEST_FALSE(states[i].mDevInode.IsValid());
+                    APSARA_TEST_FALSE(states[i].mSigMatched);
+                    break;
+            }
+        }
+        INT32_FLAG(checkpoint_restore_thread_count) = 1;
+        bfs::remove_all(rootDir);
+    }
 };
 
 APSARA_UNIT_TEST_CASE(EventDispatcherDirUnittest, TestFindAllSubDirAndHandler, 0);
 APSARA_UNIT_TEST_CASE(EventDispatcherDirUnittest, TestUnregisterAllDir, 0);
 APSARA_UNIT_TEST_CASE(EventDispatcherDirUnittest, TestStopAllDir, 0);
+APSARA_UNIT_TEST_CASE(EventDispatcherDirUnittest, TestPrefetchCheckpointFileStates, 0);
 } // end of namespace logtail
 
 int main(int argc, char** argv) {
@@ -16,6 +16,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <memory>
 #include <string>
@@ -27,6 +28,9 @@
 #include "common/JsonUtil.h"
 #include "config/CollectionConfig.h"
 #include "file_server/ConfigManager.h"
+#include "file_server/EventDispatcher.h"
+#include "file_server/FileServer.h"
+#include "file_server/checkpoint/CheckPointManager.h"
 #include "file_server/event/Event.h"
 #include "file_server/event_handler/EventHandler.h"
 #include "unittest/Unittest.h"
@@ -43,18 +47,25 @@ public:
         : ModifyHandler(configName, pConfig) {}
     virtual void Handle(const Event& event) { ++handle_count; }
     virtual void HandleTimeOut() { ++handle_timeout_count; }
-    virtual bool DumpReaderMeta(bool isRotatorReader, bool checkConfigFlag) { return true; }
+    virtual bool DumpReaderMeta(bool isRotatorReader, bool checkConfigFlag) {
+        ++dump_count;
+        return true;
+    }
     void Reset() {
         handle_count = 0;
         handle_timeout_count = 0;
+        dump_count = 0;
     }
     int handle_count = 0;
     int handle_timeout_count = 0;
+    int dump_count = 0;
 };
 
 class CreateModifyHandlerUnittest : public ::testing::Test {
 public:
     void TestHandleContainerStoppedEvent();
+    void TestRemoveModifyHandlers();
+    void TestDumpCheckPointForConfigUpdate();
 
 protected:
     static void SetUpTestCase() {
@@ -197,10 +208,84 @@ void CreateModifyHandlerUnittest::TestHandleContainerStoppedEvent() {
     APSARA_TEST_EQUAL_FATAL(pHanlder->handle_count, 2);
 }
 
+void CreateModifyHandlerUnittest::TestRemoveModifyHandlers() {
+    CreateModifyHandler createModifyHandler(&mCreateHandler);
+    const std::string otherConfigName = "##1.0##project-0$config-1";
+    MockModifyHandler* pHanlder = new MockModifyHandler(mConfigName, mConfig);
+    MockModifyHandler* pOtherHanlder = new MockModifyHandler(otherConfigName, mConfig);
+    createModifyHandler.mModifyHandlerPtrMap.insert(std::make_pair(mConfigName, pHanlder));
+    createModifyHandler.mModifyHandlerPtrMap.insert(std::make_pair(otherConfigName, pOtherHanlder));
+
+    createModifyHandler.RemoveModifyHandlers({mConfigName, "not_exist"});
+    // both normal and rotator readers are dumped before removal
+    APSARA_TEST_EQUAL(2, pHanlder->dump_count);
+    APSARA_TEST_EQUAL(0, pOtherHanlder->dump_count);
+    APSARA_TEST_EQUAL(1U, createModifyHandler.mModifyHandlerPtrMap.size());
+    APSARA_TEST_TRUE(createModifyHandler.mModifyHandlerPtrMap.find(otherConfigName)
+                     != createModifyHandler.mModifyHandlerPtrMap.end());
+    // the removed handler is released later
+    auto& handlersToDelete = ConfigManager::GetInstance()->mHandlersToDelete;
+    APSARA_TEST_TRUE(find(handlersToDelete.begin(), handlersToDelete.end(), pHanlder) != handlersToDelete.end());
+    ConfigManager::GetInstance()->DeleteHandlers();
+}
+
+void CreateModifyHandlerUnittest::TestDumpCheckPointForConfigUpdate() {
+    AppConfig::GetInstance()->mCheckPointFilePath = gRootDir + PATH_SEPARATOR + "checkpoint";
+    CreateModifyHandler createModifyHandler(&mCreateHandler);
+    const std::string otherConfigName = "##1.0##project-0$config-1";
+    CollectionPipelineContext otherCtx;
+    otherCtx.SetConfigName(otherConfigName);
+    // each config has a reader of the same file
+    auto addHandler = [&](const std::string& configName, CollectionPipelineContext* readerCtx) {
+        auto* handler = new ModifyHandler(configName, mConfig);
+        auto reader = std::make_shared<LogFileReader>(gRootDir,
+                                                      gLogName,
+                                                      DevInode(),
+                                                      std::make_pair(&readerOpts, readerCtx),
+                                                      std::make_pair(&multilineOpts, readerCtx),
+                                                      std::make_pair(&tagOpts, readerCtx));
+        reader->UpdateReaderManual();
+        APSARA_TEST_TRUE(reader->CheckFileSignatureAndOffset(true));
+        handler->mNameReaderMap[gLogName] = LogFileReaderPtrArray{reader};
+        reader->SetReaderArray(&handler->mNameReaderMap[gLogName]);
+        handler->mDevInodeReaderMap[reader->mDevInode] = reader;
+        createModifyHandler.mModifyHandlerPtrMap.insert(std::make_pair(configName, handler));
+        return reader->mDevInode;
+    };
+    auto devInode = addHandler(mConfigName, &ctx);
+    addHandler(otherConfigName, &otherCtx);
+    auto& dirInfoMap = EventDispatcher::GetInstance()->mWdDirInfoMap;
+    dirInfoMap[0] = new DirInfo(gRootDir, 0, false, &createModifyHandler);
+
+    FileServer::GetInstance()->mUpdatingConfigNames = {mConfigName};
+    FileServer::GetInstance()->DumpCheckPointForConfigUpdate();
+    delete dirInfoMap[0];
+    dirInfoMap.erase(0);
+    FileServer::GetInstance()->mUpdatingConfigNames.clear();
+    ConfigManager::GetInstance()->DeleteHandlers();
+
+    // only the checkpoint of the updated config is restored on resume
+    auto checkPointManager = CheckPointManager::Instance();
+    CheckPointPtr checkPoint;
+    APSARA_TEST_TRUE(checkPointManager->GetCheckPoint(devInode, mConfigName, checkPoint));
+    APSARA_TEST_FALSE(checkPointManager->GetCheckPoint(devInode, otherConfigName, checkPoint));
+
+    // while the checkpoints of the other config are still persisted
+    checkPointManager->RemoveAllCheckPoint();
+    checkPointManager->LoadCheckPoint();
+    APSARA_TEST_TRUE(checkPointManager->GetCheckPoint(devInode, mConfigName, checkPoint));
+    APSARA_TEST_TRUE(checkPointManager->GetCheckPoint(devInode, otherConfigName, checkPoint));
+    DirCheckPointPtr dirCheckPoint;
+    APSARA_TEST_TRUE(checkPointManager->GetDirCheckPoint(gRootDir, dirCheckPoint));
+    checkPointManager->RemoveAllCheckPoint();
+}
+
 std::string CreateModifyHandlerUnittest::gRootDir;
 std::string CreateModifyHandlerUnittest::gLogName;
 
 UNIT_TEST_CASE(CreateModifyHandlerUnittest, TestHandleContainerStoppedEvent);
+UNIT_TEST_CASE(CreateModifyHandlerUnittest, TestRemoveModifyHandlers);
+UNIT_TEST_CASE(CreateModifyHandlerUnittest, TestDumpCheckPointForConfigUpdate);
 } // end of namespace logtail
 
 int main(int argc, char** argv) {
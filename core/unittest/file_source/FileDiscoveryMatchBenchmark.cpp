@@ -0,0 +1,151 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "json/json.h"
+
+#include "collection_pipeline/CollectionPipelineContext.h"
+#include "common/FileSystemUtil.h"
+#include "file_server/FileDiscoveryMatchIndex.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+static const size_t kQueryCnt = 10000;
+
+class FileDiscoveryMatchBenchmark : public ::testing::Test {
+public:
+    void TestMatch_100();
+    void TestMatch_2000();
+    void TestMatch_10000();
+
+protected:
+    void TearDown() override {
+        mIndex.Clear();
+        mAllConfigs.clear();
+        mOptions.clear();
+        mContexts.clear();
+    }
+
+private:
+    void TestMatch(size_t configCnt);
+    void AddConfig(const filesystem::path& filePath, const vector<string>& excludeDirs);
+
+    FileDiscoveryMatchIndex mIndex;
+    vector<unique_ptr<FileDiscoveryOptions>> mOptions;
+    vector<unique_ptr<CollectionPipelineContext>> mContexts;
+    vector<FileDiscoveryConfig> mAllConfigs;
+};
+
+void FileDiscoveryMatchBenchmark::AddConfig(const filesystem::path& filePath, const vector<string>& excludeDirs) {
+    Json::Value configJson;
+    configJson["FilePaths"].append(Json::Value(filePath.string()));
+    configJson["MaxDirSearchDepth"] = Json::Value(3);
+    for (const auto& dir : excludeDirs) {
+        configJson["ExcludeDirs"].append(Json::Value(dir));
+    }
+    mContexts.emplace_back(make_unique<CollectionPipelineContext>());
+    mContexts.back()->SetConfigName("config_" + to_string(mContexts.size()));
+    mOptions.emplace_back(make_unique<FileDiscoveryOptions>());
+    APSARA_TEST_TRUE_FATAL(mOptions.back()->Init(configJson, *mContexts.back(), "test"));
+    mAllConfigs.emplace_back(mOptions.back().get(), mContexts.back().get());
+    mIndex.Add(mContexts.back()->GetConfigName(), mAllConfigs.back());
+}
+
+void FileDiscoveryMatchBenchmark::TestMatch(size_t configCnt) {
+    // a shared node: most configs collect their own service dir, some use wildcard and blacklist
+    auto root = filesystem::current_path() / "data";
+    for (size_t i = 0; i < configCnt; ++i) {
+        auto svc = "svc" + to_string(i);
+        switch (i % 10) {
+            case 0:
+                AddConfig(root / "*" / svc / "*.log", {});
+                break;
+            case 1:
+                AddConfig(root / svc / "logs" / "*.log", {(root / svc / "logs" / "archive").string()});
+                break;
+            case 2:
+                AddConfig(root / svc / "logs" / "access*.txt", {});
+                break;
+            default:
+                AddConfig(root / svc / "logs" / "*.log", {});
+                break;
+        }
+    }
+    vector<pair<string, string>> queries;
+    for (size_t i = 0; i < kQueryCnt; ++i) {
+        auto dir = root / ("svc" + to_string(i * 7919 % configCnt)) / "logs";
+        if (i % 5 == 0) {
+            dir /= "sub";
+        }
+        queries.emplace_back(NormalizeNativePath(dir.string()), "app-" + to_string(i) + ".log");
+    }
+
+    size_t linearMatched = 0, indexMatched = 0;
+    auto start = chrono::high_resolution_clock::now();
+    for (const auto& query : queries) {
+        for (const auto& config : mAllConfigs) {
+            if (config.first->IsMatch(query.first, query.second)) {
+                ++linearMatched;
+            }
+        }
+    }
+    chrono::duration<double, milli> linearElapsed = chrono::high_resolution_clock::now() - start;
+
+    start = chrono::high_resolution_clock::now();
+    vector<FileDiscoveryConfig> candidates;
+    for (const auto& query : queries) {
+        candidates.clear();
+        mIndex.GetCandidates(query.first, query.second, candidates);
+        for (const auto& config : candidates) {
+            if (config.first->IsMatch(query.first, query.second)) {
+                ++indexMatched;
+            }
+        }
+    }
+    chrono::duration<double, milli> indexElapsed = chrono::high_resolution_clock::now() - start;
+
+    cout << "config count: " << configCnt << ", query count: " << kQueryCnt << endl;
+    cout << "linear match elapsed: " << linearElapsed.count() << " ms" << endl;
+    cout << "index match elapsed: " << indexElapsed.count() << " ms" << endl;
+    APSARA_TEST_EQUAL(linearMatched, indexMatched);
+}
+
+void FileDiscoveryMatchBenchmark::TestMatch_100() {
+    TestMatch(100);
+}
+
+void FileDiscoveryMatchBenchmark::TestMatch_2000() {
+    TestMatch(2000);
+}
+
+void FileDiscoveryMatchBenchmark::TestMatch_10000() {
+    TestMatch(10000);
+}
+
+UNIT_TEST_CASE(FileDiscoveryMatchBenchmark, TestMatch_100)
+UNIT_TEST_CASE(FileDiscoveryMatchBenchmark, TestMatch_2000)
+UNIT_TEST_CASE(FileDiscoveryMatchBenchmark, TestMatch_10000)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
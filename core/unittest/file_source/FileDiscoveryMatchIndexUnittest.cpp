@@ -0,0 +1,186 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "json/json.h"
+
+#include "collection_pipeline/CollectionPipelineContext.h"
+#include "common/FileSystemUtil.h"
+#include "file_server/FileDiscoveryMatchIndex.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class FileDiscoveryMatchIndexUnittest : public testing::Test {
+public:
+    void TestGetCandidates();
+    void TestAddAndRemove();
+
+protected:
+    void SetUp() override { mRoot = NormalizeNativePath((filesystem::current_path() / "match_index").string()); }
+
+private:
+    FileDiscoveryOptions* AddConfig(const string& name,
+                                    const filesystem::path& filePath,
+                                    const vector<string>& excludeDirs = {});
+    // the configs matched by IsMatch among @configs
+    set<string> GetMatchedConfigs(const vector<FileDiscoveryConfig>& configs, const string& path, const string& name);
+
+    string mRoot;
+    FileDiscoveryMatchIndex mIndex;
+    vector<unique_ptr<FileDiscoveryOptions>> mOptions;
+    vector<unique_ptr<CollectionPipelineContext>> mContexts;
+    vector<FileDiscoveryConfig> mAllConfigs;
+};
+
+void FileDiscoveryMatchIndexUnittest::TestGetCandidates() {
+    filesystem::path root(mRoot);
+    AddConfig("app", root / "app" / "*.log");
+    AddConfig("app_sub", root / "app" / "sub" / "*.log");
+    AddConfig("app_excluded", root / "app" / "*.log", {(root / "app" / "tmp").string()});
+    AddConfig("app_txt", root / "app" / "*.txt");
+    AddConfig("other", root / "other" / "*.log");
+    AddConfig("wildcard", root / "*" / "logs" / "*.log");
+    AddConfig("wildcard_mid", root / "app" / "svc?" / "logs" / "*.log");
+    AddConfig("container", root / "container" / "*.log")->SetEnableContainerDiscoveryFlag(true);
+    mIndex.Clear();
+    for (size_t i = 0; i < mAllConfigs.size(); ++i) {
+        mIndex.Add(mAllConfigs[i].second->GetConfigName(), mAllConfigs[i]);
+    }
+
+    vector<pair<filesystem::path, string>> queries = {
+        {root / "app", "a.log"},
+        {root / "app", "a.txt"},
+        {root / "app", ""},
+        {root / "app" / "sub", "a.log"},
+        {root / "app" / "tmp", "a.log"},
+        {root / "app" / "svc1" / "logs", "a.log"},
+        {root / "other", "a.log"},
+        {root / "other" / "logs", "a.log"},
+        {root / "another", "a.log"},
+        {root / "container", "a.log"},
+        {root.parent_path(), "a.log"},
+    };
+    auto isContainer = [](const FileDiscoveryConfig& c) { return c.second->GetConfigName() == "container"; };
+    for (const auto& query : queries) {
+        auto path = NormalizeNativePath(query.first.string());
+        vector<FileDiscoveryConfig> candidates;
+        mIndex.GetCandidates(path, query.second, candidates);
+        // same result as evaluating all configs
+        APSARA_TEST_TRUE(GetMatchedConfigs(candidates, path, query.second)
+                         == GetMatchedConfigs(mAllConfigs, path, query.second));
+        // container configs are always candidates
+        APSARA_TEST_TRUE(query.second != "a.log"
+                         || find_if(candidates.begin(), candidates.end(), isContainer) != candidates.end());
+    }
+
+    {
+        // unrelated configs are pruned by base path and file pattern
+        vector<FileDiscoveryConfig> candidates;
+        mIndex.GetCandidates(NormalizeNativePath((root / "other").string()), "a.log", candidates);
+        set<string> names;
+        for (const auto& c : candidates) {
+            names.insert(c.second->GetConfigName());
+        }
+        APSARA_TEST_TRUE(names == set<string>({"other", "wildcard", "container"}));
+    }
+    {
+        // candidates are in the order of addition
+        vector<FileDiscoveryConfig> candidates;
+        mIndex.GetCandidates(NormalizeNativePath((root / "app" / "sub").string()), "a.log", candidates);
+        APSARA_TEST_EQUAL(6U, candidates.size());
+        APSARA_TEST_EQUAL("app", candidates[0].second->GetConfigName());
+        APSARA_TEST_EQUAL("app_sub", candidates[1].second->GetConfigName());
+        APSARA_TEST_EQUAL("app_excluded", candidates[2].second->GetConfigName());
+        APSARA_TEST_EQUAL("wildcard", candidates[3].second->GetConfigName());
+        APSARA_TEST_EQUAL("wildcard_mid", candidates[4].second->GetConfigName());
+        APSARA_TEST_EQUAL("container", candidates[5].second->GetConfigName());
+    }
+}
+
+void FileDiscoveryMatchIndexUnittest::TestAddAndRemove() {
+    filesystem::path root(mRoot);
+    AddConfig("app", root / "app" / "*.log");
+    AddConfig("other", root / "other" / "*.log");
+    mIndex.Clear();
+    mIndex.Add("app", mAllConfigs[0]);
+    mIndex.Add("other", mAllConfigs[1]);
+    APSARA_TEST_EQUAL(2U, mIndex.Size());
+
+    auto appPath = NormalizeNativePath((root / "app").string());
+    vector<FileDiscoveryConfig> candidates;
+    mIndex.GetCandidates(appPath, "a.log", candidates);
+    APSARA_TEST_EQUAL(1U, candidates.size());
+    APSARA_TEST_EQUAL(mAllConfigs[0].first, candidates[0].first);
+
+    // config update replaces the old one
+    mIndex.Add("app", mAllConfigs[1]);
+    APSARA_TEST_EQUAL(2U, mIndex.Size());
+    candidates.clear();
+    mIndex.GetCandidates(appPath, "a.log", candidates);
+    APSARA_TEST_TRUE(candidates.empty());
+
+    mIndex.Remove("app");
+    mIndex.Remove("app");
+    APSARA_TEST_EQUAL(1U, mIndex.Size());
+    candidates.clear();
+    mIndex.GetCandidates(NormalizeNativePath((root / "other").string()), "a.log", candidates);
+    APSARA_TEST_EQUAL(1U, candidates.size());
+    APSARA_TEST_EQUAL(mAllConfigs[1].first, candidates[0].first);
+}
+
+FileDiscoveryOptions* FileDiscoveryMatchIndexUnittest::AddConfig(const string& name,
+                                                                 const filesystem::path& filePath,
+                                                                 const vector<string>& excludeDirs) {
+    Json::Value configJson;
+    configJson["FilePaths"].append(Json::Value(filePath.string()));
+    configJson["MaxDirSearchDepth"] = Json::Value(10);
+    for (const auto& dir : excludeDirs) {
+        configJson["ExcludeDirs"].append(Json::Value(dir));
+    }
+    mContexts.emplace_back(make_unique<CollectionPipelineContext>());
+    mContexts.back()->SetConfigName(name);
+    mOptions.emplace_back(make_unique<FileDiscoveryOptions>());
+    APSARA_TEST_TRUE(mOptions.back()->Init(configJson, *mContexts.back(), "test"));
+    mAllConfigs.emplace_back(mOptions.back().get(), mContexts.back().get());
+    return mOptions.back().get();
+}
+
+set<string> FileDiscoveryMatchIndexUnittest::GetMatchedConfigs(const vector<FileDiscoveryConfig>& configs,
+                                                               const string& path,
+                                                               const string& name) {
+    set<string> res;
+    for (const auto& config : configs) {
+        // container configs need container info to match, which are checked separately
+        if (!config.first->IsContainerDiscoveryEnabled() && config.first->IsMatch(path, name)) {
+            res.insert(config.second->GetConfigName());
+        }
+    }
+    return res;
+}
+
+UNIT_TEST_CASE(FileDiscoveryMatchIndexUnittest, TestGetCandidates)
+UNIT_TEST_CASE(FileDiscoveryMatchIndexUnittest, TestAddAndRemove)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,157 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "collection_pipeline/CollectionPipeline.h"
+#include "collection_pipeline/plugin/PluginRegistry.h"
+#include "collection_pipeline/queue/ProcessQueueManager.h"
+#include "collection_pipeline/queue/QueueKeyManager.h"
+#include "common/JsonUtil.h"
+#include "file_server/StaticFileServer.h"
+#include "file_server/checkpoint/InputStaticFileCheckpointManager.h"
+#include "plugin/input/InputStaticFile.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(static_file_range_reader_thread_num);
+DECLARE_FLAG_INT32(static_file_read_range_size_mb);
+
+using namespace std;
+
+namespace logtail {
+
+static const uint64_t kFileSize = 2ULL * 1024 * 1024 * 1024;
+static const size_t kProcessThreadCnt = 4;
+
+// reads a generated 2GB file through the static file server, sequentially and in ranges with different numbers of
+// range reader threads, while several threads drain the process queue, and reports the read throughput
+class StaticFileServerBenchmark : public testing::Test {
+public:
+    void TestReadSequentially() { Read(0); }
+    void TestReadIn2Ranges() { Read(2); }
+    void TestReadIn4Ranges() { Read(4); }
+    void TestReadIn8Ranges() { Read(8); }
+
+protected:
+    static void SetUpTestCase() {
+        PluginRegistry::GetInstance()->LoadPlugins();
+        filesystem::create_directories("test_logs");
+        ofstream fout(sFilePath, ios_base::binary);
+        string line;
+        for (uint64_t size = 0, i = 0; size < kFileSize; size += line.size(), ++i) {
+            line = "2025-01-01 00:00:00.000 [INFO] [main] request " + to_string(i)
+                + " done, user=admin, method=GET, path=/api/v1/resources, status=200, latency=12ms\n";
+            fout << line;
+        }
+    }
+
+    static void TearDownTestCase() { filesystem::remove_all("test_logs"); }
+
+    void SetUp() override {
+        InputStaticFileCheckpointManager::GetInstance()->mCheckpointRootPath = filesystem::path("./input_static_file");
+        filesystem::create_directories(InputStaticFileCheckpointManager::GetInstance()->mCheckpointRootPath);
+    }
+
+    void TearDown() override {
+        StaticFileServer::GetInstance()->Clear();
+        InputStaticFileCheckpointManager::GetInstance()->mInputCheckpointMap.clear();
+        filesystem::remove_all(InputStaticFileCheckpointManager::GetInstance()->mCheckpointRootPath);
+        ProcessQueueManager::GetInstance()->Clear();
+        INT32_FLAG(static_file_range_reader_thread_num) = 0;
+        INT32_FLAG(static_file_read_range_size_mb) = 256;
+    }
+
+private:
+    void Read(int32_t threadNum);
+
+    static const string sFilePath;
+};
+
+const string StaticFileServerBenchmark::sFilePath = "./test_logs/test_file.log";
+
+void StaticFileServerBenchmark::Read(int32_t threadNum) {
+    INT32_FLAG(static_file_range_reader_thread_num) = threadNum;
+
+    string configName = "test_config_" + to_string(threadNum);
+    CollectionPipeline p;
+    p.mName = configName;
+    p.mPluginID.store(0);
+    CollectionPipelineContext ctx;
+    ctx.SetConfigName(configName);
+    ctx.SetPipeline(p);
+    auto key = QueueKeyManager::GetInstance()->GetKey(configName);
+    ctx.SetProcessQueueKey(key);
+    ProcessQueueManager::GetInstance()->CreateOrUpdateBoundedQueue(key, 0, ctx);
+
+    Json::Value configJson, optionalGoPipeline;
+    configJson["Type"] = Json::Value("input_static_file_onetime");
+    configJson["FilePaths"].append(Json::Value(filesystem::absolute(sFilePath).string()));
+    InputStaticFile input;
+    input.SetContext(ctx);
+    input.CreateMetricsRecordRef(InputFile::sName, "1");
+    input.Init(configJson, optionalGoPipeline);
+    input.CommitMetricsRecordRef();
+
+    // process threads only drop the data, so that reading is the bottleneck
+    atomic_bool isRunning = true;
+    atomic_uint64_t readBytes = 0;
+    vector<thread> processThreads;
+    for (size_t i = 0; i < kProcessThreadCnt; ++i) {
+        processThreads.emplace_back([&isRunning, &readBytes, i]() {
+            while (isRunning) {
+                unique_ptr<ProcessQueueItem> item;
+                string name;
+                if (!ProcessQueueManager::GetInstance()->PopItem(i, item, name)) {
+                    this_thread::sleep_for(chrono::milliseconds(1));
+                    continue;
+                }
+                readBytes += item->mEventGroup.DataSize();
+            }
+        });
+    }
+
+    auto start = chrono::steady_clock::now();
+    input.Start();
+    FileFingerprint fingerprint;
+    while (InputStaticFileCheckpointManager::GetInstance()->GetCurrentFileFingerprint(configName, 0, &fingerprint)) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    auto elapsedSec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    isRunning = false;
+    for (auto& t : processThreads) {
+        t.join();
+    }
+    input.Stop(true);
+
+    cout << (threadNum == 0 ? string("sequentially") : to_string(threadNum) + " range reader threads") << ": "
+         << kFileSize / 1024.0 / 1024.0 / elapsedSec << " MB/s, " << readBytes.load() / 1024 / 1024
+         << " MB event data" << endl;
+    APSARA_TEST_TRUE(readBytes.load() > 0U);
+}
+
+UNIT_TEST_CASE(StaticFileServerBenchmark, TestReadSequentially)
+UNIT_TEST_CASE(StaticFileServerBenchmark, TestReadIn2Ranges)
+UNIT_TEST_CASE(StaticFileServerBenchmark, TestReadIn4Ranges)
+UNIT_TEST_CASE(StaticFileServerBenchmark, TestReadIn8Ranges)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
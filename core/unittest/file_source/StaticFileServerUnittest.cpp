@@ -12,14 +12,24 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
+#include <thread>
+
 #include "collection_pipeline/CollectionPipeline.h"
 #include "collection_pipeline/plugin/PluginRegistry.h"
+#include "collection_pipeline/queue/ProcessQueueManager.h"
+#include "collection_pipeline/queue/QueueKeyManager.h"
 #include "common/JsonUtil.h"
+#include "common/StringTools.h"
+#include "constants/Constants.h"
 #include "file_server/StaticFileServer.h"
 #include "file_server/checkpoint/InputStaticFileCheckpointManager.h"
 #include "plugin/input/InputStaticFile.h"
 #include "unittest/Unittest.h"
 
+DECLARE_FLAG_INT32(static_file_range_reader_thread_num);
+DECLARE_FLAG_INT32(static_file_read_range_size_mb);
+
 using namespace std;
 
 namespace logtail {
@@ -29,6 +39,8 @@ public:
     void TestGetNextAvailableReader() const;
     void TestUpdateInputs() const;
     void TestClearUnusedCheckpoints() const;
+    void TestReadInRanges() const;
+    void TestReadInRangesWithFullQueue() const;
 
 protected:
     static void SetUpTestCase() { PluginRegistry::GetInstance()->LoadPlugins(); }
@@ -48,6 +60,10 @@ protected:
     }
 
 private:
+    // reads a file in ranges and checks that each line is pushed exactly once. if fillQueue is true, the process queue
+    // is kept full by another producer for a while, so that pushes of range readers fail.
+    void ReadInRanges(bool fillQueue) const;
+
     InputStaticFileCheckpointManager* sManager;
     StaticFileServer* sServer;
 };
@@ -186,9 +202,125 @@ void StaticFileServerUnittest::TestClearUnusedCheckpoints() const {
     INT32_FLAG(unused_checkpoints_clear_interval_sec) = 600;
 }
 
+void StaticFileServerUnittest::TestReadInRanges() const {
+    ReadInRanges(false);
+}
+
+void StaticFileServerUnittest::TestReadInRangesWithFullQueue() const {
+    ReadInRanges(true);
+}
+
+void StaticFileServerUnittest::ReadInRanges(bool fillQueue) const {
+    INT32_FLAG(static_file_range_reader_thread_num) = 2;
+    INT32_FLAG(static_file_read_range_size_mb) = 1;
+
+    // prepare test log of about 3.5MB, which is split into 4 ranges
+    const size_t lineCnt = 40000;
+    filesystem::create_directories("test_logs");
+    {
+        ofstream fout("./test_logs/test_file.log", ios_base::binary);
+        for (size_t i = 0; i < lineCnt; ++i) {
+            fout << "line " << i << " " << string(80, 'a') << "\n";
+        }
+    }
+
+    // build input
+    CollectionPipeline p;
+    p.mName = "test_config";
+    p.mPluginID.store(0);
+    CollectionPipelineContext ctx;
+    ctx.SetConfigName("test_config");
+    ctx.SetPipeline(p);
+    auto key = QueueKeyManager::GetInstance()->GetKey("test_config");
+    ctx.SetProcessQueueKey(key);
+    ProcessQueueManager::GetInstance()->CreateOrUpdateBoundedQueue(key, 0, ctx);
+
+    string configStr = R"(
+        {
+            "Type": "input_static_file_onetime",
+            "FilePaths": []
+        }
+    )";
+    string errorMsg;
+    Json::Value configJson, optionalGoPipeline;
+    APSARA_TEST_TRUE(ParseJsonTable(configStr, configJson, errorMsg));
+    configJson["FilePaths"].append(Json::Value(filesystem::absolute("./test_logs/test_file.log").string()));
+    InputStaticFile input;
+    input.SetContext(ctx);
+    input.CreateMetricsRecordRef(InputFile::sName, "1");
+    input.Init(configJson, optionalGoPipeline);
+    input.CommitMetricsRecordRef();
+    input.Start();
+    APSARA_TEST_EQUAL(2U, sServer->mRangeReaderThreadRes.size());
+
+    // push empty groups of another input whenever there is room in the queue, for longer than range readers used to
+    // retry before discarding data
+    atomic_bool isFilling = fillQueue;
+    thread filler([&]() {
+        auto end = chrono::steady_clock::now() + chrono::seconds(3);
+        while (isFilling && chrono::steady_clock::now() < end) {
+            auto item = make_unique<ProcessQueueItem>(PipelineEventGroup(make_shared<SourceBuffer>()), 1);
+            ProcessQueueManager::GetInstance()->PushQueue(key, std::move(item));
+        }
+        isFilling = false;
+    });
+
+    // consume the process queue until all lines are read
+    vector<size_t> lineReadCnts(lineCnt, 0);
+    size_t totalLineCnt = 0;
+    auto start = chrono::steady_clock::now();
+    while (totalLineCnt < lineCnt && chrono::steady_clock::now() - start < chrono::seconds(30)) {
+        unique_ptr<ProcessQueueItem> item;
+        string configName;
+        if (!ProcessQueueManager::GetInstance()->PopItem(0, item, configName)) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+            continue;
+        }
+        if (isFilling) {
+            this_thread::sleep_for(chrono::milliseconds(5));
+        }
+        if (item->mInputIndex == 1) {
+            continue;
+        }
+        for (const auto& event : item->mEventGroup.GetEvents()) {
+            auto content = event.Cast<LogEvent>().GetContent(DEFAULT_CONTENT_KEY);
+            for (const auto& line : SplitString(string(content.data(), content.size()), "\n")) {
+                ++lineReadCnts[stoul(line.substr(5, line.find(' ', 5) - 5))];
+                ++totalLineCnt;
+            }
+        }
+    }
+    isFilling = false;
+    filler.join();
+    APSARA_TEST_EQUAL(lineCnt, totalLineCnt);
+    APSARA_TEST_EQUAL(lineReadCnts.end(), find_if(lineReadCnts.begin(), lineReadCnts.end(), [](size_t cnt) {
+                          return cnt != 1;
+                      }));
+    // the checkpoint is updated after the last data is pushed
+    FileFingerprint fingerprint;
+    while (sManager->GetCurrentFileFingerprint("test_config", 0, &fingerprint)
+           && chrono::steady_clock::now() - start < chrono::seconds(30)) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    {
+        lock_guard<mutex> lock(sManager->mUpdateMux);
+        auto const& cpt = sManager->mInputCheckpointMap.at(make_pair("test_config", 0));
+        APSARA_TEST_EQUAL(StaticFileReadingStatus::FINISHED, cpt.mStatus);
+        APSARA_TEST_EQUAL(FileStatus::FINISHED, cpt.mFileCheckpoints[0].mStatus);
+    }
+
+    input.Stop(true);
+    ProcessQueueManager::GetInstance()->Clear();
+    filesystem::remove_all("test_logs");
+    INT32_FLAG(static_file_range_reader_thread_num) = 0;
+    INT32_FLAG(static_file_read_range_size_mb) = 256;
+}
+
 UNIT_TEST_CASE(StaticFileServerUnittest, TestGetNextAvailableReader)
 UNIT_TEST_CASE(StaticFileServerUnittest, TestUpdateInputs)
 UNIT_TEST_CASE(StaticFileServerUnittest, TestClearUnusedCheckpoints)
+UNIT_TEST_CASE(StaticFileServerUnittest, TestReadInRanges)
+UNIT_TEST_CASE(StaticFileServerUnittest, TestReadInRangesWithFullQueue)
 
 } // namespace logtail
 
@@ -0,0 +1,157 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "json/json.h"
+
+#include "collection_pipeline/CollectionPipeline.h"
+#include "collection_pipeline/CollectionPipelineContext.h"
+#include "collection_pipeline/queue/SLSSenderQueueItem.h"
+#include "common/FileEncryption.h"
+#include "common/FileSystemUtil.h"
+#include "common/Flags.h"
+#include "plugin/flusher/sls/DiskBufferSegment.h"
+#include "plugin/flusher/sls/DiskBufferWriter.h"
+#include "plugin/flusher/sls/FlusherSLS.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_BOOL(enable_disk_buffer_fsync);
+DECLARE_FLAG_INT32(file_encryption_header_length);
+
+using namespace std;
+
+namespace logtail {
+
+static const size_t kItemCnt = 2000;
+static const size_t kItemSize = 64 * 1024;
+static const size_t kBatchSize = 20;
+
+class DiskBufferBenchmark : public ::testing::Test {
+public:
+    void TestWriteAndReplay();
+
+protected:
+    void SetUp() override {
+        mRootDir = (bfs::path(GetProcessExecutionDir()) / "DiskBufferBenchmark").string();
+        bfs::remove_all(mRootDir);
+        bfs::create_directories(mRootDir);
+        DiskBufferWriter::GetInstance()->SetBufferFilePath(mRootDir);
+
+        mCtx.SetConfigName("test_config");
+        mCtx.SetPipeline(mPipeline);
+        Json::Value configJson, optionalGoPipeline;
+        configJson["Type"] = "flusher_sls";
+        configJson["Project"] = "test_project";
+        configJson["Logstore"] = "test_logstore";
+        configJson["Endpoint"] = "test_region.log.aliyuncs.com";
+        mFlusher.reset(new FlusherSLS());
+        mFlusher->SetContext(mCtx);
+        mFlusher->CreateMetricsRecordRef(FlusherSLS::sName, "1");
+        APSARA_TEST_TRUE_FATAL(mFlusher->Init(configJson, optionalGoPipeline));
+        mFlusher->CommitMetricsRecordRef();
+    }
+
+    void TearDown() override { bfs::remove_all(mRootDir); }
+
+private:
+    double Write(bool fsync);
+    double Replay(size_t threadCnt, size_t& recordCnt);
+
+    string mRootDir;
+    CollectionPipeline mPipeline;
+    CollectionPipelineContext mCtx;
+    unique_ptr<FlusherSLS> mFlusher;
+};
+
+double DiskBufferBenchmark::Write(bool fsync) {
+    BOOL_FLAG(enable_disk_buffer_fsync) = fsync;
+    auto writer = DiskBufferWriter::GetInstance();
+    string data(kItemSize, 'a');
+    auto start = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < kItemCnt; i += kBatchSize) {
+        FILE* fout = nullptr;
+        string bufferFileName;
+        for (size_t j = 0; j < kBatchSize; ++j) {
+            SLSSenderQueueItem item(string(data), data.size(), mFlusher.get(), 0, "test_logstore");
+            writer->SendToBufferFile(&item, fout, bufferFileName);
+        }
+        writer->CloseBufferFile(fout, bufferFileName);
+    }
+    chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+    return kItemCnt * kItemSize / 1024.0 / 1024.0 / elapsed.count();
+}
+
+double DiskBufferBenchmark::Replay(size_t threadCnt, size_t& recordCnt) {
+    auto writer = DiskBufferWriter::GetInstance();
+    vector<string> files;
+    writer->LoadFileToSend(time(nullptr) + 1, files);
+    atomic_size_t next(0), cnt(0), bytes(0);
+    auto replay = [&]() {
+        sls_logs::LogtailBufferMeta bufferMeta;
+        for (size_t idx = next++; idx < files.size(); idx = next++) {
+            DiskBufferSegment segment;
+            string filename = writer->GetBufferFilePath() + files[idx];
+            if (!segment.Open(filename, INT32_FLAG(file_encryption_header_length))) {
+                continue;
+            }
+            for (const auto& record : segment.GetRecords()) {
+                writer->ParseBufferMeta(record, filename, bufferMeta);
+                unique_ptr<char[]> des(new char[record.mMeta.mLogDataSize]);
+                FileEncryption::GetInstance()->Decrypt(record.mEncryption,
+                                                       record.mMeta.mEncryptionSize,
+                                                       des.get(),
+                                                       record.mMeta.mLogDataSize,
+                                                       FileEncryption::GetInstance()->GetDefaultKeyVersion());
+                ++cnt;
+                bytes += record.mMeta.mLogDataSize;
+            }
+        }
+    };
+    auto start = chrono::high_resolution_clock::now();
+    vector<future<void>> replayers;
+    for (size_t i = 0; i < threadCnt; ++i) {
+        replayers.emplace_back(async(launch::async, replay));
+    }
+    for (auto& replayer : replayers) {
+        replayer.get();
+    }
+    chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+    recordCnt = cnt;
+    return bytes / 1024.0 / 1024.0 / elapsed.count();
+}
+
+void DiskBufferBenchmark::TestWriteAndReplay() {
+    cout << "item count: " << kItemCnt << ", item size: " << kItemSize << ", batch size: " << kBatchSize << endl;
+    cout << "write without fsync: " << Write(false) << " MB/s" << endl;
+    cout << "write with batched fsync: " << Write(true) << " MB/s" << endl;
+    for (size_t threadCnt : {1, 4}) {
+        size_t recordCnt = 0;
+        double throughput = Replay(threadCnt, recordCnt);
+        cout << "replay with " << threadCnt << " thread(s): " << throughput << " MB/s" << endl;
+        APSARA_TEST_EQUAL(2 * kItemCnt, recordCnt);
+    }
+}
+
+UNIT_TEST_CASE(DiskBufferBenchmark, TestWriteAndReplay)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
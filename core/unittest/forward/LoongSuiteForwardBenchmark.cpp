@@ -0,0 +1,146 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <grpcpp/create_channel.h>
+#include <grpcpp/grpcpp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "collection_pipeline/CollectionPipelineContext.h"
+#include "collection_pipeline/queue/ProcessQueueManager.h"
+#include "collection_pipeline/queue/QueueKeyManager.h"
+#include "forward/GrpcInputManager.h"
+#include "forward/loongsuite/LoongSuiteForwardService.h"
+#include "protobuf/forward/loongsuite.grpc.pb.h"
+#include "runner/ProcessorRunner.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+static const string kAddress = "127.0.0.1:19100";
+static const string kConfigName = "forward_benchmark";
+static const size_t kRequestCnt = 20000;
+static const size_t kDataPerRequest = 4;
+static const size_t kDataSize = 1024;
+
+// compares events/s and p99 latency of the unary Forward with ForwardStream against a local server, where each
+// request is a small batch of data as sent by agents
+class LoongSuiteForwardBenchmark : public ::testing::Test {
+public:
+    void TestUnaryVsStream();
+
+protected:
+    static void SetUpTestCase() {
+        mCtx.SetConfigName(kConfigName);
+        mQueueKey = QueueKeyManager::GetInstance()->GetKey(kConfigName);
+        ProcessQueueManager::GetInstance()->CreateOrUpdateBoundedQueue(mQueueKey, 0, mCtx);
+        // groups are discarded by processor runner since no pipeline exists
+        ProcessorRunner::GetInstance()->Init();
+        GrpcInputManager::GetInstance()->Init();
+    }
+
+    static void TearDownTestCase() {
+        GrpcInputManager::GetInstance()->Stop();
+        ProcessorRunner::GetInstance()->Stop();
+    }
+
+private:
+    static void Report(const string& name, vector<double>& latencies, double elapsedMs);
+
+    static CollectionPipelineContext mCtx;
+    static QueueKey mQueueKey;
+};
+
+CollectionPipelineContext LoongSuiteForwardBenchmark::mCtx;
+QueueKey LoongSuiteForwardBenchmark::mQueueKey;
+
+void LoongSuiteForwardBenchmark::Report(const string& name, vector<double>& latencies, double elapsedMs) {
+    sort(latencies.begin(), latencies.end());
+    double p99 = latencies[latencies.size() * 99 / 100];
+    cout << name << ": " << kRequestCnt * kDataPerRequest * 1000 / elapsedMs << " events/s, p99 latency: " << p99
+         << " us" << endl;
+}
+
+void LoongSuiteForwardBenchmark::TestUnaryVsStream() {
+    Json::Value config;
+    config["QueueKey"] = Json::Value(static_cast<int32_t>(mQueueKey));
+    config["InputIndex"] = Json::Value(0);
+    APSARA_TEST_TRUE_FATAL(
+        GrpcInputManager::GetInstance()->AddListenInput<LoongSuiteForwardServiceImpl>(kConfigName, kAddress, config));
+    this_thread::sleep_for(chrono::milliseconds(200));
+
+    auto stub = LoongSuiteForwardService::NewStub(grpc::CreateChannel(kAddress, grpc::InsecureChannelCredentials()));
+    LoongSuiteForwardRequest request;
+    for (size_t i = 0; i < kDataPerRequest; ++i) {
+        request.add_data(string(kDataSize, 'a' + i));
+    }
+
+    {
+        vector<double> latencies;
+        latencies.reserve(kRequestCnt);
+        size_t failedCnt = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < kRequestCnt; ++i) {
+            grpc::ClientContext context;
+            context.AddMetadata("x-loongsuite-apm-configname", kConfigName);
+            LoongSuiteForwardResponse response;
+            auto reqStart = chrono::steady_clock::now();
+            if (!stub->Forward(&context, request, &response).ok()) {
+                ++failedCnt;
+            }
+            latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - reqStart).count());
+        }
+        Report("unary",
+               latencies,
+               chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        cout << "unary failed requests: " << failedCnt << endl;
+    }
+    {
+        // latency of a streaming request is the time for the write to be accepted, which includes flow control
+        vector<double> latencies;
+        latencies.reserve(kRequestCnt);
+        grpc::ClientContext context;
+        context.AddMetadata("x-loongsuite-apm-configname", kConfigName);
+        LoongSuiteForwardResponse response;
+        auto start = chrono::steady_clock::now();
+        auto writer = stub->ForwardStream(&context, &response);
+        for (size_t i = 0; i < kRequestCnt; ++i) {
+            auto reqStart = chrono::steady_clock::now();
+            if (!writer->Write(request)) {
+                break;
+            }
+            latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - reqStart).count());
+        }
+        writer->WritesDone();
+        auto status = writer->Finish();
+        Report("stream",
+               latencies,
+               chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        APSARA_TEST_TRUE(status.ok());
+        APSARA_TEST_EQUAL(kRequestCnt, latencies.size());
+    }
+}
+
+UNIT_TEST_CASE(LoongSuiteForwardBenchmark, TestUnaryVsStream)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
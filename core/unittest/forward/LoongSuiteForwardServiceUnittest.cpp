@@ -14,19 +14,27 @@
  * limitations under the License.
  */
 
+#include <grpcpp/grpcpp.h>
 #include <json/value.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <thread>
 
+#include "collection_pipeline/queue/ProcessQueueManager.h"
+#include "collection_pipeline/queue/QueueKeyManager.h"
 #include "common/Flags.h"
+#include "common/memory/MemoryBudget.h"
 #include "forward/loongsuite/LoongSuiteForwardService.h"
+#include "models/RawEvent.h"
 #include "protobuf/forward/loongsuite.grpc.pb.h"
 #include "runner/ProcessorRunner.h"
 #include "unittest/Unittest.h"
 
 DECLARE_FLAG_INT32(grpc_server_forward_max_retry_times);
+DECLARE_FLAG_INT32(grpc_server_forward_stream_batch_size_bytes);
+DECLARE_FLAG_INT32(grpc_server_forward_stream_max_blocked_ms);
 
 using namespace std;
 
@@ -54,6 +62,7 @@ public:
     void TestAddToIndexEdgeCases();
     void TestRetryTimeControllerEdgeCases();
     void TestConfigConflicts();
+    void TestAddRawEvents();
 
 protected:
     void SetUp() override {
@@ -373,6 +382,25 @@ void LoongSuiteForwardServiceUnittest::TestForwardWithEmptyData() {
     APSARA_TEST_TRUE_FATAL(reactor != nullptr);
 }
 
+void LoongSuiteForwardServiceUnittest::TestAddRawEvents() {
+    LoongSuiteForwardRequest request;
+    request.add_data("data1");
+    request.add_data("");
+    request.add_data("data_2");
+
+    // requests of a stream are batched into the same group
+    PipelineEventGroup eventGroup(std::make_shared<SourceBuffer>());
+    APSARA_TEST_EQUAL(11U, LoongSuiteForwardServiceImpl::AddRawEvents(request, eventGroup));
+    APSARA_TEST_EQUAL(11U, LoongSuiteForwardServiceImpl::AddRawEvents(request, eventGroup));
+    APSARA_TEST_EQUAL(4U, eventGroup.GetEvents().size());
+    APSARA_TEST_EQUAL("data1", eventGroup.GetEvents()[0].Cast<RawEvent>().GetContent());
+    APSARA_TEST_EQUAL("data_2", eventGroup.GetEvents()[3].Cast<RawEvent>().GetContent());
+
+    request.Clear();
+    APSARA_TEST_EQUAL(0U, LoongSuiteForwardServiceImpl::AddRawEvents(request, eventGroup));
+    APSARA_TEST_EQUAL(4U, eventGroup.GetEvents().size());
+}
+
 void LoongSuiteForwardServiceUnittest::TestAddToIndexEdgeCases() {
     Json::Value config;
     config["QueueKey"] = 1;
@@ -442,6 +470,197 @@ void LoongSuiteForwardServiceUnittest::TestConfigConflicts() {
     APSARA_TEST_EQUAL_FATAL(2, it->second->queueKey);
 }
 
+// ForwardStream against a local server, where the process queue is not consumed unless popped by the test
+class LoongSuiteForwardStreamUnittest : public testing::Test {
+public:
+    void TestFlowControl();
+    void TestUnavailable();
+    void TestCancel();
+    void TestMemoryBudget();
+
+protected:
+    void SetUp() override {
+        mCtx.SetConfigName(kConfigName);
+        mQueueKey = QueueKeyManager::GetInstance()->GetKey(kConfigName);
+        ProcessQueueManager::GetInstance()->CreateOrUpdateBoundedQueue(mQueueKey, 0, mCtx);
+        ProcessQueueManager::GetInstance()->EnablePop(kConfigName);
+        Json::Value config;
+        config["QueueKey"] = Json::Value(static_cast<int32_t>(mQueueKey));
+        config["InputIndex"] = Json::Value(0);
+        APSARA_TEST_TRUE_FATAL(mService.Update(kConfigName, config));
+
+        int port = 0;
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port);
+        builder.RegisterService(&mService);
+        mServer = builder.BuildAndStart();
+        APSARA_TEST_TRUE_FATAL(mServer != nullptr);
+        mStub = LoongSuiteForwardService::NewStub(
+            grpc::CreateChannel("127.0.0.1:" + to_string(port), grpc::InsecureChannelCredentials()));
+        // each request is pushed as a batch
+        INT32_FLAG(grpc_server_forward_stream_batch_size_bytes) = 1;
+    }
+
+    void TearDown() override {
+        mServer->Shutdown();
+        mServer.reset();
+        ProcessQueueManager::GetInstance()->DeleteQueue(mQueueKey);
+        INT32_FLAG(grpc_server_forward_stream_batch_size_bytes) = 512 * 1024;
+        INT32_FLAG(grpc_server_forward_stream_max_blocked_ms) = 30000;
+        MemoryBudget::GetInstance()->SetLimit(0);
+    }
+
+    // writes @cnt requests, each of which has a single data "data_<idx>"
+    static bool Write(grpc::ClientWriter<LoongSuiteForwardRequest>& writer, size_t cnt) {
+        for (size_t i = 0; i < cnt; ++i) {
+            LoongSuiteForwardRequest request;
+            request.add_data("data_" + to_string(i));
+            if (!writer.Write(request)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // pops the process queue until @cnt events are received or timeout
+    static void PopEvents(size_t cnt, vector<string>& events) {
+        auto start = chrono::steady_clock::now();
+        while (events.size() < cnt && chrono::steady_clock::now() - start < chrono::seconds(10)) {
+            unique_ptr<ProcessQueueItem> item;
+            string configName;
+            if (!ProcessQueueManager::GetInstance()->PopItem(0, item, configName)) {
+                this_thread::sleep_for(chrono::milliseconds(1));
+                continue;
+            }
+            for (const auto& event : item->mEventGroup.GetEvents()) {
+                auto content = event.Cast<RawEvent>().GetContent();
+                events.emplace_back(content.data(), content.size());
+            }
+        }
+    }
+
+    static void CheckEvents(const vector<string>& events, size_t cnt) {
+        APSARA_TEST_EQUAL(cnt, events.size());
+        for (size_t i = 0; i < events.size(); ++i) {
+            APSARA_TEST_EQUAL("data_" + to_string(i), events[i]);
+        }
+    }
+
+    static const string kConfigName;
+
+    LoongSuiteForwardServiceImpl mService;
+    unique_ptr<grpc::Server> mServer;
+    unique_ptr<LoongSuiteForwardService::Stub> mStub;
+    CollectionPipelineContext mCtx;
+    QueueKey mQueueKey = 0;
+};
+
+const string LoongSuiteForwardStreamUnittest::kConfigName = "forward_stream_test_config";
+
+void LoongSuiteForwardStreamUnittest::TestFlowControl() {
+    const size_t cnt = 20;
+    atomic_bool isDone = false;
+    grpc::Status status;
+    thread client([&]() {
+        grpc::ClientContext context;
+        context.AddMetadata("x-loongsuite-apm-configname", kConfigName);
+        LoongSuiteForwardResponse response;
+        auto writer = mStub->ForwardStream(&context, &response);
+        Write(*writer, cnt);
+        writer->WritesDone();
+        status = writer->Finish();
+        isDone = true;
+    });
+
+    // the stream is paused instead of failed when the process queue is full
+    this_thread::sleep_for(chrono::milliseconds(500));
+    APSARA_TEST_FALSE(isDone);
+    APSARA_TEST_FALSE(ProcessQueueManager::GetInstance()->IsValidToPush(mQueueKey));
+
+    // and resumed once the queue is consumed
+    vector<string> events;
+    PopEvents(cnt, events);
+    client.join();
+    APSARA_TEST_TRUE(status.ok());
+    CheckEvents(events, cnt);
+}
+
+void LoongSuiteForwardStreamUnittest::TestUnavailable() {
+    INT32_FLAG(grpc_server_forward_stream_max_blocked_ms) = 100;
+    const size_t queueCap = 5;
+
+    grpc::ClientContext context;
+    context.AddMetadata("x-loongsuite-apm-configname", kConfigName);
+    LoongSuiteForwardResponse response;
+    auto writer = mStub->ForwardStream(&context, &response);
+    Write(*writer, queueCap + 3);
+    writer->WritesDone();
+    auto status = writer->Finish();
+    APSARA_TEST_EQUAL(grpc::StatusCode::UNAVAILABLE, status.error_code());
+
+    // the batch blocked is still pushed after the stream fails, while requests not read yet are left to the client
+    vector<string> events;
+    PopEvents(queueCap + 1, events);
+    this_thread::sleep_for(chrono::milliseconds(100));
+    PopEvents(queueCap + 2, events);
+    CheckEvents(events, queueCap + 1);
+}
+
+void LoongSuiteForwardStreamUnittest::TestCancel() {
+    const size_t queueCap = 5;
+
+    grpc::ClientContext context;
+    context.AddMetadata("x-loongsuite-apm-configname", kConfigName);
+    LoongSuiteForwardResponse response;
+    auto writer = mStub->ForwardStream(&context, &response);
+    Write(*writer, queueCap + 1);
+    this_thread::sleep_for(chrono::milliseconds(200));
+    context.TryCancel();
+    auto status = writer->Finish();
+    APSARA_TEST_EQUAL(grpc::StatusCode::CANCELLED, status.error_code());
+
+    // the batch read before cancellation is not dropped
+    vector<string> events;
+    PopEvents(queueCap + 1, events);
+    CheckEvents(events, queueCap + 1);
+}
+
+void LoongSuiteForwardStreamUnittest::TestMemoryBudget() {
+    INT32_FLAG(grpc_server_forward_stream_max_blocked_ms) = 100;
+    // the budget is exceeded by data not buffered by any pipeline, so that all pipelines back off
+    auto* budget = MemoryBudget::GetInstance();
+    budget->Add(MemoryBudget::Category::SOURCE_BUFFER, 1);
+    budget->SetLimit(1);
+    APSARA_TEST_FALSE(ProcessQueueManager::GetInstance()->IsValidToPush(mQueueKey));
+
+    // both forward paths back off, although the queue is empty
+    {
+        grpc::ClientContext context;
+        context.AddMetadata("x-loongsuite-apm-configname", kConfigName);
+        LoongSuiteForwardRequest request;
+        request.add_data("data_0");
+        LoongSuiteForwardResponse response;
+        auto status = mStub->Forward(&context, request, &response);
+        APSARA_TEST_EQUAL(grpc::StatusCode::UNAVAILABLE, status.error_code());
+    }
+    {
+        grpc::ClientContext context;
+        context.AddMetadata("x-loongsuite-apm-configname", kConfigName);
+        LoongSuiteForwardResponse response;
+        auto writer = mStub->ForwardStream(&context, &response);
+        Write(*writer, 2);
+        writer->WritesDone();
+        auto status = writer->Finish();
+        APSARA_TEST_EQUAL(grpc::StatusCode::UNAVAILABLE, status.error_code());
+    }
+    budget->Sub(MemoryBudget::Category::SOURCE_BUFFER, 1);
+
+    // the batch blocked is still pushed after the stream fails
+    vector<string> events;
+    PopEvents(1, events);
+    CheckEvents(events, 1);
+}
+
 UNIT_TEST_CASE(LoongSuiteForwardServiceUnittest, TestServiceName)
 UNIT_TEST_CASE(LoongSuiteForwardServiceUnittest, TestUpdateConfig)
 UNIT_TEST_CASE(LoongSuiteForwardServiceUnittest, TestUpdateConfigWithInvalidParams)
@@ -462,6 +681,11 @@ UNIT_TEST_CASE(LoongSuiteForwardServiceUnittest, TestForwardWithEmptyData)
 UNIT_TEST_CASE(LoongSuiteForwardServiceUnittest, TestAddToIndexEdgeCases)
 UNIT_TEST_CASE(LoongSuiteForwardServiceUnittest, TestRetryTimeControllerEdgeCases)
 UNIT_TEST_CASE(LoongSuiteForwardServiceUnittest, TestConfigConflicts)
+UNIT_TEST_CASE(LoongSuiteForwardServiceUnittest, TestAddRawEvents)
+UNIT_TEST_CASE(LoongSuiteForwardStreamUnittest, TestFlowControl)
+UNIT_TEST_CASE(LoongSuiteForwardStreamUnittest, TestUnavailable)
+UNIT_TEST_CASE(LoongSuiteForwardStreamUnittest, TestCancel)
+UNIT_TEST_CASE(LoongSuiteForwardStreamUnittest, TestMemoryBudget)
 } // namespace logtail
 
 UNIT_TEST_MAIN
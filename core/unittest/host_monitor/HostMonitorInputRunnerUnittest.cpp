@@ -59,7 +59,7 @@ void HostMonitorInputRunnerUnittest::TestUpdateAndRemoveCollector() const {
     APSARA_TEST_FALSE_FATAL(
         runner->IsCollectTaskValid(startTime - std::chrono::seconds(60), configName, MockCollector::sName));
     APSARA_TEST_TRUE_FATAL(runner->HasRegisteredPlugins());
-    APSARA_TEST_EQUAL_FATAL(1, Timer::GetInstance()->mQueue.size());
+    APSARA_TEST_EQUAL_FATAL(1, Timer::GetInstance()->Size());
     runner->RemoveCollector(configName);
     APSARA_TEST_FALSE_FATAL(
         runner->IsCollectTaskValid(startTime + std::chrono::seconds(60), configName, MockCollector::sName));
@@ -76,7 +76,7 @@ void HostMonitorInputRunnerUnittest::TestScheduleOnce() const {
     runner->UpdateCollector(
         configName, {{MockCollector::sName, 1, HostMonitorCollectType::kMultiValue}}, QueueKey{}, 0);
     // UpdateCollector会添加一个定时器事件
-    APSARA_TEST_EQUAL_FATAL(1, Timer::GetInstance()->mQueue.size());
+    APSARA_TEST_EQUAL_FATAL(1, Timer::GetInstance()->Size());
     auto queueKey = QueueKeyManager::GetInstance()->GetKey(configName);
     auto ctx = CollectionPipelineContext();
     ctx.SetConfigName(configName);
@@ -94,7 +94,7 @@ void HostMonitorInputRunnerUnittest::TestScheduleOnce() const {
     runner->ScheduleOnce(collectContext);
     std::this_thread::sleep_for(std::chrono::seconds(1));
     // second schedule once should be cancelled, because start time is not the same
-    APSARA_TEST_EQUAL_FATAL(1, Timer::GetInstance()->mQueue.size());
+    APSARA_TEST_EQUAL_FATAL(1, Timer::GetInstance()->Size());
 
     auto mockCollector2 = std::make_unique<MockCollector>();
     auto collectContext2 = std::make_shared<HostMonitorContext>(configName,
@@ -107,7 +107,7 @@ void HostMonitorInputRunnerUnittest::TestScheduleOnce() const {
         = HostMonitorInputRunner::GetInstance()->mRegisteredStartTime.at({configName, MockCollector::sName});
     runner->ScheduleOnce(collectContext2);
     std::this_thread::sleep_for(std::chrono::seconds(1));
-    APSARA_TEST_EQUAL_FATAL(2, Timer::GetInstance()->mQueue.size());
+    APSARA_TEST_EQUAL_FATAL(2, Timer::GetInstance()->Size());
 
     auto item = std::make_unique<ProcessQueueItem>(std::make_shared<SourceBuffer>(), 0);
     ProcessQueueManager::GetInstance()->EnablePop(configName);
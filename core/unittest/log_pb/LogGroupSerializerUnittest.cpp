@@ -94,6 +94,21 @@ void LogGroupSerializerUnittest::TestSerialize() {
     APSARA_TEST_EQUAL("value_5", logGroupPb.logtags(0).value());
     APSARA_TEST_EQUAL("key_6", logGroupPb.logtags(1).key());
     APSARA_TEST_EQUAL("value_6", logGroupPb.logtags(1).value());
+
+    // category is only set when handing off to Go pipelines
+    logGroup.Prepare(groupSZ);
+    logGroup.StartToAddLog(logSZ[1]);
+    logGroup.AddLogTime(123456789);
+    logGroup.AddLogContent("key_3", "value_3");
+    logGroup.AddLogContent("key_4", "value_4");
+    logGroup.AddCategory("category");
+    logGroup.AddTopic("topic");
+    logGroupPb.Clear();
+    APSARA_TEST_TRUE(logGroupPb.ParseFromString(logGroup.GetResult()));
+    APSARA_TEST_EQUAL(1L, logGroupPb.logs_size());
+    APSARA_TEST_TRUE(logGroupPb.has_category());
+    APSARA_TEST_EQUAL("category", logGroupPb.category());
+    APSARA_TEST_EQUAL("topic", logGroupPb.topic());
 }
 
 UNIT_TEST_CASE(LogGroupSerializerUnittest, TestSerialize)
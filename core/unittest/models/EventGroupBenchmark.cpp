@@ -14,8 +14,12 @@
 
 #include <cstdlib>
 
+#include <thread>
+#include <vector>
+
 #include "common/JsonUtil.h"
 #include "common/TimeUtil.h"
+#include "models/EventPool.h"
 #include "models/LogEvent.h"
 #include "models/PipelineEventGroup.h"
 
@@ -35,6 +39,7 @@ class EventGroupBenchmark {
 public:
     void TestEraseInLoop();
     void TestWriteIndexInLoop();
+    void TestAcquireEvents();
 };
 
 void EraseInLoop(PipelineEventGroup& logGroup) {
@@ -102,15 +107,72 @@ void EventGroupBenchmark::TestWriteIndexInLoop() {
     printf("%s costs %lums\n", __func__, timeelapsed);
 }
 
+// groups are created and destroyed by the same threads, so that events keep going back to the pool
+void CreateGroups(EventPool* pool, bool batch) {
+    for (int i = 0; i < 1000; ++i) {
+        PipelineEventGroup group(std::make_shared<SourceBuffer>());
+        if (batch) {
+            group.AddLogEvents(1000, true, pool);
+        } else {
+            for (int j = 0; j < 1000; ++j) {
+                group.AddLogEvent(true, pool);
+            }
+        }
+    }
+}
+
+void EventGroupBenchmark::TestAcquireEvents() {
+    EventPool sharedPool(true);
+    EventPool magazinePool(true, EventPool::kDefaultMagazineSize);
+    struct Case {
+        const char* mName;
+        EventPool* mPool;
+        bool mBatch;
+    };
+    std::vector<Case> cases = {{"thread local pool, one by one", nullptr, false},
+                               {"thread local pool, batch", nullptr, true},
+                               {"shared pool, one by one", &sharedPool, false},
+                               {"shared pool, batch", &sharedPool, true},
+                               {"shared pool with magazines, one by one", &magazinePool, false},
+                               {"shared pool with magazines, batch", &magazinePool, true}};
+    for (size_t threadCnt : {1, 4}) {
+        for (const auto& item : cases) {
+            uint64_t starttime = GetCurrentTimeInMilliSeconds();
+            std::vector<std::thread> threads;
+            for (size_t i = 0; i < threadCnt; ++i) {
+                threads.emplace_back(CreateGroups, item.mPool, item.mBatch);
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+            uint64_t timeelapsed = GetCurrentTimeInMilliSeconds() - starttime;
+            printf("%s: %s with %zu threads costs %lums\n", __func__, item.mName, threadCnt, timeelapsed);
+        }
+    }
+}
+
 } // namespace logtail
 
 int main(int argc, char* argv[]) {
     logtail::EventGroupBenchmark benchmark;
     benchmark.TestEraseInLoop();
     benchmark.TestWriteIndexInLoop();
+    benchmark.TestAcquireEvents();
     /* Result:
        TestEraseInLoop costs 453ms
        TestWriteIndexInLoop costs 22ms
+       TestAcquireEvents: thread local pool, one by one with 1 threads costs 21ms
+       TestAcquireEvents: thread local pool, batch with 1 threads costs 13ms
+       TestAcquireEvents: shared pool, one by one with 1 threads costs 53ms
+       TestAcquireEvents: shared pool, batch with 1 threads costs 16ms
+       TestAcquireEvents: shared pool with magazines, one by one with 1 threads costs 22ms
+       TestAcquireEvents: shared pool with magazines, batch with 1 threads costs 15ms
+       TestAcquireEvents: thread local pool, one by one with 4 threads costs 103ms
+       TestAcquireEvents: thread local pool, batch with 4 threads costs 79ms
+       TestAcquireEvents: shared pool, one by one with 4 threads costs 272ms
+       TestAcquireEvents: shared pool, batch with 4 threads costs 70ms
+       TestAcquireEvents: shared pool with magazines, one by one with 4 threads costs 120ms
+       TestAcquireEvents: shared pool with magazines, batch with 4 threads costs 77ms
      */
     return 0;
 }
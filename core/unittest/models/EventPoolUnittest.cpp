@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <thread>
+
 #include "models/EventPool.h"
 #include "models/PipelineEventGroup.h"
 #include "unittest/Unittest.h"
@@ -25,6 +27,8 @@ public:
     void TestNoLock();
     void TestLock();
     void TestGC();
+    void TestAcquireBatch();
+    void TestMagazine();
 
 protected:
     void SetUp() override { mGroup.reset(new PipelineEventGroup(make_shared<SourceBuffer>())); }
@@ -238,9 +242,104 @@ void EventPoolUnittest::TestGC() {
     }
 }
 
+void EventPoolUnittest::TestAcquireBatch() {
+    PipelineEventGroup g(make_shared<SourceBuffer>());
+    {
+        EventPool pool(false);
+        vector<LogEvent*> events;
+        pool.Acquire(mGroup.get(), 3, events);
+        APSARA_TEST_EQUAL(3U, events.size());
+        pool.Release(std::move(events));
+
+        // 3 from the pool and 2 new ones
+        vector<LogEvent*> res;
+        pool.Acquire(&g, 5, res);
+        APSARA_TEST_EQUAL(5U, res.size());
+        APSARA_TEST_EQUAL(0U, pool.mLogEventPool.size());
+        APSARA_TEST_EQUAL(0U, pool.mMinUnusedLogEventsCnt);
+        for (auto* e : res) {
+            APSARA_TEST_EQUAL(&g, e->GetPipelineEventGroupPtr());
+            delete e;
+        }
+    }
+    {
+        EventPool pool;
+        vector<MetricEvent*> events;
+        pool.Acquire(mGroup.get(), 3, events);
+        pool.Release(std::move(events));
+        APSARA_TEST_EQUAL(3U, pool.mMetricEventPoolBak.size());
+
+        // events in the backup pool are taken at once
+        vector<MetricEvent*> res;
+        pool.Acquire(&g, 2, res);
+        APSARA_TEST_EQUAL(2U, res.size());
+        APSARA_TEST_EQUAL(1U, pool.mMetricEventPool.size());
+        APSARA_TEST_EQUAL(0U, pool.mMetricEventPoolBak.size());
+        APSARA_TEST_EQUAL(0U, pool.mMinUnusedMetricEventsCnt);
+        for (auto* e : res) {
+            APSARA_TEST_EQUAL(&g, e->GetPipelineEventGroupPtr());
+            delete e;
+        }
+        pool.Clear();
+    }
+}
+
+void EventPoolUnittest::TestMagazine() {
+    EventPool pool(true, 4);
+    APSARA_TEST_EQUAL(4U, pool.mMagazineSize);
+    APSARA_TEST_EQUAL(0U, EventPool(false, 4).mMagazineSize);
+
+    vector<LogEvent*> events;
+    pool.Acquire(mGroup.get(), 7, events);
+    pool.Release(std::move(events));
+    APSARA_TEST_EQUAL(7U, pool.mLogEventPoolBak.size());
+
+    // a whole magazine is taken from the pool at once
+    auto e = pool.AcquireLogEvent(mGroup.get());
+    APSARA_TEST_EQUAL(3U, pool.GetThreadMagazines().mLogEvents.size());
+    APSARA_TEST_EQUAL(3U, pool.mLogEventPool.size());
+    APSARA_TEST_EQUAL(0U, pool.mLogEventPoolBak.size());
+    APSARA_TEST_EQUAL(0U, pool.mMinUnusedLogEventsCnt);
+
+    // each thread has its own magazine, which is freed on thread exit
+    thread t([&]() {
+        auto e = pool.AcquireLogEvent(mGroup.get());
+        APSARA_TEST_EQUAL(2U, pool.GetThreadMagazines().mLogEvents.size());
+        pool.Release({e});
+    });
+    t.join();
+    APSARA_TEST_EQUAL(3U, pool.GetThreadMagazines().mLogEvents.size());
+    APSARA_TEST_EQUAL(0U, pool.mLogEventPool.size());
+    APSARA_TEST_EQUAL(1U, pool.mLogEventPoolBak.size());
+
+    // events in the magazine are used first, then those in the pool, and new ones at last
+    PipelineEventGroup g(make_shared<SourceBuffer>());
+    vector<LogEvent*> res;
+    pool.Acquire(&g, 5, res);
+    APSARA_TEST_EQUAL(5U, res.size());
+    APSARA_TEST_EQUAL(0U, pool.GetThreadMagazines().mLogEvents.size());
+    APSARA_TEST_EQUAL(0U, pool.mLogEventPool.size());
+    APSARA_TEST_EQUAL(0U, pool.mLogEventPoolBak.size());
+    for (auto* item : res) {
+        APSARA_TEST_EQUAL(&g, item->GetPipelineEventGroupPtr());
+        delete item;
+    }
+    delete e;
+
+    // magazines of different pools are separated
+    EventPool other(true, 4);
+    other.Release({new LogEvent(mGroup.get())});
+    delete other.AcquireLogEvent(mGroup.get());
+    APSARA_TEST_EQUAL(0U, other.GetThreadMagazines().mLogEvents.size());
+    APSARA_TEST_EQUAL(0U, pool.GetThreadMagazines().mLogEvents.size());
+    pool.Clear();
+}
+
 UNIT_TEST_CASE(EventPoolUnittest, TestNoLock)
 UNIT_TEST_CASE(EventPoolUnittest, TestLock)
 UNIT_TEST_CASE(EventPoolUnittest, TestGC)
+UNIT_TEST_CASE(EventPoolUnittest, TestAcquireBatch)
+UNIT_TEST_CASE(EventPoolUnittest, TestMagazine)
 
 } // namespace logtail
 
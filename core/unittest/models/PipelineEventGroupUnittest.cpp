@@ -28,6 +28,7 @@ class PipelineEventGroupUnittest : public ::testing::Test {
 public:
     void TestCreateEvent();
     void TestAddEvent();
+    void TestAddEvents();
     void TestSwapEvents();
     void TestReserveEvents();
     void TestCopy();
@@ -36,6 +37,7 @@ public:
     void TestDelMetadata();
     void TestFromJsonToJson();
     void TestTagsHash();
+    void TestTrace();
 
 protected:
     void SetUp() override {
@@ -121,6 +123,26 @@ void PipelineEventGroupUnittest::TestAddEvent() {
     }
 }
 
+void PipelineEventGroupUnittest::TestAddEvents() {
+    mEventGroup->AddLogEvents(2);
+    mEventGroup->AddMetricEvents(2, true);
+    mEventGroup->AddRawEvents(2, true, &mPool);
+    mEventGroup->AddSpanEvents(0, true, &mPool);
+    auto& events = mEventGroup->MutableEvents();
+    APSARA_TEST_EQUAL_FATAL(6U, events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        APSARA_TEST_EQUAL(mEventGroup.get(), events[i]->GetPipelineEventGroupPtr());
+    }
+    APSARA_TEST_TRUE(events[0].Is<LogEvent>());
+    APSARA_TEST_FALSE(events[0].IsFromEventPool());
+    APSARA_TEST_TRUE(events[2].Is<MetricEvent>());
+    APSARA_TEST_TRUE(events[2].IsFromEventPool());
+    APSARA_TEST_EQUAL(nullptr, events[2].GetEventPool());
+    APSARA_TEST_TRUE(events[4].Is<RawEvent>());
+    APSARA_TEST_TRUE(events[4].IsFromEventPool());
+    APSARA_TEST_EQUAL(&mPool, events[4].GetEventPool());
+}
+
 void PipelineEventGroupUnittest::TestSwapEvents() {
     mEventGroup->AddLogEvent();
     mEventGroup->AddMetricEvent();
@@ -311,8 +333,37 @@ void PipelineEventGroupUnittest::TestTagsHash() {
     APSARA_TEST_NOT_EQUAL(g1.GetTagsHash(), g3.GetTagsHash());
 }
 
+void PipelineEventGroupUnittest::TestTrace() {
+    auto trace = make_shared<EventGroupTrace>();
+    mEventGroup->SetTrace(trace);
+    {
+        // copied groups are not traced to avoid duplicate records
+        auto res = mEventGroup->Copy();
+        APSARA_TEST_TRUE(res.GetTrace() == nullptr);
+    }
+    {
+        PipelineEventGroup res(std::move(*mEventGroup));
+        APSARA_TEST_EQUAL(trace.get(), res.GetTrace().get());
+    }
+    {
+        EventGroupTrace t;
+        chrono::nanoseconds latency;
+        APSARA_TEST_FALSE(t.GetStageLatency(0, latency));
+        APSARA_TEST_FALSE(t.GetTotalLatency(latency));
+        t.Stamp(TraceStamp::READ);
+        t.Stamp(TraceStamp::PROCESS_QUEUE_PUSH);
+        APSARA_TEST_TRUE(t.GetStageLatency(0, latency));
+        APSARA_TEST_FALSE(t.GetStageLatency(1, latency));
+        APSARA_TEST_FALSE(t.GetStageLatency(EventGroupTrace::kStageCnt, latency));
+        t.Stamp(TraceStamp::SEND_DONE);
+        APSARA_TEST_TRUE(t.GetTotalLatency(latency));
+        APSARA_TEST_STREQ("read", EventGroupTrace::GetStageName(0));
+    }
+}
+
 UNIT_TEST_CASE(PipelineEventGroupUnittest, TestCreateEvent)
 UNIT_TEST_CASE(PipelineEventGroupUnittest, TestAddEvent)
+UNIT_TEST_CASE(PipelineEventGroupUnittest, TestAddEvents)
 UNIT_TEST_CASE(PipelineEventGroupUnittest, TestSwapEvents)
 UNIT_TEST_CASE(PipelineEventGroupUnittest, TestReserveEvents)
 UNIT_TEST_CASE(PipelineEventGroupUnittest, TestCopy)
@@ -321,6 +372,7 @@ UNIT_TEST_CASE(PipelineEventGroupUnittest, TestSetMetadata)
 UNIT_TEST_CASE(PipelineEventGroupUnittest, TestDelMetadata)
 UNIT_TEST_CASE(PipelineEventGroupUnittest, TestFromJsonToJson)
 UNIT_TEST_CASE(PipelineEventGroupUnittest, TestTagsHash)
+UNIT_TEST_CASE(PipelineEventGroupUnittest, TestTrace)
 
 } // namespace logtail
 
@@ -0,0 +1,157 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+
+#include "collection_pipeline/limiter/CpuGovernor.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class CpuGovernorUnittest : public testing::Test {
+public:
+    void TestDisabled();
+    void TestPriorityShare();
+    void TestConvergence();
+    void TestAcquire();
+
+protected:
+    void TearDown() override {
+        auto* governor = CpuGovernor::GetInstance();
+        governor->Update(0.0, 0.0);
+        for (auto& bucket : governor->mBuckets) {
+            bucket = CpuGovernor::Bucket();
+        }
+    }
+
+private:
+    // the monitor calls Update once per second
+    static void Update(double cpuUsage, double cpuLimit) {
+        auto* governor = CpuGovernor::GetInstance();
+        governor->mLastUpdateTime = chrono::steady_clock::now() - chrono::seconds(1);
+        governor->Update(cpuUsage, cpuLimit);
+    }
+};
+
+void CpuGovernorUnittest::TestDisabled() {
+    auto* governor = CpuGovernor::GetInstance();
+    APSARA_TEST_FALSE(governor->IsEnabled());
+    APSARA_TEST_TRUE(governor->Acquire(0, 0));
+
+    Update(0.0, 1.0);
+    APSARA_TEST_TRUE(governor->IsEnabled());
+
+    governor->Consume(0, 1000000);
+    APSARA_TEST_FALSE(governor->Acquire(0, 0));
+    Update(0.0, 0.0);
+    APSARA_TEST_FALSE(governor->IsEnabled());
+    APSARA_TEST_TRUE(governor->Acquire(0, 0));
+}
+
+void CpuGovernorUnittest::TestPriorityShare() {
+    auto* governor = CpuGovernor::GetInstance();
+    Update(0.0, 1.4);
+    EXPECT_NEAR(1.4, governor->GetRate(), 1e-6);
+
+    // only active priorities share the rate
+    governor->Consume(0, 0);
+    governor->Consume(2, 0);
+    Update(0.0, 1.4);
+    EXPECT_NEAR(1.4, governor->GetRate(), 1e-6);
+    EXPECT_NEAR(1.4 * 4 / 5, governor->mBuckets[0].mRate, 1e-6);
+    EXPECT_NEAR(1.4 / 5, governor->mBuckets[2].mRate, 1e-6);
+    EXPECT_NEAR(1.4 * 2 / 7, governor->mBuckets[1].mRate, 1e-6);
+
+    // all priorities active
+    governor->Consume(0, 0);
+    governor->Consume(1, 0);
+    governor->Consume(2, 0);
+    Update(0.0, 1.4);
+    EXPECT_NEAR(1.4 * 4 / 7, governor->mBuckets[0].mRate, 1e-6);
+    EXPECT_NEAR(1.4 * 2 / 7, governor->mBuckets[1].mRate, 1e-6);
+    EXPECT_NEAR(1.4 / 7, governor->mBuckets[2].mRate, 1e-6);
+}
+
+// governed threads consume all the cpu time given, while ungoverned threads use a varying amount of cpu
+void CpuGovernorUnittest::TestConvergence() {
+    static const double kLimit = 1.0;
+    auto* governor = CpuGovernor::GetInstance();
+
+    Update(0.0, kLimit);
+    double ungoverned = 0.3;
+    double usage = 0.0;
+    for (size_t i = 0; i < 20; ++i) {
+        double governed = governor->GetRate();
+        governor->Consume(1, static_cast<int64_t>(governed * 1000000));
+        usage = governed + ungoverned;
+        Update(usage, kLimit);
+    }
+    EXPECT_NEAR(kLimit, usage, 0.001);
+
+    // the usage approaches the limit monotonically without overshooting
+    ungoverned = 0.6;
+    double lastUsage = 1.3;
+    for (size_t i = 0; i < 20; ++i) {
+        double governed = governor->GetRate();
+        governor->Consume(1, static_cast<int64_t>(governed * 1000000));
+        usage = governed + ungoverned;
+        APSARA_TEST_TRUE(usage >= kLimit - 0.001);
+        APSARA_TEST_TRUE(usage <= lastUsage);
+        lastUsage = usage;
+        Update(usage, kLimit);
+    }
+    EXPECT_NEAR(kLimit, usage, 0.001);
+
+    // governed threads are never starved
+    ungoverned = 2.0;
+    for (size_t i = 0; i < 20; ++i) {
+        double governed = governor->GetRate();
+        governor->Consume(1, static_cast<int64_t>(governed * 1000000));
+        Update(governed + ungoverned, kLimit);
+    }
+    EXPECT_NEAR(kLimit * 0.05, governor->GetRate(), 1e-6);
+}
+
+void CpuGovernorUnittest::TestAcquire() {
+    auto* governor = CpuGovernor::GetInstance();
+    governor->Consume(0, 0);
+    Update(0.0, 1.0);
+    APSARA_TEST_TRUE(governor->Acquire(0, 0));
+
+    // 10ms of cpu time overdrawn, which is refilled at 1 core in 10ms
+    governor->Consume(0, 10000);
+    APSARA_TEST_FALSE(governor->Acquire(0, 0));
+    auto start = chrono::steady_clock::now();
+    APSARA_TEST_TRUE(governor->Acquire(0, 1000));
+    auto elapsedMs = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    APSARA_TEST_TRUE(elapsedMs >= 5);
+    APSARA_TEST_TRUE(elapsedMs < 500);
+
+    // never waits once disabled
+    governor->Consume(0, 1000000);
+    APSARA_TEST_FALSE(governor->Acquire(0, 0));
+    Update(0.0, 0.0);
+    APSARA_TEST_TRUE(governor->Acquire(0, 1000));
+}
+
+UNIT_TEST_CASE(CpuGovernorUnittest, TestDisabled)
+UNIT_TEST_CASE(CpuGovernorUnittest, TestPriorityShare)
+UNIT_TEST_CASE(CpuGovernorUnittest, TestConvergence)
+UNIT_TEST_CASE(CpuGovernorUnittest, TestAcquire)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
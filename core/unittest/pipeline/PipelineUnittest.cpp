@@ -27,6 +27,7 @@
 #include "collection_pipeline/queue/ProcessQueueManager.h"
 #include "collection_pipeline/queue/QueueKeyManager.h"
 #include "common/JsonUtil.h"
+#include "common/TimeUtil.h"
 #include "config/CollectionConfig.h"
 #include "plugin/input/InputFeedbackInterfaceRegistry.h"
 #include "plugin/processor/inner/ProcessorSplitLogStringNative.h"
@@ -49,6 +50,7 @@ public:
     void TestProcess() const;
     void TestSend() const;
     void TestFlushBatch() const;
+    void TestResourceUsage() const;
     void TestInProcessingCount() const;
     void TestWaitAllItemsInProcessFinished() const;
     void TestMultiFlusherAndRouter() const;
@@ -2977,6 +2979,32 @@ void PipelineUnittest::TestSend() const {
     }
 }
 
+void PipelineUnittest::TestResourceUsage() const {
+    CollectionPipeline pipeline;
+    WriteMetrics::GetInstance()->CreateMetricsRecordRef(
+        pipeline.mMetricsRecordRef, MetricCategory::METRIC_CATEGORY_UNKNOWN, {});
+    pipeline.mCpuTimeMs = pipeline.mMetricsRecordRef.CreateTimeCounter(METRIC_PIPELINE_CPU_TIME_MS);
+    pipeline.mAllocatedSizeBytes = pipeline.mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_ALLOCATED_SIZE_BYTES);
+    WriteMetrics::GetInstance()->CommitMetricsRecordRef(pipeline.mMetricsRecordRef);
+
+    {
+        PipelineResourceUsageGuard guard(pipeline);
+        SourceBuffer buffer;
+        buffer.AllocateStringBuffer(1024 * 1024 - 1);
+        auto start = GetCurrentThreadCpuTimeInNanoSeconds();
+        while (IsThreadCpuTimeSupported() && GetCurrentThreadCpuTimeInNanoSeconds() - start < 2000000) {
+        }
+    }
+    // allocations out of the guard are not accounted
+    SourceBuffer buffer;
+    APSARA_TEST_EQUAL(4096U + 1024 * 1024, pipeline.GetTotalAllocatedBytes());
+    APSARA_TEST_EQUAL(4096U + 1024 * 1024, pipeline.mAllocatedSizeBytes->GetValue());
+    if (IsThreadCpuTimeSupported()) {
+        APSARA_TEST_TRUE(pipeline.GetTotalCpuTime() >= chrono::milliseconds(2));
+        APSARA_TEST_TRUE(pipeline.mCpuTimeMs->GetValue() >= 2U);
+    }
+}
+
 void PipelineUnittest::TestFlushBatch() const {
     CollectionPipeline pipeline;
     pipeline.mName = configName;
@@ -3138,6 +3166,7 @@ UNIT_TEST_CASE(PipelineUnittest, OnInputFileWithContainerDiscovery)
 UNIT_TEST_CASE(PipelineUnittest, TestProcess)
 UNIT_TEST_CASE(PipelineUnittest, TestSend)
 UNIT_TEST_CASE(PipelineUnittest, TestFlushBatch)
+UNIT_TEST_CASE(PipelineUnittest, TestResourceUsage)
 UNIT_TEST_CASE(PipelineUnittest, TestInProcessingCount)
 UNIT_TEST_CASE(PipelineUnittest, TestWaitAllItemsInProcessFinished)
 UNIT_TEST_CASE(PipelineUnittest, TestMultiFlusherAndRouter)
@@ -22,6 +22,8 @@
 #include "config/CollectionConfig.h"
 #include "models/LogEvent.h"
 #include "plugin/processor/inner/ProcessorParseFromPBNative.h"
+#include "protobuf/models/PipelineEventGroupDecoder.h"
+#include "protobuf/models/ProtocolConversion.h"
 #include "protobuf/models/pipeline_event_group.pb.h"
 #include "protobuf/models/span_event.pb.h"
 #include "unittest/Unittest.h"
@@ -104,6 +106,42 @@ static void runBenchmark(int size, int batchSize, std::string serializedData) {
     }
 }
 
+// compares the previous path, i.e., ParseFromArray followed by TransferPBToPipelineEventGroup, with the direct decoder
+static void runDecodeComparison(int size, const std::string& serializedData) {
+    uint64_t transferTime = 0;
+    uint64_t decodeTime = 0;
+    size_t transferEventCnt = 0;
+    size_t decodeEventCnt = 0;
+    for (int i = 0; i < size; i++) {
+        std::string errMsg;
+        {
+            uint64_t startTime = GetCurrentTimeInMicroSeconds();
+            models::PipelineEventGroup pbGroup;
+            PipelineEventGroup eventGroup(std::make_shared<SourceBuffer>());
+            if (pbGroup.ParseFromArray(serializedData.data(), serializedData.size())
+                && TransferPBToPipelineEventGroup(pbGroup, eventGroup, errMsg)) {
+                transferEventCnt += eventGroup.GetEvents().size();
+            }
+            transferTime += GetCurrentTimeInMicroSeconds() - startTime;
+        }
+        {
+            uint64_t startTime = GetCurrentTimeInMicroSeconds();
+            PipelineEventGroup eventGroup(std::make_shared<SourceBuffer>());
+            if (DecodePBToPipelineEventGroup(serializedData, eventGroup, errMsg)) {
+                decodeEventCnt += eventGroup.GetEvents().size();
+            }
+            decodeTime += GetCurrentTimeInMicroSeconds() - startTime;
+        }
+    }
+    if (transferEventCnt != decodeEventCnt) {
+        std::cout << "event count mismatch: " << transferEventCnt << " vs " << decodeEventCnt << std::endl;
+    }
+    std::cout << "parse and transfer: " << transferTime << " us, "
+              << formatSize(serializedData.size() * (uint64_t)size * 1000000 / (transferTime + 1)) << "/s" << std::endl;
+    std::cout << "direct decode:      " << decodeTime << " us, "
+              << formatSize(serializedData.size() * (uint64_t)size * 1000000 / (decodeTime + 1)) << "/s" << std::endl;
+}
+
 static void createHttpSpan(models::SpanEvent* span) {
     span->set_traceid("cba78930fe0c2626bc60696a3453cc40");
     span->set_spanid("4083239a6a2e704e");
@@ -426,6 +464,7 @@ static void BM_ParseFromPBBasicSpanData(int size, int batchSize) {
     }
 
     runBenchmark(size, batchSize, pbEventGroup.SerializeAsString());
+    runDecodeComparison(size * batchSize, pbEventGroup.SerializeAsString());
 }
 
 static void BM_ParseFromPBMaxBatchSizeSpanData(int size, int batchSize) {
@@ -445,6 +484,7 @@ static void BM_ParseFromPBMaxBatchSizeSpanData(int size, int batchSize) {
     }
 
     runBenchmark(size, batchSize, pbEventGroup.SerializeAsString());
+    runDecodeComparison(size * batchSize, pbEventGroup.SerializeAsString());
 }
 
 static void BM_ParseFromPBLargeSingleSpanData(int size, int batchSize) {
@@ -457,6 +497,7 @@ static void BM_ParseFromPBLargeSingleSpanData(int size, int batchSize) {
     *spanEvents->add_events() = genaiSpan;
 
     runBenchmark(size, batchSize, pbEventGroup.SerializeAsString());
+    runDecodeComparison(size * batchSize, pbEventGroup.SerializeAsString());
 }
 
 int main(int argc, char** argv) {
@@ -18,6 +18,7 @@
 
 #include "models/PipelineEventGroup.h"
 #include "plugin/processor/inner/ProcessorParseFromPBNative.h"
+#include "protobuf/models/PipelineEventGroupDecoder.h"
 #include "protobuf/models/ProtocolConversion.h"
 #include "protobuf/models/pipeline_event_group.pb.h"
 #include "protobuf/models/span_event.pb.h"
@@ -39,6 +40,7 @@ public:
     void TestProcessInvalidProtobufData();
     void TestProcessMultiInvalidProtobufData();
     void TestProcessPartialInvalidProtobufData();
+    void TestDecodeLogAndMetricData();
 
 private:
     void prepareValidProcessor(ProcessorParseFromPBNative&);
@@ -264,6 +266,71 @@ void ProcessorParseFromPBNativeUnittest::TestProcessPartialInvalidProtobufData()
     APSARA_TEST_EQUAL(uint64_t(2), processor.mOutSuccessfulEventsTotal->GetValue());
 }
 
+void ProcessorParseFromPBNativeUnittest::TestDecodeLogAndMetricData() {
+    // same result as ParseFromArray followed by TransferPBToPipelineEventGroup
+    auto assertSameAsTransfer = [](const models::PipelineEventGroup& pbGroup) {
+        string data = pbGroup.SerializeAsString();
+        string transferErrMsg, decodeErrMsg;
+        PipelineEventGroup expected(make_shared<SourceBuffer>());
+        models::PipelineEventGroup parsed;
+        APSARA_TEST_TRUE(parsed.ParseFromString(data));
+        bool expectedRes = TransferPBToPipelineEventGroup(parsed, expected, transferErrMsg);
+        PipelineEventGroup actual(make_shared<SourceBuffer>());
+        APSARA_TEST_EQUAL(expectedRes, DecodePBToPipelineEventGroup(data, actual, decodeErrMsg));
+        APSARA_TEST_EQUAL(transferErrMsg, decodeErrMsg);
+        if (expectedRes) {
+            APSARA_TEST_EQUAL(expected.ToJsonString(), actual.ToJsonString());
+        }
+    };
+    {
+        models::PipelineEventGroup pbGroup;
+        (*pbGroup.mutable_tags())["host"] = "10.0.0.1";
+        (*pbGroup.mutable_metadata())["source_id"] = "id";
+        for (int i = 0; i < 3; ++i) {
+            auto log = pbGroup.mutable_logs()->add_events();
+            log->set_timestamp(1748313840259765375ULL + i);
+            log->set_level("INFO");
+            log->set_fileoffset(100 * i);
+            log->set_rawsize(100);
+            auto content = log->add_contents();
+            content->set_key("content");
+            content->set_value("value_" + to_string(i));
+        }
+        assertSameAsTransfer(pbGroup);
+    }
+    {
+        models::PipelineEventGroup pbGroup;
+        auto metric = pbGroup.mutable_metrics()->add_events();
+        metric->set_timestamp(1748313840000000000ULL);
+        metric->set_name("http_requests_total");
+        metric->mutable_untypedsinglevalue()->set_value(1.5);
+        (*metric->mutable_tags())["method"] = "GET";
+        assertSameAsTransfer(pbGroup);
+
+        // metric without value
+        pbGroup.mutable_metrics()->add_events()->set_name("no_value");
+        assertSameAsTransfer(pbGroup);
+    }
+    {
+        // no events
+        models::PipelineEventGroup pbGroup;
+        (*pbGroup.mutable_tags())["host"] = "10.0.0.1";
+        assertSameAsTransfer(pbGroup);
+        pbGroup.mutable_logs();
+        assertSameAsTransfer(pbGroup);
+    }
+    {
+        // truncated data
+        models::PipelineEventGroup pbGroup;
+        pbGroup.mutable_logs()->add_events()->set_level("INFO");
+        string data = pbGroup.SerializeAsString();
+        string errMsg;
+        PipelineEventGroup eventGroup(make_shared<SourceBuffer>());
+        APSARA_TEST_FALSE(DecodePBToPipelineEventGroup(StringView(data.data(), data.size() - 1), eventGroup, errMsg));
+        APSARA_TEST_FALSE(errMsg.empty());
+    }
+}
+
 void ProcessorParseFromPBNativeUnittest::prepareValidProcessor(ProcessorParseFromPBNative& processor) {
     Json::Value config;
     config["Protocol"] = "LoongSuite";
@@ -437,6 +504,7 @@ UNIT_TEST_CASE(ProcessorParseFromPBNativeUnittest, TestProcessInvalidProtobufDat
 UNIT_TEST_CASE(ProcessorParseFromPBNativeUnittest, TestProcessMultiValidSpanData)
 UNIT_TEST_CASE(ProcessorParseFromPBNativeUnittest, TestProcessMultiInvalidProtobufData)
 UNIT_TEST_CASE(ProcessorParseFromPBNativeUnittest, TestProcessPartialInvalidProtobufData)
+UNIT_TEST_CASE(ProcessorParseFromPBNativeUnittest, TestDecodeLogAndMetricData)
 
 } // namespace logtail
 
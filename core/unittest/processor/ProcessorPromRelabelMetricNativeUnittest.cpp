@@ -33,6 +33,7 @@ public:
     void TestProcess();
     void TestAddAutoMetrics();
     void TestHonorLabels();
+    void TestRelabelResultCache();
 
     CollectionPipelineContext mContext;
 };
@@ -297,10 +298,89 @@ test_metric8{k1="v1", k3="v2", } 9.9410452992e+10 1715829785083
     APSARA_TEST_EQUAL("v2", eventGroup.GetEvents().at(7).Cast<MetricEvent>().GetTag(string("exported_k3")).to_string());
 }
 
+void ProcessorPromRelabelMetricNativeUnittest::TestRelabelResultCache() {
+    Json::Value config;
+    ProcessorPromRelabelMetricNative processor;
+    processor.SetContext(mContext);
+    string configStr = R"JSON(
+        {
+            "job_name": "test_job",
+            "metric_relabel_configs": [
+                {
+                    "action": "drop",
+                    "regex": "v.*",
+                    "source_labels": ["k3"]
+                },
+                {
+                    "action": "replace",
+                    "regex": "(.*)",
+                    "replacement": "${1}_new",
+                    "source_labels": ["k1"],
+                    "target_label": "k4"
+                },
+                {
+                    "action": "labeldrop",
+                    "regex": "k2"
+                }
+            ]
+        }
+    )JSON";
+    string errorMsg;
+    APSARA_TEST_TRUE(ParseJsonTable(configStr, config, errorMsg));
+    APSARA_TEST_TRUE(processor.Init(config));
+    APSARA_TEST_NOT_EQUAL(nullptr, processor.mRelabelResultCache);
+
+    string rawData = R"""(
+test_metric1{k1="v1", k2="v2"} 1.0
+test_metric2{k1="v1", k3="v3"} 2.0
+test_metric3{k2="v2", k1="v1"} 3.0
+)""";
+    vector<string> results;
+    for (size_t i = 0; i < 2; ++i) {
+        auto eventGroup = TextParser().Parse(rawData, 0, 0);
+        eventGroup.SetTag(string("instance"), string("localhost:8080"));
+        processor.Process(eventGroup);
+        APSARA_TEST_EQUAL(2U, eventGroup.GetEvents().size());
+        const auto& event = eventGroup.GetEvents()[0].Cast<MetricEvent>();
+        APSARA_TEST_EQUAL("v1_new", event.GetTag("k4"));
+        APSARA_TEST_FALSE(event.HasTag("k2"));
+        APSARA_TEST_EQUAL("localhost:8080", event.GetTag("instance"));
+        results.push_back(eventGroup.ToJsonString());
+    }
+    // the second round is served by the cache with the same result
+    APSARA_TEST_EQUAL(3U, processor.mRelabelResultCache->Size());
+    APSARA_TEST_EQUAL(results[0], results[1]);
+
+    rawData = R"""(
+test_metric2{k1="v1", k3="v3"} 2.0
+test_metric4{__tmp="v", k1="v4"} 4.0
+)""";
+    auto eventGroup = TextParser().Parse(rawData, 0, 0);
+    auto& dropped = eventGroup.MutableEvents()[0].Cast<MetricEvent>();
+    auto& kept = eventGroup.MutableEvents()[1].Cast<MetricEvent>();
+    auto droppedHash = ProcessorPromRelabelMetricNative::GetSeriesHash(dropped);
+    auto keptHash = ProcessorPromRelabelMetricNative::GetSeriesHash(kept);
+    APSARA_TEST_FALSE(processor.RelabelMetric(dropped));
+
+    // the result of another series with the same hash is not used
+    processor.mRelabelResultCache->Insert(keptHash, processor.mRelabelResultCache->Find(droppedHash));
+    APSARA_TEST_TRUE(processor.RelabelMetric(kept));
+    APSARA_TEST_EQUAL("v4_new", kept.GetTag("k4"));
+
+    // labels with reserved names are not cached, which are removed after relabeling anyway
+    auto result = processor.mRelabelResultCache->Find(keptHash);
+    APSARA_TEST_TRUE(result->mKeep);
+    APSARA_TEST_EQUAL(2U, result->mSourceLabels.size());
+    APSARA_TEST_EQUAL(2U, result->mLabels.size());
+    APSARA_TEST_TRUE(result->mLabels[0].mInputIndex >= 0);
+    APSARA_TEST_EQUAL("k4", result->mLabels[1].mKey);
+}
+
 UNIT_TEST_CASE(ProcessorPromRelabelMetricNativeUnittest, TestInit)
 UNIT_TEST_CASE(ProcessorPromRelabelMetricNativeUnittest, TestProcess)
 UNIT_TEST_CASE(ProcessorPromRelabelMetricNativeUnittest, TestAddAutoMetrics)
 UNIT_TEST_CASE(ProcessorPromRelabelMetricNativeUnittest, TestHonorLabels)
+UNIT_TEST_CASE(ProcessorPromRelabelMetricNativeUnittest, TestRelabelResultCache)
 
 
 } // namespace logtail
@@ -0,0 +1,315 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+
+#include <string>
+#include <vector>
+
+#include "models/MetricEvent.h"
+#include "models/PipelineEventGroup.h"
+#include "prometheus/Constants.h"
+#include "prometheus/labels/ProtobufParser.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// encodes io.prometheus.client.MetricFamily by hand, since the proto is not compiled into the agent
+class PbWriter {
+public:
+    PbWriter& Varint(uint32_t field, uint64_t value) {
+        AppendVarint(mData, (static_cast<uint64_t>(field) << 3) | 0);
+        AppendVarint(mData, value);
+        return *this;
+    }
+    PbWriter& Sint(uint32_t field, int64_t value) {
+        return Varint(field, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+    PbWriter& Double(uint32_t field, double value) {
+        AppendVarint(mData, (static_cast<uint64_t>(field) << 3) | 1);
+        char buf[8];
+        memcpy(buf, &value, sizeof(buf));
+        mData.append(buf, sizeof(buf));
+        return *this;
+    }
+    PbWriter& Bytes(uint32_t field, const string& value) {
+        AppendVarint(mData, (static_cast<uint64_t>(field) << 3) | 2);
+        AppendVarint(mData, value.size());
+        mData += value;
+        return *this;
+    }
+    const string& Data() const { return mData; }
+
+    static void AppendVarint(string& data, uint64_t value) {
+        while (value >= 0x80) {
+            data.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<char>(value));
+    }
+    static string Delimited(const string& message) {
+        string res;
+        AppendVarint(res, message.size());
+        return res + message;
+    }
+    static string Label(const string& name, const string& value) {
+        return PbWriter().Bytes(1, name).Bytes(2, value).Data();
+    }
+
+private:
+    string mData;
+};
+
+class ProtobufParserUnittest : public testing::Test {
+public:
+    void TestParseCounterAndGauge();
+    void TestParseSummary();
+    void TestParseHistogram();
+    void TestParseNativeHistogram();
+    void TestParseIncomplete();
+    void TestIsProtobufContentType();
+
+protected:
+    void SetUp() override { mParser.SetDefaultTimestamp(1715829785, 83000000); }
+
+private:
+    static const MetricEvent& GetEvent(const PipelineEventGroup& eGroup, size_t i) {
+        return eGroup.GetEvents()[i].Cast<MetricEvent>();
+    }
+    static double GetValue(const PipelineEventGroup& eGroup, size_t i) {
+        return GetEvent(eGroup, i).GetValue<UntypedSingleValue>()->mValue;
+    }
+
+    ProtobufParser mParser;
+};
+
+void ProtobufParserUnittest::TestParseCounterAndGauge() {
+    string counter = PbWriter()
+                         .Bytes(1, "http_requests_total")
+                         .Bytes(2, "help")
+                         .Varint(3, 0)
+                         .Bytes(4,
+                                PbWriter()
+                                    .Bytes(1, PbWriter::Label("method", "GET"))
+                                    .Bytes(1, PbWriter::Label("code", "200"))
+                                    .Bytes(3, PbWriter().Double(1, 1027).Data())
+                                    .Varint(6, 1395066363000)
+                                    .Data())
+                         .Bytes(4,
+                                PbWriter()
+                                    .Bytes(1, PbWriter::Label("method", "POST"))
+                                    .Bytes(3, PbWriter().Double(1, 3).Data())
+                                    .Data())
+                         .Data();
+    // type after metrics
+    string gauge = PbWriter()
+                       .Bytes(1, "go_goroutines")
+                       .Bytes(4, PbWriter().Bytes(2, PbWriter().Double(1, 7).Data()).Data())
+                       .Varint(3, 1)
+                       .Data();
+    string data = PbWriter::Delimited(counter) + PbWriter::Delimited(gauge);
+
+    PipelineEventGroup eGroup(make_shared<SourceBuffer>());
+    size_t consumed = 0;
+    APSARA_TEST_TRUE(mParser.Parse(data, eGroup, consumed));
+    APSARA_TEST_EQUAL(data.size(), consumed);
+    // strings are copied
+    data.clear();
+    APSARA_TEST_EQUAL(3UL, eGroup.GetEvents().size());
+
+    const auto& e0 = GetEvent(eGroup, 0);
+    APSARA_TEST_EQUAL("http_requests_total", e0.GetName());
+    APSARA_TEST_EQUAL("http_requests_total", e0.GetTag(prometheus::NAME));
+    APSARA_TEST_EQUAL("GET", e0.GetTag("method"));
+    APSARA_TEST_EQUAL("200", e0.GetTag("code"));
+    APSARA_TEST_EQUAL(1027.0, GetValue(eGroup, 0));
+    APSARA_TEST_EQUAL(1395066363, e0.GetTimestamp());
+    APSARA_TEST_EQUAL(0U, e0.GetTimestampNanosecond().value());
+
+    const auto& e1 = GetEvent(eGroup, 1);
+    APSARA_TEST_EQUAL("POST", e1.GetTag("method"));
+    APSARA_TEST_FALSE(e1.HasTag("code"));
+    APSARA_TEST_EQUAL(3.0, GetValue(eGroup, 1));
+    APSARA_TEST_EQUAL(1715829785, e1.GetTimestamp());
+    APSARA_TEST_EQUAL(83000000U, e1.GetTimestampNanosecond().value());
+
+    APSARA_TEST_EQUAL("go_goroutines", GetEvent(eGroup, 2).GetName());
+    APSARA_TEST_EQUAL(7.0, GetValue(eGroup, 2));
+}
+
+void ProtobufParserUnittest::TestParseSummary() {
+    string summary = PbWriter()
+                         .Varint(1, 850)
+                         .Double(2, 0.034885631)
+                         .Bytes(3, PbWriter().Double(1, 0.5).Double(2, 4.1114e-05).Data())
+                         .Bytes(3, PbWriter().Double(1, 0.99).Double(2, 0.000112326).Data())
+                         .Data();
+    string family = PbWriter()
+                        .Bytes(1, "go_gc_duration_seconds")
+                        .Varint(3, 2)
+                        .Bytes(4, PbWriter().Bytes(4, summary).Data())
+                        .Data();
+    string data = PbWriter::Delimited(family);
+
+    PipelineEventGroup eGroup(make_shared<SourceBuffer>());
+    size_t consumed = 0;
+    APSARA_TEST_TRUE(mParser.Parse(data, eGroup, consumed));
+    APSARA_TEST_EQUAL(4UL, eGroup.GetEvents().size());
+    APSARA_TEST_EQUAL("go_gc_duration_seconds", GetEvent(eGroup, 0).GetName());
+    APSARA_TEST_EQUAL("0.5", GetEvent(eGroup, 0).GetTag("quantile"));
+    APSARA_TEST_EQUAL(4.1114e-05, GetValue(eGroup, 0));
+    APSARA_TEST_EQUAL("0.99", GetEvent(eGroup, 1).GetTag("quantile"));
+    APSARA_TEST_EQUAL("go_gc_duration_seconds_sum", GetEvent(eGroup, 2).GetName());
+    APSARA_TEST_EQUAL("go_gc_duration_seconds_sum", GetEvent(eGroup, 2).GetTag(prometheus::NAME));
+    APSARA_TEST_EQUAL(0.034885631, GetValue(eGroup, 2));
+    APSARA_TEST_EQUAL("go_gc_duration_seconds_count", GetEvent(eGroup, 3).GetName());
+    APSARA_TEST_EQUAL(850.0, GetValue(eGroup, 3));
+}
+
+void ProtobufParserUnittest::TestParseHistogram() {
+    auto bucket = [](double upperBound, uint64_t count) {
+        return PbWriter().Varint(1, count).Double(2, upperBound).Data();
+    };
+    string histogram = PbWriter()
+                           .Varint(1, 10)
+                           .Double(2, 12.5)
+                           .Bytes(3, bucket(0.00001, 1))
+                           .Bytes(3, bucket(2.5, 6))
+                           .Bytes(3, bucket(1000000, 9))
+                           .Data();
+    string family = PbWriter()
+                        .Bytes(1, "request_duration_seconds")
+                        .Varint(3, 4)
+                        .Bytes(4,
+                               PbWriter()
+                                   .Bytes(1, PbWriter::Label("path", "/a"))
+                                   .Bytes(7, histogram)
+                                   .Data())
+                        .Bytes(4,
+                               PbWriter()
+                                   .Bytes(1, PbWriter::Label("path", "/b"))
+                                   .Bytes(7, histogram)
+                                   .Data())
+                        .Data();
+    string data = PbWriter::Delimited(family);
+
+    PipelineEventGroup eGroup(make_shared<SourceBuffer>());
+    size_t consumed = 0;
+    APSARA_TEST_TRUE(mParser.Parse(data, eGroup, consumed));
+    APSARA_TEST_EQUAL(12UL, eGroup.GetEvents().size());
+    vector<string> les = {"1e-05", "2.5", "1e+06", "+Inf"};
+    vector<double> counts = {1, 6, 9, 10};
+    for (size_t i = 0; i < les.size(); ++i) {
+        APSARA_TEST_EQUAL("request_duration_seconds_bucket", GetEvent(eGroup, i).GetName());
+        APSARA_TEST_EQUAL("/a", GetEvent(eGroup, i).GetTag("path"));
+        APSARA_TEST_EQUAL(les[i], GetEvent(eGroup, i).GetTag("le").to_string());
+        APSARA_TEST_EQUAL(counts[i], GetValue(eGroup, i));
+    }
+    APSARA_TEST_EQUAL("request_duration_seconds_sum", GetEvent(eGroup, 4).GetName());
+    APSARA_TEST_EQUAL(12.5, GetValue(eGroup, 4));
+    APSARA_TEST_EQUAL("request_duration_seconds_count", GetEvent(eGroup, 5).GetName());
+    APSARA_TEST_EQUAL(10.0, GetValue(eGroup, 5));
+    // formatted bounds are shared by metrics of the same family
+    APSARA_TEST_EQUAL("/b", GetEvent(eGroup, 6).GetTag("path"));
+    APSARA_TEST_EQUAL(GetEvent(eGroup, 0).GetTag("le").data(), GetEvent(eGroup, 6).GetTag("le").data());
+}
+
+void ProtobufParserUnittest::TestParseNativeHistogram() {
+    // schema 0, i.e., bucket i is (2^(i-1), 2^i]
+    string histogram = PbWriter()
+                           .Varint(1, 7)
+                           .Double(2, 3.5)
+                           .Sint(5, 0)
+                           .Double(6, 0.001)
+                           .Varint(7, 1)
+                           .Bytes(9, PbWriter().Sint(1, 1).Varint(2, 1).Data())
+                           .Sint(10, 3)
+                           .Bytes(12, PbWriter().Sint(1, 0).Varint(2, 2).Data())
+                           .Data();
+    // packed deltas
+    string packed;
+    PbWriter::AppendVarint(packed, 4); // zigzag of 2
+    PbWriter::AppendVarint(packed, 1); // zigzag of -1
+    histogram = PbWriter().Bytes(13, packed).Data() + histogram;
+    string family = PbWriter()
+                        .Bytes(1, "native_seconds")
+                        .Varint(3, 4)
+                        .Bytes(4, PbWriter().Bytes(7, histogram).Data())
+                        .Data();
+    string data = PbWriter::Delimited(family);
+
+    PipelineEventGroup eGroup(make_shared<SourceBuffer>());
+    size_t consumed = 0;
+    APSARA_TEST_TRUE(mParser.Parse(data, eGroup, consumed));
+    APSARA_TEST_EQUAL(7UL, eGroup.GetEvents().size());
+    vector<string> les = {"-1", "0.001", "1", "2", "+Inf"};
+    vector<double> counts = {3, 4, 6, 7, 7};
+    for (size_t i = 0; i < les.size(); ++i) {
+        APSARA_TEST_EQUAL("native_seconds_bucket", GetEvent(eGroup, i).GetName());
+        APSARA_TEST_EQUAL(les[i], GetEvent(eGroup, i).GetTag("le").to_string());
+        APSARA_TEST_EQUAL(counts[i], GetValue(eGroup, i));
+    }
+    APSARA_TEST_EQUAL(3.5, GetValue(eGroup, 5));
+    APSARA_TEST_EQUAL(7.0, GetValue(eGroup, 6));
+}
+
+void ProtobufParserUnittest::TestParseIncomplete() {
+    auto gauge = [](const string& name, double value) {
+        string metric = PbWriter().Bytes(2, PbWriter().Double(1, value).Data()).Data();
+        return PbWriter::Delimited(PbWriter().Bytes(1, name).Varint(3, 1).Bytes(4, metric).Data());
+    };
+    string first = gauge("a", 1);
+    string second = gauge("b", 2);
+    string data = first + second;
+    {
+        // incomplete message is left for the next call
+        PipelineEventGroup eGroup(make_shared<SourceBuffer>());
+        size_t consumed = 0;
+        APSARA_TEST_TRUE(mParser.Parse(StringView(data.data(), data.size() - 1), eGroup, consumed));
+        APSARA_TEST_EQUAL(first.size(), consumed);
+        APSARA_TEST_EQUAL(1UL, eGroup.GetEvents().size());
+        APSARA_TEST_TRUE(mParser.Parse(StringView(data.data() + consumed, 0), eGroup, consumed));
+        APSARA_TEST_EQUAL(0UL, consumed);
+    }
+    {
+        // invalid message
+        string invalid = PbWriter::Delimited(string("\x0a\x10" "abc", 5));
+        PipelineEventGroup eGroup(make_shared<SourceBuffer>());
+        size_t consumed = 0;
+        APSARA_TEST_FALSE(mParser.Parse(first + invalid, eGroup, consumed));
+        APSARA_TEST_EQUAL(first.size(), consumed);
+    }
+}
+
+void ProtobufParserUnittest::TestIsProtobufContentType() {
+    APSARA_TEST_TRUE(ProtobufParser::IsProtobufContentType(
+        "application/vnd.google.protobuf; proto=io.prometheus.client.MetricFamily; encoding=delimited"));
+    APSARA_TEST_FALSE(ProtobufParser::IsProtobufContentType("text/plain; version=0.0.4; charset=utf-8"));
+    APSARA_TEST_FALSE(ProtobufParser::IsProtobufContentType("application/vnd.google.protobuf"));
+}
+
+UNIT_TEST_CASE(ProtobufParserUnittest, TestParseCounterAndGauge)
+UNIT_TEST_CASE(ProtobufParserUnittest, TestParseSummary)
+UNIT_TEST_CASE(ProtobufParserUnittest, TestParseHistogram)
+UNIT_TEST_CASE(ProtobufParserUnittest, TestParseNativeHistogram)
+UNIT_TEST_CASE(ProtobufParserUnittest, TestParseIncomplete)
+UNIT_TEST_CASE(ProtobufParserUnittest, TestIsProtobufContentType)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
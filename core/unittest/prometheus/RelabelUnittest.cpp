@@ -49,6 +49,7 @@ public:
     void TestLowerCase();
     void TestUpperCase();
     void TestMultiRelabel();
+    void TestRelabelResultCache();
 };
 
 
@@ -512,6 +513,37 @@ void RelabelConfigUnittest::TestMultiRelabel() {
     APSARA_TEST_TRUE(configList.Process(result));
 }
 
+void RelabelConfigUnittest::TestRelabelResultCache() {
+    RelabelResultCache cache(2);
+    auto result = make_shared<RelabelResult>();
+    result->mKeep = true;
+    cache.Insert(1, result);
+    cache.Insert(2, make_shared<RelabelResult>());
+    APSARA_TEST_EQUAL(result, cache.Find(1));
+    APSARA_TEST_FALSE(cache.Find(2)->mKeep);
+    APSARA_TEST_EQUAL(nullptr, cache.Find(3));
+
+    // current generation is full and becomes the previous one
+    cache.Insert(3, make_shared<RelabelResult>());
+    APSARA_TEST_EQUAL(2U, cache.mPrevious.size());
+    APSARA_TEST_EQUAL(1U, cache.mCurrent.size());
+
+    // results in use are promoted back
+    APSARA_TEST_EQUAL(result, cache.Find(1));
+    APSARA_TEST_EQUAL(2U, cache.mCurrent.size());
+    APSARA_TEST_EQUAL(1U, cache.mPrevious.size());
+
+    // results not in use are evicted
+    cache.Insert(4, make_shared<RelabelResult>());
+    APSARA_TEST_EQUAL(3U, cache.Size());
+    APSARA_TEST_EQUAL(nullptr, cache.Find(2));
+    APSARA_TEST_EQUAL(result, cache.Find(1));
+
+    RelabelResultCache disabledCache(0);
+    disabledCache.Insert(1, result);
+    APSARA_TEST_EQUAL(0U, disabledCache.Size());
+}
+
 UNIT_TEST_CASE(ActionConverterUnittest, TestStringToAction)
 UNIT_TEST_CASE(ActionConverterUnittest, TestActionToString)
 
@@ -529,6 +561,7 @@ UNIT_TEST_CASE(RelabelConfigUnittest, TestKeepEqual)
 UNIT_TEST_CASE(RelabelConfigUnittest, TestLowerCase)
 UNIT_TEST_CASE(RelabelConfigUnittest, TestUpperCase)
 UNIT_TEST_CASE(RelabelConfigUnittest, TestMultiRelabel)
+UNIT_TEST_CASE(RelabelConfigUnittest, TestRelabelResultCache)
 
 } // namespace logtail
 
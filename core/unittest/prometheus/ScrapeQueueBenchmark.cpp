@@ -0,0 +1,256 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/http/AsynCurlRunner.h"
+#include "prometheus/async/PromFuture.h"
+#include "prometheus/component/ScrapeQueue.h"
+#include "prometheus/component/ScrapeTimerEvent.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+static const size_t kTargetCnt = 400;
+static const size_t kSeriesPerTarget = 1000;
+static const chrono::milliseconds kResponseDelay(100);
+static const chrono::milliseconds kSampleInterval(20);
+
+// a local farm of slow exporters behind one listening port, which answers each GET request on a keep-alive
+// connection with the same exposition after a fixed delay
+class MockTargetFarm {
+public:
+    bool Start() {
+        mListenFd = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(mListenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (bind(mListenFd, reinterpret_cast<sockaddr*>(&addr), len) != 0 || listen(mListenFd, 1024) != 0
+            || getsockname(mListenFd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            return false;
+        }
+        mPort = ntohs(addr.sin_port);
+
+        string body;
+        for (size_t i = 0; i < kSeriesPerTarget; ++i) {
+            body += "test_metric{series=\"" + to_string(i) + "\",job=\"mock\"} " + to_string(i) + "\n";
+        }
+        mResponse = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+            + to_string(body.size()) + "\r\n\r\n" + body;
+        mIsRunning = true;
+        mThread = thread(&MockTargetFarm::Run, this);
+        return true;
+    }
+
+    void Stop() {
+        mIsRunning = false;
+        if (mThread.joinable()) {
+            mThread.join();
+        }
+        close(mListenFd);
+    }
+
+    int32_t GetPort() const { return mPort; }
+
+private:
+    void Run() {
+        vector<pollfd> fds{{mListenFd, POLLIN, 0}};
+        map<int, string> buffers;
+        multimap<chrono::steady_clock::time_point, int> dueResponses;
+        char buf[4096];
+        while (mIsRunning) {
+            auto now = chrono::steady_clock::now();
+            while (!dueResponses.empty() && dueResponses.begin()->first <= now) {
+                SendAll(dueResponses.begin()->second);
+                dueResponses.erase(dueResponses.begin());
+            }
+            int timeout = 10;
+            if (!dueResponses.empty()) {
+                auto wait = chrono::duration_cast<chrono::milliseconds>(dueResponses.begin()->first - now).count();
+                timeout = static_cast<int>(min<int64_t>(timeout, wait + 1));
+            }
+            if (poll(fds.data(), fds.size(), timeout) <= 0) {
+                continue;
+            }
+            for (size_t i = 1; i < fds.size(); ++i) {
+                if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                    continue;
+                }
+                auto n = recv(fds[i].fd, buf, sizeof(buf), 0);
+                if (n <= 0) {
+                    close(fds[i].fd);
+                    buffers.erase(fds[i].fd);
+                    fds[i].fd = -1;
+                    continue;
+                }
+                auto& buffer = buffers[fds[i].fd];
+                buffer.append(buf, n);
+                for (auto pos = buffer.find("\r\n\r\n"); pos != string::npos; pos = buffer.find("\r\n\r\n")) {
+                    dueResponses.emplace(chrono::steady_clock::now() + kResponseDelay, fds[i].fd);
+                    buffer.erase(0, pos + 4);
+                }
+            }
+            fds.erase(remove_if(fds.begin() + 1, fds.end(), [](const pollfd& p) { return p.fd < 0; }), fds.end());
+            if (fds[0].revents & POLLIN) {
+                int fd = accept(mListenFd, nullptr, nullptr);
+                if (fd >= 0) {
+                    fds.push_back({fd, POLLIN, 0});
+                }
+            }
+        }
+        for (size_t i = 1; i < fds.size(); ++i) {
+            close(fds[i].fd);
+        }
+    }
+
+    void SendAll(int fd) {
+        size_t sent = 0;
+        while (sent < mResponse.size()) {
+            auto n = send(fd, mResponse.data() + sent, mResponse.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                return;
+            }
+            sent += n;
+        }
+    }
+
+    int mListenFd = -1;
+    int32_t mPort = 0;
+    string mResponse;
+    atomic_bool mIsRunning = false;
+    thread mThread;
+};
+
+// scrapes all targets of the farm at the same instant, as targets of a job without offsets, and reports the peak of
+// in-flight scrapes and the process CPU time of each sample window, with and without the in-flight budget
+class ScrapeQueueBenchmark : public testing::Test {
+public:
+    void TestBurstScrape();
+
+protected:
+    static void SetUpTestCase() {
+        AsynCurlRunner::GetInstance()->Init();
+        APSARA_TEST_TRUE_FATAL(sFarm.Start());
+    }
+
+    static void TearDownTestCase() {
+        AsynCurlRunner::GetInstance()->Stop();
+        sFarm.Stop();
+    }
+
+private:
+    static void ScrapeOnce(size_t maxInFlight);
+
+    static MockTargetFarm sFarm;
+};
+
+MockTargetFarm ScrapeQueueBenchmark::sFarm;
+
+void ScrapeQueueBenchmark::ScrapeOnce(size_t maxInFlight) {
+    auto* queue = ScrapeQueue::GetInstance();
+    queue->mMaxInFlightCnt = maxInFlight == 0 ? numeric_limits<size_t>::max() : maxInFlight;
+    queue->mScrapeQueueingDelayMs = make_shared<Counter>("delay");
+
+    atomic_size_t doneCnt = 0;
+    atomic_size_t failCnt = 0;
+    auto execTime = chrono::steady_clock::now();
+    auto cpuStart = clock();
+    for (size_t i = 0; i < kTargetCnt; ++i) {
+        auto future = make_shared<PromFuture<HttpResponse&, uint64_t>>();
+        future->AddDoneCallback([&doneCnt, &failCnt](HttpResponse& response, uint64_t) {
+            if (response.GetStatusCode() != 200) {
+                ++failCnt;
+            }
+            ++doneCnt;
+            return true;
+        });
+        auto request = make_unique<PromHttpRequest>("GET",
+                                                    false,
+                                                    "127.0.0.1",
+                                                    sFarm.GetPort(),
+                                                    "/metrics/" + to_string(i),
+                                                    "",
+                                                    map<string, string>(),
+                                                    "",
+                                                    HttpResponse(),
+                                                    30,
+                                                    1,
+                                                    future);
+        ScrapeTimerEvent(execTime, std::move(request)).Execute();
+    }
+
+    size_t peakInFlight = 0;
+    vector<double> cpuMs;
+    auto lastClock = cpuStart;
+    while (doneCnt.load() < kTargetCnt) {
+        this_thread::sleep_for(kSampleInterval);
+        peakInFlight = max(peakInFlight, queue->InFlightCount());
+        auto curClock = clock();
+        cpuMs.push_back((curClock - lastClock) * 1000.0 / CLOCKS_PER_SEC);
+        lastClock = curClock;
+    }
+    auto elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - execTime).count();
+
+    double mean = 0, maxCpu = 0, variance = 0;
+    for (auto v : cpuMs) {
+        mean += v;
+        maxCpu = max(maxCpu, v);
+    }
+    mean /= cpuMs.size();
+    for (auto v : cpuMs) {
+        variance += (v - mean) * (v - mean);
+    }
+    cout << "max in-flight " << (maxInFlight == 0 ? string("unlimited") : to_string(maxInFlight))
+         << ": peak in-flight " << peakInFlight << ", elapsed " << elapsedMs << " ms, failed " << failCnt.load()
+         << ", avg queueing delay " << queue->mScrapeQueueingDelayMs->GetValue() / kTargetCnt << " ms, cpu per "
+         << kSampleInterval.count() << "ms window: max " << maxCpu << " ms, stddev " << sqrt(variance / cpuMs.size())
+         << " ms" << endl;
+    APSARA_TEST_EQUAL(0U, failCnt.load());
+    if (maxInFlight > 0) {
+        APSARA_TEST_TRUE(peakInFlight <= maxInFlight);
+    }
+    queue->mMaxInFlightCnt = numeric_limits<size_t>::max();
+}
+
+void ScrapeQueueBenchmark::TestBurstScrape() {
+    ScrapeOnce(0);
+    ScrapeOnce(kTargetCnt / 10);
+}
+
+UNIT_TEST_CASE(ScrapeQueueBenchmark, TestBurstScrape)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
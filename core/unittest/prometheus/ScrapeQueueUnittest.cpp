@@ -0,0 +1,109 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "common/http/AsynCurlRunner.h"
+#include "prometheus/component/ScrapeQueue.h"
+#include "prometheus/component/ScrapeTimerEvent.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class ScrapeQueueUnittest : public testing::Test {
+public:
+    void TestBudget();
+    void TestUnlimited();
+    void TestScrapeTimerEvent();
+
+protected:
+    void SetUp() override {
+        mQueue = ScrapeQueue::GetInstance();
+        mQueue->mInFlightCnt = 0;
+        mQueue->mPending.clear();
+        mQueue->mScrapeQueueingDelayMs = make_shared<Counter>("delay");
+        AsynCurlRunner::GetInstance()->mQueue.Clear();
+    }
+
+    void TearDown() override {
+        mQueue->mMaxInFlightCnt = numeric_limits<size_t>::max();
+        mQueue->mScrapeQueueingDelayMs.reset();
+    }
+
+private:
+    static unique_ptr<PromHttpRequest> MakeRequest() {
+        return make_unique<PromHttpRequest>(
+            "GET", false, "127.0.0.1", 8080, "/metrics", "", map<string, string>(), "", HttpResponse(), 10, 1, nullptr);
+    }
+
+    ScrapeQueue* mQueue = nullptr;
+};
+
+void ScrapeQueueUnittest::TestBudget() {
+    mQueue->mMaxInFlightCnt = 2;
+    auto execTime = chrono::steady_clock::now() - chrono::milliseconds(100);
+    for (size_t i = 0; i < 3; ++i) {
+        mQueue->PushRequest(MakeRequest(), execTime);
+    }
+    APSARA_TEST_EQUAL(2U, mQueue->InFlightCount());
+    APSARA_TEST_EQUAL(1U, mQueue->PendingCount());
+    APSARA_TEST_EQUAL(2U, AsynCurlRunner::GetInstance()->mQueue.Size());
+
+    // the pending one is sent once a scrape is done
+    unique_ptr<AsynHttpRequest> request;
+    APSARA_TEST_TRUE(AsynCurlRunner::GetInstance()->mQueue.TryPop(request));
+    APSARA_TEST_TRUE(static_cast<PromHttpRequest*>(request.get())->mFromScrapeQueue);
+    request->OnSendDone(request->mResponse);
+    APSARA_TEST_EQUAL(2U, mQueue->InFlightCount());
+    APSARA_TEST_EQUAL(0U, mQueue->PendingCount());
+    APSARA_TEST_EQUAL(2U, AsynCurlRunner::GetInstance()->mQueue.Size());
+
+    mQueue->OnScrapeDone();
+    mQueue->OnScrapeDone();
+    APSARA_TEST_EQUAL(0U, mQueue->InFlightCount());
+    APSARA_TEST_TRUE(mQueue->mScrapeQueueingDelayMs->GetValue() >= 300U);
+}
+
+void ScrapeQueueUnittest::TestUnlimited() {
+    for (size_t i = 0; i < 100; ++i) {
+        mQueue->PushRequest(MakeRequest(), chrono::steady_clock::now());
+    }
+    APSARA_TEST_EQUAL(100U, mQueue->InFlightCount());
+    APSARA_TEST_EQUAL(0U, mQueue->PendingCount());
+    APSARA_TEST_EQUAL(100U, AsynCurlRunner::GetInstance()->mQueue.Size());
+}
+
+void ScrapeQueueUnittest::TestScrapeTimerEvent() {
+    mQueue->mMaxInFlightCnt = 1;
+    ScrapeTimerEvent event1(chrono::steady_clock::now(), MakeRequest());
+    ScrapeTimerEvent event2(chrono::steady_clock::now(), MakeRequest());
+    APSARA_TEST_TRUE(event1.IsValid());
+    APSARA_TEST_TRUE(event1.Execute());
+    APSARA_TEST_TRUE(event2.Execute());
+    APSARA_TEST_EQUAL(1U, mQueue->InFlightCount());
+    APSARA_TEST_EQUAL(1U, mQueue->PendingCount());
+    APSARA_TEST_EQUAL(1U, AsynCurlRunner::GetInstance()->mQueue.Size());
+}
+
+UNIT_TEST_CASE(ScrapeQueueUnittest, TestBudget)
+UNIT_TEST_CASE(ScrapeQueueUnittest, TestUnlimited)
+UNIT_TEST_CASE(ScrapeQueueUnittest, TestScrapeTimerEvent)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -20,10 +20,12 @@
 
 #include "EventPool.h"
 #include "Flags.h"
+#include "models/MetricEvent.h"
 #include "models/RawEvent.h"
 #include "prometheus/Constants.h"
 #include "prometheus/component/StreamScraper.h"
 #include "prometheus/labels/Labels.h"
+#include "prometheus/labels/TextParser.h"
 #include "prometheus/schedulers/ScrapeConfig.h"
 #include "unittest/Unittest.h"
 
@@ -36,6 +38,8 @@ class StreamScraperUnittest : public testing::Test {
 public:
     void TestStreamMetricWriteCallback();
     void TestStreamSendMetric();
+    void TestStreamParse();
+    void TestStreamProtobuf();
 
 
 protected:
@@ -179,9 +183,88 @@ void StreamScraperUnittest::TestStreamSendMetric() {
     APSARA_TEST_EQUAL("go_memstats_alloc_bytes_total 1.5159292e+08", res1.GetEvents()[3].Cast<RawEvent>().GetContent());
 }
 
+void StreamScraperUnittest::TestStreamParse() {
+    EventPool eventPool{true};
+
+    Labels labels;
+    labels.Set(prometheus::ADDRESS_LABEL_NAME, "localhost:8080");
+    auto interner = make_shared<LabelInterner>();
+    auto streamScraper = make_shared<StreamScraper>(labels, 0, 0, "id", &eventPool, std::chrono::system_clock::now());
+    streamScraper->EnableParse(true, interner);
+
+    string body1 = "# TYPE go_gc_duration_seconds summary\n"
+                   "go_gc_duration_seconds{quantile=\"0\"} 1.5531e-05 1715829785083\n"
+                   "go_gc_duration_seconds{quan";
+    string body2 = "tile=\"0.25\"} 3.9357e-05 1715829785083\n"
+                   "go_goroutines 7";
+    StreamScraper::MetricWriteCallback(body1.data(), (size_t)1, (size_t)body1.length(), streamScraper.get());
+    StreamScraper::MetricWriteCallback(body2.data(), (size_t)1, (size_t)body2.length(), streamScraper.get());
+    streamScraper->FlushCache();
+    // raw data is released before the group is sent
+    body1.clear();
+    body2.clear();
+    streamScraper->SendMetrics();
+
+    auto& res = streamScraper->mItem[0]->mEventGroup;
+    APSARA_TEST_EQUAL(3UL, res.GetEvents().size());
+    APSARA_TEST_EQUAL(1UL, res.GetExtraSourceBuffers().count(interner->GetSourceBuffer()));
+    const auto& e0 = res.GetEvents()[0].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("go_gc_duration_seconds", e0.GetName());
+    APSARA_TEST_EQUAL("go_gc_duration_seconds", e0.GetTag(prometheus::NAME));
+    APSARA_TEST_EQUAL("0", e0.GetTag("quantile"));
+    APSARA_TEST_EQUAL(1715829785, e0.GetTimestamp());
+    APSARA_TEST_EQUAL(1.5531e-05, e0.GetValue<UntypedSingleValue>()->mValue);
+    const auto& e1 = res.GetEvents()[1].Cast<MetricEvent>();
+    APSARA_TEST_EQUAL("0.25", e1.GetTag("quantile"));
+    // metric names and label keys are interned
+    APSARA_TEST_EQUAL(e0.GetName().data(), e1.GetName().data());
+    APSARA_TEST_EQUAL("go_goroutines", res.GetEvents()[2].Cast<MetricEvent>().GetName());
+    APSARA_TEST_EQUAL(7.0, res.GetEvents()[2].Cast<MetricEvent>().GetValue<UntypedSingleValue>()->mValue);
+}
+
+void StreamScraperUnittest::TestStreamProtobuf() {
+    EventPool eventPool{true};
+
+    Labels labels;
+    labels.Set(prometheus::ADDRESS_LABEL_NAME, "localhost:8080");
+    auto streamScraper = make_shared<StreamScraper>(labels, 0, 0, "id", &eventPool, std::chrono::system_clock::now());
+    HttpResponse response;
+    response.AddHeader("content-type",
+                       "application/vnd.google.protobuf; proto=io.prometheus.client.MetricFamily; encoding=delimited");
+    streamScraper->EnableProtobuf(&response, true);
+
+    // MetricFamily{name: "go_goroutines", type: GAUGE, metric: [{gauge: {value: 7}}]}, delimited
+    string family = string("\x0a\x0dgo_goroutines\x18\x01\x22\x0b\x12\x09\x09", 22) + string(6, '\0')
+        + string("\x1c\x40", 2);
+    string body = string(1, static_cast<char>(family.size())) + family;
+    body += body;
+    // split in the middle of the second message
+    StreamScraper::MetricWriteCallback(body.data(), (size_t)1, (size_t)40, streamScraper.get());
+    APSARA_TEST_EQUAL(1UL, streamScraper->mEventGroup.GetEvents().size());
+    StreamScraper::MetricWriteCallback(body.data() + 40, (size_t)1, body.size() - 40, streamScraper.get());
+    streamScraper->FlushCache();
+    streamScraper->SendMetrics();
+
+    auto& res = streamScraper->mItem[0]->mEventGroup;
+    APSARA_TEST_EQUAL(2UL, res.GetEvents().size());
+    for (const auto& e : res.GetEvents()) {
+        APSARA_TEST_EQUAL("go_goroutines", e.Cast<MetricEvent>().GetName());
+        APSARA_TEST_EQUAL(7.0, e.Cast<MetricEvent>().GetValue<UntypedSingleValue>()->mValue);
+    }
+
+    // text is used if the exporter does not support protobuf
+    response.AddHeader("content-type", "text/plain; version=0.0.4");
+    streamScraper->Reset();
+    string text = "go_goroutines 7\n";
+    StreamScraper::MetricWriteCallback(text.data(), (size_t)1, text.size(), streamScraper.get());
+    APSARA_TEST_EQUAL(1UL, streamScraper->mEventGroup.GetEvents().size());
+    APSARA_TEST_TRUE(streamScraper->mEventGroup.GetEvents()[0].Is<RawEvent>());
+}
 
 UNIT_TEST_CASE(StreamScraperUnittest, TestStreamMetricWriteCallback)
 UNIT_TEST_CASE(StreamScraperUnittest, TestStreamSendMetric)
+UNIT_TEST_CASE(StreamScraperUnittest, TestStreamParse)
+UNIT_TEST_CASE(StreamScraperUnittest, TestStreamProtobuf)
 
 
 } // namespace logtail::prom
@@ -14,8 +14,18 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
 #include <string>
 
+#include "common/http/Constant.h"
+#include "common/http/HttpResponse.h"
+#include "models/EventPool.h"
+#include "models/RawEvent.h"
+#include "prometheus/Constants.h"
+#include "prometheus/component/StreamScraper.h"
 #include "prometheus/labels/TextParser.h"
 #include "unittest/Unittest.h"
 
@@ -27,6 +37,10 @@ class TextParserBenchmark : public testing::Test {
 public:
     void TestParse100M() const;
     void TestParse1000M() const;
+    // end to end cost from the curl write callback to MetricEvents, with parsing in processor or in scraper
+    void TestScrapeCallback100M() const;
+    // bytes transferred and parse cpu of a mock exporter with many histograms, in text and protobuf exposition
+    void TestScrapeProtobufVsText() const;
 
 protected:
     void SetUp() override {
@@ -47,6 +61,12 @@ protected:
     }
 
 private:
+    // feeds @data to the write callback in chunks of the size curl usually delivers
+    static void FeedCallback(const std::string& data, prom::StreamScraper& scraper);
+    static void GenerateHistograms(std::string& text, std::string& classicPb, std::string& nativePb);
+    // @return cpu seconds
+    static double ScrapeOnce(const std::string& data, const std::string& contentType, size_t& sampleCnt);
+
     std::string mRawData = R"""(
 test_metric1{k1="v1", k2="v2"} 2.0 1234567890
 test_metric2{k1="v1",k2="v2"} 9.9410452992e+10
@@ -87,8 +107,201 @@ void TextParserBenchmark::TestParse1000M() const {
     // elapsed: 4960MB in release mode
 }
 
+void TextParserBenchmark::FeedCallback(const std::string& data, prom::StreamScraper& scraper) {
+    static const size_t kChunkSize = 16 * 1024;
+    std::string chunk;
+    for (size_t pos = 0; pos < data.size(); pos += kChunkSize) {
+        chunk.assign(data, pos, std::min(kChunkSize, data.size() - pos));
+        prom::StreamScraper::MetricWriteCallback(chunk.data(), 1, chunk.size(), &scraper);
+    }
+    scraper.FlushCache();
+    scraper.SendMetrics();
+}
+
+void TextParserBenchmark::TestScrapeCallback100M() const {
+    EventPool eventPool{true};
+    Labels labels;
+    labels.Set(prometheus::ADDRESS_LABEL_NAME, "localhost:8080");
+    size_t rawCnt = 0;
+    size_t metricCnt = 0;
+    {
+        prom::StreamScraper scraper(labels, 0, 0, "id", &eventPool, std::chrono::system_clock::now());
+        auto start = std::chrono::high_resolution_clock::now();
+        FeedCallback(m100MData, scraper);
+        // the work done by ProcessorPromParseMetricNative afterwards
+        TextParser parser;
+        for (auto& item : scraper.mItem) {
+            for (const auto& e : item->mEventGroup.GetEvents()) {
+                auto metricEvent = item->mEventGroup.CreateMetricEvent(true);
+                if (parser.ParseLine(e.Cast<RawEvent>().GetContent(), *metricEvent)) {
+                    ++rawCnt;
+                }
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        cout << "parse in processor, elapsed: " << elapsed.count() << " seconds" << endl;
+    }
+    {
+        prom::StreamScraper scraper(labels, 0, 0, "id", &eventPool, std::chrono::system_clock::now());
+        scraper.EnableParse(true, std::make_shared<LabelInterner>());
+        auto start = std::chrono::high_resolution_clock::now();
+        FeedCallback(m100MData, scraper);
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        cout << "parse in scraper, elapsed: " << elapsed.count() << " seconds" << endl;
+        for (auto& item : scraper.mItem) {
+            metricCnt += item->mEventGroup.GetEvents().size();
+        }
+    }
+    APSARA_TEST_EQUAL(rawCnt, metricCnt);
+}
+
+namespace {
+
+void AppendVarint(std::string& data, uint64_t value) {
+    while (value >= 0x80) {
+        data.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    data.push_back(static_cast<char>(value));
+}
+
+void AppendTag(std::string& data, uint32_t field, uint32_t wireType) {
+    AppendVarint(data, (static_cast<uint64_t>(field) << 3) | wireType);
+}
+
+void AppendVarintField(std::string& data, uint32_t field, uint64_t value) {
+    AppendTag(data, field, 0);
+    AppendVarint(data, value);
+}
+
+void AppendDoubleField(std::string& data, uint32_t field, double value) {
+    AppendTag(data, field, 1);
+    char buf[8];
+    memcpy(buf, &value, sizeof(buf));
+    data.append(buf, sizeof(buf));
+}
+
+void AppendBytesField(std::string& data, uint32_t field, const std::string& value) {
+    AppendTag(data, field, 2);
+    AppendVarint(data, value.size());
+    data += value;
+}
+
+} // namespace
+
+void TextParserBenchmark::GenerateHistograms(std::string& text, std::string& classicPb, std::string& nativePb) {
+    static const size_t kSeriesCnt = 5000;
+    static const size_t kBucketCnt = 20;
+    const std::string name = "http_request_duration_seconds";
+    std::string classicFamily;
+    std::string nativeFamily;
+    AppendBytesField(classicFamily, 1, name);
+    AppendVarintField(classicFamily, 3, 4);
+    nativeFamily = classicFamily;
+    text = "# HELP " + name + " request duration\n# TYPE " + name + " histogram\n";
+    for (size_t i = 0; i < kSeriesCnt; ++i) {
+        std::string path = "/api/v1/item/" + std::to_string(i);
+        std::string labels = "method=\"GET\",path=\"" + path + "\",code=\"200\"";
+        std::string pbLabels;
+        for (const auto& kv : {std::make_pair("method", "GET"), std::make_pair("code", "200")}) {
+            std::string label;
+            AppendBytesField(label, 1, kv.first);
+            AppendBytesField(label, 2, kv.second);
+            AppendBytesField(pbLabels, 1, label);
+        }
+        std::string pathLabel;
+        AppendBytesField(pathLabel, 1, "path");
+        AppendBytesField(pathLabel, 2, path);
+        AppendBytesField(pbLabels, 1, pathLabel);
+
+        // buckets of schema 0, i.e., le of 2^j
+        std::string classic;
+        AppendVarintField(classic, 1, kBucketCnt * 10);
+        AppendDoubleField(classic, 2, 123.5);
+        std::string native = classic;
+        AppendVarintField(native, 5, 0);
+        std::string span;
+        AppendVarintField(span, 1, 0);
+        AppendVarintField(span, 2, kBucketCnt);
+        AppendBytesField(native, 12, span);
+        std::string deltas;
+        for (size_t j = 0; j < kBucketCnt; ++j) {
+            double le = static_cast<double>(1ULL << j);
+            std::string bucket;
+            AppendVarintField(bucket, 1, (j + 1) * 10);
+            AppendDoubleField(bucket, 2, le);
+            AppendBytesField(classic, 3, bucket);
+            AppendVarint(deltas, j == 0 ? 20 : 0);
+            text += name + "_bucket{" + labels + ",le=\"" + std::to_string(1ULL << j) + "\"} "
+                + std::to_string((j + 1) * 10) + "\n";
+        }
+        AppendBytesField(native, 13, deltas);
+        text += name + "_bucket{" + labels + ",le=\"+Inf\"} " + std::to_string(kBucketCnt * 10) + "\n";
+        text += name + "_sum{" + labels + "} 123.5\n";
+        text += name + "_count{" + labels + "} " + std::to_string(kBucketCnt * 10) + "\n";
+
+        std::string metric = pbLabels;
+        AppendBytesField(metric, 7, classic);
+        AppendBytesField(classicFamily, 4, metric);
+        metric = pbLabels;
+        AppendBytesField(metric, 7, native);
+        AppendBytesField(nativeFamily, 4, metric);
+    }
+    classicPb.clear();
+    AppendVarint(classicPb, classicFamily.size());
+    classicPb += classicFamily;
+    nativePb.clear();
+    AppendVarint(nativePb, nativeFamily.size());
+    nativePb += nativeFamily;
+}
+
+double TextParserBenchmark::ScrapeOnce(const std::string& data, const std::string& contentType, size_t& sampleCnt) {
+    EventPool eventPool{true};
+    Labels labels;
+    labels.Set(prometheus::ADDRESS_LABEL_NAME, "localhost:8080");
+    prom::StreamScraper scraper(labels, 0, 0, "id", &eventPool, std::chrono::system_clock::now());
+    HttpResponse response;
+    response.AddHeader(CONTENT_TYPE, contentType);
+    scraper.EnableProtobuf(&response, true);
+    // text is parsed in scraper as well for a fair comparison
+    scraper.EnableParse(true, std::make_shared<LabelInterner>());
+    auto start = std::clock();
+    FeedCallback(data, scraper);
+    double cpu = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+    sampleCnt = 0;
+    for (auto& item : scraper.mItem) {
+        sampleCnt += item->mEventGroup.GetEvents().size();
+    }
+    return cpu;
+}
+
+void TextParserBenchmark::TestScrapeProtobufVsText() const {
+    std::string text;
+    std::string classicPb;
+    std::string nativePb;
+    GenerateHistograms(text, classicPb, nativePb);
+    static const std::string kPbContentType
+        = "application/vnd.google.protobuf; proto=io.prometheus.client.MetricFamily; encoding=delimited";
+
+    size_t textCnt = 0;
+    size_t classicCnt = 0;
+    size_t nativeCnt = 0;
+    double textCpu = ScrapeOnce(text, "text/plain; version=0.0.4", textCnt);
+    double classicCpu = ScrapeOnce(classicPb, kPbContentType, classicCnt);
+    double nativeCpu = ScrapeOnce(nativePb, kPbContentType, nativeCnt);
+    cout << "text: " << text.size() << " bytes, " << textCpu << " cpu seconds, " << textCnt << " samples" << endl;
+    cout << "protobuf classic histogram: " << classicPb.size() << " bytes, " << classicCpu << " cpu seconds, "
+         << classicCnt << " samples" << endl;
+    cout << "protobuf native histogram: " << nativePb.size() << " bytes, " << nativeCpu << " cpu seconds, "
+         << nativeCnt << " samples" << endl;
+    APSARA_TEST_EQUAL(textCnt, classicCnt);
+    APSARA_TEST_EQUAL(textCnt, nativeCnt);
+}
+
 UNIT_TEST_CASE(TextParserBenchmark, TestParse100M)
 UNIT_TEST_CASE(TextParserBenchmark, TestParse1000M)
+UNIT_TEST_CASE(TextParserBenchmark, TestScrapeCallback100M)
+UNIT_TEST_CASE(TextParserBenchmark, TestScrapeProtobufVsText)
 
 } // namespace logtail
 
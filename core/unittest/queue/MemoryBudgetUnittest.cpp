@@ -0,0 +1,206 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "collection_pipeline/queue/BoundedProcessQueue.h"
+#include "collection_pipeline/queue/ProcessQueueManager.h"
+#include "collection_pipeline/queue/QueueKeyManager.h"
+#include "collection_pipeline/queue/SenderQueueItem.h"
+#include "common/memory/MemoryBudget.h"
+#include "common/memory/SourceBuffer.h"
+#include "models/PipelineEventGroup.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class MemoryBudgetUnittest : public testing::Test {
+public:
+    void TestSourceBufferUsage();
+    void TestSenderQueueItemUsage();
+    void TestPipelineUsage();
+    void TestThrottleOnOverload();
+    void TestThrottlePerPipeline();
+
+protected:
+    void TearDown() override {
+        MemoryBudget::GetInstance()->SetLimit(0);
+        ProcessQueueManager::GetInstance()->Clear();
+        QueueKeyManager::GetInstance()->Clear();
+    }
+
+private:
+    static unique_ptr<ProcessQueueItem> GenerateItem(size_t contentSize) {
+        PipelineEventGroup g(make_shared<SourceBuffer>());
+        g.AddLogEvent()->SetContent(string("content"), string(contentSize, 'a'));
+        return make_unique<ProcessQueueItem>(std::move(g), 0);
+    }
+};
+
+void MemoryBudgetUnittest::TestSourceBufferUsage() {
+    auto* budget = MemoryBudget::GetInstance();
+    auto base = budget->GetUsage(MemoryBudget::Category::SOURCE_BUFFER);
+    {
+        SourceBuffer buffer;
+        APSARA_TEST_EQUAL(base + 4096, budget->GetUsage(MemoryBudget::Category::SOURCE_BUFFER));
+
+        // from the current chunk
+        buffer.AllocateStringBuffer(2999);
+        APSARA_TEST_EQUAL(base + 4096, budget->GetUsage(MemoryBudget::Category::SOURCE_BUFFER));
+
+        // new chunk
+        buffer.AllocateStringBuffer(1499);
+        APSARA_TEST_EQUAL(base + 4096 + 8192, budget->GetUsage(MemoryBudget::Category::SOURCE_BUFFER));
+
+        // large allocation
+        buffer.AllocateStringBuffer(1024 * 1024 - 1);
+        APSARA_TEST_EQUAL(base + 4096 + 8192 + 1024 * 1024, budget->GetUsage(MemoryBudget::Category::SOURCE_BUFFER));
+
+        // moved
+        SourceBuffer other(std::move(buffer));
+        APSARA_TEST_EQUAL(base + 4096 + 8192 + 1024 * 1024, budget->GetUsage(MemoryBudget::Category::SOURCE_BUFFER));
+
+        // move assigned, the chunks of the assigned buffer are released
+        SourceBuffer assigned;
+        assigned.AllocateStringBuffer(1024 * 1024 - 1);
+        APSARA_TEST_EQUAL(base + 2 * 4096 + 8192 + 2 * 1024 * 1024,
+                          budget->GetUsage(MemoryBudget::Category::SOURCE_BUFFER));
+        assigned = std::move(other);
+        APSARA_TEST_EQUAL(base + 4096 + 8192 + 1024 * 1024, budget->GetUsage(MemoryBudget::Category::SOURCE_BUFFER));
+    }
+    APSARA_TEST_EQUAL(base, budget->GetUsage(MemoryBudget::Category::SOURCE_BUFFER));
+}
+
+void MemoryBudgetUnittest::TestSenderQueueItemUsage() {
+    auto* budget = MemoryBudget::GetInstance();
+    auto base = budget->GetUsage(MemoryBudget::Category::SENDER_QUEUE_ITEM);
+    {
+        SenderQueueItem item(string(100, 'a'), 100, nullptr, 0);
+        APSARA_TEST_EQUAL(base + 100, budget->GetUsage(MemoryBudget::Category::SENDER_QUEUE_ITEM));
+
+        unique_ptr<SenderQueueItem> copy(item.Clone());
+        APSARA_TEST_EQUAL(base + 200, budget->GetUsage(MemoryBudget::Category::SENDER_QUEUE_ITEM));
+    }
+    APSARA_TEST_EQUAL(base, budget->GetUsage(MemoryBudget::Category::SENDER_QUEUE_ITEM));
+}
+
+void MemoryBudgetUnittest::TestPipelineUsage() {
+    auto* budget = MemoryBudget::GetInstance();
+    auto gauge = budget->GetPipelineUsage("test_config_1");
+    // shared by components of the same pipeline
+    APSARA_TEST_EQUAL(gauge, budget->GetPipelineUsage("test_config_1"));
+    APSARA_TEST_NOT_EQUAL(gauge, budget->GetPipelineUsage("test_config_2"));
+
+    // released once all components of the pipeline are gone
+    gauge.reset();
+    auto other = budget->GetPipelineUsage("test_config_3");
+    APSARA_TEST_TRUE(budget->mPipelineUsages.find("test_config_1") == budget->mPipelineUsages.end());
+    APSARA_TEST_TRUE(budget->mPipelineUsages.find("test_config_2") == budget->mPipelineUsages.end());
+}
+
+// synthetic overload: the input keeps producing as long as it is allowed, while the processor is stalled
+void MemoryBudgetUnittest::TestThrottleOnOverload() {
+    static const size_t kContentSize = 256 * 1024;
+
+    auto* budget = MemoryBudget::GetInstance();
+    auto* manager = ProcessQueueManager::GetInstance();
+    CollectionPipelineContext ctx;
+    ctx.SetConfigName("test_config");
+    QueueKey key = QueueKeyManager::GetInstance()->GetKey("test_config");
+    manager->CreateOrUpdateBoundedQueue(key, 0, ctx);
+    manager->EnablePop("test_config");
+    auto* queue = static_cast<BoundedProcessQueue*>(manager->mQueues[key].first->get());
+
+    int64_t limit = budget->GetUsage() + 3 * kContentSize;
+    budget->SetLimit(limit);
+
+    // the input stops well before the queue is full
+    size_t dataSize = 0;
+    while (manager->IsValidToPush(key)) {
+        auto item = GenerateItem(kContentSize);
+        dataSize += item->mEventGroup.DataSize();
+        APSARA_TEST_EQUAL(QueueStatus::OK, manager->PushQueue(key, std::move(item)));
+    }
+    APSARA_TEST_EQUAL(3U, queue->Size());
+    APSARA_TEST_TRUE(queue->IsValidToPush());
+    APSARA_TEST_TRUE(budget->GetUsage() >= limit);
+    APSARA_TEST_EQUAL(dataSize, queue->mPipelineMemoryUsageBytes->GetValue());
+
+    // the input is resumed only after the usage drops below 90% of the budget
+    unique_ptr<ProcessQueueItem> item;
+    string configName;
+    APSARA_TEST_TRUE(manager->PopItem(0, item, configName));
+    dataSize -= item->mEventGroup.DataSize();
+    APSARA_TEST_TRUE(budget->GetUsage() >= limit / 10 * 9);
+    APSARA_TEST_FALSE(manager->IsValidToPush(key));
+    item.reset();
+    APSARA_TEST_TRUE(budget->GetUsage() < limit / 10 * 9);
+    APSARA_TEST_TRUE(manager->IsValidToPush(key));
+    APSARA_TEST_EQUAL(dataSize, queue->mPipelineMemoryUsageBytes->GetValue());
+}
+
+// a pipeline blocked by its flusher is throttled, while the others go on
+void MemoryBudgetUnittest::TestThrottlePerPipeline() {
+    static const size_t kContentSize = 256 * 1024;
+
+    auto* budget = MemoryBudget::GetInstance();
+    auto* manager = ProcessQueueManager::GetInstance();
+    CollectionPipelineContext ctx1;
+    ctx1.SetConfigName("test_config_1");
+    QueueKey key1 = QueueKeyManager::GetInstance()->GetKey("test_config_1");
+    manager->CreateOrUpdateBoundedQueue(key1, 0, ctx1);
+    CollectionPipelineContext ctx2;
+    ctx2.SetConfigName("test_config_2");
+    QueueKey key2 = QueueKeyManager::GetInstance()->GetKey("test_config_2");
+    manager->CreateOrUpdateBoundedQueue(key2, 0, ctx2);
+
+    int64_t limit = budget->GetUsage() + 3 * kContentSize;
+    budget->SetLimit(limit);
+
+    APSARA_TEST_EQUAL(QueueStatus::OK, manager->PushQueue(key2, GenerateItem(100)));
+    while (manager->IsValidToPush(key1)) {
+        APSARA_TEST_EQUAL(QueueStatus::OK, manager->PushQueue(key1, GenerateItem(kContentSize)));
+    }
+    auto* queue1 = static_cast<BoundedProcessQueue*>(manager->mQueues[key1].first->get());
+    APSARA_TEST_EQUAL(3U, queue1->Size());
+    APSARA_TEST_TRUE(queue1->IsValidToPush());
+    APSARA_TEST_TRUE(budget->IsExceeded());
+
+    APSARA_TEST_TRUE(manager->IsValidToPush(key2));
+    APSARA_TEST_EQUAL(QueueStatus::OK, manager->PushQueue(key2, GenerateItem(100)));
+    APSARA_TEST_TRUE(manager->IsValidToPush(key2));
+    APSARA_TEST_FALSE(manager->IsValidToPush(key1));
+
+    // the pipelines to throttle are picked again after a while, once another pipeline buffers the most
+    APSARA_TEST_EQUAL(QueueStatus::OK, manager->PushQueue(key2, GenerateItem(4 * kContentSize)));
+    APSARA_TEST_TRUE(manager->IsValidToPush(key2));
+    APSARA_TEST_FALSE(manager->IsValidToPush(key1));
+    this_thread::sleep_for(ProcessQueueInterface::kMemoryBudgetCheckInterval);
+    APSARA_TEST_FALSE(manager->IsValidToPush(key2));
+    APSARA_TEST_TRUE(manager->IsValidToPush(key1));
+}
+
+UNIT_TEST_CASE(MemoryBudgetUnittest, TestSourceBufferUsage)
+UNIT_TEST_CASE(MemoryBudgetUnittest, TestSenderQueueItemUsage)
+UNIT_TEST_CASE(MemoryBudgetUnittest, TestPipelineUsage)
+UNIT_TEST_CASE(MemoryBudgetUnittest, TestThrottleOnOverload)
+UNIT_TEST_CASE(MemoryBudgetUnittest, TestThrottlePerPipeline)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
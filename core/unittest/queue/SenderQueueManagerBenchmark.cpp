@@ -0,0 +1,87 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "collection_pipeline/queue/SenderQueueManager.h"
+#include "unittest/Unittest.h"
+#include "unittest/queue/FeedbackInterfaceMock.h"
+
+using namespace std;
+
+namespace logtail {
+
+static const size_t kQueueCnt = 5000;
+static const size_t kItemsCntLimit = 1000;
+static const chrono::seconds kDuration(2);
+
+// pushes items to a few random queues out of 5k queues each round, like the flusher runner loop, fetches available
+// items and completes them, and reports the number of items sent per second
+class SenderQueueManagerBenchmark : public testing::Test {
+public:
+    void TestFetch1PercentActive() { Fetch(kQueueCnt / 100); }
+    void TestFetch10PercentActive() { Fetch(kQueueCnt / 10); }
+
+protected:
+    static void SetUpTestCase() { BoundedSenderQueueInterface::SetFeedback(&sFeedback); }
+    void TearDown() override { SenderQueueManager::GetInstance()->Clear(); }
+
+private:
+    void Fetch(size_t activeQueueCnt);
+
+    static FeedbackInterfaceMock sFeedback;
+};
+
+FeedbackInterfaceMock SenderQueueManagerBenchmark::sFeedback;
+
+void SenderQueueManagerBenchmark::Fetch(size_t activeQueueCnt) {
+    auto* manager = SenderQueueManager::GetInstance();
+    CollectionPipelineContext ctx;
+    auto limiter = make_shared<ConcurrencyLimiter>("", kItemsCntLimit);
+    for (QueueKey key = 0; key < static_cast<QueueKey>(kQueueCnt); ++key) {
+        manager->CreateQueue(key, "", ctx, {{"region", limiter}}, 0);
+    }
+
+    mt19937 rng(0);
+    size_t sentCnt = 0;
+    vector<SenderQueueItem*> items;
+    auto start = chrono::steady_clock::now();
+    while (chrono::steady_clock::now() - start < kDuration) {
+        for (size_t i = 0; i < activeQueueCnt; ++i) {
+            QueueKey key = rng() % kQueueCnt;
+            manager->PushQueue(key, make_unique<SenderQueueItem>("content", 7, nullptr, key));
+        }
+        items.clear();
+        manager->GetAvailableItems(items, kItemsCntLimit);
+        for (auto* item : items) {
+            limiter->OnSendDone();
+            manager->RemoveItem(item->mQueueKey, item);
+        }
+        sentCnt += items.size();
+    }
+    auto elapsedSec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << kQueueCnt << " queues, " << activeQueueCnt << " pushed per round: " << sentCnt / elapsedSec << " items/s"
+         << endl;
+    APSARA_TEST_TRUE(sentCnt > 0U);
+}
+
+UNIT_TEST_CASE(SenderQueueManagerBenchmark, TestFetch1PercentActive)
+UNIT_TEST_CASE(SenderQueueManagerBenchmark, TestFetch10PercentActive)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
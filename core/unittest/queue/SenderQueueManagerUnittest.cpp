@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <filesystem>
+
+#include "app_config/AppConfig.h"
 #include "collection_pipeline/queue/ExactlyOnceQueueManager.h"
 #include "collection_pipeline/queue/QueueKeyManager.h"
 #include "collection_pipeline/queue/QueueParam.h"
@@ -21,6 +24,8 @@
 #include "unittest/Unittest.h"
 
 DECLARE_FLAG_INT32(sender_queue_gc_threshold_sec);
+DECLARE_FLAG_BOOL(enable_sender_queue_spill);
+DECLARE_FLAG_INT32(sender_queue_spill_extra_buffer_bytes);
 
 using namespace std;
 
@@ -35,6 +40,8 @@ public:
     void TestGetAvailableItems();
     void TestRemoveItem();
     void TestIsAllQueueEmpty();
+    void TestReadyQueues();
+    void TestSpillInBackground();
 
 protected:
     static void SetUpTestCase() {
@@ -43,6 +50,7 @@ protected:
         sManager->mDefaultQueueParam.mCapacity = 2;
         sManager->mDefaultQueueParam.mLowWatermark = 1;
         sManager->mDefaultQueueParam.mHighWatermark = 3;
+        AppConfig::GetInstance()->mBufferFilePath = GetProcessExecutionDir();
         for (size_t i = 0; i < 2; ++i) {
             auto cpt = make_shared<RangeCheckpoint>();
             cpt->index = i;
@@ -63,6 +71,8 @@ protected:
         ExactlyOnceQueueManager::GetInstance()->Clear();
         QueueKeyManager::GetInstance()->Clear();
         sConcurrencyLimiter = make_shared<ConcurrencyLimiter>("", 80);
+        BOOL_FLAG(enable_sender_queue_spill) = false;
+        INT32_FLAG(sender_queue_spill_extra_buffer_bytes) = 16 * 1024 * 1024;
     }
 
 private:
@@ -206,7 +216,7 @@ void SenderQueueManagerUnittest::TestGetAvailableItems() {
         sManager->GetAvailableItems(items, -1);
         APSARA_TEST_EQUAL(4U, items.size());
         for (auto& item : items) {
-            item->mStatus = SendingStatus::IDLE;
+            sManager->SetItemIdle(item);
         }
     }
     auto regionConcurrencyLimiter = FlusherSLS::GetRegionConcurrencyLimiter(mFlusher.mRegion);
@@ -276,6 +286,83 @@ void SenderQueueManagerUnittest::TestIsAllQueueEmpty() {
     }
 }
 
+void SenderQueueManagerUnittest::TestReadyQueues() {
+    auto limiter = make_shared<ConcurrencyLimiter>("", 80);
+    sManager->CreateQueue(0, sFlusherId, sCtx, {{"region", limiter}}, 0);
+    sManager->CreateQueue(1, sFlusherId, sCtx, {{"region", limiter}}, 0);
+    APSARA_TEST_TRUE(sManager->mReadyQueueKeys.empty());
+
+    // pushed queues become ready
+    auto item = GenerateItem();
+    auto ptr = item.get();
+    sManager->PushQueue(0, std::move(item));
+    sManager->PushQueue(1, GenerateItem());
+    sManager->PushQueue(1, GenerateItem());
+    APSARA_TEST_EQUAL(2U, sManager->mReadyQueueKeys.size());
+
+    // queues limited by concurrency limiter are still ready
+    limiter->SetCurrentLimit(2);
+    sManager->mSenderQueueBeginIndex = 0;
+    vector<SenderQueueItem*> items;
+    sManager->GetAvailableItems(items, 80);
+    APSARA_TEST_EQUAL(2U, items.size());
+    APSARA_TEST_EQUAL(1U, sManager->mReadyQueueKeys.size());
+    APSARA_TEST_EQUAL(1, sManager->mReadyQueueKeys[0]);
+
+    // items reset to idle make the queue ready again
+    sManager->SetItemIdle(ptr);
+    APSARA_TEST_EQUAL(2U, sManager->mReadyQueueKeys.size());
+    limiter->SetCurrentLimit(80);
+    items.clear();
+    sManager->GetAvailableItems(items, 80);
+    APSARA_TEST_EQUAL(2U, items.size());
+    APSARA_TEST_TRUE(sManager->mReadyQueueKeys.empty());
+    APSARA_TEST_TRUE(sManager->mReadyQueueKeySet.empty());
+
+    // nothing to fetch from queues not ready
+    items.clear();
+    sManager->GetAvailableItems(items, 80);
+    APSARA_TEST_TRUE(items.empty());
+}
+
+void SenderQueueManagerUnittest::TestSpillInBackground() {
+    BOOL_FLAG(enable_sender_queue_spill) = true;
+    INT32_FLAG(sender_queue_spill_extra_buffer_bytes) = 1;
+    sManager->CreateQueue(0, sFlusherId, sCtx, {{"region", sConcurrencyLimiter}}, 0);
+    auto& queue = sManager->mQueues.at(0);
+
+    // spilled items are written to disk by the spill thread instead of the pushing one
+    for (size_t i = 0; i < 10; ++i) {
+        APSARA_TEST_EQUAL(0, sManager->PushQueue(0, make_unique<SenderQueueItem>(ToString(i), 10, nullptr, 0)));
+    }
+    APSARA_TEST_TRUE(queue.HasSpilledItems());
+    for (size_t i = 0; i < 500 && queue.mSpiller->mPendingWriteCnt > 0; ++i) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    APSARA_TEST_EQUAL(0U, queue.mSpiller->mPendingWriteCnt);
+    APSARA_TEST_FALSE(filesystem::is_empty(SenderQueueSpiller::GetSpillDir()));
+
+    // spilled items are read back by the spill thread as sent items are removed
+    vector<string> sent;
+    for (size_t i = 0; i < 500 && sent.size() < 10; ++i) {
+        vector<SenderQueueItem*> items;
+        sManager->GetAvailableItems(items, 80);
+        for (auto item : items) {
+            sent.push_back(item->mData);
+            sManager->DecreaseConcurrencyLimiterInSendingCnt(0);
+            sManager->RemoveItem(0, item);
+        }
+        if (items.empty()) {
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+    }
+    APSARA_TEST_EQUAL(10U, sent.size());
+    for (size_t i = 0; i < sent.size(); ++i) {
+        APSARA_TEST_EQUAL(ToString(i), sent[i]);
+    }
+    APSARA_TEST_TRUE(sManager->IsAllQueueEmpty());
+}
+
 unique_ptr<SenderQueueItem> SenderQueueManagerUnittest::GenerateItem(bool isSLS) {
     if (isSLS) {
         auto cpt = make_shared<RangeCheckpoint>();
@@ -292,6 +379,8 @@ UNIT_TEST_CASE(SenderQueueManagerUnittest, TestPushQueue)
 UNIT_TEST_CASE(SenderQueueManagerUnittest, TestGetAvailableItems)
 UNIT_TEST_CASE(SenderQueueManagerUnittest, TestRemoveItem)
 UNIT_TEST_CASE(SenderQueueManagerUnittest, TestIsAllQueueEmpty)
+UNIT_TEST_CASE(SenderQueueManagerUnittest, TestReadyQueues)
+UNIT_TEST_CASE(SenderQueueManagerUnittest, TestSpillInBackground)
 
 } // namespace logtail
 
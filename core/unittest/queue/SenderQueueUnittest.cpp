@@ -12,10 +12,23 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fstream>
+
+#include "app_config/AppConfig.h"
+#include "collection_pipeline/queue/SLSSenderQueueItem.h"
 #include "collection_pipeline/queue/SenderQueue.h"
+#include "common/FileSystemUtil.h"
+#include "common/Flags.h"
+#include "common/StringTools.h"
+#include "common/memory/MemoryBudget.h"
 #include "unittest/Unittest.h"
 #include "unittest/queue/FeedbackInterfaceMock.h"
 
+DECLARE_FLAG_BOOL(enable_sender_queue_spill);
+DECLARE_FLAG_INT32(sender_queue_spill_extra_buffer_bytes);
+DECLARE_FLAG_INT64(sender_queue_spill_max_bytes);
+DECLARE_FLAG_INT32(sender_queue_spill_max_age_sec);
+
 using namespace std;
 
 namespace logtail {
@@ -26,11 +39,18 @@ public:
     void TestRemove();
     void TestGetAvailableItems();
     void TestMetric();
+    void TestSpill();
+    void TestSpillLimit();
+    void TestSpillUnderMemoryPressure();
+    void TestSpillDerivedItem();
+    void TestRemoveStaleSpillFiles();
+    void TestCloneItemTrace();
 
 protected:
     static void SetUpTestCase() {
         sConcurrencyLimiter = make_shared<ConcurrencyLimiter>("", 80);
         sCtx.SetConfigName("test_config");
+        AppConfig::GetInstance()->mBufferFilePath = GetProcessExecutionDir();
     }
 
     void SetUp() override {
@@ -41,8 +61,14 @@ protected:
     }
 
     void TearDown() override {
+        mQueue.reset();
         sFeedback.Clear();
         sConcurrencyLimiter = make_shared<ConcurrencyLimiter>("", 80);
+        BOOL_FLAG(enable_sender_queue_spill) = false;
+        INT32_FLAG(sender_queue_spill_extra_buffer_bytes) = 16 * 1024 * 1024;
+        INT64_FLAG(sender_queue_spill_max_bytes) = 1024 * 1024 * 1024;
+        INT32_FLAG(sender_queue_spill_max_age_sec) = 86400;
+        MemoryBudget::GetInstance()->SetLimit(0);
     }
 
 private:
@@ -59,6 +85,11 @@ private:
     static shared_ptr<ConcurrencyLimiter> sConcurrencyLimiter;
 
     unique_ptr<SenderQueueItem> GenerateItem();
+    unique_ptr<SenderQueueItem> GenerateItem(size_t idx);
+    // mocks a downstream endpoint, which sends at most @limit items successfully if it is available
+    void Send(bool available, size_t limit, vector<string>& sent);
+    // mocks the spill thread of the queue manager, which does the disk io of the spiller without the queue lock
+    void DoSpillIO();
 
     unique_ptr<SenderQueue> mQueue;
 };
@@ -222,14 +253,237 @@ void SenderQueueUnittest::TestMetric() {
     APSARA_TEST_EQUAL(1U, mQueue->mValidToPushFlag->GetValue());
 }
 
+void SenderQueueUnittest::TestSpill() {
+    BOOL_FLAG(enable_sender_queue_spill) = true;
+    // spill as soon as there is one item in the extra buffer
+    INT32_FLAG(sender_queue_spill_extra_buffer_bytes) = 1;
+
+    vector<string> sent;
+    size_t pushed = 0;
+    // downstream outage: the queue keeps accepting items, which overflow to memory and then to disk
+    for (; pushed < 10; ++pushed) {
+        APSARA_TEST_TRUE(mQueue->Push(GenerateItem(pushed)));
+        APSARA_TEST_TRUE(mQueue->IsValidToPush());
+        Send(false, 2, sent);
+    }
+    APSARA_TEST_EQUAL(sCap, mQueue->Size());
+    APSARA_TEST_EQUAL(1U, mQueue->mExtraBuffer.size());
+    APSARA_TEST_EQUAL(7U, mQueue->mSpiller->Size());
+    APSARA_TEST_EQUAL(7U, mQueue->mSpillSize->GetValue());
+    APSARA_TEST_EQUAL(static_cast<int64_t>(mQueue->mSpiller->DataSize()), SenderQueueSpiller::GetTotalSpilledBytes());
+    APSARA_TEST_TRUE(sent.empty());
+
+    // downstream toggles between available and unavailable, while new items keep coming
+    for (size_t round = 0; round < 10; ++round) {
+        for (size_t i = 0; i < 3; ++i, ++pushed) {
+            APSARA_TEST_TRUE(mQueue->Push(GenerateItem(pushed)));
+        }
+        Send(round % 2 == 0, 4, sent);
+    }
+    while (!mQueue->Empty() || mQueue->HasSpilledItems()) {
+        Send(true, 4, sent);
+    }
+
+    // all items are sent in order, and spill files are removed
+    APSARA_TEST_EQUAL(pushed, sent.size());
+    for (size_t i = 0; i < sent.size(); ++i) {
+        APSARA_TEST_EQUAL(GenerateItem(i)->mData, sent[i]);
+    }
+    APSARA_TEST_TRUE(mQueue->mExtraBuffer.empty());
+    APSARA_TEST_TRUE(mQueue->mSpiller->Empty());
+    APSARA_TEST_EQUAL(0, SenderQueueSpiller::GetTotalSpilledBytes());
+    APSARA_TEST_EQUAL(0U, mQueue->mSpillSizeBytes->GetValue());
+    APSARA_TEST_TRUE(filesystem::is_empty(SenderQueueSpiller::GetSpillDir()));
+    APSARA_TEST_TRUE(mQueue->IsValidToPush());
+}
+
+void SenderQueueUnittest::TestSpillLimit() {
+    BOOL_FLAG(enable_sender_queue_spill) = true;
+    INT32_FLAG(sender_queue_spill_extra_buffer_bytes) = 1;
+    auto itemSize = GenerateItem(0)->mData.size();
+    INT64_FLAG(sender_queue_spill_max_bytes) = 3 * itemSize;
+
+    // disk quota
+    size_t pushed = 0;
+    for (; pushed < 6; ++pushed) {
+        APSARA_TEST_TRUE(mQueue->Push(GenerateItem(pushed)));
+        APSARA_TEST_TRUE(mQueue->IsValidToPush());
+    }
+    APSARA_TEST_EQUAL(3U, mQueue->mSpiller->Size());
+    // spill tier is exhausted, backpressure is applied
+    APSARA_TEST_TRUE(mQueue->Push(GenerateItem(pushed++)));
+    APSARA_TEST_FALSE(mQueue->IsValidToPush());
+    APSARA_TEST_EQUAL(3U, mQueue->mSpiller->Size());
+    APSARA_TEST_EQUAL(2U, mQueue->mExtraBuffer.size());
+
+    // max age
+    for (auto& entry : mQueue->mSpiller->mEntries) {
+        entry.mItem->mFirstEnqueTime -= chrono::seconds(INT32_FLAG(sender_queue_spill_max_age_sec) + 1);
+    }
+    vector<string> sent;
+    while (!mQueue->Empty() || mQueue->HasSpilledItems()) {
+        Send(true, 4, sent);
+    }
+    APSARA_TEST_EQUAL(pushed - 3, sent.size());
+    APSARA_TEST_EQUAL(3U, mQueue->mSpillDiscardedItemsCnt->GetValue());
+    APSARA_TEST_EQUAL(3 * itemSize, mQueue->mSpillDiscardedSizeBytes->GetValue());
+    APSARA_TEST_EQUAL(0, SenderQueueSpiller::GetTotalSpilledBytes());
+    APSARA_TEST_TRUE(mQueue->IsValidToPush());
+}
+
+void SenderQueueUnittest::TestSpillUnderMemoryPressure() {
+    BOOL_FLAG(enable_sender_queue_spill) = true;
+
+    // the extra buffer is used when the budget is not exceeded
+    APSARA_TEST_TRUE(mQueue->Push(GenerateItem(0)));
+    APSARA_TEST_TRUE(mQueue->Push(GenerateItem(1)));
+    APSARA_TEST_TRUE(mQueue->Push(GenerateItem(2)));
+    APSARA_TEST_EQUAL(1U, mQueue->mExtraBuffer.size());
+    APSARA_TEST_TRUE(mQueue->mSpiller == nullptr);
+
+    // new items go to disk as soon as the budget is exceeded
+    MemoryBudget::GetInstance()->SetLimit(1);
+    APSARA_TEST_TRUE(mQueue->Push(GenerateItem(3)));
+    APSARA_TEST_TRUE(mQueue->Push(GenerateItem(4)));
+    APSARA_TEST_EQUAL(1U, mQueue->mExtraBuffer.size());
+    APSARA_TEST_EQUAL(2U, mQueue->mSpiller->Size());
+
+    // all items are sent in order after the pressure is gone
+    MemoryBudget::GetInstance()->SetLimit(0);
+    vector<string> sent;
+    while (!mQueue->Empty() || mQueue->HasSpilledItems()) {
+        Send(true, 4, sent);
+    }
+    APSARA_TEST_EQUAL(5U, sent.size());
+    for (size_t i = 0; i < sent.size(); ++i) {
+        APSARA_TEST_EQUAL(GenerateItem(i)->mData, sent[i]);
+    }
+}
+
+void SenderQueueUnittest::TestSpillDerivedItem() {
+    BOOL_FLAG(enable_sender_queue_spill) = true;
+    INT32_FLAG(sender_queue_spill_extra_buffer_bytes) = 1;
+
+    for (size_t i = 0; i < 4; ++i) {
+        APSARA_TEST_TRUE(mQueue->Push(make_unique<SLSSenderQueueItem>(std::move(GenerateItem(i)->mData),
+                                                                      sDataSize,
+                                                                      nullptr,
+                                                                      sKey,
+                                                                      "logstore_" + ToString(i),
+                                                                      RawDataType::EVENT_GROUP,
+                                                                      "shard_" + ToString(i))));
+    }
+    APSARA_TEST_EQUAL(1U, mQueue->mSpiller->Size());
+    // only the data is moved to disk, and it is not accounted in the memory budget any more
+    auto usage = MemoryBudget::GetInstance()->GetUsage(MemoryBudget::Category::SENDER_QUEUE_ITEM);
+    auto spiller = mQueue->GetSpillerWithPendingIO();
+    APSARA_TEST_TRUE(spiller != nullptr);
+    spiller->mReadAheadSize = SenderQueueSpiller::kReadAheadBytes;
+    spiller->DoIO();
+    APSARA_TEST_TRUE(spiller->mEntries.front().mState == SenderQueueSpiller::EntryState::ON_DISK);
+    APSARA_TEST_TRUE(spiller->mEntries.front().mItem->mData.empty());
+    APSARA_TEST_EQUAL(usage - static_cast<int64_t>(GenerateItem(3)->mData.size()),
+                      MemoryBudget::GetInstance()->GetUsage(MemoryBudget::Category::SENDER_QUEUE_ITEM));
+    APSARA_TEST_FALSE(filesystem::is_empty(SenderQueueSpiller::GetSpillDir()));
+    spiller->mReadAheadSize = 0;
+
+    // fields of the derived item are kept
+    vector<string> sent;
+    vector<SenderQueueItem*> items;
+    while (!mQueue->Empty() || mQueue->HasSpilledItems()) {
+        items.clear();
+        mQueue->GetAvailableItems(items, -1);
+        for (auto* item : items) {
+            auto* slsItem = dynamic_cast<SLSSenderQueueItem*>(item);
+            APSARA_TEST_TRUE_FATAL(slsItem != nullptr);
+            APSARA_TEST_EQUAL("logstore_" + ToString(sent.size()), slsItem->mLogstore);
+            APSARA_TEST_EQUAL("shard_" + ToString(sent.size()), slsItem->mShardHashKey);
+            APSARA_TEST_EQUAL(GenerateItem(sent.size())->mData, slsItem->mData);
+            sent.emplace_back(item->mData);
+            mQueue->Remove(item);
+            DoSpillIO();
+        }
+    }
+    APSARA_TEST_EQUAL(4U, sent.size());
+    APSARA_TEST_EQUAL(0, SenderQueueSpiller::GetTotalSpilledBytes());
+    APSARA_TEST_TRUE(filesystem::is_empty(SenderQueueSpiller::GetSpillDir()));
+}
+
+void SenderQueueUnittest::TestRemoveStaleSpillFiles() {
+    BOOL_FLAG(enable_sender_queue_spill) = true;
+    INT32_FLAG(sender_queue_spill_extra_buffer_bytes) = 1;
+    filesystem::create_directories(SenderQueueSpiller::GetSpillDir());
+    auto staleFile = filesystem::path(SenderQueueSpiller::GetSpillDir()) / "stale.dat";
+    { ofstream(staleFile) << "stale"; }
+
+    // files are not removed on spill
+    for (size_t i = 0; i < 4; ++i) {
+        APSARA_TEST_TRUE(mQueue->Push(GenerateItem(i)));
+    }
+    DoSpillIO();
+    APSARA_TEST_TRUE(filesystem::exists(staleFile));
+
+    SenderQueueSpiller::RemoveStaleFiles();
+    APSARA_TEST_FALSE(filesystem::exists(SenderQueueSpiller::GetSpillDir()));
+}
+
+void SenderQueueUnittest::Send(bool available, size_t limit, vector<string>& sent) {
+    vector<SenderQueueItem*> items;
+    mQueue->GetAvailableItems(items, -1);
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (available && i < limit) {
+            sent.emplace_back(items[i]->mData);
+            mQueue->Remove(items[i]);
+        } else {
+            items[i]->mStatus = SendingStatus::IDLE;
+        }
+    }
+    DoSpillIO();
+}
+
+void SenderQueueUnittest::DoSpillIO() {
+    auto spiller = mQueue->GetSpillerWithPendingIO();
+    if (spiller && spiller->DoIO()) {
+        mQueue->FeedFromSpiller();
+    }
+}
+
+void SenderQueueUnittest::TestCloneItemTrace() {
+    auto item = GenerateItem();
+    item->mTrace = make_shared<EventGroupTrace>();
+    item->mTrace->Stamp(TraceStamp::READ);
+
+    // the clone is sent on its own, so it stamps a trace of its own
+    unique_ptr<SenderQueueItem> copy(item->Clone());
+    APSARA_TEST_NOT_EQUAL(nullptr, copy->mTrace);
+    APSARA_TEST_TRUE(copy->mTrace != item->mTrace);
+    APSARA_TEST_TRUE(copy->mTrace->HasStamp(TraceStamp::READ));
+    copy->mTrace->Stamp(TraceStamp::SEND_DONE);
+    APSARA_TEST_FALSE(item->mTrace->HasStamp(TraceStamp::SEND_DONE));
+
+    item->mTrace.reset();
+    copy.reset(item->Clone());
+    APSARA_TEST_EQUAL(nullptr, copy->mTrace);
+}
+
 unique_ptr<SenderQueueItem> SenderQueueUnittest::GenerateItem() {
     return make_unique<SenderQueueItem>("content", sDataSize, nullptr, sKey);
 }
 
+unique_ptr<SenderQueueItem> SenderQueueUnittest::GenerateItem(size_t idx) {
+    return make_unique<SenderQueueItem>("content_" + ToString(idx + 100), sDataSize, nullptr, sKey);
+}
+
 UNIT_TEST_CASE(SenderQueueUnittest, TestPush)
 UNIT_TEST_CASE(SenderQueueUnittest, TestRemove)
 UNIT_TEST_CASE(SenderQueueUnittest, TestGetAvailableItems)
 UNIT_TEST_CASE(SenderQueueUnittest, TestMetric)
+UNIT_TEST_CASE(SenderQueueUnittest, TestSpill)
+UNIT_TEST_CASE(SenderQueueUnittest, TestSpillLimit)
+UNIT_TEST_CASE(SenderQueueUnittest, TestSpillUnderMemoryPressure)
+UNIT_TEST_CASE(SenderQueueUnittest, TestSpillDerivedItem)
+UNIT_TEST_CASE(SenderQueueUnittest, TestRemoveStaleSpillFiles)
+UNIT_TEST_CASE(SenderQueueUnittest, TestCloneItemTrace)
 
 } // namespace logtail
 
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <thread>
+
 #include "collection_pipeline/plugin/PluginRegistry.h"
 #include "collection_pipeline/queue/SenderQueueManager.h"
 #include "runner/FlusherRunner.h"
@@ -21,6 +23,7 @@
 #include "unittest/plugin/PluginMock.h"
 
 DECLARE_FLAG_INT32(discard_send_fail_interval);
+DECLARE_FLAG_INT32(flusher_runner_thread_num);
 
 using namespace std;
 
@@ -30,6 +33,9 @@ class FlusherRunnerUnittest : public ::testing::Test {
 public:
     void TestDispatch();
     void TestPushToHttpSink();
+    void TestDispatchInParallel();
+    void TestDispatchItemWithoutContext();
+    void TestPushToHttpSinkInParallel();
 
 protected:
     static void SetUpTestCase() { AppConfig::GetInstance()->mSendRequestGlobalConcurrency = 10; }
@@ -142,8 +148,111 @@ void FlusherRunnerUnittest::TestPushToHttpSink() {
     }
 }
 
+void FlusherRunnerUnittest::TestDispatchInParallel() {
+    INT32_FLAG(flusher_runner_thread_num) = 4;
+    vector<unique_ptr<FlusherHttpMock>> flushers;
+    vector<CollectionPipelineContext> ctxs(4);
+    for (size_t i = 0; i < ctxs.size(); ++i) {
+        auto flusher = make_unique<FlusherHttpMock>();
+        Json::Value tmp;
+        ctxs[i].SetConfigName("test_config_" + to_string(i));
+        flusher->SetContext(ctxs[i]);
+        flusher->CreateMetricsRecordRef("name", "1");
+        flusher->Init(Json::Value(), tmp);
+        flusher->CommitMetricsRecordRef();
+        for (size_t j = 0; j < 2; ++j) {
+            flusher->PushToQueue(make_unique<SenderQueueItem>("content", 10, flusher.get(), flusher->GetQueueKey()));
+        }
+        flushers.push_back(std::move(flusher));
+    }
+
+    auto runner = FlusherRunner::GetInstance();
+    runner->Init();
+    APSARA_TEST_EQUAL(4U, runner->mDispatcherQueues.size());
+    for (size_t i = 0; i < 500 && (HttpSink::GetInstance()->mQueue.Size() < 8 || runner->mDispatchingCnt > 0);
+         ++i) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    APSARA_TEST_EQUAL(8U, HttpSink::GetInstance()->mQueue.Size());
+    APSARA_TEST_EQUAL(0, runner->mDispatchingCnt.load());
+
+    HttpSink::GetInstance()->mQueue.Clear();
+    SenderQueueManager::GetInstance()->Clear();
+    runner->Stop();
+    APSARA_TEST_TRUE(runner->mDispatcherQueues.empty());
+    runner->mHttpSendingCnt = 0;
+    INT32_FLAG(flusher_runner_thread_num) = 1;
+}
+
+void FlusherRunnerUnittest::TestDispatchItemWithoutContext() {
+    auto flusher = make_unique<FlusherHttpMock>();
+    Json::Value tmp;
+    CollectionPipelineContext ctx;
+    flusher->SetContext(ctx);
+    flusher->CreateMetricsRecordRef("name", "1");
+    flusher->Init(Json::Value(), tmp);
+    flusher->CommitMetricsRecordRef();
+
+    auto item = make_unique<SenderQueueItem>("content", 10, flusher.get(), flusher->GetQueueKey());
+    auto realItem = item.get();
+    flusher->PushToQueue(std::move(item));
+
+    // flushers of the agent itself, e.g., the ones for alarms, have no context
+    flusher->mContext = nullptr;
+    FlusherRunner::GetInstance()->DispatchItem(realItem, chrono::system_clock::now());
+
+    unique_ptr<HttpSinkRequest> req;
+    APSARA_TEST_TRUE(HttpSinkMock::GetInstance()->mQueue.TryPop(req));
+    APSARA_TEST_NOT_EQUAL(nullptr, req);
+    FlusherRunner::GetInstance()->mHttpSendingCnt = 0;
+}
+
+void FlusherRunnerUnittest::TestPushToHttpSinkInParallel() {
+    auto flusher = make_unique<FlusherHttpMock>();
+    Json::Value tmp;
+    CollectionPipelineContext ctx;
+    flusher->SetContext(ctx);
+    flusher->CreateMetricsRecordRef("name", "1");
+    flusher->Init(Json::Value(), tmp);
+    flusher->CommitMetricsRecordRef();
+    vector<unique_ptr<SenderQueueItem>> items;
+    for (size_t i = 0; i < 40; ++i) {
+        items.push_back(make_unique<SenderQueueItem>("content", 10, flusher.get(), flusher->GetQueueKey()));
+    }
+
+    // the global concurrency is never exceeded, even if items are pushed by several threads
+    auto runner = FlusherRunner::GetInstance();
+    vector<thread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&, i]() {
+            for (size_t j = i; j < items.size(); j += 4) {
+                runner->PushToHttpSink(items[j].get());
+            }
+        });
+    }
+    size_t sentCnt = 0;
+    int32_t maxSendingCnt = 0;
+    while (sentCnt < items.size()) {
+        maxSendingCnt = max(maxSendingCnt, runner->GetSendingBufferCount());
+        unique_ptr<HttpSinkRequest> req;
+        if (HttpSink::GetInstance()->mQueue.TryPop(req)) {
+            ++sentCnt;
+            this_thread::sleep_for(chrono::milliseconds(1));
+            runner->DecreaseHttpSendingCnt();
+        }
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    APSARA_TEST_TRUE(maxSendingCnt <= 10);
+    APSARA_TEST_EQUAL(0, runner->GetSendingBufferCount());
+}
+
 UNIT_TEST_CASE(FlusherRunnerUnittest, TestDispatch)
 UNIT_TEST_CASE(FlusherRunnerUnittest, TestPushToHttpSink)
+UNIT_TEST_CASE(FlusherRunnerUnittest, TestDispatchInParallel)
+UNIT_TEST_CASE(FlusherRunnerUnittest, TestDispatchItemWithoutContext)
+UNIT_TEST_CASE(FlusherRunnerUnittest, TestPushToHttpSinkInParallel)
 
 } // namespace logtail
 
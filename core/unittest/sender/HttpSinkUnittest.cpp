@@ -0,0 +1,297 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+#include "collection_pipeline/plugin/interface/HttpFlusher.h"
+#include "collection_pipeline/queue/QueueKeyManager.h"
+#include "common/Flags.h"
+#include "runner/sink/http/HttpSink.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_BOOL(enable_http_sink_hedging);
+DECLARE_FLAG_INT32(http_sink_hedging_min_delay_ms);
+DECLARE_FLAG_INT32(http_sink_low_speed_time_sec);
+
+using namespace std;
+
+namespace logtail {
+
+// A local http server which answers each request after the delay given by the order of the request, so that tail
+// latency can be injected. A negative delay means never answering.
+class MockHttpServer {
+public:
+    bool Start(function<int(size_t)> delayOf) {
+        mDelayOf = std::move(delayOf);
+        mListenFd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t len = sizeof(addr);
+        if (mListenFd < 0 || ::bind(mListenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+            || listen(mListenFd, 16) != 0 || getsockname(mListenFd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            return false;
+        }
+        mPort = ntohs(addr.sin_port);
+        mAcceptThread = thread(&MockHttpServer::Accept, this);
+        return true;
+    }
+
+    void Stop() {
+        mIsStopped = true;
+        if (mAcceptThread.joinable()) {
+            mAcceptThread.join();
+        }
+        for (auto& t : mConnThreads) {
+            t.join();
+        }
+        mConnThreads.clear();
+        close(mListenFd);
+    }
+
+    uint16_t mPort = 0;
+    atomic_size_t mReceivedCnt = 0;
+    // requests whose connection is closed by the client before the response
+    atomic_size_t mCancelledCnt = 0;
+
+private:
+    void Accept() {
+        while (!mIsStopped) {
+            pollfd pfd{mListenFd, POLLIN, 0};
+            if (poll(&pfd, 1, 10) <= 0) {
+                continue;
+            }
+            int fd = accept(mListenFd, nullptr, nullptr);
+            if (fd >= 0) {
+                mConnThreads.emplace_back(&MockHttpServer::Serve, this, fd);
+            }
+        }
+    }
+
+    void Serve(int fd) {
+        string buf;
+        while (!mIsStopped) {
+            auto headerEnd = buf.find("\r\n\r\n");
+            if (headerEnd == string::npos) {
+                if (!Read(fd, buf)) {
+                    break;
+                }
+                continue;
+            }
+            size_t bodyLen = 0;
+            auto pos = buf.find("Content-Length: ");
+            if (pos != string::npos && pos < headerEnd) {
+                bodyLen = stoul(buf.substr(pos + 16));
+            }
+            if (buf.size() < headerEnd + 4 + bodyLen) {
+                if (!Read(fd, buf)) {
+                    break;
+                }
+                continue;
+            }
+            buf.erase(0, headerEnd + 4 + bodyLen);
+
+            size_t idx = mReceivedCnt++;
+            if (!WaitOrCancelled(fd, mDelayOf(idx))) {
+                ++mCancelledCnt;
+                break;
+            }
+            string body = to_string(idx);
+            string rsp = "HTTP/1.1 200 OK\r\nContent-Length: " + to_string(body.size()) + "\r\n\r\n" + body;
+            if (send(fd, rsp.data(), rsp.size(), MSG_NOSIGNAL) < 0) {
+                break;
+            }
+        }
+        close(fd);
+    }
+
+    bool Read(int fd, string& buf) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (poll(&pfd, 1, 10) <= 0) {
+            return true;
+        }
+        char tmp[4096];
+        auto n = recv(fd, tmp, sizeof(tmp), 0);
+        if (n <= 0) {
+            return false;
+        }
+        buf.append(tmp, n);
+        return true;
+    }
+
+    // returns false if the client closes the connection during the delay
+    bool WaitOrCancelled(int fd, int delayMs) {
+        auto deadline = chrono::steady_clock::now() + chrono::milliseconds(delayMs);
+        while (!mIsStopped && (delayMs < 0 || chrono::steady_clock::now() < deadline)) {
+            pollfd pfd{fd, POLLIN, 0};
+            char c = 0;
+            if (poll(&pfd, 1, 5) > 0 && recv(fd, &c, 1, MSG_PEEK) <= 0) {
+                return false;
+            }
+        }
+        return !mIsStopped;
+    }
+
+    function<int(size_t)> mDelayOf;
+    int mListenFd = -1;
+    thread mAcceptThread;
+    vector<thread> mConnThreads;
+    atomic_bool mIsStopped = false;
+};
+
+class HttpFlusherForHedging : public HttpFlusher {
+public:
+    static const string sName;
+
+    const string& Name() const override { return sName; }
+    bool Init(const Json::Value&, Json::Value&) override { return true; }
+    bool Send(PipelineEventGroup&&) override { return true; }
+    bool Flush(size_t) override { return true; }
+    bool FlushAll() override { return true; }
+    bool BuildRequest(SenderQueueItem*, unique_ptr<HttpSinkRequest>&, bool*, string*) override { return true; }
+    void OnSendDone(const HttpResponse& response, SenderQueueItem*) override {
+        mNetworkStatus = response.GetNetworkStatus().mCode;
+        mBody = *response.GetBody<string>();
+    }
+
+    NetworkCode mNetworkStatus = NetworkCode::Other;
+    string mBody;
+};
+
+const string HttpFlusherForHedging::sName = "flusher_http_for_hedging";
+
+class HttpSinkUnittest : public ::testing::Test {
+public:
+    void TestHedgeSlowRequest();
+    void TestHedgeCheckInterval();
+    void TestAbortStalledRequest();
+
+protected:
+    void SetUp() override {
+        mSink = new HttpSink();
+        mSink->mClient = curl_multi_init();
+        mKey = QueueKeyManager::GetInstance()->GetKey("http_sink_test");
+    }
+
+    void TearDown() override {
+        mServer.Stop();
+        curl_multi_cleanup(mSink->mClient);
+        delete mSink;
+        BOOL_FLAG(enable_http_sink_hedging) = false;
+        INT32_FLAG(http_sink_low_speed_time_sec) = 0;
+    }
+
+    // sends a request and waits for the response, returns the response time
+    chrono::milliseconds Send(uint32_t timeout = 10, uint32_t maxTryCnt = 0) {
+        mItem = make_unique<SenderQueueItem>("data", 4, &mFlusher, mKey);
+        auto request = make_unique<HttpSinkRequest>(
+            "POST", false, "127.0.0.1", mServer.mPort, "/", "", map<string, string>(), "data", mItem.get(), timeout, maxTryCnt);
+        auto start = chrono::steady_clock::now();
+        mSink->AddRequestToClient(std::move(request));
+        mSink->DoRun();
+        return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+    }
+
+    // waits for the server to notice a closed connection
+    size_t GetCancelledCnt() {
+        for (size_t i = 0; i < 100 && mServer.mCancelledCnt == 0; ++i) {
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+        return mServer.mCancelledCnt;
+    }
+
+    HttpSink* mSink = nullptr;
+    MockHttpServer mServer;
+    HttpFlusherForHedging mFlusher;
+    unique_ptr<SenderQueueItem> mItem;
+    QueueKey mKey = 0;
+};
+
+void HttpSinkUnittest::TestHedgeSlowRequest() {
+    const size_t warmUpCnt = EndpointLatencyTracker::sMinSampleCnt;
+    APSARA_TEST_TRUE(mServer.Start([&](size_t idx) { return idx == warmUpCnt || idx == warmUpCnt + 2 ? 1000 : 0; }));
+    BOOL_FLAG(enable_http_sink_hedging) = true;
+    INT32_FLAG(http_sink_hedging_min_delay_ms) = 50;
+
+    // too few samples to tell a slow request
+    for (size_t i = 0; i < warmUpCnt; ++i) {
+        Send();
+        APSARA_TEST_EQUAL(NetworkCode::Ok, mFlusher.mNetworkStatus);
+    }
+    APSARA_TEST_EQUAL(0U, mSink->mHedgeCnt);
+
+    // the hedge sent on a new connection wins, and the slow one is cancelled
+    auto responseTime = Send();
+    APSARA_TEST_TRUE(responseTime < chrono::milliseconds(500));
+    APSARA_TEST_EQUAL(NetworkCode::Ok, mFlusher.mNetworkStatus);
+    APSARA_TEST_EQUAL(to_string(warmUpCnt + 1), mFlusher.mBody);
+    APSARA_TEST_EQUAL(1U, GetCancelledCnt());
+    APSARA_TEST_EQUAL(0U, mSink->mHedgeCnt);
+    APSARA_TEST_TRUE(mSink->mSendingRequests.empty());
+
+    // without hedging, the request waits for the slow response
+    BOOL_FLAG(enable_http_sink_hedging) = false;
+    responseTime = Send();
+    APSARA_TEST_TRUE(responseTime >= chrono::milliseconds(1000));
+    APSARA_TEST_EQUAL(NetworkCode::Ok, mFlusher.mNetworkStatus);
+    APSARA_TEST_EQUAL(to_string(warmUpCnt + 2), mFlusher.mBody);
+    APSARA_TEST_EQUAL(warmUpCnt + 3, mServer.mReceivedCnt);
+}
+
+void HttpSinkUnittest::TestHedgeCheckInterval() {
+    BOOL_FLAG(enable_http_sink_hedging) = true;
+    INT32_FLAG(http_sink_hedging_min_delay_ms) = 1000;
+    int runningHandlers = 0;
+
+    // no request can become slow within the min delay, so the requests are not scanned again until then
+    auto wait = mSink->HedgeSlowRequests(runningHandlers);
+    APSARA_TEST_EQUAL(chrono::milliseconds(1000), wait);
+    auto nextCheckTime = mSink->mNextHedgeCheckTime;
+    wait = mSink->HedgeSlowRequests(runningHandlers);
+    APSARA_TEST_TRUE(wait <= chrono::milliseconds(1000));
+    APSARA_TEST_TRUE(nextCheckTime == mSink->mNextHedgeCheckTime);
+    APSARA_TEST_EQUAL(0, runningHandlers);
+}
+
+void HttpSinkUnittest::TestAbortStalledRequest() {
+    APSARA_TEST_TRUE(mServer.Start([](size_t) { return -1; }));
+    INT32_FLAG(http_sink_low_speed_time_sec) = 1;
+
+    // aborted long before the timeout, and handed to the flusher at once without retrying, so that the failure is
+    // counted only once by the flusher. libcurl measures the speed over the latest seconds, so the bytes uploaded at
+    // first delay the abort a little.
+    auto responseTime = Send(30, 3);
+    APSARA_TEST_TRUE(responseTime < chrono::seconds(10));
+    APSARA_TEST_EQUAL(NetworkCode::LowSpeed, mFlusher.mNetworkStatus);
+    APSARA_TEST_EQUAL(1U, GetCancelledCnt());
+    APSARA_TEST_EQUAL(1U, mServer.mReceivedCnt);
+    APSARA_TEST_TRUE(mSink->mSendingRequests.empty());
+}
+
+UNIT_TEST_CASE(HttpSinkUnittest, TestHedgeSlowRequest)
+UNIT_TEST_CASE(HttpSinkUnittest, TestHedgeCheckInterval)
+UNIT_TEST_CASE(HttpSinkUnittest, TestAbortStalledRequest)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
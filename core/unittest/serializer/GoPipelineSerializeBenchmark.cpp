@@ -0,0 +1,186 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "collection_pipeline/CollectionPipelineContext.h"
+#include "constants/TagConstants.h"
+#include "models/PipelineEventGroup.h"
+#include "protobuf/sls/LogGroupSerializer.h"
+#include "protobuf/sls/sls_logs.pb.h"
+#include "runner/ProcessorRunner.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+static const size_t kEventCnt = 1000;
+static const size_t kRoundCnt = 200;
+
+// measures the C++ side cost of handing off event groups to Go pipelines, i.e., ProcessorRunner::Serialize
+class GoPipelineSerializeBenchmark : public ::testing::Test {
+public:
+    void TestLogEvents();
+    void TestMetricEvents();
+    void TestSpanEvents();
+
+protected:
+    void SetUp() override { mCtx.SetConfigName("test_config"); }
+
+private:
+    static PipelineEventGroup GenerateLogGroup();
+    static PipelineEventGroup GenerateMetricGroup();
+    static PipelineEventGroup GenerateSpanGroup();
+    // the previous implementation, which builds protobuf objects with a copy of every field
+    static string SerializeByProtobuf(const PipelineEventGroup& group, const string& logstore);
+    // @return ms per 1k events
+    double RunHandoff(PipelineEventGroup (*generate)(), size_t& outputSize);
+
+    CollectionPipelineContext mCtx;
+};
+
+PipelineEventGroup GoPipelineSerializeBenchmark::GenerateLogGroup() {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(LOG_RESERVED_KEY_TOPIC, "topic");
+    group.SetTag(string("__path__"), string("/var/log/app/access.log"));
+    group.SetTag(string("__hostname__"), string("host-0"));
+    for (size_t i = 0; i < kEventCnt; ++i) {
+        auto e = group.AddLogEvent();
+        e->SetTimestamp(1234567890 + i, 123456789);
+        for (size_t j = 0; j < 10; ++j) {
+            e->SetContent("key_" + to_string(j), "value_" + to_string(i) + "_" + string(32, 'a' + j));
+        }
+    }
+    return group;
+}
+
+PipelineEventGroup GoPipelineSerializeBenchmark::GenerateMetricGroup() {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(LOG_RESERVED_KEY_TOPIC, "topic");
+    for (size_t i = 0; i < kEventCnt; ++i) {
+        auto e = group.AddMetricEvent();
+        e->SetName("http_requests_total");
+        e->SetTimestamp(1234567890 + i);
+        e->SetValue<UntypedSingleValue>(static_cast<double>(i));
+        e->SetTag(string("method"), string("GET"));
+        e->SetTag(string("path"), "/api/v1/item/" + to_string(i % 100));
+        e->SetTag(string("status"), string("200"));
+    }
+    return group;
+}
+
+PipelineEventGroup GoPipelineSerializeBenchmark::GenerateSpanGroup() {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(LOG_RESERVED_KEY_TOPIC, "topic");
+    for (size_t i = 0; i < kEventCnt; ++i) {
+        auto e = group.AddSpanEvent();
+        e->SetTraceId("trace-" + to_string(i));
+        e->SetSpanId("span-" + to_string(i));
+        e->SetParentSpanId("parent-" + to_string(i));
+        e->SetName("/api/v1/item");
+        e->SetKind(SpanEvent::Kind::Server);
+        e->SetStatus(SpanEvent::StatusCode::Ok);
+        e->SetStartTimeNs(1000);
+        e->SetEndTimeNs(2000 + i);
+        e->SetTimestamp(1234567890 + i);
+        e->SetTag(string("host"), string("10.0.0.1"));
+        e->SetTag(string("statusCode"), string("200"));
+    }
+    return group;
+}
+
+string GoPipelineSerializeBenchmark::SerializeByProtobuf(const PipelineEventGroup& group, const string& logstore) {
+    sls_logs::LogGroup logGroup;
+    for (const auto& e : group.GetEvents()) {
+        const auto& logEvent = e.Cast<LogEvent>();
+        auto log = logGroup.add_logs();
+        for (const auto& kv : logEvent) {
+            auto contPtr = log->add_contents();
+            contPtr->set_key(kv.first.to_string());
+            contPtr->set_value(kv.second.to_string());
+        }
+        log->set_time(logEvent.GetTimestamp());
+    }
+    for (const auto& tag : group.GetTags()) {
+        if (tag.first == LOG_RESERVED_KEY_TOPIC) {
+            logGroup.set_topic(tag.second.to_string());
+        } else {
+            auto logTag = logGroup.add_logtags();
+            logTag->set_key(tag.first.to_string());
+            logTag->set_value(tag.second.to_string());
+        }
+    }
+    logGroup.set_category(logstore);
+    return logGroup.SerializeAsString();
+}
+
+double GoPipelineSerializeBenchmark::RunHandoff(PipelineEventGroup (*generate)(), size_t& outputSize) {
+    LogGroupSerializer serializer;
+    chrono::nanoseconds elapsed(0);
+    for (size_t i = 0; i < kRoundCnt; ++i) {
+        auto group = generate();
+        string errorMsg;
+        auto start = chrono::high_resolution_clock::now();
+        APSARA_TEST_TRUE_FATAL(ProcessorRunner::Serialize(group, mCtx, serializer, errorMsg));
+        elapsed += chrono::high_resolution_clock::now() - start;
+    }
+    outputSize = serializer.GetResult().size();
+    sls_logs::LogGroup logGroup;
+    APSARA_TEST_TRUE(logGroup.ParseFromString(serializer.GetResult()));
+    APSARA_TEST_EQUAL(static_cast<int>(kEventCnt), logGroup.logs_size());
+    return chrono::duration<double, milli>(elapsed).count() / kRoundCnt * 1000 / kEventCnt;
+}
+
+void GoPipelineSerializeBenchmark::TestLogEvents() {
+    chrono::nanoseconds elapsed(0);
+    string res;
+    for (size_t i = 0; i < kRoundCnt; ++i) {
+        auto group = GenerateLogGroup();
+        auto start = chrono::high_resolution_clock::now();
+        res = SerializeByProtobuf(group, mCtx.GetLogstoreName());
+        elapsed += chrono::high_resolution_clock::now() - start;
+    }
+    double protobufCost = chrono::duration<double, milli>(elapsed).count() / kRoundCnt * 1000 / kEventCnt;
+
+    size_t outputSize = 0;
+    double handoffCost = RunHandoff(&GenerateLogGroup, outputSize);
+    cout << "log events, protobuf object: " << protobufCost << " ms/1k events, output size: " << res.size() << endl;
+    cout << "log events, log group serializer: " << handoffCost << " ms/1k events, output size: " << outputSize
+         << endl;
+    APSARA_TEST_EQUAL(res.size(), outputSize);
+}
+
+void GoPipelineSerializeBenchmark::TestMetricEvents() {
+    size_t outputSize = 0;
+    double cost = RunHandoff(&GenerateMetricGroup, outputSize);
+    cout << "metric events, log group serializer: " << cost << " ms/1k events, output size: " << outputSize << endl;
+}
+
+void GoPipelineSerializeBenchmark::TestSpanEvents() {
+    size_t outputSize = 0;
+    double cost = RunHandoff(&GenerateSpanGroup, outputSize);
+    cout << "span events, log group serializer: " << cost << " ms/1k events, output size: " << outputSize << endl;
+}
+
+UNIT_TEST_CASE(GoPipelineSerializeBenchmark, TestLogEvents)
+UNIT_TEST_CASE(GoPipelineSerializeBenchmark, TestMetricEvents)
+UNIT_TEST_CASE(GoPipelineSerializeBenchmark, TestSpanEvents)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN